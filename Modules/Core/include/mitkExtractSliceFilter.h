@@ -162,6 +162,13 @@ namespace mitk
       this->m_InterpolationMode = interpolation;
     }
 
+    /** \brief Copy the voxels directly instead of executing vtkImageReslice if every pixel of the slice lies on
+    * a voxel center (e.g. axial, sagittal or coronal planes of the image geometry). On by default.
+    * The output is the same as the one of vtkImageReslice.
+    */
+    void SetAxisAlignedFastPath(bool enabled) { m_AxisAlignedFastPath = enabled; }
+    bool GetAxisAlignedFastPath() const { return m_AxisAlignedFastPath; }
+
   protected:
     ExtractSliceFilter(vtkImageReslice *reslicer = nullptr);
     virtual ~ExtractSliceFilter();
@@ -170,6 +177,11 @@ namespace mitk
     virtual void GenerateOutputInformation() override;
     virtual void GenerateInputRequestedRegion() override;
 
+    /** \brief Fills the output of the reslicer by copying voxels if the configured reslicing is a
+    * signed permutation of the voxel grid. Returns false if vtkImageReslice has to execute.
+    */
+    bool ExtractAxisAlignedSlice(vtkImageData *inputData);
+
     const PlaneGeometry *m_WorldGeometry;
     vtkSmartPointer<vtkImageReslice> m_Reslicer;
 
@@ -196,6 +208,7 @@ namespace mitk
     double m_BackgroundLevel;
 
     unsigned int m_Component;
+    bool m_AxisAlignedFastPath;
   };
 }
 
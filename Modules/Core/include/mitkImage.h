@@ -19,8 +19,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkBaseData.h"
 #include "mitkImageAccessorBase.h"
+#include "mitkImageAccessorLockManager.h"
 #include "mitkImageDataItem.h"
 #include "mitkImageDescriptor.h"
+#include "mitkImageVolumeLoader.h"
 #include "mitkImageVtkAccessor.h"
 #include "mitkLevelWindow.h"
 #include "mitkPlaneGeometry.h"
@@ -28,6 +30,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkCoreExports.h>
 #include <mitkProportionalTimeGeometry.h>
 
+#include <list>
+
 // DEPRECATED
 #include <mitkTimeSlicedGeometry.h>
 
@@ -261,6 +265,45 @@ namespace mitk
                                   int n = 0,
                                   ImportMemoryManagementType importMemoryManagement = CopyMemory);
 
+    //##Documentation
+    //## @brief Let volume @a t in channel @a n reference the memory of @a storage, starting
+    //## at byte @a offset.
+    //##
+    //## No data is copied. The image keeps a reference on the storage as long as the volume
+    //## is part of the image. This can be used to back an image by out-of-core memory, e.g.
+    //## a MemoryMappedImageDataStorage.
+    //## @throws mitk::Exception if the storage is too small for the volume.
+    //## @sa SetImportChannel(ImageDataStorage*, int, size_t)
+    virtual bool SetImportVolume(ImageDataStorage *storage, int t = 0, int n = 0, size_t offset = 0);
+
+    //##Documentation
+    //## @brief Let channel @a n reference the memory of @a storage, starting at byte @a offset.
+    //##
+    //## No data is copied. The image keeps a reference on the storage as long as the channel
+    //## is part of the image.
+    //## @throws mitk::Exception if the storage is too small for the channel.
+    virtual bool SetImportChannel(ImageDataStorage *storage, int n = 0, size_t offset = 0);
+
+    //##Documentation
+    //## @brief Let the volumes of the image be produced on demand by @a loader.
+    //##
+    //## Volumes that are not set are no longer allocated empty but are loaded by the
+    //## loader when they are requested for the first time. This allows to display the first
+    //## time step of long 4D series before the remaining time steps are read.
+    //## Must be called after Initialize(); calling Initialize() removes the loader.
+    //## @sa SetVolumeLoaderMemoryBudget
+    void SetVolumeLoader(ImageVolumeLoader *loader);
+    ImageVolumeLoader *GetVolumeLoader() const;
+
+    //##Documentation
+    //## @brief Set the maximum number of bytes occupied by volumes produced by the volume loader.
+    //##
+    //## If the budget is exceeded, the least recently used loaded volumes are released again,
+    //## as long as they are not referenced anywhere else (accessors, slices, vtkImageData).
+    //## A budget of 0 (default) means unlimited.
+    void SetVolumeLoaderMemoryBudget(size_t budget);
+    size_t GetVolumeLoaderMemoryBudget() const;
+
     //##Documentation
     //## initialize new (or re-initialize) image information
     //## @warning Initialize() by pic assumes a plane, evenly spaced geometry starting at (0,0,0).
@@ -726,21 +769,30 @@ namespace mitk
                                                       void *data,
                                                       ImportMemoryManagementType importMemoryManagement) const;
 
+    ImageDataItemPointer LoadVolumeData_unlocked(int t, int n) const;
+    void TouchLoadedVolume_unlocked(int pos) const;
+    void ReleaseLoadedVolumes_unlocked(int keepPos) const;
+
     bool IsSliceSet_unlocked(int s, int t, int n) const;
     bool IsVolumeSet_unlocked(int t, int n) const;
     bool IsChannelSet_unlocked(int n) const;
 
-    /** Stores all existing ImageReadAccessors */
-    mutable std::vector<ImageAccessorBase *> m_Readers;
-    /** Stores all existing ImageWriteAccessors */
-    mutable std::vector<ImageAccessorBase *> m_Writers;
+    /** Locks the image parts of all existing ImageReadAccessors and ImageWriteAccessors */
+    mutable ImageAccessorLockManager m_AccessorLocks;
     /** Stores all existing ImageVtkAccessors */
     mutable std::vector<ImageAccessorBase *> m_VtkReaders;
 
-    /** A mutex, which needs to be locked to manage m_Readers and m_Writers */
+    /** A mutex, which needs to be locked while image accessors organize the image data */
     itk::SimpleFastMutexLock m_ReadWriteLock;
     /** A mutex, which needs to be locked to manage m_VtkReaders */
     itk::SimpleFastMutexLock m_VtkReadersLock;
+
+    /** Produces volumes on demand, see SetVolumeLoader() */
+    ImageVolumeLoader::Pointer m_VolumeLoader;
+    size_t m_VolumeLoaderMemoryBudget;
+    /** Volume indices of the volumes produced by m_VolumeLoader, most recently used first */
+    mutable std::list<int> m_LoadedVolumes;
+    mutable size_t m_LoadedVolumesSize;
   };
 
   /**
@@ -30,25 +30,13 @@ namespace mitk
   //##Documentation
   //## @brief The ImageAccessorBase class provides a lock mechanism for all inheriting image accessors.
   //##
+  //## The accessed memory region is locked in the ImageAccessorLockManager of the image,
+  //## shared by read accessors and exclusively by write accessors.
+  //##
   //## @ingroup Data
 
   class Image;
 
-  /** \brief This struct allows to make ImageAccessors wait for this particular ImageAccessor object*/
-  struct ImageAccessorWaitLock
-  {
-    /** \brief Holds the number of ImageAccessors, which are waiting until the represented ImageAccessor is released. */
-    unsigned int m_WaiterCount;
-
-    /** \brief A mutex that allows other ImageAccessors to wait for the represented ImageAccessor. */
-    itk::SimpleFastMutexLock m_Mutex;
-  };
-
-// Defs to assure dead lock prevention only in case of possible thread handling.
-#if defined(ITK_USE_SPROC) || defined(ITK_USE_PTHREADS) || defined(ITK_USE_WIN32_THREADS)
-#define MITK_USE_RECURSIVE_MUTEX_PREVENTION
-#endif
-
   class MITKCORE_EXPORT ImageAccessorBase
   {
     friend class Image;
@@ -88,19 +76,6 @@ namespace mitk
     /** \brief Gives const access to the data. */
     inline const void *GetData() const { return m_AddressBegin; }
   protected:
-// Define type of thread id
-#ifdef ITK_USE_SPROC
-    typedef int ThreadIDType;
-#endif
-
-#ifdef ITK_USE_WIN32_THREADS
-    typedef DWORD ThreadIDType;
-#endif
-
-#ifdef ITK_USE_PTHREADS
-    typedef pthread_t ThreadIDType;
-#endif
-
     /** \brief Checks validity of given parameters from inheriting classes and stores those parameters in member
      * variables. */
     ImageAccessorBase(ImageConstPointer iP, const ImageDataItem *iDI = nullptr, int OptionFlags = DefaultBehavior);
@@ -125,33 +100,7 @@ namespace mitk
     /** Defines if the accessed image part lies coherently in memory */
     bool m_CoherentMemory;
 
-    /** \brief Pointer to a WaitLock struct, that allows other ImageAccessors to wait for this ImageAccessor */
-    ImageAccessorWaitLock *m_WaitLock;
-
-    /** \brief Increments m_WaiterCount. A call of this method is prohibited unless the Mutex m_ReadWriteLock in the
-     * mitk::Image class is Locked. */
-    inline void Increment() { m_WaitLock->m_WaiterCount += 1; }
-    /** \brief Computes if there is an Overlap of the image part between this instantiation and another ImageAccessor
-     * object
-      * \throws mitk::Exception if memory area is incoherent (not supported yet)
-      */
-    bool Overlap(const ImageAccessorBase *iAB);
-
-    /** \brief Uses the WaitLock to wait for another ImageAccessor*/
-    void WaitForReleaseOf(ImageAccessorWaitLock *wL);
-
-    ThreadIDType m_Thread;
-
-    /** \brief Prevents a recursive mutex lock by comparing thread ids of competing image accessors */
-    void PreventRecursiveMutexLock(ImageAccessorBase *iAB);
-
     virtual const Image *GetImage() const = 0;
-
-  private:
-    /** \brief System dependend thread method, to prevent recursive mutex access */
-    ThreadIDType CurrentThreadHandle();
-    /** \brief System dependend thread method, to prevent recursive mutex access */
-    inline bool CompareThreadHandles(ThreadIDType, ThreadIDType);
   };
 
   class MemoryIsLockedException : public Exception
@@ -0,0 +1,103 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKIMAGEACCESSORLOCKMANAGER_H
+#define MITKIMAGEACCESSORLOCKMANAGER_H
+
+#include <MitkCoreExports.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * @brief Manages shared (read) and exclusive (write) locks of memory regions of an image.
+   *
+   * Every mitk::Image owns one lock manager, which is used by the image accessors to
+   * coordinate access to the image data. Locks are requested for a byte range
+   * [begin, end). Shared locks are compatible with each other, an exclusive lock is
+   * compatible with no other lock of an overlapping region.
+   *
+   * Locks of identical regions (typically many accessors of the same slice or volume)
+   * are merged into one region entry, so the effort of acquiring a lock depends on the
+   * number of distinct locked regions, not on the number of accessors. As long as no
+   * exclusive lock is held, shared locks are granted without any overlap check.
+   * Waiting accessors sleep on a condition variable until a region is released.
+   *
+   * @ingroup Data
+   */
+  class MITKCORE_EXPORT ImageAccessorLockManager
+  {
+  public:
+    ImageAccessorLockManager();
+    ~ImageAccessorLockManager();
+
+    /**
+     * @brief Locks the region [begin, end) for @a owner.
+     * @param exclusive request an exclusive instead of a shared lock
+     * @param wait if true, wait until conflicting locks are released, otherwise throw
+     * @throws mitk::MemoryIsLockedException if @a wait is false and the region is locked
+     * @throws mitk::Exception if a conflicting lock is held by the calling thread itself,
+     *         which would never be released while waiting
+     */
+    void Lock(const void *owner, const void *begin, const void *end, bool exclusive, bool wait);
+
+    /** @brief Releases the lock that @a owner holds for the region [begin, end). */
+    void Unlock(const void *owner, const void *begin, const void *end);
+
+    /** @brief Returns true if any lock overlaps the region [begin, end). */
+    bool IsLocked(const void *begin, const void *end) const;
+
+    /** @brief Returns the number of locks currently held. */
+    size_t GetNumberOfLocks() const;
+
+  private:
+    typedef std::pair<const unsigned char *, const unsigned char *> RegionKey;
+
+    struct Holder
+    {
+      const void *m_Owner;
+      std::thread::id m_Thread;
+    };
+
+    struct Region
+    {
+      bool m_Exclusive;
+      std::vector<Holder> m_Holders;
+    };
+
+    typedef std::map<RegionKey, Region> RegionMap;
+
+    /** Returns the first locked region that conflicts with the requested lock or nullptr. */
+    const Region *FindConflict(const RegionKey &key, bool exclusive) const;
+
+    ImageAccessorLockManager(const ImageAccessorLockManager &);
+    ImageAccessorLockManager &operator=(const ImageAccessorLockManager &);
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_RegionReleased;
+    RegionMap m_Regions;
+    size_t m_NumberOfExclusiveRegions;
+    size_t m_NumberOfLocks;
+  };
+}
+
+#endif // MITKIMAGEACCESSORLOCKMANAGER_H
@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 //#include <mitkIpPic.h>
 //#include "mitkPixelType.h"
 #include "mitkImageDescriptor.h"
+#include "mitkImageDataStorage.h"
 //#include "mitkImageVtkAccessor.h"
 
 class vtkImageData;
@@ -90,6 +91,17 @@ namespace mitk
                   void *data,
                   bool manageMemory);
 
+    //##Documentation
+    //## @brief Creates an item whose data is provided by @a storage, starting at byte @a offset.
+    //##
+    //## The item keeps a reference on the storage, the storage memory is never freed by the item itself.
+    ImageDataItem(const mitk::PixelType &type,
+                  int timestep,
+                  unsigned int dimension,
+                  unsigned int *dimensions,
+                  ImageDataStorage *storage,
+                  size_t offset = 0);
+
     ImageDataItem(const ImageDataItem &other);
 
     /**
@@ -115,6 +127,14 @@ namespace mitk
     }
 
     ImageDataItem::ConstPointer GetParent() const { return m_Parent; }
+
+    //##Documentation
+    //## @brief Returns the storage backing this item (or its parent), nullptr for heap allocated data.
+    ImageDataStorage *GetStorage() const { return m_Storage; }
+
+    //##Documentation
+    //## @brief Returns true if the data is backed by a storage that must not be written to.
+    bool IsReadOnly() const { return m_Storage.IsNotNull() && m_Storage->IsReadOnly(); }
     /**
      * @brief GetVtkImageAccessor Returns a vtkImageDataItem, if none is present, a new one is constructed by the
      * ConstructVtkImageData method.
@@ -155,6 +175,8 @@ namespace mitk
 
     ImageDataItem::ConstPointer m_Parent;
 
+    ImageDataStorage::Pointer m_Storage;
+
     unsigned int m_Dimension;
 
     unsigned int m_Dimensions[MAX_IMAGE_DIMENSIONS];
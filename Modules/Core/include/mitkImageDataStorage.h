@@ -0,0 +1,66 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKIMAGEDATASTORAGE_H
+#define MITKIMAGEDATASTORAGE_H
+
+#include "mitkCommon.h"
+#include <MitkCoreExports.h>
+#include <itkLightObject.h>
+
+namespace mitk
+{
+  /**
+   * @brief Abstract backing store for the pixel buffer of an ImageDataItem
+   *
+   * By default an ImageDataItem owns a heap allocated buffer. An ImageDataStorage
+   * can be handed to mitk::Image::SetImportChannel() / SetImportVolume() instead
+   * to let the image reference memory which is provided by some other means, e.g.
+   * a memory-mapped file (see MemoryMappedImageDataStorage). The storage is kept
+   * alive by all ImageDataItems referencing it, so it is released together with the
+   * last slice, volume or channel that uses it.
+   *
+   * Access to the data still happens exclusively through ImageReadAccessor and
+   * ImageWriteAccessor. A storage that reports IsReadOnly() == true can not be
+   * accessed by an ImageWriteAccessor.
+   *
+   * @ingroup Data
+   */
+  class MITKCORE_EXPORT ImageDataStorage : public itk::LightObject
+  {
+  public:
+    mitkClassMacroItkParent(ImageDataStorage, itk::LightObject);
+
+    /** @brief Returns the start of the pixel buffer. */
+    virtual void *GetData() const = 0;
+
+    /** @brief Returns the size of the pixel buffer in bytes. */
+    virtual size_t GetSize() const = 0;
+
+    /** @brief Returns true if the buffer must not be written to. */
+    virtual bool IsReadOnly() const = 0;
+
+  protected:
+    ImageDataStorage();
+    virtual ~ImageDataStorage();
+
+  private:
+    ImageDataStorage(const ImageDataStorage &);
+    ImageDataStorage &operator=(const ImageDataStorage &);
+  };
+}
+
+#endif // MITKIMAGEDATASTORAGE_H
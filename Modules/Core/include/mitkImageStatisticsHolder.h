@@ -24,8 +24,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkHistogram.h>
 #endif
 
+#include <itkEventObject.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <set>
+
 namespace mitk
 {
+  /** Invoked on an mitk::Image when ImageStatisticsHolder::ComputeImageStatisticsInBackground() is done */
+  itkEventMacro(ImageStatisticsComputedEvent, itk::AnyEvent);
+
   /**
     @brief Class holding the statistics informations about a single mitk::Image
 
@@ -35,6 +44,9 @@ namespace mitk
     Each mitk::Image holds a normal pointer to its StatisticsHolder object. To get access to the methods, use the
     GetStatistics() method
     in mitk::Image class.
+
+    The extrema of a time step are computed in a single pass over the pixel buffer, which is split
+    among the ITK default number of threads.
     */
   class MITKCORE_EXPORT ImageStatisticsHolder
   {
@@ -135,24 +147,43 @@ namespace mitk
 
     bool IsValidTimeStep(int t) const;
 
-    template <typename ItkImageType>
-    friend void _ComputeExtremaInItkImage(const ItkImageType *itkImage,
-                                          mitk::ImageStatisticsHolder *statisticsHolder,
-                                          int t);
+    //##Documentation
+    //## \brief Start computing the extrema of time step @a t in a background thread.
+    //##
+    //## The results are published to this holder as soon as they are available, then an
+    //## ImageStatisticsComputedEvent is invoked on the image from the background thread.
+    //## Until then, the Get...NoRecompute() methods return their defaults, while the
+    //## recomputing getters wait for the background computation instead of starting another one.
+    void ComputeImageStatisticsInBackground(int t = 0, unsigned int component = 0);
 
-    template <typename ItkImageType>
-    friend void _ComputeExtremaInItkVectorImage(const ItkImageType *itkImage,
-                                                mitk::ImageStatisticsHolder *statisticsHolder,
-                                                int t,
-                                                unsigned int component);
+    //##Documentation
+    //## \brief Returns true if the extrema of time step @a t are up to date.
+    bool IsImageStatisticsComputed(int t = 0) const;
 
   protected:
+    /** Requires m_StatisticsMutex to be locked */
     virtual void ResetImageStatistics();
 
     virtual void ComputeImageStatistics(int t = 0, unsigned int component = 0);
 
+    /** Requires m_StatisticsMutex to be locked */
     virtual void Expand(unsigned int timeSteps);
 
+    /** Waits for background computations of time step @a t and returns true if its extrema have to be computed */
+    bool PrepareImageStatistics(int t);
+
+    /** Returns true if extrema can be computed for the pixel type, otherwise defaults are used */
+    bool HasExtrema(const mitk::PixelType &pixelType) const;
+
+    /** Requires m_StatisticsMutex to be locked, results of time steps outside of the arrays are dropped */
+    void PublishImageStatistics(int t,
+                                ScalarType min,
+                                ScalarType secondMin,
+                                ScalarType max,
+                                ScalarType secondMax,
+                                unsigned int countOfMin,
+                                unsigned int countOfMax);
+
     ImageTimeSelector::Pointer GetTimeSelector();
 
     mitk::Image *m_Image;
@@ -168,6 +199,11 @@ namespace mitk
     mutable std::vector<ScalarType> m_Scalar2ndMax;
 
     itk::TimeStamp m_LastRecomputeTimeStamp;
+
+    /** Protects the statistics arrays against concurrent background computations */
+    mutable std::mutex m_StatisticsMutex;
+    std::condition_variable m_StatisticsComputed;
+    std::set<int> m_TimeStepsInBackground;
   };
 
 } // end namespace
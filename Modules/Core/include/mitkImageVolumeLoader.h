@@ -0,0 +1,63 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKIMAGEVOLUMELOADER_H
+#define MITKIMAGEVOLUMELOADER_H
+
+#include "mitkCommon.h"
+#include <MitkCoreExports.h>
+#include <itkObject.h>
+
+namespace mitk
+{
+  /**
+   * @brief Provides the volumes of an mitk::Image on demand
+   *
+   * If a loader is set via Image::SetVolumeLoader(), the image does not need to hold all
+   * time steps in memory. Whenever a volume is requested that is not available yet, the
+   * image allocates it and asks the loader to fill it. Volumes produced by the loader may
+   * be evicted again if they exceed the memory budget of the image and are not in use
+   * (see Image::SetVolumeLoaderMemoryBudget()). They are simply loaded again when
+   * requested the next time.
+   *
+   * Implementations are called while the image data arrays of the image are locked, so
+   * they must not access the image they are loading for.
+   *
+   * @ingroup Data
+   */
+  class MITKCORE_EXPORT ImageVolumeLoader : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(ImageVolumeLoader, itk::Object);
+
+    /**
+     * @brief Fills @a buffer with the volume at time step @a t of channel @a n.
+     * @param size size of @a buffer in bytes, which is the size of one volume of channel @a n
+     * @return false if the volume could not be loaded
+     */
+    virtual bool LoadVolume(int t, int n, void *buffer, size_t size) = 0;
+
+  protected:
+    ImageVolumeLoader();
+    virtual ~ImageVolumeLoader();
+
+  private:
+    ImageVolumeLoader(const ImageVolumeLoader &);
+    ImageVolumeLoader &operator=(const ImageVolumeLoader &);
+  };
+}
+
+#endif // MITKIMAGEVOLUMELOADER_H
@@ -23,12 +23,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 // MITK Rendering
 #include "mitkBaseRenderer.h"
 #include "mitkExtractSliceFilter.h"
+#include "mitkResliceCache.h"
 #include "mitkVtkMapper.h"
 
 // VTK
 #include <vtkPropAssembly.h>
 #include <vtkSmartPointer.h>
 
+#include <functional>
+#include <memory>
+
 class vtkActor;
 class vtkPolyDataMapper;
 class vtkPlaneSource;
@@ -184,6 +188,45 @@ namespace mitk
       /** \brief Timestamp of last update of stored data. */
       itk::TimeStamp m_LastUpdateTime;
 
+      /** \brief Everything besides modification times the thick slice depends on. */
+      struct ThickSliceSettings
+      {
+        ThickSliceSettings()
+          : m_Image(nullptr),
+            m_WorldGeometry(nullptr),
+            m_Mode(0),
+            m_Number(0),
+            m_TimeStep(0),
+            m_Interpolation(0),
+            m_InPlaneResampleExtentByGeometry(false)
+        {
+        }
+
+        bool operator==(const ThickSliceSettings &other) const
+        {
+          return m_Image == other.m_Image && m_WorldGeometry == other.m_WorldGeometry && m_Mode == other.m_Mode &&
+                 m_Number == other.m_Number && m_TimeStep == other.m_TimeStep &&
+                 m_Interpolation == other.m_Interpolation &&
+                 m_InPlaneResampleExtentByGeometry == other.m_InPlaneResampleExtentByGeometry;
+        }
+
+        const mitk::Image *m_Image;
+        const mitk::BaseGeometry *m_WorldGeometry;
+        int m_Mode;
+        int m_Number;
+        int m_TimeStep;
+        int m_Interpolation;
+        bool m_InPlaneResampleExtentByGeometry;
+      };
+      /** \brief Settings and timestamp of the last thick slice computation. The computation is skipped if
+            neither changed, e.g. if only the level window was modified. */
+      ThickSliceSettings m_LastThickSliceSettings;
+      itk::TimeStamp m_LastThickSliceUpdateTime;
+
+      /** \brief The cached slice that is currently rendered, nullptr if the slice was not cached (e.g. thick slices).
+            Holds the resliced image, reslice axes and spacing instead of m_Reslicer. */
+      ResliceCache::SlicePointer m_CachedSlice;
+
       /** \brief mmPerPixel relation between pixel and mm. (World spacing).*/
       mitk::ScalarType *m_mmPerPixel;
 
@@ -202,6 +245,19 @@ namespace mitk
     /** \brief Get the LocalStorage corresponding to the current renderer. */
     LocalStorage *GetLocalStorage(mitk::BaseRenderer *renderer);
 
+    /** \brief Cache of resliced images, shared by all render windows showing the image.
+      * Scrolling back to a slice or re-rendering after e.g. a level window change reuses the cached slice.
+      * Its memory budget can be adjusted or set to 0 to disable caching. */
+    ResliceCache &GetResliceCache();
+
+    /** \brief Creates a job that reslices @a planeGeometry like GenerateDataForRenderer() and adds the slice to the
+      * reslice cache, so that it is rendered without reslicing once the renderer reaches the plane.
+      *
+      * Must be called from the rendering thread; the returned job may run on any thread. It reslices a view of the
+      * image volume of the current time step with its own ExtractSliceFilter. Returns an empty function if the slice
+      * is already cached or cannot be cached (curved planes, thick slices, plane outside of the image). */
+    std::function<void()> CreatePrefetchJob(mitk::BaseRenderer *renderer, const PlaneGeometry *planeGeometry);
+
     /** \brief Set the default properties for general image rendering. */
     static void SetDefaultProperties(mitk::DataNode *node, mitk::BaseRenderer *renderer = nullptr, bool overwrite = false);
 
@@ -303,6 +359,19 @@ namespace mitk
       * If the distances have different sign, there is an intersection.
       **/
     bool RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry, SlicedGeometry3D *imageGeometry);
+
+    /** \brief Returns the vtkImageReslice interpolation of the node, nearest neighbor for images with a single slice. */
+    int GetResliceInterpolation(mitk::BaseRenderer *renderer, const mitk::Image *image);
+
+    /** \brief Returns the thick slices mode of the current world plane (0 if thick slicing is off). */
+    int GetThickSlicesMode(mitk::BaseRenderer *renderer, const mitk::Image *image, int &thickSlicesNum);
+
+    /** \brief Latest modification of the data the cached slices of @a timeStep were resliced from. */
+    itk::ModifiedTimeType GetResliceCacheMTime(const mitk::Image *image, int timeStep) const;
+
+  private:
+    /** \brief Shared with prefetch jobs, which may outlive the mapper. */
+    std::shared_ptr<ResliceCache> m_ResliceCache;
   };
 
 } // namespace mitk
@@ -37,6 +37,22 @@ namespace mitk
     ItkImageIO(itk::ImageIOBase::Pointer imageIO);
     ItkImageIO(const CustomMimeType &mimeType, itk::ImageIOBase::Pointer imageIO, int rank);
 
+    /**
+     * Reader option (bool, default false) for NRRD and MetaImage files. If enabled,
+     * uncompressed pixel data stored in native byte order is mapped into memory
+     * (copy-on-write) instead of being read, see MemoryMappedImageDataStorage.
+     * The file must not be modified or deleted while the image is alive.
+     */
+    static std::string OPTION_MEMORY_MAPPING();
+
+    /**
+     * Reader option (bool, default false) for 4D images of ImageIOs that support
+     * streamed reading. If enabled, only the image information is read up front and
+     * each time step is read when it is requested for the first time, see
+     * Image::SetVolumeLoader().
+     */
+    static std::string OPTION_LOAD_TIME_STEPS_ON_DEMAND();
+
     // -------------- AbstractFileReader -------------
 
     using AbstractFileReader::Read;
@@ -55,6 +71,9 @@ namespace mitk
     // Fills the m_DefaultMetaDataKeys vector with default values
     virtual void InitializeDefaultMetaDataKeys();
 
+    // Sets the default reader options supported by the wrapped ImageIO
+    virtual void InitializeDefaultReaderOptions();
+
   private:
     ItkImageIO(const ItkImageIO &other);
 
@@ -35,6 +35,10 @@ namespace mitk
   //##
   //## Derived from UndoModel AND itk::Object. Invokes ITK-events to signal listening
   //## GUI elements, whether each of the stacks is empty or not (to enable/disable button, ...)
+  //##
+  //## The operations of the undo stack are kept within a memory budget. If a new item exceeds it,
+  //## the oldest items of the undo stack are deleted and an UndoFullEvent is invoked. The redo stack
+  //## only holds items that were undone, and it is cleared by the next new item.
   class MITKCORE_EXPORT LimitedLinearUndo : public UndoModel
   {
   public:
@@ -101,6 +105,21 @@ namespace mitk
     //## corresponding to the given values; if nothing found, then returns nullptr
     virtual OperationEvent *GetLastOfType(OperationActor *destination, OperationType opType) override;
 
+    //##Documentation
+    //## @brief Sets the number of bytes the items of the undo stack may hold, 0 means no limit
+    //##
+    //## The newest item of the undo stack is never deleted. The default budget is 1 GB.
+    void SetMemoryBudget(std::size_t memoryBudget);
+    std::size_t GetMemoryBudget() const;
+
+    //##Documentation
+    //## @brief Returns the number of bytes held by the items of the undo stack
+    //##
+    //## The sizes of the items are cached. Items that are still being compressed are not waited for, they count
+    //## with their current size until they are queried again, i.e. by the next new item, SetMemoryBudget() or this
+    //## method.
+    std::size_t GetMemorySize();
+
   protected:
     //##Documentation
     //## Constructor
@@ -114,11 +133,35 @@ namespace mitk
     //## elements in the list and to clear the list
     void ClearList(UndoContainer *list);
 
+    //## @brief Pushes an item onto the undo stack and caches its memory size
+    void PushUndoItem(UndoStackItem *item);
+
+    //## @brief Removes the newest item of the undo stack and returns it
+    UndoStackItem *PopUndoItem();
+
+    //## @brief Deletes the oldest object events of the undo stack until the memory budget is kept
+    void ShrinkToBudget();
+
     UndoContainer m_UndoList;
 
     UndoContainer m_RedoList;
 
+    std::size_t m_MemoryBudget;
+
   private:
+    struct ItemMemorySize
+    {
+      std::size_t Size;
+      bool IsFinal;
+    };
+
+    //## @brief Queries the items again whose memory size was not final yet
+    void UpdateMemorySize();
+
+    // cached memory size of each item of m_UndoList and their sum
+    std::vector<ItemMemorySize> m_UndoMemorySizes;
+    std::size_t m_MemorySize;
+
     int FirstObjectEventIdOfCurrentGroup(UndoContainer &stack);
   };
 
@@ -131,7 +174,8 @@ namespace mitk
   itkEventMacro(RedoEmptyEvent, UndoStackEvent);
   itkEventMacro(UndoNotEmptyEvent, UndoStackEvent);
   itkEventMacro(RedoNotEmptyEvent, UndoStackEvent);
-  /// Additional unused events, if anybody wants to put an artificial limit to the possible number of items in the stack
+  /// UndoFullEvent is invoked when the oldest items of the undo stack are deleted to keep the memory budget,
+  /// RedoFullEvent is unused
   itkEventMacro(UndoFullEvent, UndoStackEvent);
   itkEventMacro(RedoFullEvent, UndoStackEvent);
 
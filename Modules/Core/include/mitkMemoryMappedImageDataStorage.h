@@ -0,0 +1,97 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKMEMORYMAPPEDIMAGEDATASTORAGE_H
+#define MITKMEMORYMAPPEDIMAGEDATASTORAGE_H
+
+#include "mitkImageDataStorage.h"
+
+#include <string>
+
+namespace mitk
+{
+  /**
+   * @brief ImageDataStorage that maps a byte range of a file into memory
+   *
+   * The file is mapped on construction, but the operating system only pages in the
+   * parts that are actually touched. This allows images larger than the physical
+   * memory to be loaded and makes opening uncompressed image files almost free.
+   *
+   * Two modes are supported:
+   *  - ReadOnly: the mapped pages are shared with the file and must not be written.
+   *              ImageWriteAccessors on such data throw an mitk::Exception.
+   *  - CopyOnWrite: the pages are private to the process. Written pages are copied
+   *                 by the operating system, the file itself is never modified.
+   *
+   * @warning The file must neither be truncated nor overwritten while it is mapped.
+   *          On Windows the file can not be deleted or replaced while it is mapped.
+   *
+   * @ingroup Data
+   */
+  class MITKCORE_EXPORT MemoryMappedImageDataStorage : public ImageDataStorage
+  {
+  public:
+    enum MappingMode
+    {
+      ReadOnly,
+      CopyOnWrite
+    };
+
+    mitkClassMacro(MemoryMappedImageDataStorage, ImageDataStorage);
+
+    /**
+     * @brief Maps @a size bytes of @a fileName starting at byte @a offset.
+     * @throws mitk::Exception if the file can not be opened, is too small or can not be mapped.
+     */
+    static Pointer New(const std::string &fileName, size_t offset, size_t size, MappingMode mode = CopyOnWrite)
+    {
+      Pointer smartPtr = new MemoryMappedImageDataStorage(fileName, offset, size, mode);
+      smartPtr->UnRegister();
+      return smartPtr;
+    }
+
+    virtual void *GetData() const override;
+    virtual size_t GetSize() const override;
+    virtual bool IsReadOnly() const override;
+
+    const std::string &GetFileName() const { return m_FileName; }
+    size_t GetOffset() const { return m_Offset; }
+    MappingMode GetMappingMode() const { return m_Mode; }
+
+    /** @brief Returns the size of the file @a fileName in bytes, or 0 if it does not exist. */
+    static size_t GetFileSize(const std::string &fileName);
+
+  protected:
+    MemoryMappedImageDataStorage(const std::string &fileName, size_t offset, size_t size, MappingMode mode);
+    virtual ~MemoryMappedImageDataStorage();
+
+  private:
+    void Unmap();
+
+    std::string m_FileName;
+    size_t m_Offset;
+    size_t m_Size;
+    MappingMode m_Mode;
+
+    // start and length of the mapped view, aligned to the allocation granularity
+    void *m_MappedView;
+    size_t m_MappedLength;
+    // start of the requested byte range inside the mapped view
+    unsigned char *m_Data;
+  };
+}
+
+#endif // MITKMEMORYMAPPEDIMAGEDATASTORAGE_H
@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkCommon.h>
 
+#include <cstddef>
+
 namespace mitk
 {
   typedef int OperationType;
@@ -43,6 +45,16 @@ namespace mitk
 
     OperationType GetOperationType();
 
+    //##Documentation
+    //## @brief Returns the number of bytes held by the operation, operations with large buffers
+    //## override it so that the undo model can keep the history within its memory budget
+    virtual std::size_t GetMemorySize();
+
+    //##Documentation
+    //## @brief False, while GetMemorySize() may still change, e.g. because the buffers are compressed on another
+    //## thread
+    virtual bool IsMemorySizeFinal();
+
   protected:
     OperationType m_OperationType;
   };
@@ -78,6 +78,14 @@ namespace mitk
     virtual void ReverseOperations();
     virtual void ReverseAndExecute();
 
+    //##Documentation
+    //## @brief Returns the number of bytes held by this item
+    virtual std::size_t GetMemorySize();
+
+    //##Documentation
+    //## @brief False, while GetMemorySize() may still change
+    virtual bool IsMemorySizeFinal();
+
     //##Documentation
     //## @brief Increases the current ObjectEventId
     //## For example if a button click generates operations the ObjectEventId has to be incremented to be able to undo
@@ -174,6 +182,12 @@ namespace mitk
     //## and false if it already has been deleted
     virtual bool IsValid();
 
+    //## @brief Returns the number of bytes held by both operations
+    virtual std::size_t GetMemorySize() override;
+
+    //## @brief False, while the memory size of one of the operations may still change
+    virtual bool IsMemorySizeFinal() override;
+
   protected:
     void OnObjectDeleted();
 
@@ -0,0 +1,137 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKRESLICECACHE_H
+#define MITKRESLICECACHE_H
+
+#include <MitkCoreExports.h>
+#include <mitkCommon.h>
+#include <mitkPlaneGeometry.h>
+
+#include <itkObject.h>
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+
+#include <array>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace mitk
+{
+  /**
+   * \brief Least recently used cache of resliced 2D images of one image.
+   *
+   * Slices are identified by the time step, the values of the world plane geometry, the interpolation mode
+   * and the resampling grid (see ExtractSliceFilter). The cache holds copies of the slices together with the
+   * reslice axes and the output spacing, so that they can be rendered without reslicing the image again.
+   * If the total size of the cached slices exceeds the memory budget, the least recently used slices are removed.
+   *
+   * The cache has to be told about modifications of the image via Validate(); all slices are discarded if the
+   * image has been modified since they were added.
+   */
+  class MITKCORE_EXPORT ResliceCache
+  {
+  public:
+    struct MITKCORE_EXPORT Key
+    {
+      Key();
+      Key(const PlaneGeometry *worldGeometry,
+          int timeStep,
+          int interpolation,
+          bool inPlaneResampleExtentByGeometry);
+
+      bool operator<(const Key &other) const;
+      bool operator==(const Key &other) const;
+
+      int m_TimeStep;
+      int m_Interpolation;
+      bool m_InPlaneResampleExtentByGeometry;
+      const BaseGeometry *m_ReferenceGeometry;
+      /** index to world matrix, offset and bounds of the world plane geometry */
+      std::array<ScalarType, 18> m_Geometry;
+    };
+
+    struct Slice
+    {
+      vtkSmartPointer<vtkImageData> m_Image;
+      vtkSmartPointer<vtkMatrix4x4> m_ResliceAxes;
+      ScalarType m_Spacing[2];
+      /** in bytes */
+      size_t m_MemorySize;
+    };
+
+    typedef std::shared_ptr<Slice> SlicePointer;
+
+    /** \param memoryBudget in bytes */
+    explicit ResliceCache(size_t memoryBudget = 32 * 1024 * 1024);
+
+    /** \brief Removes all slices if @a inputMTime differs from the time passed before, i.e. the image was modified. */
+    void Validate(itk::ModifiedTimeType inputMTime);
+
+    /** \brief Returns the cached slice or nullptr. The slice is marked as most recently used. */
+    SlicePointer Get(const Key &key);
+
+    /**
+     * \brief Adds a copy of @a image and returns it. Returns nullptr if the slice is larger than the budget.
+     */
+    SlicePointer Add(const Key &key, vtkImageData *image, vtkMatrix4x4 *resliceAxes, const ScalarType *spacing);
+
+    /**
+     * \brief Adds a slice that was resliced in the background from the image state @a inputMTime.
+     * The slice is dropped if the cache has been validated with another time in the meantime.
+     */
+    SlicePointer Add(const Key &key,
+                     vtkImageData *image,
+                     vtkMatrix4x4 *resliceAxes,
+                     const ScalarType *spacing,
+                     itk::ModifiedTimeType inputMTime);
+
+    /** \brief Returns whether the slice is cached, without marking it as used. */
+    bool Contains(const Key &key) const;
+
+    void Clear();
+
+    /** \brief A budget of 0 disables the cache. */
+    void SetMemoryBudget(size_t memoryBudget);
+    size_t GetMemoryBudget() const;
+
+    /** \brief Size of all cached slices in bytes. */
+    size_t GetMemorySize() const;
+    size_t GetNumberOfSlices() const;
+
+  private:
+    typedef std::pair<Key, SlicePointer> EntryType;
+    typedef std::list<EntryType> EntryListType;
+
+    SlicePointer CopySlice(vtkImageData *image, vtkMatrix4x4 *resliceAxes, const ScalarType *spacing) const;
+    SlicePointer Insert(const Key &key, const SlicePointer &slice);
+    void ShrinkToBudget();
+
+    mutable std::mutex m_Mutex;
+    size_t m_MemoryBudget;
+    size_t m_MemorySize;
+    itk::ModifiedTimeType m_InputMTime;
+    /** most recently used slices first */
+    EntryListType m_Entries;
+    std::map<Key, EntryListType::iterator> m_Index;
+  };
+}
+
+#endif
@@ -27,7 +27,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #pragma GCC visibility pop
 #include "mitkDataStorage.h"
 #include "mitkRestorePlanePositionOperation.h"
+#include "mitkSlicePrefetcher.h"
 #include <itkCommand.h>
+#include <chrono>
 #include <sstream>
 // DEPRECATED
 #include <mitkTimeSlicedGeometry.h>
@@ -471,6 +473,15 @@ namespace mitk
      */
     void AdjustSliceStepperRange();
 
+    /**
+     * \brief Reslices the slices ahead of the current slice in the background while scrolling.
+     *
+     * The number of prefetched slices grows with the scroll speed. Set to nullptr to disable prefetching.
+     * Prefetching requires a renderer (see SetRenderer()).
+     */
+    itkSetObjectMacro(SlicePrefetcher, SlicePrefetcher);
+    itkGetObjectMacro(SlicePrefetcher, SlicePrefetcher);
+
   protected:
     SliceNavigationController();
     virtual ~SliceNavigationController();
@@ -509,6 +520,13 @@ namespace mitk
     bool m_SliceRotationLocked;
     unsigned int m_OldPos;
 
+    /** \brief Queues the slices ahead of the current slice at the prefetcher, called by SendSlice(). */
+    void PrefetchSlices();
+
+    SlicePrefetcher::Pointer m_SlicePrefetcher;
+    unsigned int m_LastPrefetchPos;
+    std::chrono::steady_clock::time_point m_LastPrefetchTime;
+
     typedef std::map<void *, std::list<unsigned long>> ObserverTagsMapType;
     ObserverTagsMapType m_ReceiverToObserverTagsMap;
   };
@@ -0,0 +1,101 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKSLICEPREFETCHER_H
+#define MITKSLICEPREFETCHER_H
+
+#include <MitkCoreExports.h>
+#include <mitkCommon.h>
+
+#include <itkObject.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mitk
+{
+  class BaseRenderer;
+
+  /**
+   * \brief Reslices the slices ahead of the current slice of a 2D renderer on worker threads.
+   *
+   * For every visible image of the renderer that is rendered by an ImageVtkMapper2D, the next slices
+   * in scroll direction are resliced in the background (see ImageVtkMapper2D::CreatePrefetchJob()) and stored
+   * in the reslice cache of the mapper. When the renderer reaches such a slice, it is rendered without reslicing.
+   *
+   * Each call of Prefetch() replaces the jobs that did not start yet, so that the workers always work on
+   * the slices closest to the current position. The worker threads are started on first use.
+   *
+   * \ingroup NavigationControl
+   */
+  class MITKCORE_EXPORT SlicePrefetcher : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(SlicePrefetcher, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    typedef std::function<void()> JobType;
+
+    /** \brief Number of worker threads, takes effect when the workers are started. */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /** \brief Upper limit of the number of slices prefetched ahead of the current slice. */
+    itkSetMacro(MaximumNumberOfSlices, unsigned int);
+    itkGetConstMacro(MaximumNumberOfSlices, unsigned int);
+
+    /**
+     * \brief Queues the reslicing of @a numberOfSlices slices of the world geometry of @a renderer,
+     * starting at @a slice + @a step and moving by @a step slices. Pending jobs of earlier calls are dropped.
+     * Must be called from the rendering thread.
+     */
+    void Prefetch(BaseRenderer *renderer, unsigned int slice, int step, unsigned int numberOfSlices);
+
+    /** \brief Drops all jobs that did not start yet. */
+    void Cancel();
+
+    /** \brief Blocks until all queued jobs are finished. */
+    void Wait();
+
+    unsigned int GetNumberOfPendingJobs() const;
+
+  protected:
+    SlicePrefetcher();
+    ~SlicePrefetcher() override;
+
+    void Enqueue(std::vector<JobType> &jobs);
+    void StartWorkers();
+    void StopWorkers();
+    void Work();
+
+    unsigned int m_NumberOfThreads;
+    unsigned int m_MaximumNumberOfSlices;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_JobAvailable;
+    std::condition_variable m_JobsDone;
+    std::deque<JobType> m_Jobs;
+    unsigned int m_NumberOfRunningJobs;
+    bool m_Stop;
+    std::vector<std::thread> m_Workers;
+  };
+}
+
+#endif
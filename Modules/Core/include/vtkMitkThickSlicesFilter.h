@@ -14,13 +14,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 ===================================================================*/
 
-// .NAME vtkMitkThickSlicesFilter - Computes the gradient vector.
+// .NAME vtkMitkThickSlicesFilter - Projects a thick slab onto a single slice.
 // .SECTION Description
-// vtkMitkThickSlicesFilter computes the gradient vector of an image.  The
-// vector results are stored as scalar components. The Dimensionality
-// determines whether to perform a 2d or 3d gradient. The default is
-// two dimensional XY gradient.  OutputScalarType is always
-// double. Gradient is computed using central differences.
+// vtkMitkThickSlicesFilter projects all slices of the input along z onto
+// one output slice (MIP, sum, weighted sum, MinIP or mean). The output is
+// split into slabs of rows that are processed by several threads; each row
+// is computed slice by slice with unit stride loops.
 
 #ifndef __vtkMitkThickSlicesFilter_h
 #define __vtkMitkThickSlicesFilter_h
@@ -85,7 +84,14 @@ private:
   void operator=(const vtkMitkThickSlicesFilter &);           // Not implemented.
 
 public:
-  void SetThickSliceMode(int mode) { m_CurrentMode = mode; }
+  void SetThickSliceMode(int mode)
+  {
+    if (m_CurrentMode != mode)
+    {
+      m_CurrentMode = mode;
+      this->Modified();
+    }
+  }
   int GetThickSliceMode() { return m_CurrentMode; }
 };
 
@@ -25,6 +25,121 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkImageExtractComponents.h>
 #include <vtkLinearTransform.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+  template <typename TPixel>
+  TPixel ConvertBackgroundLevel(double backgroundLevel)
+  {
+    // vtkImageReslice clamps and rounds the background level to the scalar type
+    if (std::numeric_limits<TPixel>::is_integer)
+    {
+      backgroundLevel = std::max<double>(backgroundLevel, std::numeric_limits<TPixel>::min());
+      backgroundLevel = std::min<double>(backgroundLevel, std::numeric_limits<TPixel>::max());
+      return static_cast<TPixel>(std::floor(backgroundLevel + 0.5));
+    }
+    return static_cast<TPixel>(backgroundLevel);
+  }
+
+  /** Copies the voxels of a slice whose pixels map to voxels by a signed axis permutation.
+   * start is the voxel of the first output pixel, stepX/Y/Z the voxel offsets per output pixel. */
+  template <typename TPixel>
+  void CopyAxisAlignedSlice(const TPixel *input,
+                            const int *inputDimensions,
+                            int numberOfComponents,
+                            TPixel *output,
+                            const int *outputExtent,
+                            const int *start,
+                            const int *stepX,
+                            const int *stepY,
+                            const int *stepZ,
+                            double backgroundLevel)
+  {
+    const TPixel background = ConvertBackgroundLevel<TPixel>(backgroundLevel);
+    const vtkIdType inputStride[3] = {numberOfComponents,
+                                      static_cast<vtkIdType>(numberOfComponents) * inputDimensions[0],
+                                      static_cast<vtkIdType>(numberOfComponents) * inputDimensions[0] * inputDimensions[1]};
+    const vtkIdType pixelStride = stepX[0] * inputStride[0] + stepX[1] * inputStride[1] + stepX[2] * inputStride[2];
+    const int width = outputExtent[1] - outputExtent[0] + 1;
+    const size_t rowLength = static_cast<size_t>(width) * numberOfComponents;
+
+    for (int z = 0; z <= outputExtent[5] - outputExtent[4]; ++z)
+    {
+      for (int y = 0; y <= outputExtent[3] - outputExtent[2]; ++y, output += rowLength)
+      {
+        int row[3];
+        for (int a = 0; a < 3; ++a)
+          row[a] = start[a] + y * stepY[a] + z * stepZ[a];
+
+        // range of pixels of the row that lie inside of the volume
+        int begin = 0;
+        int end = width;
+        for (int a = 0; a < 3; ++a)
+        {
+          if (stepX[a] == 0)
+          {
+            if (row[a] < 0 || row[a] >= inputDimensions[a])
+              end = 0;
+          }
+          else if (stepX[a] > 0)
+          {
+            begin = std::max(begin, -row[a]);
+            end = std::min(end, inputDimensions[a] - row[a]);
+          }
+          else
+          {
+            begin = std::max(begin, row[a] - inputDimensions[a] + 1);
+            end = std::min(end, row[a] + 1);
+          }
+        }
+        if (end < begin)
+          begin = end = 0;
+
+        std::fill(output, output + static_cast<size_t>(begin) * numberOfComponents, background);
+        std::fill(output + static_cast<size_t>(end) * numberOfComponents, output + rowLength, background);
+        if (begin == end)
+          continue;
+
+        const TPixel *voxel =
+          input + row[0] * inputStride[0] + row[1] * inputStride[1] + row[2] * inputStride[2] + begin * pixelStride;
+        TPixel *pixel = output + static_cast<size_t>(begin) * numberOfComponents;
+
+        if (pixelStride == numberOfComponents)
+        {
+          // rows of the slice are rows of the volume (axial)
+          std::memcpy(pixel, voxel, static_cast<size_t>(end - begin) * numberOfComponents * sizeof(TPixel));
+        }
+        else
+        {
+          for (int x = begin; x < end; ++x, voxel += pixelStride)
+          {
+            for (int c = 0; c < numberOfComponents; ++c)
+              *pixel++ = voxel[c];
+          }
+        }
+      }
+    }
+  }
+
+  /** Returns whether the continuous index offset per output pixel is a signed unit step along one axis. */
+  bool GetAxisStep(const double *step, double tolerance, int *axisStep)
+  {
+    int numberOfAxes = 0;
+    for (int a = 0; a < 3; ++a)
+    {
+      axisStep[a] = static_cast<int>(std::floor(step[a] + 0.5));
+      if (std::abs(step[a] - axisStep[a]) > tolerance || std::abs(axisStep[a]) > 1)
+        return false;
+      numberOfAxes += std::abs(axisStep[a]);
+    }
+    return numberOfAxes == 1;
+  }
+}
+
 mitk::ExtractSliceFilter::ExtractSliceFilter(vtkImageReslice *reslicer)
 {
   if (reslicer == nullptr)
@@ -49,6 +164,7 @@ mitk::ExtractSliceFilter::ExtractSliceFilter(vtkImageReslice *reslicer)
   m_VtkOutputRequested = false;
   m_BackgroundLevel = -32768.0;
   m_Component = 0;
+  m_AxisAlignedFastPath = true;
 }
 
 mitk::ExtractSliceFilter::~ExtractSliceFilter()
@@ -348,13 +464,16 @@ void mitk::ExtractSliceFilter::GenerateData()
 
   m_Reslicer->SetOutputSpacing(m_OutPutSpacing[0], m_OutPutSpacing[1], m_ZSpacing);
 
-  // TODO check the following lines, they are responsible whether vtk error outputs appear or not
-  m_Reslicer->UpdateWholeExtent(); // this produces a bad allocation error for 2D images
-  // m_Reslicer->GetOutput()->UpdateInformation();
-  // m_Reslicer->GetOutput()->SetUpdateExtentToWholeExtent();
+  if (!this->ExtractAxisAlignedSlice(input->GetVtkImageData(m_TimeStep)))
+  {
+    // TODO check the following lines, they are responsible whether vtk error outputs appear or not
+    m_Reslicer->UpdateWholeExtent(); // this produces a bad allocation error for 2D images
+    // m_Reslicer->GetOutput()->UpdateInformation();
+    // m_Reslicer->GetOutput()->SetUpdateExtentToWholeExtent();
 
-  // start the pipeline
-  m_Reslicer->Update();
+    // start the pipeline
+    m_Reslicer->Update();
+  }
   /*================ #END setup vtkImageReslice properties================*/
 
   if (m_VtkOutputRequested)
@@ -461,6 +580,99 @@ void mitk::ExtractSliceFilter::GenerateData()
   }
 }
 
+bool mitk::ExtractSliceFilter::ExtractAxisAlignedSlice(vtkImageData *inputData)
+{
+  // Subclasses of vtkImageReslice (e.g. the overwriting reslicer used for writing slices back)
+  // have to execute, as well as curved planes and outputs of a converted scalar type.
+  if (!m_AxisAlignedFastPath || inputData == nullptr || this->GetInput()->GetDimension() < 3 ||
+      std::strcmp(m_Reslicer->GetClassName(), "vtkImageReslice") != 0 || m_Reslicer->GetOutputScalarType() > 0 ||
+      (m_Reslicer->GetResliceTransform() != nullptr && m_ResliceTransform.IsNull()) ||
+      dynamic_cast<const AbstractTransformGeometry *>(m_WorldGeometry) != nullptr ||
+      inputData->GetNumberOfScalarComponents() > 4 || inputData->GetScalarPointer() == nullptr)
+  {
+    return false;
+  }
+
+  // output point = origin + index * spacing, world point = reslice axes * output point
+  vtkSmartPointer<vtkMatrix4x4> outputToInput = vtkSmartPointer<vtkMatrix4x4>::New();
+  outputToInput->DeepCopy(m_Reslicer->GetResliceAxes());
+
+  double inputSpacing[3];
+  double inputOrigin[3];
+  inputData->GetSpacing(inputSpacing);
+  inputData->GetOrigin(inputOrigin);
+  if (m_ResliceTransform.IsNotNull())
+  {
+    // the input is resliced in index coordinates (see the unit spacing filter in GenerateData)
+    vtkMatrix4x4::Multiply4x4(
+      m_ResliceTransform->GetVtkTransform()->GetLinearInverse()->GetMatrix(), outputToInput, outputToInput);
+    inputSpacing[0] = inputSpacing[1] = inputSpacing[2] = 1.0;
+  }
+
+  int outputExtent[6];
+  double outputSpacing[3];
+  double outputOrigin[3];
+  m_Reslicer->GetOutputExtent(outputExtent);
+  m_Reslicer->GetOutputSpacing(outputSpacing);
+  m_Reslicer->GetOutputOrigin(outputOrigin);
+
+  // continuous voxel index of the first output pixel and its change per output pixel in x, y and z
+  double first[3];
+  double steps[3][3];
+  for (int r = 0; r < 3; ++r)
+  {
+    double point = outputToInput->GetElement(r, 3);
+    for (int c = 0; c < 3; ++c)
+    {
+      point += outputToInput->GetElement(r, c) * (outputOrigin[c] + outputExtent[2 * c] * outputSpacing[c]);
+      steps[c][r] = outputToInput->GetElement(r, c) * outputSpacing[c] / inputSpacing[r];
+    }
+    first[r] = (point - inputOrigin[r]) / inputSpacing[r];
+  }
+
+  // Only if every pixel lies on a voxel center, all interpolation modes just copy voxels.
+  const double tolerance = m_InterpolationMode == RESLICE_NEAREST ? 1e-3 : 1e-6;
+  int start[3];
+  int stepX[3], stepY[3], stepZ[3] = {0, 0, 0};
+  for (int r = 0; r < 3; ++r)
+  {
+    start[r] = static_cast<int>(std::floor(first[r] + 0.5));
+    if (std::abs(first[r] - start[r]) > tolerance)
+      return false;
+  }
+  if (!GetAxisStep(steps[0], tolerance, stepX) || !GetAxisStep(steps[1], tolerance, stepY))
+    return false;
+  if (outputExtent[5] > outputExtent[4] && !GetAxisStep(steps[2], tolerance, stepZ))
+    return false;
+
+  int inputDimensions[3];
+  inputData->GetDimensions(inputDimensions);
+  const int numberOfComponents = inputData->GetNumberOfScalarComponents();
+
+  vtkImageData *output = m_Reslicer->GetOutput();
+  output->SetExtent(outputExtent);
+  output->SetSpacing(outputSpacing);
+  output->SetOrigin(outputOrigin);
+  output->AllocateScalars(inputData->GetScalarType(), numberOfComponents);
+
+  switch (inputData->GetScalarType())
+  {
+    vtkTemplateMacro(CopyAxisAlignedSlice(static_cast<const VTK_TT *>(inputData->GetScalarPointer()),
+                                          inputDimensions,
+                                          numberOfComponents,
+                                          static_cast<VTK_TT *>(output->GetScalarPointer()),
+                                          outputExtent,
+                                          start,
+                                          stepX,
+                                          stepY,
+                                          stepZ,
+                                          m_BackgroundLevel));
+    default:
+      return false;
+  }
+  return true;
+}
+
 bool mitk::ExtractSliceFilter::GetClippedPlaneBounds(double bounds[6])
 {
   if (!m_WorldGeometry || !this->GetInput())
@@ -17,9 +17,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkLimitedLinearUndo.h"
 #include <mitkRenderingManager.h>
 
-mitk::LimitedLinearUndo::LimitedLinearUndo()
+mitk::LimitedLinearUndo::LimitedLinearUndo() : m_MemoryBudget(1024 * 1024 * 1024), m_MemorySize(0)
 {
-  // nothing to do
 }
 
 mitk::LimitedLinearUndo::~LimitedLinearUndo()
@@ -52,10 +51,12 @@ bool mitk::LimitedLinearUndo::SetOperationEvent(UndoStackItem *stackItem)
     InvokeEvent(RedoEmptyEvent());
   }
 
-  m_UndoList.push_back(operationEvent);
+  this->PushUndoItem(operationEvent);
 
   InvokeEvent(UndoNotEmptyEvent());
 
+  this->ShrinkToBudget();
+
   return true;
 }
 
@@ -94,8 +95,7 @@ bool mitk::LimitedLinearUndo::Undo(int oeid)
   {
     m_UndoList.back()->ReverseAndExecute();
 
-    m_RedoList.push_back(m_UndoList.back()); // move to redo stack
-    m_UndoList.pop_back();
+    m_RedoList.push_back(this->PopUndoItem()); // move to redo stack
     InvokeEvent(RedoNotEmptyEvent());
 
     if (m_UndoList.empty())
@@ -134,7 +134,7 @@ bool mitk::LimitedLinearUndo::Redo(int oeid)
   {
     m_RedoList.back()->ReverseAndExecute();
 
-    m_UndoList.push_back(m_RedoList.back());
+    this->PushUndoItem(m_RedoList.back());
     m_RedoList.pop_back();
     InvokeEvent(UndoNotEmptyEvent());
 
@@ -153,6 +153,8 @@ bool mitk::LimitedLinearUndo::Redo(int oeid)
 void mitk::LimitedLinearUndo::Clear()
 {
   this->ClearList(&m_UndoList);
+  m_UndoMemorySizes.clear();
+  m_MemorySize = 0;
   InvokeEvent(UndoEmptyEvent());
 
   this->ClearList(&m_RedoList);
@@ -214,3 +216,92 @@ int mitk::LimitedLinearUndo::FirstObjectEventIdOfCurrentGroup(mitk::LimitedLinea
 
   return firstObjectEventId;
 }
+
+void mitk::LimitedLinearUndo::SetMemoryBudget(std::size_t memoryBudget)
+{
+  m_MemoryBudget = memoryBudget;
+  this->ShrinkToBudget();
+}
+
+std::size_t mitk::LimitedLinearUndo::GetMemoryBudget() const
+{
+  return m_MemoryBudget;
+}
+
+std::size_t mitk::LimitedLinearUndo::GetMemorySize()
+{
+  this->UpdateMemorySize();
+  return m_MemorySize;
+}
+
+void mitk::LimitedLinearUndo::PushUndoItem(UndoStackItem *item)
+{
+  const ItemMemorySize itemMemorySize = {item->GetMemorySize(), item->IsMemorySizeFinal()};
+  m_UndoList.push_back(item);
+  m_UndoMemorySizes.push_back(itemMemorySize);
+  m_MemorySize += itemMemorySize.Size;
+}
+
+mitk::UndoStackItem *mitk::LimitedLinearUndo::PopUndoItem()
+{
+  UndoStackItem *item = m_UndoList.back();
+  m_UndoList.pop_back();
+  m_MemorySize -= m_UndoMemorySizes.back().Size;
+  m_UndoMemorySizes.pop_back();
+  return item;
+}
+
+void mitk::LimitedLinearUndo::UpdateMemorySize()
+{
+  // e.g. slices that were compressed in the meantime, usually only the newest items
+  for (std::size_t i = 0; i < m_UndoList.size(); ++i)
+  {
+    ItemMemorySize &itemMemorySize = m_UndoMemorySizes[i];
+    if (itemMemorySize.IsFinal)
+      continue;
+
+    itemMemorySize.IsFinal = m_UndoList[i]->IsMemorySizeFinal();
+    m_MemorySize -= itemMemorySize.Size;
+    itemMemorySize.Size = m_UndoList[i]->GetMemorySize();
+    m_MemorySize += itemMemorySize.Size;
+  }
+}
+
+void mitk::LimitedLinearUndo::ShrinkToBudget()
+{
+  if (m_MemoryBudget == 0)
+    return;
+
+  this->UpdateMemorySize();
+  std::size_t memorySize = m_MemorySize;
+
+  // Items of one object event are deleted together, the newest object event is kept
+  std::size_t end = 0;
+  while (memorySize > m_MemoryBudget)
+  {
+    std::size_t next = end;
+    std::size_t objectEventSize = 0;
+    while (next < m_UndoList.size() && m_UndoList[next]->GetObjectEventId() == m_UndoList[end]->GetObjectEventId())
+    {
+      objectEventSize += m_UndoMemorySizes[next].Size;
+      ++next;
+    }
+
+    if (next == m_UndoList.size())
+      break;
+
+    memorySize -= objectEventSize;
+    end = next;
+  }
+
+  if (end == 0)
+    return;
+
+  for (std::size_t i = 0; i < end; ++i)
+    delete m_UndoList[i];
+  m_UndoList.erase(m_UndoList.begin(), m_UndoList.begin() + end);
+  m_UndoMemorySizes.erase(m_UndoMemorySizes.begin(), m_UndoMemorySizes.begin() + end);
+  m_MemorySize = memorySize;
+
+  InvokeEvent(UndoFullEvent());
+}
@@ -76,6 +76,16 @@ void mitk::UndoStackItem::ReverseAndExecute()
   ReverseOperations();
 }
 
+std::size_t mitk::UndoStackItem::GetMemorySize()
+{
+  return sizeof(UndoStackItem) + m_Description.capacity();
+}
+
+bool mitk::UndoStackItem::IsMemorySizeFinal()
+{
+  return true;
+}
+
 // ******************** mitk::OperationEvent ********************
 
 mitk::Operation *mitk::OperationEvent::GetOperation()
@@ -152,3 +162,19 @@ bool mitk::OperationEvent::IsValid()
 {
   return !m_Invalid;
 }
+
+std::size_t mitk::OperationEvent::GetMemorySize()
+{
+  std::size_t memorySize = UndoStackItem::GetMemorySize();
+  if (m_Operation)
+    memorySize += m_Operation->GetMemorySize();
+  if (m_UndoOperation)
+    memorySize += m_UndoOperation->GetMemorySize();
+  return memorySize;
+}
+
+bool mitk::OperationEvent::IsMemorySizeFinal()
+{
+  return (!m_Operation || m_Operation->IsMemorySizeFinal()) &&
+         (!m_UndoOperation || m_UndoOperation->IsMemorySizeFinal());
+}
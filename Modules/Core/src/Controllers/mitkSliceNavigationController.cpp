@@ -45,6 +45,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkCommand.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
 namespace mitk
 {
   SliceNavigationController::SliceNavigationController()
@@ -62,7 +66,9 @@ namespace mitk
       m_BlockUpdate(false),
       m_SliceLocked(false),
       m_SliceRotationLocked(false),
-      m_OldPos(0)
+      m_OldPos(0),
+      m_SlicePrefetcher(SlicePrefetcher::New()),
+      m_LastPrefetchPos(0)
   {
     typedef itk::SimpleMemberCommand<SliceNavigationController> SNCCommandType;
     SNCCommandType::Pointer sliceStepperChangedCommand, timeStepperChangedCommand;
@@ -397,10 +403,44 @@ namespace mitk
 
         // Request rendering update for all views
         this->GetRenderingManager()->RequestUpdateAll();
+
+        this->PrefetchSlices();
       }
     }
   }
 
+  void SliceNavigationController::PrefetchSlices()
+  {
+    const unsigned int pos = m_Slice->GetPos();
+    const int step = static_cast<int>(pos) - static_cast<int>(m_LastPrefetchPos);
+    const auto now = std::chrono::steady_clock::now();
+    const double secondsPerStep = std::chrono::duration<double>(now - m_LastPrefetchTime).count();
+    m_LastPrefetchPos = pos;
+    m_LastPrefetchTime = now;
+
+    if (m_SlicePrefetcher.IsNull() || m_Renderer == nullptr || step == 0)
+    {
+      return;
+    }
+
+    // larger steps are jumps to another position, not scrolling
+    const unsigned int maximumNumberOfSlices = m_SlicePrefetcher->GetMaximumNumberOfSlices();
+    if (static_cast<unsigned int>(std::abs(step)) > maximumNumberOfSlices)
+    {
+      m_SlicePrefetcher->Cancel();
+      return;
+    }
+
+    // prefetch the slices that are reached within the next quarter of a second, at least the next two
+    unsigned int numberOfSlices = 2;
+    if (secondsPerStep > 0.0 && secondsPerStep < 1.0)
+    {
+      numberOfSlices = std::max(numberOfSlices, static_cast<unsigned int>(std::ceil(0.25 / secondsPerStep)));
+    }
+
+    m_SlicePrefetcher->Prefetch(m_Renderer, pos, step, std::min(numberOfSlices, maximumNumberOfSlices));
+  }
+
   void SliceNavigationController::SendTime()
   {
     if (!m_BlockUpdate)
@@ -0,0 +1,172 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkSlicePrefetcher.h"
+
+#include "mitkBaseRenderer.h"
+#include "mitkDataStorage.h"
+#include "mitkImage.h"
+#include "mitkImageVtkMapper2D.h"
+#include "mitkSlicedGeometry3D.h"
+
+#include <algorithm>
+
+mitk::SlicePrefetcher::SlicePrefetcher()
+  : m_NumberOfThreads(2), m_MaximumNumberOfSlices(8), m_NumberOfRunningJobs(0), m_Stop(false)
+{
+}
+
+mitk::SlicePrefetcher::~SlicePrefetcher()
+{
+  this->StopWorkers();
+}
+
+void mitk::SlicePrefetcher::Prefetch(BaseRenderer *renderer, unsigned int slice, int step, unsigned int numberOfSlices)
+{
+  if (renderer == nullptr || step == 0 || renderer->GetMapperID() != BaseRenderer::Standard2D)
+    return;
+
+  DataStorage::Pointer dataStorage = renderer->GetDataStorage();
+  const TimeGeometry *worldTimeGeometry = renderer->GetWorldTimeGeometry();
+  if (dataStorage.IsNull() || worldTimeGeometry == nullptr)
+    return;
+
+  const auto *slicedGeometry =
+    dynamic_cast<const SlicedGeometry3D *>(worldTimeGeometry->GetGeometryForTimeStep(renderer->GetTimeStep()).GetPointer());
+  if (slicedGeometry == nullptr)
+    return;
+
+  std::vector<ImageVtkMapper2D *> mappers;
+  DataStorage::SetOfObjects::ConstPointer nodes = dataStorage->GetAll();
+  for (auto it = nodes->Begin(); it != nodes->End(); ++it)
+  {
+    DataNode *node = it->Value();
+    if (dynamic_cast<Image *>(node->GetData()) == nullptr || !node->IsVisible(renderer))
+      continue;
+
+    auto *mapper = dynamic_cast<ImageVtkMapper2D *>(node->GetMapper(BaseRenderer::Standard2D));
+    if (mapper != nullptr)
+      mappers.push_back(mapper);
+  }
+
+  // nearest slices first, so that they are ready when the renderer reaches them
+  std::vector<JobType> jobs;
+  const long numberOfPlanes = slicedGeometry->GetSlices();
+  numberOfSlices = std::min(numberOfSlices, m_MaximumNumberOfSlices);
+  for (unsigned int i = 1; i <= numberOfSlices; ++i)
+  {
+    const long planeIndex = static_cast<long>(slice) + static_cast<long>(i) * step;
+    if (planeIndex < 0 || planeIndex >= numberOfPlanes)
+      break;
+
+    const PlaneGeometry *plane = slicedGeometry->GetPlaneGeometry(static_cast<int>(planeIndex));
+    for (ImageVtkMapper2D *mapper : mappers)
+    {
+      JobType job = mapper->CreatePrefetchJob(renderer, plane);
+      if (job)
+        jobs.push_back(job);
+    }
+  }
+
+  this->Enqueue(jobs);
+}
+
+void mitk::SlicePrefetcher::Enqueue(std::vector<JobType> &jobs)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Jobs.clear();
+    for (JobType &job : jobs)
+      m_Jobs.push_back(std::move(job));
+
+    if (m_Jobs.empty())
+    {
+      if (m_NumberOfRunningJobs == 0)
+        m_JobsDone.notify_all();
+      return;
+    }
+  }
+
+  this->StartWorkers();
+  m_JobAvailable.notify_all();
+}
+
+void mitk::SlicePrefetcher::Cancel()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Jobs.clear();
+  m_JobsDone.notify_all();
+}
+
+void mitk::SlicePrefetcher::Wait()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_JobsDone.wait(lock, [this] { return m_Jobs.empty() && m_NumberOfRunningJobs == 0; });
+}
+
+unsigned int mitk::SlicePrefetcher::GetNumberOfPendingJobs() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return static_cast<unsigned int>(m_Jobs.size()) + m_NumberOfRunningJobs;
+}
+
+void mitk::SlicePrefetcher::StartWorkers()
+{
+  if (!m_Workers.empty())
+    return;
+
+  const unsigned int numberOfThreads = std::max(1u, m_NumberOfThreads);
+  for (unsigned int i = 0; i < numberOfThreads; ++i)
+    m_Workers.emplace_back(&SlicePrefetcher::Work, this);
+}
+
+void mitk::SlicePrefetcher::StopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Jobs.clear();
+    m_Stop = true;
+  }
+  m_JobAvailable.notify_all();
+
+  for (std::thread &worker : m_Workers)
+    worker.join();
+  m_Workers.clear();
+}
+
+void mitk::SlicePrefetcher::Work()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true)
+  {
+    m_JobAvailable.wait(lock, [this] { return m_Stop || !m_Jobs.empty(); });
+    if (m_Stop)
+      return;
+
+    JobType job = std::move(m_Jobs.front());
+    m_Jobs.pop_front();
+    ++m_NumberOfRunningJobs;
+
+    lock.unlock();
+    job();
+    job = nullptr; // release the data of the job outside of the lock
+    lock.lock();
+
+    --m_NumberOfRunningJobs;
+    if (m_Jobs.empty() && m_NumberOfRunningJobs == 0)
+      m_JobsDone.notify_all();
+  }
+}
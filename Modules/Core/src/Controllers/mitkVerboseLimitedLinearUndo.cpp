@@ -37,10 +37,12 @@ bool mitk::VerboseLimitedLinearUndo::SetOperationEvent(UndoStackItem *undoStackI
     InvokeEvent(RedoEmptyEvent());
   }
 
-  m_UndoList.push_back(undoStackItem);
+  this->PushUndoItem(undoStackItem);
 
   InvokeEvent(UndoNotEmptyEvent());
 
+  this->ShrinkToBudget();
+
   return true;
 }
 
@@ -30,6 +30,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkMutexLockHolder.h>
 
 // Other
+#include <algorithm>
 #include <cmath>
 
 #define FILL_C_ARRAY(_arr, _size, _value)                                                                              \
@@ -45,7 +46,9 @@ mitk::Image::Image()
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
-    m_ImageStatistics(nullptr)
+    m_ImageStatistics(nullptr),
+    m_VolumeLoaderMemoryBudget(0),
+    m_LoadedVolumesSize(0)
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
   FILL_C_ARRAY(m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
@@ -60,7 +63,9 @@ mitk::Image::Image(const Image &other)
     m_ImageDescriptor(nullptr),
     m_OffsetTable(nullptr),
     m_CompleteData(nullptr),
-    m_ImageStatistics(nullptr)
+    m_ImageStatistics(nullptr),
+    m_VolumeLoaderMemoryBudget(0),
+    m_LoadedVolumesSize(0)
 {
   m_Dimensions = new unsigned int[MAX_IMAGE_DIMENSIONS];
   FILL_C_ARRAY(m_Dimensions, MAX_IMAGE_DIMENSIONS, 0u);
@@ -297,6 +302,15 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetSliceData_unlocked(
     return m_Slices[pos] = sl;
   }
 
+  // slice is unavailable. Can its volume be loaded on demand?
+  if (m_VolumeLoader.IsNotNull())
+  {
+    if (LoadVolumeData_unlocked(t, n).IsNull())
+      return nullptr;
+    // the volume is complete now, so there is no risk of an endless loop
+    return GetSliceData_unlocked(s, t, n, data, importMemoryManagement);
+  }
+
   // slice is unavailable. Can we calculate it?
   if ((GetSource().IsNotNull()) && (GetSource()->Updating() == false))
   {
@@ -347,7 +361,11 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetVolumeData_unlocked(
   int pos = GetVolumeIndex(t, n);
   vol = m_Volumes[pos];
   if ((vol.GetPointer() != nullptr) && (vol->IsComplete()))
+  {
+    if (m_VolumeLoader.IsNotNull())
+      TouchLoadedVolume_unlocked(pos);
     return vol;
+  }
 
   const size_t ptypeSize = this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
 
@@ -428,6 +446,12 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetVolumeData_unlocked(
     return m_Volumes[pos] = vol;
   }
 
+  // volume is unavailable. Can it be loaded on demand?
+  if (m_VolumeLoader.IsNotNull())
+  {
+    return LoadVolumeData_unlocked(t, n);
+  }
+
   // volume is unavailable. Can we calculate it?
   if ((GetSource().IsNotNull()) && (GetSource()->Updating() == false))
   {
@@ -452,6 +476,21 @@ mitk::Image::ImageDataItemPointer mitk::Image::GetVolumeData_unlocked(
   }
   else
   {
+    // some slices are set already (e.g. during progressive loading): keep their data by completing the
+    // volume they are part of instead of allocating a new one. The slices that are not set yet are zeroed.
+    vol = m_Volumes[pos];
+    if (vol.GetPointer() != nullptr && data == nullptr)
+    {
+      const size_t sliceSize = m_OffsetTable[2] * this->m_ImageDescriptor->GetChannelTypeById(n).GetSize();
+      for (unsigned int s = 0; s < m_Dimensions[2]; ++s)
+      {
+        if (m_Slices[GetSliceIndex(s, t, n)].GetPointer() == nullptr)
+          std::memset(static_cast<char *>(vol->GetData()) + s * sliceSize, 0, sliceSize);
+      }
+      vol->SetComplete(true);
+      return vol;
+    }
+
     ImageDataItemPointer item = AllocateVolumeData_unlocked(t, n, data, importMemoryManagement);
     item->SetComplete(true);
     return item;
@@ -584,6 +623,10 @@ bool mitk::Image::IsSliceSet_unlocked(int s, int t, int n) const
   if (IsValidSlice(s, t, n) == false)
     return false;
 
+  // every slice can be provided by loading its volume
+  if (m_VolumeLoader.IsNotNull())
+    return true;
+
   if (m_Slices[GetSliceIndex(s, t, n)].GetPointer() != nullptr)
   {
     return true;
@@ -613,6 +656,11 @@ bool mitk::Image::IsVolumeSet_unlocked(int t, int n) const
 {
   if (IsValidVolume(t, n) == false)
     return false;
+
+  // every volume can be provided by the volume loader
+  if (m_VolumeLoader.IsNotNull())
+    return true;
+
   ImageDataItemPointer ch, vol;
 
   // volume directly available?
@@ -637,6 +685,120 @@ bool mitk::Image::IsVolumeSet_unlocked(int t, int n) const
   return true;
 }
 
+void mitk::Image::SetVolumeLoader(ImageVolumeLoader *loader)
+{
+  MutexHolder lock(m_ImageDataArraysLock);
+  m_VolumeLoader = loader;
+  if (loader == nullptr)
+  {
+    // loaded volumes simply become regular volumes of the image
+    m_LoadedVolumes.clear();
+    m_LoadedVolumesSize = 0;
+  }
+}
+
+mitk::ImageVolumeLoader *mitk::Image::GetVolumeLoader() const
+{
+  return m_VolumeLoader;
+}
+
+void mitk::Image::SetVolumeLoaderMemoryBudget(size_t budget)
+{
+  MutexHolder lock(m_ImageDataArraysLock);
+  m_VolumeLoaderMemoryBudget = budget;
+  ReleaseLoadedVolumes_unlocked(-1);
+}
+
+size_t mitk::Image::GetVolumeLoaderMemoryBudget() const
+{
+  return m_VolumeLoaderMemoryBudget;
+}
+
+mitk::Image::ImageDataItemPointer mitk::Image::LoadVolumeData_unlocked(int t, int n) const
+{
+  const int pos = GetVolumeIndex(t, n);
+  const mitk::PixelType chPixelType = this->m_ImageDescriptor->GetChannelTypeById(n);
+
+  ImageDataItemPointer vol = new ImageDataItem(chPixelType, t, 3, m_Dimensions, nullptr, true);
+  if (!m_VolumeLoader->LoadVolume(t, n, vol->GetData(), vol->GetSize()))
+  {
+    MITK_ERROR << "Volume loader failed to load time step " << t << " of channel " << n;
+    return nullptr;
+  }
+  vol->SetComplete(true);
+
+  // slices of a previously released volume have been released as well
+  for (unsigned int s = 0; s < m_Dimensions[2]; ++s)
+  {
+    m_Slices[GetSliceIndex(s, t, n)] = nullptr;
+  }
+  m_Volumes[pos] = vol;
+
+  m_LoadedVolumes.push_front(pos);
+  m_LoadedVolumesSize += vol->GetSize();
+  ReleaseLoadedVolumes_unlocked(pos);
+
+  return vol;
+}
+
+void mitk::Image::TouchLoadedVolume_unlocked(int pos) const
+{
+  auto it = std::find(m_LoadedVolumes.begin(), m_LoadedVolumes.end(), pos);
+  if (it != m_LoadedVolumes.end() && it != m_LoadedVolumes.begin())
+  {
+    m_LoadedVolumes.splice(m_LoadedVolumes.begin(), m_LoadedVolumes, it);
+  }
+}
+
+void mitk::Image::ReleaseLoadedVolumes_unlocked(int keepPos) const
+{
+  if (m_VolumeLoaderMemoryBudget == 0 || m_LoadedVolumesSize <= m_VolumeLoaderMemoryBudget)
+    return;
+
+  auto it = m_LoadedVolumes.end();
+  while (m_LoadedVolumesSize > m_VolumeLoaderMemoryBudget && it != m_LoadedVolumes.begin())
+  {
+    --it;
+    const int pos = *it;
+    if (pos == keepPos)
+      continue;
+
+    ImageDataItemPointer vol = m_Volumes[pos];
+    if (vol.IsNull())
+    {
+      it = m_LoadedVolumes.erase(it);
+      continue;
+    }
+
+    // volumes that have been merged into a channel are no longer owned by the loader
+    if (vol->GetParent().IsNotNull() || vol->GetManageMemory() == false)
+      continue;
+
+    // is the volume accessed right now?
+    if ((vol->m_VtkImageData != nullptr && vol->m_VtkImageData->GetReferenceCount() > 1) ||
+        m_AccessorLocks.IsLocked(vol->m_Data, vol->m_Data + vol->GetSize()))
+      continue;
+
+    // release slices which are only referenced by the image, they keep the volume alive
+    const int t = pos % m_Dimensions[3];
+    const int n = pos / m_Dimensions[3];
+    for (unsigned int s = 0; s < m_Dimensions[2]; ++s)
+    {
+      ImageDataItemPointer &slice = m_Slices[GetSliceIndex(s, t, n)];
+      if (slice.IsNotNull() && slice->GetReferenceCount() == 1)
+        slice = nullptr;
+    }
+
+    // the local smart pointer and the array hold the only references
+    if (vol->GetReferenceCount() > 2)
+      continue;
+
+    m_LoadedVolumesSize -= vol->GetSize();
+    m_Volumes[pos] = nullptr;
+    it = m_LoadedVolumes.erase(it);
+  }
+}
+
 bool mitk::Image::IsChannelSet(int n) const
 {
   MutexHolder lock(m_ImageDataArraysLock);
@@ -804,6 +966,78 @@ bool mitk::Image::SetImportChannel(void *data, int n, ImportMemoryManagementType
   return true;
 }
 
+bool mitk::Image::SetImportVolume(ImageDataStorage *storage, int t, int n, size_t offset)
+{
+  if (storage == nullptr || IsValidVolume(t, n) == false)
+    return false;
+
+  const bool wasSet = IsVolumeSet(t, n);
+  const mitk::PixelType chPixelType = this->m_ImageDescriptor->GetChannelTypeById(n);
+
+  ImageDataItemPointer vol = new ImageDataItem(chPixelType, t, 3, m_Dimensions, storage, offset);
+  vol->SetComplete(true);
+
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+
+    // the channel and the slices of this volume may still reference the former data
+    m_Channels[n] = nullptr;
+    m_CompleteData = nullptr;
+    for (unsigned int s = 0; s < m_Dimensions[2]; ++s)
+    {
+      m_Slices[GetSliceIndex(s, t, n)] = nullptr;
+    }
+    m_Volumes[GetVolumeIndex(t, n)] = vol;
+  }
+
+  if (wasSet)
+  {
+    // we have changed the data: call Modified()!
+    Modified();
+  }
+  else
+  {
+    this->m_ImageDescriptor->GetChannelDescriptor(n).SetData(vol->GetData());
+  }
+  return true;
+}
+
+bool mitk::Image::SetImportChannel(ImageDataStorage *storage, int n, size_t offset)
+{
+  if (storage == nullptr || IsValidChannel(n) == false)
+    return false;
+
+  const bool wasSet = IsChannelSet(n);
+  const mitk::PixelType chPixelType = this->m_ImageDescriptor->GetChannelTypeById(n);
+
+  ImageDataItemPointer ch = new ImageDataItem(chPixelType, -1, m_Dimension, m_Dimensions, storage, offset);
+  ch->SetComplete(true);
+
+  {
+    MutexHolder lock(m_ImageDataArraysLock);
+
+    // volumes and slices of this channel may still reference the former data
+    for (unsigned int t = 0; t < m_Dimensions[3]; ++t)
+    {
+      m_Volumes[GetVolumeIndex(t, n)] = nullptr;
+      for (unsigned int s = 0; s < m_Dimensions[2]; ++s)
+      {
+        m_Slices[GetSliceIndex(s, t, n)] = nullptr;
+      }
+    }
+    m_CompleteData = nullptr;
+    m_Channels[n] = ch;
+  }
+
+  this->m_ImageDescriptor->GetChannelDescriptor(n).SetData(ch->GetData());
+  if (wasSet)
+  {
+    // we have changed the data: call Modified()!
+    Modified();
+  }
+  return true;
+}
+
 void mitk::Image::Initialize()
 {
   ImageDataItemPointerArray::iterator it, end;
@@ -821,6 +1055,10 @@ void mitk::Image::Initialize()
   }
   m_CompleteData = nullptr;
 
+  m_VolumeLoader = nullptr;
+  m_LoadedVolumes.clear();
+  m_LoadedVolumesSize = 0;
+
   if (m_ImageStatistics == nullptr)
   {
     m_ImageStatistics = new mitk::ImageStatisticsHolder(this);
@@ -0,0 +1,137 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImageAccessorLockManager.h"
+#include "mitkExceptionMacro.h"
+#include "mitkImageAccessorBase.h"
+
+mitk::ImageAccessorLockManager::ImageAccessorLockManager() : m_NumberOfExclusiveRegions(0), m_NumberOfLocks(0)
+{
+}
+
+mitk::ImageAccessorLockManager::~ImageAccessorLockManager()
+{
+}
+
+const mitk::ImageAccessorLockManager::Region *mitk::ImageAccessorLockManager::FindConflict(const RegionKey &key,
+                                                                                           bool exclusive) const
+{
+  // shared locks only conflict with exclusive ones
+  if (!exclusive && m_NumberOfExclusiveRegions == 0)
+    return nullptr;
+
+  // regions are sorted by their begin, so only regions starting before the end of the request can overlap
+  for (auto it = m_Regions.begin(); it != m_Regions.end() && it->first.first < key.second; ++it)
+  {
+    if (it->first.second > key.first && (exclusive || it->second.m_Exclusive))
+    {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+
+void mitk::ImageAccessorLockManager::Lock(
+  const void *owner, const void *begin, const void *end, bool exclusive, bool wait)
+{
+  const RegionKey key(static_cast<const unsigned char *>(begin), static_cast<const unsigned char *>(end));
+  const std::thread::id thread = std::this_thread::get_id();
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  while (const Region *conflict = this->FindConflict(key, exclusive))
+  {
+    if (!wait)
+    {
+      mitkThrowException(mitk::MemoryIsLockedException)
+        << "The image part being ordered by the ImageAccessor is already in use and locked";
+    }
+
+    // waiting for a lock of the own thread would never end
+    for (auto holder = conflict->m_Holders.begin(); holder != conflict->m_Holders.end(); ++holder)
+    {
+      if (holder->m_Thread == thread)
+      {
+        mitkThrow() << "Prohibited image access: the requested image part is already in use and cannot be requested "
+                       "recursively!";
+      }
+    }
+
+    m_RegionReleased.wait(lock);
+  }
+
+  Region &region = m_Regions[key];
+  if (region.m_Holders.empty())
+  {
+    region.m_Exclusive = exclusive;
+    if (exclusive)
+      ++m_NumberOfExclusiveRegions;
+  }
+
+  Holder holder;
+  holder.m_Owner = owner;
+  holder.m_Thread = thread;
+  region.m_Holders.push_back(holder);
+  ++m_NumberOfLocks;
+}
+
+void mitk::ImageAccessorLockManager::Unlock(const void *owner, const void *begin, const void *end)
+{
+  const RegionKey key(static_cast<const unsigned char *>(begin), static_cast<const unsigned char *>(end));
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  auto regionIt = m_Regions.find(key);
+  if (regionIt == m_Regions.end())
+    return;
+
+  std::vector<Holder> &holders = regionIt->second.m_Holders;
+  for (auto holder = holders.begin(); holder != holders.end(); ++holder)
+  {
+    if (holder->m_Owner == owner)
+    {
+      *holder = holders.back();
+      holders.pop_back();
+      --m_NumberOfLocks;
+      break;
+    }
+  }
+
+  // waiting accessors only have to be woken up if a region is released completely
+  if (holders.empty())
+  {
+    if (regionIt->second.m_Exclusive)
+      --m_NumberOfExclusiveRegions;
+    m_Regions.erase(regionIt);
+
+    lock.unlock();
+    m_RegionReleased.notify_all();
+  }
+}
+
+bool mitk::ImageAccessorLockManager::IsLocked(const void *begin, const void *end) const
+{
+  const RegionKey key(static_cast<const unsigned char *>(begin), static_cast<const unsigned char *>(end));
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return this->FindConflict(key, true) != nullptr;
+}
+
+size_t mitk::ImageAccessorLockManager::GetNumberOfLocks() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfLocks;
+}
@@ -31,6 +31,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkUnsignedLongArray.h>
 #include <vtkUnsignedShortArray.h>
 
+#include <mitkExceptionMacro.h>
 #include <mitkImage.h>
 #include <mitkImageVtkReadAccessor.h>
 #include <mitkImageVtkWriteAccessor.h>
@@ -52,6 +53,7 @@ mitk::ImageDataItem::ImageDataItem(const ImageDataItem &aParent,
     m_IsComplete(false),
     m_Size(0),
     m_Parent(&aParent),
+    m_Storage(aParent.m_Storage),
     m_Dimension(dimension),
     m_Timestep(timestep)
 {
@@ -65,6 +67,10 @@ mitk::ImageDataItem::ImageDataItem(const ImageDataItem &aParent,
 
   if (data != nullptr && data != m_Data)
   {
+    if (this->IsReadOnly())
+    {
+      mitkThrow() << "Cannot copy data into an image part that is backed by read-only storage.";
+    }
     memcpy(m_Data, data, m_Size);
     if (manageMemory)
     {
@@ -168,6 +174,51 @@ mitk::ImageDataItem::ImageDataItem(const mitk::PixelType &type,
   m_ReferenceCount = 0;
 }
 
+mitk::ImageDataItem::ImageDataItem(const mitk::PixelType &type,
+                                   int timestep,
+                                   unsigned int dimension,
+                                   unsigned int *dimensions,
+                                   ImageDataStorage *storage,
+                                   size_t offset)
+  : m_Data(nullptr),
+    m_PixelType(new mitk::PixelType(type)),
+    m_ManageMemory(false),
+    m_VtkImageData(nullptr),
+    m_VtkImageReadAccessor(nullptr),
+    m_VtkImageWriteAccessor(nullptr),
+    m_Offset(0),
+    m_IsComplete(false),
+    m_Size(0),
+    m_Parent(nullptr),
+    m_Storage(storage),
+    m_Dimension(dimension),
+    m_Timestep(timestep)
+{
+  if (storage == nullptr)
+  {
+    delete m_PixelType;
+    mitkThrow() << "Cannot create an ImageDataItem without storage.";
+  }
+
+  for (unsigned int i = 0; i < m_Dimension; i++)
+  {
+    m_Dimensions[i] = dimensions[i];
+  }
+
+  this->ComputeItemSize(dimensions, dimension);
+
+  if (offset + m_Size > storage->GetSize())
+  {
+    delete m_PixelType;
+    mitkThrow() << "Image data storage of " << storage->GetSize() << " bytes is too small for " << m_Size
+                << " bytes at offset " << offset << ".";
+  }
+
+  m_Data = static_cast<unsigned char *>(storage->GetData()) + offset;
+
+  m_ReferenceCount = 0;
+}
+
 mitk::ImageDataItem::ImageDataItem(const ImageDataItem &other)
   : itk::LightObject(),
     m_Data(other.m_Data),
@@ -180,6 +231,7 @@ mitk::ImageDataItem::ImageDataItem(const ImageDataItem &other)
     m_IsComplete(other.m_IsComplete),
     m_Size(other.m_Size),
     m_Parent(other.m_Parent),
+    m_Storage(other.m_Storage),
     m_Dimension(other.m_Dimension),
     m_Timestep(other.m_Timestep)
 {
@@ -111,240 +111,309 @@ void mitk::ImageStatisticsHolder::ResetImageStatistics()
   m_CountOfMaxValuedVoxels.assign(1, 0);
 }
 
-#include "mitkImageAccessByItk.h"
+#include "mitkImageReadAccessor.h"
 
-//#define BOUNDINGOBJECT_IGNORE
+#include <itkMultiThreader.h>
 
-template <typename ItkImageType>
-void mitk::_ComputeExtremaInItkImage(const ItkImageType *itkImage, mitk::ImageStatisticsHolder *statisticsHolder, int t)
+#include <algorithm>
+#include <thread>
+
+namespace
 {
-  typename ItkImageType::RegionType region;
-  region = itkImage->GetBufferedRegion();
-  if (region.Crop(itkImage->GetRequestedRegion()) == false)
-    return;
-  if (region != itkImage->GetRequestedRegion())
-    return;
+  /** Extrema of one time step or of a part of it */
+  struct Extrema
+  {
+    Extrema()
+      : m_Min(itk::NumericTraits<mitk::ScalarType>::max()),
+        m_2ndMin(itk::NumericTraits<mitk::ScalarType>::max()),
+        m_Max(itk::NumericTraits<mitk::ScalarType>::NonpositiveMin()),
+        m_2ndMax(itk::NumericTraits<mitk::ScalarType>::NonpositiveMin()),
+        m_CountOfMin(0),
+        m_CountOfMax(0)
+    {
+    }
 
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
-  typedef typename ItkImageType::PixelType TPixel;
-  TPixel value = 0;
+    mitk::ScalarType m_Min;
+    mitk::ScalarType m_2ndMin;
+    mitk::ScalarType m_Max;
+    mitk::ScalarType m_2ndMax;
+    unsigned int m_CountOfMin;
+    unsigned int m_CountOfMax;
+  };
+
+  /** Single pass over every stride-th value starting at data */
+  template <typename TComponent>
+  void ComputeExtremaOfRange(const TComponent *data, size_t numberOfValues, size_t stride, Extrema &extrema)
+  {
+    mitk::ScalarType min = extrema.m_Min, min2 = extrema.m_2ndMin;
+    mitk::ScalarType max = extrema.m_Max, max2 = extrema.m_2ndMax;
+    unsigned int countOfMin = extrema.m_CountOfMin, countOfMax = extrema.m_CountOfMax;
 
-  if (statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep(t))
-    return;
-  statisticsHolder->Expand(t + 1); // make sure we have initialized all arrays
-  statisticsHolder->m_CountOfMinValuedVoxels[t] = 0;
-  statisticsHolder->m_CountOfMaxValuedVoxels[t] = 0;
+    const TComponent *end = data + numberOfValues * stride;
+    for (const TComponent *it = data; it != end; it += stride)
+    {
+      const mitk::ScalarType value = static_cast<mitk::ScalarType>(*it);
 
-  statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t] = itk::NumericTraits<ScalarType>::max();
-  statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t] =
-    itk::NumericTraits<ScalarType>::NonpositiveMin();
+      // most values lie between the second smallest and the second largest value
+      if (value > min2 && value < max2)
+        continue;
 
-  while (!it.IsAtEnd())
-  {
-    value = it.Get();
-//  if ( (value > mitkImage->m_ScalarMin) && (value < mitkImage->m_Scalar2ndMin) )        mitkImage->m_Scalar2ndMin =
-//  value;
-//  else if ( (value < mitkImage->m_ScalarMax) && (value > mitkImage->m_Scalar2ndMax) )   mitkImage->m_Scalar2ndMax =
-//  value;
-//  else if (value > mitkImage->m_ScalarMax)                                              mitkImage->m_ScalarMax =
-//  value;
-//  else if (value < mitkImage->m_ScalarMin)                                              mitkImage->m_ScalarMin =
-//  value;
-
-// if numbers start with 2ndMin or 2ndMax and never have that value again, the previous above logic failed
-#ifdef BOUNDINGOBJECT_IGNORE
-    if (value > -32765)
-    {
-#endif
       // update min
-      if (value < statisticsHolder->m_ScalarMin[t])
+      if (value < min)
       {
-        statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t];
-        statisticsHolder->m_ScalarMin[t] = value;
-        statisticsHolder->m_CountOfMinValuedVoxels[t] = 1;
+        min2 = min;
+        min = value;
+        countOfMin = 1;
       }
-      else if (value == statisticsHolder->m_ScalarMin[t])
+      else if (value == min)
       {
-        ++statisticsHolder->m_CountOfMinValuedVoxels[t];
+        ++countOfMin;
       }
-      else if (value < statisticsHolder->m_Scalar2ndMin[t])
+      else if (value < min2)
       {
-        statisticsHolder->m_Scalar2ndMin[t] = value;
+        min2 = value;
       }
 
       // update max
-      if (value > statisticsHolder->m_ScalarMax[t])
+      if (value > max)
       {
-        statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t];
-        statisticsHolder->m_ScalarMax[t] = value;
-        statisticsHolder->m_CountOfMaxValuedVoxels[t] = 1;
+        max2 = max;
+        max = value;
+        countOfMax = 1;
       }
-      else if (value == statisticsHolder->m_ScalarMax[t])
+      else if (value == max)
       {
-        ++statisticsHolder->m_CountOfMaxValuedVoxels[t];
+        ++countOfMax;
       }
-      else if (value > statisticsHolder->m_Scalar2ndMax[t])
+      else if (value > max2)
       {
-        statisticsHolder->m_Scalar2ndMax[t] = value;
+        max2 = value;
       }
-#ifdef BOUNDINGOBJECT_IGNORE
     }
-#endif
 
-    ++it;
+    extrema.m_Min = min;
+    extrema.m_2ndMin = min2;
+    extrema.m_Max = max;
+    extrema.m_2ndMax = max2;
+    extrema.m_CountOfMin = countOfMin;
+    extrema.m_CountOfMax = countOfMax;
   }
 
-  //// guard for wrong 2dMin/Max on single constant value images
-  if (statisticsHolder->m_ScalarMax[t] == statisticsHolder->m_ScalarMin[t])
+  /** Combines the extrema of two disjoint parts of an image */
+  void MergeExtrema(Extrema &extrema, const Extrema &other)
   {
-    statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMax[t];
+    const mitk::ScalarType mins[4] = {extrema.m_Min, extrema.m_2ndMin, other.m_Min, other.m_2ndMin};
+    const mitk::ScalarType min = std::min(extrema.m_Min, other.m_Min);
+    mitk::ScalarType min2 = itk::NumericTraits<mitk::ScalarType>::max();
+    for (mitk::ScalarType value : mins)
+    {
+      if (value > min && value < min2)
+        min2 = value;
+    }
+    extrema.m_CountOfMin =
+      (extrema.m_Min == min ? extrema.m_CountOfMin : 0) + (other.m_Min == min ? other.m_CountOfMin : 0);
+    extrema.m_Min = min;
+    extrema.m_2ndMin = min2;
+
+    const mitk::ScalarType maxs[4] = {extrema.m_Max, extrema.m_2ndMax, other.m_Max, other.m_2ndMax};
+    const mitk::ScalarType max = std::max(extrema.m_Max, other.m_Max);
+    mitk::ScalarType max2 = itk::NumericTraits<mitk::ScalarType>::NonpositiveMin();
+    for (mitk::ScalarType value : maxs)
+    {
+      if (value < max && value > max2)
+        max2 = value;
+    }
+    extrema.m_CountOfMax =
+      (extrema.m_Max == max ? extrema.m_CountOfMax : 0) + (other.m_Max == max ? other.m_CountOfMax : 0);
+    extrema.m_Max = max;
+    extrema.m_2ndMax = max2;
   }
-  statisticsHolder->m_LastRecomputeTimeStamp.Modified();
-  // MITK_DEBUG <<"extrema "<<itk::NumericTraits<TPixel>::NonpositiveMin()<<" "<<mitkImage->m_ScalarMin<<"
-  // "<<mitkImage->m_Scalar2ndMin<<" "<<mitkImage->m_Scalar2ndMax<<" "<<mitkImage->m_ScalarMax<<"
-  // "<<itk::NumericTraits<TPixel>::max();
-}
 
-template <typename ItkImageType>
-void mitk::_ComputeExtremaInItkVectorImage(const ItkImageType *itkImage,
-                                           mitk::ImageStatisticsHolder *statisticsHolder,
-                                           int t,
-                                           unsigned int component)
-{
-  typename ItkImageType::RegionType region;
-  region = itkImage->GetBufferedRegion();
-  if (region.Crop(itkImage->GetRequestedRegion()) == false)
-    return;
-  if (region != itkImage->GetRequestedRegion())
-    return;
+  /** Splits the buffer into one part per thread and merges the extrema of the parts */
+  template <typename TComponent>
+  Extrema ComputeExtremaOfBuffer(const void *buffer,
+                                 size_t numberOfPixels,
+                                 unsigned int numberOfComponents,
+                                 unsigned int component)
+  {
+    const TComponent *data = static_cast<const TComponent *>(buffer) + component;
+
+    // small images are not worth starting threads
+    const size_t minimumPixelsPerThread = 1 << 16;
+    size_t numberOfThreads = std::min<size_t>(itk::MultiThreader::GetGlobalDefaultNumberOfThreads(),
+                                              numberOfPixels / minimumPixelsPerThread);
+    numberOfThreads = std::max<size_t>(numberOfThreads, 1);
+
+    std::vector<Extrema> partialExtrema(numberOfThreads);
+    std::vector<std::thread> threads;
+    const size_t pixelsPerThread = numberOfPixels / numberOfThreads;
+    for (size_t i = 1; i < numberOfThreads; ++i)
+    {
+      const size_t first = i * pixelsPerThread;
+      const size_t count = (i + 1 == numberOfThreads) ? numberOfPixels - first : pixelsPerThread;
+      threads.emplace_back(ComputeExtremaOfRange<TComponent>,
+                           data + first * numberOfComponents,
+                           count,
+                           numberOfComponents,
+                           std::ref(partialExtrema[i]));
+    }
+    ComputeExtremaOfRange<TComponent>(
+      data, numberOfThreads == 1 ? numberOfPixels : pixelsPerThread, numberOfComponents, partialExtrema[0]);
 
-  itk::ImageRegionConstIterator<ItkImageType> it(itkImage, region);
+    for (auto &thread : threads)
+      thread.join();
 
-  if (statisticsHolder == nullptr || !statisticsHolder->IsValidTimeStep(t))
-    return;
-  statisticsHolder->Expand(t + 1); // make sure we have initialized all arrays
-  statisticsHolder->m_CountOfMinValuedVoxels[t] = 0;
-  statisticsHolder->m_CountOfMaxValuedVoxels[t] = 0;
+    for (size_t i = 1; i < numberOfThreads; ++i)
+      MergeExtrema(partialExtrema[0], partialExtrema[i]);
 
-  statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t] = itk::NumericTraits<ScalarType>::max();
-  statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t] =
-    itk::NumericTraits<ScalarType>::NonpositiveMin();
+    // guard for wrong 2dMin/Max on single constant value images
+    Extrema &extrema = partialExtrema[0];
+    if (extrema.m_Max == extrema.m_Min)
+    {
+      extrema.m_2ndMax = extrema.m_2ndMin = extrema.m_Max;
+    }
+    return extrema;
+  }
 
-  while (!it.IsAtEnd())
+  /** Computes the extrema of one component of a time step directly on its buffer */
+  Extrema ComputeExtrema(const mitk::Image *image, const mitk::ImageDataItem *volume, unsigned int component)
   {
-    double value = it.Get()[component];
-//  if ( (value > mitkImage->m_ScalarMin) && (value < mitkImage->m_Scalar2ndMin) )        mitkImage->m_Scalar2ndMin =
-//  value;
-//  else if ( (value < mitkImage->m_ScalarMax) && (value > mitkImage->m_Scalar2ndMax) )   mitkImage->m_Scalar2ndMax =
-//  value;
-//  else if (value > mitkImage->m_ScalarMax)                                              mitkImage->m_ScalarMax =
-//  value;
-//  else if (value < mitkImage->m_ScalarMin)                                              mitkImage->m_ScalarMin =
-//  value;
-
-// if numbers start with 2ndMin or 2ndMax and never have that value again, the previous above logic failed
-#ifdef BOUNDINGOBJECT_IGNORE
-    if (value > -32765)
-    {
-#endif
-      // update min
-      if (value < statisticsHolder->m_ScalarMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMin[t];
-        statisticsHolder->m_ScalarMin[t] = value;
-        statisticsHolder->m_CountOfMinValuedVoxels[t] = 1;
-      }
-      else if (value == statisticsHolder->m_ScalarMin[t])
-      {
-        ++statisticsHolder->m_CountOfMinValuedVoxels[t];
-      }
-      else if (value < statisticsHolder->m_Scalar2ndMin[t])
-      {
-        statisticsHolder->m_Scalar2ndMin[t] = value;
-      }
+    const mitk::PixelType pixelType = image->GetPixelType(0);
+    const unsigned int numberOfComponents = pixelType.GetNumberOfComponents();
+    const size_t numberOfPixels = volume->GetSize() / pixelType.GetSize();
 
-      // update max
-      if (value > statisticsHolder->m_ScalarMax[t])
-      {
-        statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_ScalarMax[t];
-        statisticsHolder->m_ScalarMax[t] = value;
-        statisticsHolder->m_CountOfMaxValuedVoxels[t] = 1;
-      }
-      else if (value == statisticsHolder->m_ScalarMax[t])
-      {
-        ++statisticsHolder->m_CountOfMaxValuedVoxels[t];
-      }
-      else if (value > statisticsHolder->m_Scalar2ndMax[t])
-      {
-        statisticsHolder->m_Scalar2ndMax[t] = value;
-      }
-#ifdef BOUNDINGOBJECT_IGNORE
-    }
-#endif
+    mitk::ImageReadAccessor accessor(image, volume);
+    const void *data = accessor.GetData();
 
-    ++it;
+    switch (pixelType.GetComponentType())
+    {
+      case itk::ImageIOBase::UCHAR:
+        return ComputeExtremaOfBuffer<unsigned char>(data, numberOfPixels, numberOfComponents, component);
+      case itk::ImageIOBase::CHAR:
+        return ComputeExtremaOfBuffer<signed char>(data, numberOfPixels, numberOfComponents, component);
+      case itk::ImageIOBase::USHORT:
+        return ComputeExtremaOfBuffer<unsigned short>(data, numberOfPixels, numberOfComponents, component);
+      case itk::ImageIOBase::SHORT:
+        return ComputeExtremaOfBuffer<short>(data, numberOfPixels, numberOfComponents, component);
+      case itk::ImageIOBase::UINT:
+        return ComputeExtremaOfBuffer<unsigned int>(data, numberOfPixels, numberOfComponents, component);
+      case itk::ImageIOBase::INT:
+        return ComputeExtremaOfBuffer<int>(data, numberOfPixels, numberOfComponents, component);
+      case itk::ImageIOBase::ULONG:
+        return ComputeExtremaOfBuffer<unsigned long>(data, numberOfPixels, numberOfComponents, component);
+      case itk::ImageIOBase::LONG:
+        return ComputeExtremaOfBuffer<long>(data, numberOfPixels, numberOfComponents, component);
+      case itk::ImageIOBase::FLOAT:
+        return ComputeExtremaOfBuffer<float>(data, numberOfPixels, numberOfComponents, component);
+      case itk::ImageIOBase::DOUBLE:
+        return ComputeExtremaOfBuffer<double>(data, numberOfPixels, numberOfComponents, component);
+      default:
+        MITK_WARN << "Cannot compute extrema for component type " << pixelType.GetComponentTypeAsString();
+        return Extrema();
+    }
   }
+}
 
-  //// guard for wrong 2dMin/Max on single constant value images
-  if (statisticsHolder->m_ScalarMax[t] == statisticsHolder->m_ScalarMin[t])
+bool mitk::ImageStatisticsHolder::HasExtrema(const mitk::PixelType &pixelType) const
+{
+  if (pixelType.GetNumberOfComponents() == 1 && (pixelType.GetPixelType() != itk::ImageIOBase::UNKNOWNPIXELTYPE) &&
+      (pixelType.GetPixelType() != itk::ImageIOBase::VECTOR))
   {
-    statisticsHolder->m_Scalar2ndMax[t] = statisticsHolder->m_Scalar2ndMin[t] = statisticsHolder->m_ScalarMax[t];
+    return true;
   }
-  statisticsHolder->m_LastRecomputeTimeStamp.Modified();
-  // MITK_DEBUG <<"extrema "<<itk::NumericTraits<TPixel>::NonpositiveMin()<<" "<<mitkImage->m_ScalarMin<<"
-  // "<<mitkImage->m_Scalar2ndMin<<" "<<mitkImage->m_Scalar2ndMax<<" "<<mitkImage->m_ScalarMax<<"
-  // "<<itk::NumericTraits<TPixel>::max();
+
+  // used to avoid statistics calculation on Odf images. property will be replaced as soons as bug 17928 is merged and
+  // the diffusion image refactoring is complete.
+  mitk::BoolProperty *isOdf = dynamic_cast<mitk::BoolProperty *>(m_Image->GetProperty("IsOdfImage").GetPointer());
+  return pixelType.GetPixelType() == itk::ImageIOBase::VECTOR && (!isOdf || !isOdf->GetValue());
 }
 
-void mitk::ImageStatisticsHolder::ComputeImageStatistics(int t, unsigned int component)
+bool mitk::ImageStatisticsHolder::PrepareImageStatistics(int t)
 {
   // timestep valid?
   if (!m_Image->IsValidTimeStep(t))
-    return;
+    return false;
+
+  std::unique_lock<std::mutex> lock(m_StatisticsMutex);
+
+  // wait for a computation of this time step that is running in the background
+  m_StatisticsComputed.wait(lock, [this, t]() { return m_TimeStepsInBackground.count(t) == 0; });
 
   // image modified?
   if (this->m_Image->GetMTime() > m_LastRecomputeTimeStamp.GetMTime())
-    this->ResetImageStatistics();
+  {
+    if (m_TimeStepsInBackground.empty())
+    {
+      this->ResetImageStatistics();
+    }
+    else
+    {
+      // background computations still publish into the arrays, so they are invalidated without shrinking them
+      std::fill(m_ScalarMin.begin(), m_ScalarMin.end(), itk::NumericTraits<ScalarType>::max());
+      std::fill(m_ScalarMax.begin(), m_ScalarMax.end(), itk::NumericTraits<ScalarType>::NonpositiveMin());
+      std::fill(m_Scalar2ndMin.begin(), m_Scalar2ndMin.end(), itk::NumericTraits<ScalarType>::max());
+      std::fill(m_Scalar2ndMax.begin(), m_Scalar2ndMax.end(), itk::NumericTraits<ScalarType>::NonpositiveMin());
+      std::fill(m_CountOfMinValuedVoxels.begin(), m_CountOfMinValuedVoxels.end(), 0);
+      std::fill(m_CountOfMaxValuedVoxels.begin(), m_CountOfMaxValuedVoxels.end(), 0);
+    }
+  }
 
-  Expand(t + 1);
+  this->Expand(t + 1);
 
   // do we have valid information already?
-  if (m_ScalarMin[t] != itk::NumericTraits<ScalarType>::max() ||
-      m_Scalar2ndMin[t] != itk::NumericTraits<ScalarType>::max())
+  return m_ScalarMin[t] == itk::NumericTraits<ScalarType>::max() &&
+         m_Scalar2ndMin[t] == itk::NumericTraits<ScalarType>::max();
+}
+
+void mitk::ImageStatisticsHolder::PublishImageStatistics(int t,
+                                                         ScalarType min,
+                                                         ScalarType secondMin,
+                                                         ScalarType max,
+                                                         ScalarType secondMax,
+                                                         unsigned int countOfMin,
+                                                         unsigned int countOfMax)
+{
+  if (t < 0 || static_cast<size_t>(t) >= m_ScalarMin.size())
+    return;
+
+  m_ScalarMin[t] = min;
+  m_Scalar2ndMin[t] = secondMin;
+  m_ScalarMax[t] = max;
+  m_Scalar2ndMax[t] = secondMax;
+  m_CountOfMinValuedVoxels[t] = countOfMin;
+  m_CountOfMaxValuedVoxels[t] = countOfMax;
+  m_LastRecomputeTimeStamp.Modified();
+}
+
+void mitk::ImageStatisticsHolder::ComputeImageStatistics(int t, unsigned int component)
+{
+  if (!this->PrepareImageStatistics(t))
     return; // Values already calculated before...
 
-  // used to avoid statistics calculation on Odf images. property will be replaced as soons as bug 17928 is merged and
-  // the diffusion image refactoring is complete.
-  mitk::BoolProperty *isOdf = dynamic_cast<mitk::BoolProperty *>(m_Image->GetProperty("IsOdfImage").GetPointer());
   const mitk::PixelType pType = m_Image->GetPixelType(0);
-  if (pType.GetNumberOfComponents() == 1 && (pType.GetPixelType() != itk::ImageIOBase::UNKNOWNPIXELTYPE) &&
-      (pType.GetPixelType() != itk::ImageIOBase::VECTOR))
+  if (this->HasExtrema(pType))
   {
     // recompute
-    mitk::ImageTimeSelector::Pointer timeSelector = this->GetTimeSelector();
-    if (timeSelector.IsNotNull())
-    {
-      timeSelector->SetTimeNr(t);
-      timeSelector->UpdateLargestPossibleRegion();
-      const mitk::Image *image = timeSelector->GetOutput();
-      AccessByItk_2(image, _ComputeExtremaInItkImage, this, t);
-    }
-  }
-  else if (pType.GetPixelType() == itk::ImageIOBase::VECTOR &&
-           (!isOdf || !isOdf->GetValue())) // we have a vector image
-  {
-    // recompute
-    mitk::ImageTimeSelector::Pointer timeSelector = this->GetTimeSelector();
-    if (timeSelector.IsNotNull())
-    {
-      timeSelector->SetTimeNr(t);
-      timeSelector->UpdateLargestPossibleRegion();
-      const mitk::Image *image = timeSelector->GetOutput();
-      AccessVectorPixelTypeByItk_n(image, _ComputeExtremaInItkVectorImage, (this, t, component));
-    }
+    ImageDataItem::Pointer volume = m_Image->GetVolumeData(t);
+    if (volume.IsNull())
+      return;
+
+    const Extrema extrema = ComputeExtrema(m_Image, volume, component);
+
+    std::lock_guard<std::mutex> lock(m_StatisticsMutex);
+    this->PublishImageStatistics(t,
+                                 extrema.m_Min,
+                                 extrema.m_2ndMin,
+                                 extrema.m_Max,
+                                 extrema.m_2ndMax,
+                                 extrema.m_CountOfMin,
+                                 extrema.m_CountOfMax);
   }
   else
   {
+    std::lock_guard<std::mutex> lock(m_StatisticsMutex);
+    if (static_cast<size_t>(t) >= m_ScalarMin.size())
+      return;
     m_ScalarMin[t] = 0;
     m_ScalarMax[t] = 255;
     m_Scalar2ndMin[t] = 0;
@@ -352,6 +421,78 @@ void mitk::ImageStatisticsHolder::ComputeImageStatistics(int t, unsigned int com
   }
 }
 
+void mitk::ImageStatisticsHolder::ComputeImageStatisticsInBackground(int t, unsigned int component)
+{
+  if (!this->PrepareImageStatistics(t))
+    return; // Values already calculated before...
+
+  const mitk::PixelType pType = m_Image->GetPixelType(0);
+  if (!this->HasExtrema(pType))
+  {
+    this->ComputeImageStatistics(t, component);
+    return;
+  }
+
+  // The worker keeps the image alive until it is done. It may therefore release the last
+  // reference to the image, which is why it is detached instead of joined by the destructor.
+  Image::ConstPointer image = m_Image;
+  ImageDataItem::Pointer volume = m_Image->GetVolumeData(t);
+  if (volume.IsNull())
+    return;
+  const itk::ModifiedTimeType imageTime = m_Image->GetMTime();
+
+  {
+    std::lock_guard<std::mutex> lock(m_StatisticsMutex);
+    m_TimeStepsInBackground.insert(t);
+  }
+
+  std::thread worker([this, image, volume, imageTime, t, component]() {
+    Extrema extrema;
+    bool computed = false;
+    try
+    {
+      extrema = ComputeExtrema(image, volume, component);
+      computed = true;
+    }
+    catch (const std::exception &e)
+    {
+      MITK_ERROR << "Computing the image statistics of time step " << t << " failed: " << e.what();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_StatisticsMutex);
+      // results of a modified image are outdated
+      if (computed && image->GetMTime() == imageTime)
+      {
+        this->PublishImageStatistics(t,
+                                     extrema.m_Min,
+                                     extrema.m_2ndMin,
+                                     extrema.m_Max,
+                                     extrema.m_2ndMax,
+                                     extrema.m_CountOfMin,
+                                     extrema.m_CountOfMax);
+      }
+      m_TimeStepsInBackground.erase(t);
+    }
+    m_StatisticsComputed.notify_all();
+
+    if (computed)
+    {
+      image->InvokeEvent(ImageStatisticsComputedEvent());
+    }
+  });
+  worker.detach();
+}
+
+bool mitk::ImageStatisticsHolder::IsImageStatisticsComputed(int t) const
+{
+  std::lock_guard<std::mutex> lock(m_StatisticsMutex);
+  return m_TimeStepsInBackground.count(t) == 0 && t >= 0 && static_cast<size_t>(t) < m_ScalarMin.size() &&
+         this->m_Image->GetMTime() <= m_LastRecomputeTimeStamp.GetMTime() &&
+         (m_ScalarMin[t] != itk::NumericTraits<ScalarType>::max() ||
+          m_Scalar2ndMin[t] != itk::NumericTraits<ScalarType>::max());
+}
+
 mitk::ScalarType mitk::ImageStatisticsHolder::GetScalarValueMin(int t, unsigned int component)
 {
   ComputeImageStatistics(t, component);
@@ -0,0 +1,187 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkMemoryMappedImageDataStorage.h"
+#include "mitkExceptionMacro.h"
+
+#if _MSC_VER || __MINGW32__
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <fstream>
+
+namespace
+{
+  size_t GetMappingGranularity()
+  {
+#if _MSC_VER || __MINGW32__
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwAllocationGranularity;
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGE_SIZE));
+#endif
+  }
+}
+
+mitk::MemoryMappedImageDataStorage::MemoryMappedImageDataStorage(const std::string &fileName,
+                                                                 size_t offset,
+                                                                 size_t size,
+                                                                 MappingMode mode)
+  : m_FileName(fileName),
+    m_Offset(offset),
+    m_Size(size),
+    m_Mode(mode),
+    m_MappedView(nullptr),
+    m_MappedLength(0),
+    m_Data(nullptr)
+{
+  if (size == 0)
+  {
+    mitkThrow() << "Cannot map an empty byte range of file " << fileName;
+  }
+
+  const size_t fileSize = GetFileSize(fileName);
+  if (offset + size > fileSize)
+  {
+    mitkThrow() << "Cannot map " << size << " bytes at offset " << offset << " of file " << fileName << " ("
+                << fileSize << " bytes)";
+  }
+
+  // the start of a mapping has to be aligned to the allocation granularity
+  const size_t granularity = GetMappingGranularity();
+  const size_t alignedOffset = (offset / granularity) * granularity;
+  const size_t delta = offset - alignedOffset;
+  m_MappedLength = size + delta;
+
+#if _MSC_VER || __MINGW32__
+  HANDLE file = CreateFileA(fileName.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    mitkThrow() << "Cannot open file " << fileName << " for memory mapping";
+  }
+
+  const ULONGLONG mappingSize = static_cast<ULONGLONG>(alignedOffset) + m_MappedLength;
+  HANDLE mapping = CreateFileMappingA(file,
+                                      nullptr,
+                                      mode == CopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY,
+                                      static_cast<DWORD>(mappingSize >> 32),
+                                      static_cast<DWORD>(mappingSize & 0xFFFFFFFF),
+                                      nullptr);
+  // the view keeps the file mapping alive, so both handles can be closed right away
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    mitkThrow() << "Cannot create file mapping for " << fileName;
+  }
+
+  const ULONGLONG viewOffset = static_cast<ULONGLONG>(alignedOffset);
+  m_MappedView = MapViewOfFile(mapping,
+                               mode == CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ,
+                               static_cast<DWORD>(viewOffset >> 32),
+                               static_cast<DWORD>(viewOffset & 0xFFFFFFFF),
+                               m_MappedLength);
+  CloseHandle(mapping);
+  if (m_MappedView == nullptr)
+  {
+    mitkThrow() << "Cannot map view of file " << fileName;
+  }
+#else
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    mitkThrow() << "Cannot open file " << fileName << " for memory mapping";
+  }
+
+  void *view = mmap(nullptr,
+                    m_MappedLength,
+                    mode == CopyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ,
+                    MAP_PRIVATE,
+                    fd,
+                    static_cast<off_t>(alignedOffset));
+  // the mapping keeps a reference to the file, the descriptor is not needed any longer
+  close(fd);
+  if (view == MAP_FAILED)
+  {
+    mitkThrow() << "Cannot map file " << fileName;
+  }
+  m_MappedView = view;
+
+#if defined(POSIX_MADV_SEQUENTIAL)
+  // most consumers traverse the buffer slice by slice, let the kernel read ahead
+  posix_madvise(m_MappedView, m_MappedLength, POSIX_MADV_SEQUENTIAL);
+#endif
+#endif
+
+  m_Data = static_cast<unsigned char *>(m_MappedView) + delta;
+}
+
+mitk::MemoryMappedImageDataStorage::~MemoryMappedImageDataStorage()
+{
+  this->Unmap();
+}
+
+void mitk::MemoryMappedImageDataStorage::Unmap()
+{
+  if (m_MappedView == nullptr)
+    return;
+
+#if _MSC_VER || __MINGW32__
+  UnmapViewOfFile(m_MappedView);
+#else
+  munmap(m_MappedView, m_MappedLength);
+#endif
+
+  m_MappedView = nullptr;
+  m_MappedLength = 0;
+  m_Data = nullptr;
+}
+
+void *mitk::MemoryMappedImageDataStorage::GetData() const
+{
+  return m_Data;
+}
+
+size_t mitk::MemoryMappedImageDataStorage::GetSize() const
+{
+  return m_Size;
+}
+
+bool mitk::MemoryMappedImageDataStorage::IsReadOnly() const
+{
+  return m_Mode == ReadOnly;
+}
+
+size_t mitk::MemoryMappedImageDataStorage::GetFileSize(const std::string &fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+  if (!file.is_open())
+    return 0;
+
+  std::streamoff size = file.tellg();
+  return size > 0 ? static_cast<size_t>(size) : 0;
+}
@@ -24,7 +24,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImage.h>
 #include <mitkImageReadAccessor.h>
 #include <mitkLocaleSwitch.h>
+#include <mitkMemoryMappedImageDataStorage.h>
 
+#include <itkByteSwapper.h>
 #include <itkImage.h>
 #include <itkImageFileReader.h>
 #include <itkImageIOFactory.h>
@@ -32,6 +34,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkMetaDataObject.h>
 
 #include <algorithm>
+#include <fstream>
 
 namespace mitk
 {
@@ -46,6 +49,131 @@ namespace mitk
     this->InitializeDefaultMetaDataKeys();
   }
 
+  std::string ItkImageIO::OPTION_MEMORY_MAPPING()
+  {
+    static std::string s = "Map uncompressed data into memory";
+    return s;
+  }
+
+  std::string ItkImageIO::OPTION_LOAD_TIME_STEPS_ON_DEMAND()
+  {
+    static std::string s = "Load time steps on demand";
+    return s;
+  }
+
+  /**Volume loader that reads single time steps of a 4D image via a streaming ImageIO.*/
+  class ItkImageIOVolumeLoader : public ImageVolumeLoader
+  {
+  public:
+    mitkClassMacro(ItkImageIOVolumeLoader, ImageVolumeLoader);
+    mitkNewMacro2Param(Self, const itk::ImageIOBase *, const std::string &);
+
+    virtual bool LoadVolume(int t, int n, void *buffer, size_t size) override
+    {
+      if (n != 0)
+        return false;
+
+      itk::ImageIORegion ioRegion(4);
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        ioRegion.SetIndex(i, 0);
+        ioRegion.SetSize(i, m_ImageIO->GetDimensions(i));
+      }
+      ioRegion.SetIndex(3, t);
+      ioRegion.SetSize(3, 1);
+
+      if (m_ImageIO->GetImageSizeInBytes() / m_ImageIO->GetDimensions(3) != size)
+        return false;
+
+      try
+      {
+        mitk::LocaleSwitch localeSwitch("C");
+        m_ImageIO->SetIORegion(ioRegion);
+        m_ImageIO->Read(buffer);
+      }
+      catch (const itk::ExceptionObject &e)
+      {
+        MITK_ERROR << "Reading time step " << t << " of " << m_ImageIO->GetFileName() << " failed: " << e.what();
+        return false;
+      }
+      return true;
+    }
+
+  protected:
+    ItkImageIOVolumeLoader(const itk::ImageIOBase *imageIO, const std::string &path)
+      : m_ImageIO(dynamic_cast<itk::ImageIOBase *>(imageIO->Clone().GetPointer()))
+    {
+      // the reader's ImageIO is reused for other files, so this loader works on its own copy
+      m_ImageIO->SetFileName(path);
+      m_ImageIO->ReadImageInformation();
+    }
+
+  private:
+    itk::ImageIOBase::Pointer m_ImageIO;
+  };
+
+  /**Helper function that maps the pixel data of the file into memory, if it is stored uncompressed,
+   * in native byte order and directly behind the header (NRRD and MetaImage only).
+   * Returns nullptr if the data cannot be mapped; the caller then has to read the data conventionally.*/
+  MemoryMappedImageDataStorage::Pointer MapUncompressedImageData(const std::string &path, itk::ImageIOBase *imageIO)
+  {
+    const std::string imageIOName = imageIO->GetNameOfClass();
+    const bool isNrrd = imageIOName == "NrrdImageIO";
+    const bool isMetaImage = imageIOName == "MetaImageIO";
+    if (!isNrrd && !isMetaImage)
+      return nullptr;
+
+    // NrrdImageIO permutes vector axes while reading, so only scalar NRRDs have the in-memory layout on disk
+    if (isNrrd && imageIO->GetNumberOfComponents() != 1)
+      return nullptr;
+
+    const bool systemIsBigEndian = itk::ByteSwapper<int>::SystemIsBigEndian();
+    if ((imageIO->GetByteOrder() == itk::ImageIOBase::BigEndian && !systemIsBigEndian) ||
+        (imageIO->GetByteOrder() == itk::ImageIOBase::LittleEndian && systemIsBigEndian))
+      return nullptr;
+
+    const size_t payloadSize = static_cast<size_t>(imageIO->GetImageSizeInBytes());
+    const size_t fileSize = MemoryMappedImageDataStorage::GetFileSize(path);
+    if (payloadSize == 0 || fileSize <= payloadSize)
+      return nullptr;
+
+    // Attached, uncompressed data is located at the very end of the file. Everything in front of it is
+    // the header, which is checked for the encoding and for references to detached data files.
+    const size_t headerSize = fileSize - payloadSize;
+    const size_t maxHeaderSize = 1024 * 1024;
+    if (headerSize > maxHeaderSize)
+      return nullptr;
+
+    std::string header(headerSize, '\0');
+    std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+    if (!file.read(&header[0], headerSize))
+      return nullptr;
+
+    if (isNrrd)
+    {
+      if (header.compare(0, 4, "NRRD") != 0 || header.find("encoding: raw") == std::string::npos ||
+          header.find("data file:") != std::string::npos || header.find("datafile:") != std::string::npos)
+        return nullptr;
+    }
+    else
+    {
+      if (header.find("ElementDataFile = LOCAL") == std::string::npos ||
+          header.find("CompressedData = True") != std::string::npos)
+        return nullptr;
+    }
+
+    try
+    {
+      return MemoryMappedImageDataStorage::New(
+        path, headerSize, payloadSize, MemoryMappedImageDataStorage::CopyOnWrite);
+    }
+    catch (const mitk::Exception &e)
+    {
+      MITK_WARN << "Memory mapping of " << path << " failed, reading the data instead: " << e.GetDescription();
+    }
+    return nullptr;
+  }
+
   std::vector<std::string> ItkImageIO::FixUpImageIOExtensions(const std::string &imageIOName)
   {
     std::vector<std::string> extensions;
@@ -108,6 +236,7 @@ namespace mitk
 
     this->AbstractFileReader::SetMimeTypePrefix(IOMimeTypes::DEFAULT_BASE_NAME() + ".image.");
     this->InitializeDefaultMetaDataKeys();
+    this->InitializeDefaultReaderOptions();
 
     std::vector<std::string> readExtensions = m_ImageIO->GetSupportedReadExtensions();
 
@@ -177,6 +306,7 @@ namespace mitk
 
     this->AbstractFileReader::SetMimeTypePrefix(IOMimeTypes::DEFAULT_BASE_NAME() + ".image.");
     this->InitializeDefaultMetaDataKeys();
+    this->InitializeDefaultReaderOptions();
 
     if (rank)
     {
@@ -284,11 +414,48 @@ namespace mitk
 
     MITK_INFO << "ioRegion: " << ioRegion << std::endl;
     m_ImageIO->SetIORegion(ioRegion);
-    void *buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
-    m_ImageIO->Read(buffer);
+
+    bool useMemoryMapping = false;
+    us::Any memoryMappingOption = this->GetReaderOption(OPTION_MEMORY_MAPPING());
+    if (!memoryMappingOption.Empty())
+    {
+      useMemoryMapping = us::any_cast<bool>(memoryMappingOption);
+    }
+
+    MemoryMappedImageDataStorage::Pointer mappedData;
+    if (useMemoryMapping && ndim == m_ImageIO->GetNumberOfDimensions())
+    {
+      mappedData = MapUncompressedImageData(path, m_ImageIO);
+    }
+
+    bool loadTimeStepsOnDemand = false;
+    us::Any loadOnDemandOption = this->GetReaderOption(OPTION_LOAD_TIME_STEPS_ON_DEMAND());
+    if (!loadOnDemandOption.Empty())
+    {
+      loadTimeStepsOnDemand = us::any_cast<bool>(loadOnDemandOption);
+    }
+    loadTimeStepsOnDemand = loadTimeStepsOnDemand && ndim == 4 && m_ImageIO->GetNumberOfDimensions() == 4 &&
+                            dimensions[3] > 1 && m_ImageIO->CanStreamRead();
 
     image->Initialize(MakePixelType(m_ImageIO), ndim, dimensions);
-    image->SetImportChannel(buffer, 0, Image::ManageMemory);
+
+    void *buffer = nullptr;
+    if (mappedData.IsNotNull())
+    {
+      MITK_INFO << "mapping " << mappedData->GetSize() << " bytes of pixel data into memory" << std::endl;
+      image->SetImportChannel(mappedData.GetPointer(), 0);
+    }
+    else if (loadTimeStepsOnDemand)
+    {
+      MITK_INFO << "time steps will be read on demand" << std::endl;
+      image->SetVolumeLoader(ItkImageIOVolumeLoader::New(m_ImageIO, path));
+    }
+    else
+    {
+      buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
+      m_ImageIO->Read(buffer);
+      image->SetImportChannel(buffer, 0, Image::ManageMemory);
+    }
 
     const itk::MetaDataDictionary &dictionary = m_ImageIO->GetMetaDataDictionary();
 
@@ -623,7 +790,21 @@ namespace mitk
       }
 
       ImageReadAccessor imageAccess(image);
-      m_ImageIO->Write(imageAccess.GetData());
+      const void *data = imageAccess.GetData();
+
+      // Writing truncates the target file. If the pixel data is mapped from that very file,
+      // it has to be copied into memory first.
+      std::vector<char> detachedData;
+      const auto *mappedData =
+        dynamic_cast<const MemoryMappedImageDataStorage *>(image->GetChannelData()->GetStorage());
+      if (mappedData != nullptr && mappedData->GetFileName() == path)
+      {
+        const char *begin = static_cast<const char *>(data);
+        detachedData.assign(begin, begin + image->GetChannelData()->GetSize());
+        data = detachedData.data();
+      }
+
+      m_ImageIO->Write(data);
     }
     catch (const std::exception &e)
     {
@@ -660,6 +841,21 @@ namespace mitk
   }
 
   ItkImageIO *ItkImageIO::IOClone() const { return new ItkImageIO(*this); }
+  void ItkImageIO::InitializeDefaultReaderOptions()
+  {
+    const std::string imageIOName = m_ImageIO->GetNameOfClass();
+    if (imageIOName == "NrrdImageIO" || imageIOName == "MetaImageIO")
+    {
+      Options defaultOptions;
+      defaultOptions[OPTION_MEMORY_MAPPING()] = us::Any(false);
+      if (m_ImageIO->CanStreamRead())
+      {
+        defaultOptions[OPTION_LOAD_TIME_STEPS_ON_DEMAND()] = us::Any(false);
+      }
+      this->SetDefaultReaderOptions(defaultOptions);
+    }
+  }
+
   void ItkImageIO::InitializeDefaultMetaDataKeys()
   {
     this->m_DefaultMetaDataKeys.push_back("NRRD.space");
@@ -28,3 +28,13 @@ mitk::OperationType mitk::Operation::GetOperationType()
 {
   return m_OperationType;
 }
+
+std::size_t mitk::Operation::GetMemorySize()
+{
+  return sizeof(Operation);
+}
+
+bool mitk::Operation::IsMemorySizeFinal()
+{
+  return true;
+}
@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 // MITK
 #include <mitkAbstractTransformGeometry.h>
 #include <mitkDataNode.h>
+#include <mitkImageReadAccessor.h>
 #include <mitkImageSliceSelector.h>
 #include <mitkLevelWindowProperty.h>
 #include <mitkLookupTableProperty.h>
@@ -59,7 +60,28 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
-mitk::ImageVtkMapper2D::ImageVtkMapper2D()
+#include <algorithm>
+
+namespace
+{
+  void SetExtractSliceInterpolation(mitk::ExtractSliceFilter *reslicer, int interpolationMode)
+  {
+    switch (interpolationMode)
+    {
+      case VTK_RESLICE_LINEAR:
+        reslicer->SetInterpolationMode(mitk::ExtractSliceFilter::RESLICE_LINEAR);
+        break;
+      case VTK_RESLICE_CUBIC:
+        reslicer->SetInterpolationMode(mitk::ExtractSliceFilter::RESLICE_CUBIC);
+        break;
+      default:
+        reslicer->SetInterpolationMode(mitk::ExtractSliceFilter::RESLICE_NEAREST);
+        break;
+    }
+  }
+}
+
+mitk::ImageVtkMapper2D::ImageVtkMapper2D() : m_ResliceCache(std::make_shared<ResliceCache>())
 {
 }
 
@@ -146,6 +168,8 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     // the latest image is used there if the plane is out of the geometry
     // see bug-13275
     localStorage->m_ReslicedImage = nullptr;
+    localStorage->m_LastThickSliceSettings = LocalStorage::ThickSliceSettings();
+    localStorage->m_CachedSlice = nullptr;
     localStorage->m_Mapper->SetInputData(localStorage->m_EmptyPolyData);
     return;
   }
@@ -164,68 +188,17 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
   datanode->GetBoolProperty("in plane resample extent by geometry", inPlaneResampleExtentByGeometry, renderer);
   localStorage->m_Reslicer->SetInPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry);
 
-  // Initialize the interpolation mode for resampling; switch to nearest
-  // neighbor if the input image is too small.
-  if ((image->GetDimension() >= 3) && (image->GetDimension(2) > 1))
-  {
-    VtkResliceInterpolationProperty *resliceInterpolationProperty;
-    datanode->GetProperty(resliceInterpolationProperty, "reslice interpolation", renderer);
-
-    int interpolationMode = VTK_RESLICE_NEAREST;
-    if (resliceInterpolationProperty != nullptr)
-    {
-      interpolationMode = resliceInterpolationProperty->GetInterpolation();
-    }
-
-    switch (interpolationMode)
-    {
-      case VTK_RESLICE_NEAREST:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
-        break;
-      case VTK_RESLICE_LINEAR:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_LINEAR);
-        break;
-      case VTK_RESLICE_CUBIC:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_CUBIC);
-        break;
-    }
-  }
-  else
-  {
-    localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
-  }
+  // Initialize the interpolation mode for resampling
+  const int interpolationMode = this->GetResliceInterpolation(renderer, image);
+  SetExtractSliceInterpolation(localStorage->m_Reslicer, interpolationMode);
 
   // set the vtk output property to true, makes sure that no unneeded mitk image convertion
   // is done.
   localStorage->m_Reslicer->SetVtkOutputRequest(true);
 
   // Thickslicing
-  int thickSlicesMode = 0;
   int thickSlicesNum = 1;
-  // Thick slices parameters
-  if (image->GetPixelType().GetNumberOfComponents() == 1) // for now only single component are allowed
-  {
-    DataNode *dn = renderer->GetCurrentWorldPlaneGeometryNode();
-    if (dn)
-    {
-      ResliceMethodProperty *resliceMethodEnumProperty = nullptr;
-
-      if (dn->GetProperty(resliceMethodEnumProperty, "reslice.thickslices", renderer) && resliceMethodEnumProperty)
-        thickSlicesMode = resliceMethodEnumProperty->GetValueAsId();
-
-      IntProperty *intProperty = nullptr;
-      if (dn->GetProperty(intProperty, "reslice.thickslices.num", renderer) && intProperty)
-      {
-        thickSlicesNum = intProperty->GetValue();
-        if (thickSlicesNum < 1)
-          thickSlicesNum = 1;
-      }
-    }
-    else
-    {
-      MITK_WARN << "no associated widget plane data tree node found";
-    }
-  }
+  const int thickSlicesMode = this->GetThickSlicesMode(renderer, image, thickSlicesNum);
 
   const auto *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
 
@@ -258,31 +231,79 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
     localStorage->m_Reslicer->SetOutputSpacingZDirection(dataZSpacing);
     localStorage->m_Reslicer->SetOutputExtentZDirection(-thickSlicesNum, 0 + thickSlicesNum);
 
-    // Do the reslicing. Modified() is called to make sure that the reslicer is
-    // executed even though the input geometry information did not change; this
-    // is necessary when the input /em data, but not the /em geometry changes.
-    localStorage->m_TSFilter->SetThickSliceMode(thickSlicesMode - 1);
-    localStorage->m_TSFilter->SetInputData(localStorage->m_Reslicer->GetVtkOutput());
-
-    // vtkFilter=>mitkFilter=>vtkFilter update mechanism will fail without calling manually
-    localStorage->m_Reslicer->Modified();
-    localStorage->m_Reslicer->Update();
-
-    localStorage->m_TSFilter->Modified();
-    localStorage->m_TSFilter->Update();
-    localStorage->m_ReslicedImage = localStorage->m_TSFilter->GetOutput();
+    // The thick slice is only recomputed if one of its inputs changed and not if e.g.
+    // only the level window, the opacity or the color of the node changed.
+    const BaseGeometry *imageGeometry = image->GetTimeGeometry()->GetGeometryForTimeStep(this->GetTimestep());
+    LocalStorage::ThickSliceSettings thickSliceSettings;
+    thickSliceSettings.m_Image = image;
+    thickSliceSettings.m_WorldGeometry = worldGeometry;
+    thickSliceSettings.m_Mode = thickSlicesMode;
+    thickSliceSettings.m_Number = thickSlicesNum;
+    thickSliceSettings.m_TimeStep = this->GetTimestep();
+    thickSliceSettings.m_Interpolation = interpolationMode;
+    thickSliceSettings.m_InPlaneResampleExtentByGeometry = inPlaneResampleExtentByGeometry;
+
+    localStorage->m_CachedSlice = nullptr;
+
+    const itk::TimeStamp &lastUpdate = localStorage->m_LastThickSliceUpdateTime;
+    if (!(thickSliceSettings == localStorage->m_LastThickSliceSettings) || lastUpdate < image->GetMTime() ||
+        lastUpdate < image->GetPipelineMTime() || lastUpdate < imageGeometry->GetMTime() ||
+        lastUpdate < worldGeometry->GetMTime() || lastUpdate < renderer->GetCurrentWorldPlaneGeometryUpdateTime())
+    {
+      // Do the reslicing. Modified() is called to make sure that the reslicer is
+      // executed even though the input geometry information did not change; this
+      // is necessary when the input /em data, but not the /em geometry changes.
+      localStorage->m_TSFilter->SetThickSliceMode(thickSlicesMode - 1);
+      localStorage->m_TSFilter->SetInputData(localStorage->m_Reslicer->GetVtkOutput());
+
+      // vtkFilter=>mitkFilter=>vtkFilter update mechanism will fail without calling manually
+      localStorage->m_Reslicer->Modified();
+      localStorage->m_Reslicer->Update();
+
+      localStorage->m_TSFilter->Modified();
+      localStorage->m_TSFilter->Update();
+      localStorage->m_ReslicedImage = localStorage->m_TSFilter->GetOutput();
+
+      localStorage->m_LastThickSliceSettings = thickSliceSettings;
+      localStorage->m_LastThickSliceUpdateTime.Modified();
+    }
   }
   else
   {
+    localStorage->m_LastThickSliceSettings = LocalStorage::ThickSliceSettings();
     // this is needed when thick mode was enable bevore. These variable have to be reset to default values
     localStorage->m_Reslicer->SetOutputDimensionality(2);
     localStorage->m_Reslicer->SetOutputSpacingZDirection(1.0);
     localStorage->m_Reslicer->SetOutputExtentZDirection(0, 0);
 
-    localStorage->m_Reslicer->Modified();
-    // start the pipeline with updating the largest possible, needed if the geometry of the input has changed
-    localStorage->m_Reslicer->UpdateLargestPossibleRegion();
-    localStorage->m_ReslicedImage = localStorage->m_Reslicer->GetVtkOutput();
+    // Curved planes are not cached. All slices are discarded when the image or its geometry was modified.
+    const bool cacheable = planeGeometry != nullptr &&
+                           dynamic_cast<const AbstractTransformGeometry *>(worldGeometry) == nullptr;
+    ResliceCache::Key key;
+    localStorage->m_CachedSlice = nullptr;
+    if (cacheable)
+    {
+      m_ResliceCache->Validate(this->GetResliceCacheMTime(image, this->GetTimestep()));
+
+      key = ResliceCache::Key(planeGeometry, this->GetTimestep(), interpolationMode, inPlaneResampleExtentByGeometry);
+      localStorage->m_CachedSlice = m_ResliceCache->Get(key);
+    }
+
+    if (localStorage->m_CachedSlice == nullptr)
+    {
+      localStorage->m_Reslicer->Modified();
+      // start the pipeline with updating the largest possible, needed if the geometry of the input has changed
+      localStorage->m_Reslicer->UpdateLargestPossibleRegion();
+
+      if (cacheable)
+        localStorage->m_CachedSlice = m_ResliceCache->Add(key,
+                                                          localStorage->m_Reslicer->GetVtkOutput(),
+                                                          localStorage->m_Reslicer->GetResliceAxes(),
+                                                          localStorage->m_Reslicer->GetOutputSpacing());
+    }
+
+    localStorage->m_ReslicedImage = localStorage->m_CachedSlice != nullptr ? localStorage->m_CachedSlice->m_Image.Get()
+                                                                           : localStorage->m_Reslicer->GetVtkOutput();
   }
 
   // Bounds information for reslicing (only reuqired if reference geometry
@@ -296,7 +317,8 @@ void mitk::ImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rendere
   localStorage->m_Reslicer->GetClippedPlaneBounds(sliceBounds);
 
   // get the spacing of the slice
-  localStorage->m_mmPerPixel = localStorage->m_Reslicer->GetOutputSpacing();
+  localStorage->m_mmPerPixel = localStorage->m_CachedSlice != nullptr ? localStorage->m_CachedSlice->m_Spacing
+                                                                      : localStorage->m_Reslicer->GetOutputSpacing();
 
   // calculate minimum bounding rect of IMAGE in texture
   {
@@ -869,6 +891,83 @@ mitk::ImageVtkMapper2D::LocalStorage *mitk::ImageVtkMapper2D::GetLocalStorage(mi
   return m_LSH.GetLocalStorage(renderer);
 }
 
+mitk::ResliceCache &mitk::ImageVtkMapper2D::GetResliceCache()
+{
+  return *m_ResliceCache;
+}
+
+std::function<void()> mitk::ImageVtkMapper2D::CreatePrefetchJob(mitk::BaseRenderer *renderer,
+                                                                 const PlaneGeometry *planeGeometry)
+{
+  auto *image = const_cast<mitk::Image *>(this->GetInput());
+  mitk::DataNode *datanode = this->GetDataNode();
+  if (nullptr == image || !image->IsInitialized() || nullptr == datanode || m_ResliceCache->GetMemoryBudget() == 0)
+    return nullptr;
+
+  if (nullptr == planeGeometry || !planeGeometry->IsValid() || !planeGeometry->HasReferenceGeometry() ||
+      nullptr != dynamic_cast<const AbstractTransformGeometry *>(planeGeometry) ||
+      !RenderingGeometryIntersectsImage(planeGeometry, image->GetSlicedGeometry()))
+    return nullptr;
+
+  int thickSlicesNum = 1;
+  if (this->GetThickSlicesMode(renderer, image, thickSlicesNum) > 0)
+    return nullptr;
+
+  const int timeStep = renderer->GetTimeStep(image);
+  if (!image->GetTimeGeometry()->IsValidTimeStep(timeStep) || !image->IsVolumeSet(timeStep))
+    return nullptr;
+
+  bool inPlaneResampleExtentByGeometry = false;
+  datanode->GetBoolProperty("in plane resample extent by geometry", inPlaneResampleExtentByGeometry, renderer);
+  const int interpolationMode = this->GetResliceInterpolation(renderer, image);
+
+  const itk::ModifiedTimeType inputMTime = this->GetResliceCacheMTime(image, timeStep);
+  m_ResliceCache->Validate(inputMTime);
+
+  const ResliceCache::Key key(planeGeometry, timeStep, interpolationMode, inPlaneResampleExtentByGeometry);
+  if (m_ResliceCache->Contains(key))
+    return nullptr;
+
+  // The job reslices its own image that references the memory of the volume, so that the pipeline
+  // and the geometries of the rendered image are not touched from another thread.
+  mitk::Image::Pointer inputImage = image;
+  mitk::ImageDataItem::Pointer volume = image->GetVolumeData(timeStep);
+  if (volume.IsNull() || volume->GetData() == nullptr)
+    return nullptr;
+
+  mitk::BaseGeometry::Pointer volumeGeometry = image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep)->Clone();
+  mitk::Image::Pointer volumeImage = mitk::Image::New();
+  volumeImage->Initialize(image->GetPixelType(), *volumeGeometry);
+  volumeImage->SetImportVolume(volume->GetData(), 0, 0, Image::ReferenceMemory);
+
+  mitk::PlaneGeometry::Pointer plane = planeGeometry->Clone();
+  std::shared_ptr<ResliceCache> cache = m_ResliceCache;
+
+  return [=]() {
+    try
+    {
+      // blocks writers of the volume while it is resliced
+      mitk::ImageReadAccessor accessor(inputImage, volume.GetPointer());
+
+      ExtractSliceFilter::Pointer reslicer = ExtractSliceFilter::New();
+      reslicer->SetInput(volumeImage);
+      reslicer->SetWorldGeometry(plane);
+      reslicer->SetTimeStep(0);
+      reslicer->SetResliceTransformByGeometry(volumeGeometry);
+      reslicer->SetInPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry);
+      SetExtractSliceInterpolation(reslicer, interpolationMode);
+      reslicer->SetVtkOutputRequest(true);
+      reslicer->UpdateLargestPossibleRegion();
+
+      cache->Add(key, reslicer->GetVtkOutput(), reslicer->GetResliceAxes(), reslicer->GetOutputSpacing(), inputMTime);
+    }
+    catch (const itk::ExceptionObject &e)
+    {
+      MITK_WARN << "Prefetching a slice failed: " << e.GetDescription();
+    }
+  };
+}
+
 template <typename TPixel>
 vtkSmartPointer<vtkPolyData> mitk::ImageVtkMapper2D::CreateOutlinePolyData(mitk::BaseRenderer *renderer)
 {
@@ -1033,7 +1132,9 @@ void mitk::ImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer)
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
   // get the transformation matrix of the reslicer in order to render the slice as axial, coronal or saggital
   vtkSmartPointer<vtkTransform> trans = vtkSmartPointer<vtkTransform>::New();
-  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_Reslicer->GetResliceAxes();
+  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_CachedSlice != nullptr
+                                           ? localStorage->m_CachedSlice->m_ResliceAxes.GetPointer()
+                                           : localStorage->m_Reslicer->GetResliceAxes();
   trans->SetMatrix(matrix);
   // transform the plane/contour (the actual actor) to the corresponding view (axial, coronal or saggital)
   localStorage->m_Actor->SetUserTransform(trans);
@@ -1048,6 +1149,65 @@ void mitk::ImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer)
   }
 }
 
+int mitk::ImageVtkMapper2D::GetResliceInterpolation(mitk::BaseRenderer *renderer, const mitk::Image *image)
+{
+  // switch to nearest neighbor if the input image is too small
+  int interpolationMode = VTK_RESLICE_NEAREST;
+  if ((image->GetDimension() >= 3) && (image->GetDimension(2) > 1))
+  {
+    VtkResliceInterpolationProperty *resliceInterpolationProperty;
+    this->GetDataNode()->GetProperty(resliceInterpolationProperty, "reslice interpolation", renderer);
+
+    if (resliceInterpolationProperty != nullptr)
+    {
+      interpolationMode = resliceInterpolationProperty->GetInterpolation();
+    }
+  }
+  return interpolationMode;
+}
+
+int mitk::ImageVtkMapper2D::GetThickSlicesMode(mitk::BaseRenderer *renderer,
+                                               const mitk::Image *image,
+                                               int &thickSlicesNum)
+{
+  int thickSlicesMode = 0;
+  thickSlicesNum = 1;
+  if (image->GetPixelType().GetNumberOfComponents() == 1) // for now only single component are allowed
+  {
+    DataNode *dn = renderer->GetCurrentWorldPlaneGeometryNode();
+    if (dn)
+    {
+      ResliceMethodProperty *resliceMethodEnumProperty = nullptr;
+
+      if (dn->GetProperty(resliceMethodEnumProperty, "reslice.thickslices", renderer) && resliceMethodEnumProperty)
+        thickSlicesMode = resliceMethodEnumProperty->GetValueAsId();
+
+      IntProperty *intProperty = nullptr;
+      if (dn->GetProperty(intProperty, "reslice.thickslices.num", renderer) && intProperty)
+      {
+        thickSlicesNum = intProperty->GetValue();
+        if (thickSlicesNum < 1)
+          thickSlicesNum = 1;
+      }
+    }
+    else
+    {
+      MITK_WARN << "no associated widget plane data tree node found";
+    }
+  }
+  return thickSlicesMode;
+}
+
+itk::ModifiedTimeType mitk::ImageVtkMapper2D::GetResliceCacheMTime(const mitk::Image *image, int timeStep) const
+{
+  // The world geometries are not part of this time: the cache is shared by all render windows and their
+  // geometries are modified while slicing through the image. The keys hold everything of a world plane
+  // that the reslicing depends on.
+  const BaseGeometry *imageGeometry = image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep);
+  itk::ModifiedTimeType imageMTime = std::max(image->GetMTime(), image->GetPipelineMTime());
+  return std::max(imageMTime, imageGeometry->GetMTime());
+}
+
 bool mitk::ImageVtkMapper2D::RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry,
                                                               SlicedGeometry3D *imageGeometry)
 {
@@ -1101,10 +1261,6 @@ mitk::ImageVtkMapper2D::LocalStorage::LocalStorage()
   m_ReslicedImage = vtkSmartPointer<vtkImageData>::New();
   m_EmptyPolyData = vtkSmartPointer<vtkPolyData>::New();
 
-  // the following actions are always the same and thus can be performed
-  // in the constructor for each image (i.e. the image-corresponding local storage)
-  m_TSFilter->ReleaseDataFlagOn();
-
   mitk::LookupTable::Pointer mitkLUT = mitk::LookupTable::New();
   // built a default lookuptable
   mitkLUT->SetType(mitk::LookupTable::GRAYSCALE);
@@ -0,0 +1,211 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkResliceCache.h"
+
+#include <tuple>
+
+mitk::ResliceCache::Key::Key()
+  : m_TimeStep(0), m_Interpolation(0), m_InPlaneResampleExtentByGeometry(false), m_ReferenceGeometry(nullptr)
+{
+  m_Geometry.fill(0.0);
+}
+
+mitk::ResliceCache::Key::Key(const PlaneGeometry *worldGeometry,
+                             int timeStep,
+                             int interpolation,
+                             bool inPlaneResampleExtentByGeometry)
+  : m_TimeStep(timeStep),
+    m_Interpolation(interpolation),
+    m_InPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry),
+    m_ReferenceGeometry(worldGeometry->GetReferenceGeometry())
+{
+  // the plane is completely defined by its transform and its bounds
+  const AffineTransform3D *transform = worldGeometry->GetIndexToWorldTransform();
+  const AffineTransform3D::MatrixType &matrix = transform->GetMatrix();
+  const AffineTransform3D::OffsetType &offset = transform->GetOffset();
+  const BoundingBox::BoundsArrayType bounds = worldGeometry->GetBounds();
+
+  size_t i = 0;
+  for (unsigned int row = 0; row < 3; ++row)
+    for (unsigned int column = 0; column < 3; ++column)
+      m_Geometry[i++] = matrix[row][column];
+  for (unsigned int j = 0; j < 3; ++j)
+    m_Geometry[i++] = offset[j];
+  for (unsigned int j = 0; j < 6; ++j)
+    m_Geometry[i++] = bounds[j];
+}
+
+bool mitk::ResliceCache::Key::operator<(const Key &other) const
+{
+  return std::tie(m_TimeStep, m_Interpolation, m_InPlaneResampleExtentByGeometry, m_ReferenceGeometry, m_Geometry) <
+         std::tie(other.m_TimeStep,
+                  other.m_Interpolation,
+                  other.m_InPlaneResampleExtentByGeometry,
+                  other.m_ReferenceGeometry,
+                  other.m_Geometry);
+}
+
+bool mitk::ResliceCache::Key::operator==(const Key &other) const
+{
+  return !(*this < other) && !(other < *this);
+}
+
+mitk::ResliceCache::ResliceCache(size_t memoryBudget) : m_MemoryBudget(memoryBudget), m_MemorySize(0), m_InputMTime(0)
+{
+}
+
+void mitk::ResliceCache::Validate(itk::ModifiedTimeType inputMTime)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (inputMTime != m_InputMTime)
+  {
+    m_Entries.clear();
+    m_Index.clear();
+    m_MemorySize = 0;
+    m_InputMTime = inputMTime;
+  }
+}
+
+mitk::ResliceCache::SlicePointer mitk::ResliceCache::Get(const Key &key)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  auto found = m_Index.find(key);
+  if (found == m_Index.end())
+    return nullptr;
+
+  m_Entries.splice(m_Entries.begin(), m_Entries, found->second);
+  return found->second->second;
+}
+
+mitk::ResliceCache::SlicePointer mitk::ResliceCache::Add(const Key &key,
+                                                         vtkImageData *image,
+                                                         vtkMatrix4x4 *resliceAxes,
+                                                         const ScalarType *spacing)
+{
+  SlicePointer slice = this->CopySlice(image, resliceAxes, spacing);
+  if (slice == nullptr)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return this->Insert(key, slice);
+}
+
+mitk::ResliceCache::SlicePointer mitk::ResliceCache::Add(const Key &key,
+                                                         vtkImageData *image,
+                                                         vtkMatrix4x4 *resliceAxes,
+                                                         const ScalarType *spacing,
+                                                         itk::ModifiedTimeType inputMTime)
+{
+  SlicePointer slice = this->CopySlice(image, resliceAxes, spacing);
+  if (slice == nullptr)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  if (inputMTime != m_InputMTime)
+    return nullptr;
+
+  return this->Insert(key, slice);
+}
+
+bool mitk::ResliceCache::Contains(const Key &key) const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Index.find(key) != m_Index.end();
+}
+
+void mitk::ResliceCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_Index.clear();
+  m_MemorySize = 0;
+}
+
+void mitk::ResliceCache::SetMemoryBudget(size_t memoryBudget)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_MemoryBudget = memoryBudget;
+  this->ShrinkToBudget();
+}
+
+size_t mitk::ResliceCache::GetMemoryBudget() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MemoryBudget;
+}
+
+size_t mitk::ResliceCache::GetMemorySize() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MemorySize;
+}
+
+size_t mitk::ResliceCache::GetNumberOfSlices() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+mitk::ResliceCache::SlicePointer mitk::ResliceCache::CopySlice(vtkImageData *image,
+                                                               vtkMatrix4x4 *resliceAxes,
+                                                               const ScalarType *spacing) const
+{
+  if (image == nullptr || resliceAxes == nullptr || spacing == nullptr || this->GetMemoryBudget() == 0)
+    return nullptr;
+
+  auto slice = std::make_shared<Slice>();
+  slice->m_Image = vtkSmartPointer<vtkImageData>::New();
+  slice->m_Image->DeepCopy(image);
+  slice->m_ResliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+  slice->m_ResliceAxes->DeepCopy(resliceAxes);
+  slice->m_Spacing[0] = spacing[0];
+  slice->m_Spacing[1] = spacing[1];
+  slice->m_MemorySize = static_cast<size_t>(slice->m_Image->GetActualMemorySize()) * 1024;
+  return slice;
+}
+
+mitk::ResliceCache::SlicePointer mitk::ResliceCache::Insert(const Key &key, const SlicePointer &slice)
+{
+  if (slice->m_MemorySize > m_MemoryBudget)
+    return nullptr;
+
+  auto found = m_Index.find(key);
+  if (found != m_Index.end())
+  {
+    m_MemorySize -= found->second->second->m_MemorySize;
+    m_Entries.erase(found->second);
+    m_Index.erase(found);
+  }
+
+  m_Entries.emplace_front(key, slice);
+  m_Index[key] = m_Entries.begin();
+  m_MemorySize += slice->m_MemorySize;
+
+  this->ShrinkToBudget();
+  return slice;
+}
+
+void mitk::ResliceCache::ShrinkToBudget()
+{
+  // slices that are still rendered stay alive through their shared pointers
+  while (m_MemorySize > m_MemoryBudget && !m_Entries.empty())
+  {
+    m_MemorySize -= m_Entries.back().second->m_MemorySize;
+    m_Index.erase(m_Entries.back().first);
+    m_Entries.pop_back();
+  }
+}
@@ -24,8 +24,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkPointData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
 #include <math.h>
 #include <sstream>
+#include <vector>
 
 vtkStandardNewMacro(vtkMitkThickSlicesFilter);
 
@@ -109,9 +111,50 @@ int vtkMitkThickSlicesFilter::RequestUpdateExtent(vtkInformation *,
 }
 
 //----------------------------------------------------------------------------
-// This execute method handles boundaries.
-// it handles boundaries. Pixels are just replicated to get values
-// out of extent.
+// Row kernels: each output row is computed slice by slice from the contiguous
+// input rows, so the inner loops have unit stride and can be vectorized by the
+// compiler for every scalar type.
+template <class T>
+static void vtkMitkThickSlicesFilterMaxRow(const T *inRow, vtkIdType sliceInc, int numSlices, int width, T *outRow)
+{
+  std::copy(inRow, inRow + width, outRow);
+  for (int z = 1; z < numSlices; z++)
+  {
+    const T *slice = inRow + z * sliceInc;
+    for (int x = 0; x < width; x++)
+      outRow[x] = slice[x] > outRow[x] ? slice[x] : outRow[x];
+  }
+}
+
+template <class T>
+static void vtkMitkThickSlicesFilterMinRow(const T *inRow, vtkIdType sliceInc, int numSlices, int width, T *outRow)
+{
+  std::copy(inRow, inRow + width, outRow);
+  for (int z = 1; z < numSlices; z++)
+  {
+    const T *slice = inRow + z * sliceInc;
+    for (int x = 0; x < width; x++)
+      outRow[x] = slice[x] < outRow[x] ? slice[x] : outRow[x];
+  }
+}
+
+// Accumulates weights[z] * slice z into sum, weights == nullptr means all weights are 1.
+template <class T>
+static void vtkMitkThickSlicesFilterSumRow(
+  const T *inRow, vtkIdType sliceInc, int numSlices, int width, const double *weights, double *sum)
+{
+  std::fill(sum, sum + width, 0.0);
+  for (int z = 0; z < numSlices; z++)
+  {
+    const T *slice = inRow + z * sliceInc;
+    const double weight = weights ? weights[z] : 1.0;
+    for (int x = 0; x < width; x++)
+      sum[x] += weight * slice[x];
+  }
+}
+
+//----------------------------------------------------------------------------
+// Projects all input slices onto the output extent of this thread, row by row.
 template <class T>
 void vtkMitkThickSlicesFilterExecute(vtkMitkThickSlicesFilter *self,
                                      vtkImageData *inData,
@@ -121,223 +164,98 @@ void vtkMitkThickSlicesFilterExecute(vtkMitkThickSlicesFilter *self,
                                      int outExt[6],
                                      int /*id*/)
 {
-  int idxX, idxY;
-  int maxX, maxY;
-  vtkIdType inIncX, inIncY, inIncZ;
   vtkIdType outIncX, outIncY, outIncZ;
-  // int axesNum;
   int *inExt = inData->GetExtent();
-  int *wholeExtent;
-  vtkIdType *inIncs;
-  // int useYMin, useYMax, useXMin, useXMax;
+  vtkIdType *inIncs = inData->GetIncrements();
 
   // find the region to loop over
-  maxX = outExt[1] - outExt[0];
-  maxY = outExt[3] - outExt[2];
-
-  //  maxZ = outExt[5] - outExt[4];
-
-  // Get the dimensionality of the gradient.
-  // axesNum = self->GetDimensionality();
+  const int width = outExt[1] - outExt[0] + 1;
+  const int maxY = outExt[3] - outExt[2];
 
   // Get increments to march through data
-  inData->GetContinuousIncrements(outExt, inIncX, inIncY, inIncZ);
   outData->GetContinuousIncrements(outExt, outIncX, outIncY, outIncZ);
-  /*
-// The data spacing is important for computing the gradient.
-// central differences (2 * ratio).
-// Negative because below we have (min - max) for dx ...
-inData->GetSpacing(r);
-r[0] = -0.5 / r[0];
-r[1] = -0.5 / r[1];
-r[2] = -0.5 / r[2];
-    */
-  // get some other info we need
-  inIncs = inData->GetIncrements();
-  wholeExtent = inData->GetExtent();
 
-  // Move the pointer to the correct starting position.
-  inPtr += (outExt[0] - inExt[0]) * inIncs[0] + (outExt[2] - inExt[2]) * inIncs[1] + (outExt[4] - inExt[4]) * inIncs[2];
+  // all slices of the input are projected
+  int _minZ = inExt[4];
+  int _maxZ = inExt[5];
 
-  // Loop through ouput pixels
-
-  int _minZ = /*-5 + outExt[4];  if( _minZ  < wholeExtent[4]) _minZ=*/wholeExtent[4];
-  int _maxZ = /* 5 + outExt[4];  if( _maxZ  > wholeExtent[5]) _maxZ=*/wholeExtent[5];
-
-  if (_maxZ < _minZ)
+  if (_maxZ < _minZ || width <= 0)
     return;
 
-  double invNum = 1.0 / (_maxZ - _minZ + 1);
+  // Move the pointer to the first slice of the first row.
+  inPtr += (outExt[0] - inExt[0]) * inIncs[0] + (outExt[2] - inExt[2]) * inIncs[1];
+
+  const vtkIdType sliceInc = inIncs[2];
+  const int numSlices = _maxZ - _minZ + 1;
+  const int mode = self->GetThickSliceMode();
 
-  switch (self->GetThickSliceMode())
+  // weights of the weighted mode, the first slice is not taken into account
+  std::vector<double> weights;
+  if (mode == vtkMitkThickSlicesFilter::WEIGHTED)
   {
-    default:
-    case vtkMitkThickSlicesFilter::MIP:
+    const int size = _maxZ - _minZ;
+    weights.resize(size);
+    double mean = 0.5 * double(_minZ + _maxZ);
+    double sigma_sq = double(size) / 6.0;
+    sigma_sq *= sigma_sq;
+    double sum = 0;
+    int i = 0;
+    for (int z = _minZ + 1; z <= _maxZ; z++)
     {
-      // MIP
-      for (idxY = 0; idxY <= maxY; idxY++)
-      {
-        // useYMin = ((idxY + outExt[2]) <= wholeExtent[2]) ? 0 : -inIncs[1];
-        // useYMax = ((idxY + outExt[2]) >= wholeExtent[3]) ? 0 : inIncs[1];
-        for (idxX = 0; idxX <= maxX; idxX++)
-        {
-          // useXMin = ((idxX + outExt[0]) <= wholeExtent[0]) ? 0 : -inIncs[0];
-          // useXMax = ((idxX + outExt[0]) >= wholeExtent[1]) ? 0 : inIncs[0];
-
-          T mip = inPtr[_minZ * inIncs[2]];
-
-          for (int z = _minZ + 1; z <= _maxZ; z++)
-          {
-            T value = inPtr[z * inIncs[2]];
-            if (value > mip)
-              mip = value;
-          }
-
-          // do X axis
-          *outPtr = mip;
-          outPtr++;
-          inPtr++;
-        }
-        outPtr += outIncY;
-        inPtr += inIncY;
-      }
+      double val = exp(-(((double)z - mean) / sigma_sq));
+      weights[i++] = val;
+      sum += val;
     }
-    break;
-
-    case vtkMitkThickSlicesFilter::SUM:
+    for (i = 0; i < size; i++)
     {
-      // MIP
-      for (idxY = 0; idxY <= maxY; idxY++)
-      {
-        // useYMin = ((idxY + outExt[2]) <= wholeExtent[2]) ? 0 : -inIncs[1];
-        // useYMax = ((idxY + outExt[2]) >= wholeExtent[3]) ? 0 : inIncs[1];
-        for (idxX = 0; idxX <= maxX; idxX++)
-        {
-          // useXMin = ((idxX + outExt[0]) <= wholeExtent[0]) ? 0 : -inIncs[0];
-          // useXMax = ((idxX + outExt[0]) >= wholeExtent[1]) ? 0 : inIncs[0];
-
-          double sum = 0;
-
-          for (int z = _minZ; z <= _maxZ; z++)
-          {
-            T value = inPtr[z * inIncs[2]];
-            sum += value;
-          }
-
-          // do X axis
-          *outPtr = static_cast<T>(invNum * sum);
-          outPtr++;
-          inPtr++;
-        }
-        outPtr += outIncY;
-        inPtr += inIncY;
-      }
+      weights[i] /= sum;
     }
-    break;
+  }
+
+  std::vector<double> sum(width);
+  for (int idxY = 0; idxY <= maxY; idxY++)
+  {
+    const T *inRow = inPtr + idxY * inIncs[1];
 
-    case vtkMitkThickSlicesFilter::WEIGHTED:
+    switch (mode)
     {
-      const int size = _maxZ - _minZ;
-      std::vector<double> weights(size);
-      double mean = 0.5 * double(_minZ + _maxZ);
-      double sigma_sq = double(size) / 6.0;
-      sigma_sq *= sigma_sq;
-      double sum = 0;
-      int i = 0;
-      for (int z = _minZ + 1; z <= _maxZ; z++)
-      {
-        double val = exp(-(((double)z - mean) / sigma_sq));
-        weights[i++] = val;
-        sum += val;
-      }
-      for (i = 0; i < size; i++)
-      {
-        weights[i] /= sum;
-      }
+      default:
+      case vtkMitkThickSlicesFilter::MIP:
+        vtkMitkThickSlicesFilterMaxRow(inRow, sliceInc, numSlices, width, outPtr);
+        break;
 
-      for (idxY = 0; idxY <= maxY; idxY++)
-      {
-        // useYMin = ((idxY + outExt[2]) <= wholeExtent[2]) ? 0 : -inIncs[1];
-        // useYMax = ((idxY + outExt[2]) >= wholeExtent[3]) ? 0 : inIncs[1];
-        for (idxX = 0; idxX <= maxX; idxX++)
-        {
-          // useXMin = ((idxX + outExt[0]) <= wholeExtent[0]) ? 0 : -inIncs[0];
-          // useXMax = ((idxX + outExt[0]) >= wholeExtent[1]) ? 0 : inIncs[0];
-
-          T mip = inPtr[_minZ * inIncs[2]];
-          i = 0;
-          double mymip = 0;
-          for (int z = _minZ + 1; z <= _maxZ; z++)
-          {
-            double value = inPtr[z * inIncs[2]];
-            mymip += value * weights[i++];
-          }
-          mip = static_cast<T>(mymip);
-          // do X axis
-          *outPtr = mip;
-          outPtr++;
-          inPtr++;
-        }
-        outPtr += outIncY;
-        inPtr += inIncY;
-      }
-    }
-    break;
+      case vtkMitkThickSlicesFilter::MINIP:
+        vtkMitkThickSlicesFilterMinRow(inRow, sliceInc, numSlices, width, outPtr);
+        break;
 
-    case vtkMitkThickSlicesFilter::MINIP:
-    {
-      for (idxY = 0; idxY <= maxY; idxY++)
+      case vtkMitkThickSlicesFilter::SUM:
       {
-        for (idxX = 0; idxX <= maxX; idxX++)
-        {
-          T mip = inPtr[_minZ * inIncs[2]];
-
-          for (int z = _minZ + 1; z <= _maxZ; z++)
-          {
-            T value = inPtr[z * inIncs[2]];
-            if (value < mip)
-              mip = value;
-          }
-
-          // do X axis
-          *outPtr = mip;
-          outPtr++;
-          inPtr++;
-        }
-        outPtr += outIncY;
-        inPtr += inIncY;
+        // the sum is normalized by the number of slices
+        const double invNum = 1.0 / numSlices;
+        vtkMitkThickSlicesFilterSumRow(inRow, sliceInc, numSlices, width, nullptr, sum.data());
+        for (int x = 0; x < width; x++)
+          outPtr[x] = static_cast<T>(invNum * sum[x]);
       }
-    }
-    break;
+      break;
 
-    case vtkMitkThickSlicesFilter::MEAN:
-    {
-      const int size = _maxZ - _minZ;
+      case vtkMitkThickSlicesFilter::WEIGHTED:
+        vtkMitkThickSlicesFilterSumRow(inRow + sliceInc, sliceInc, numSlices - 1, width, weights.data(), sum.data());
+        for (int x = 0; x < width; x++)
+          outPtr[x] = static_cast<T>(sum[x]);
+        break;
 
-      // MEAN
-      for (idxY = 0; idxY <= maxY; idxY++)
+      case vtkMitkThickSlicesFilter::MEAN:
       {
-        for (idxX = 0; idxX <= maxX; idxX++)
-        {
-          T sum = 0;
-          for (int z = _minZ; z <= _maxZ; z++)
-          {
-            T value = inPtr[z * inIncs[2]];
-            sum += value;
-          }
-
-          T mip = sum / size;
-
-          // do X axis
-          *outPtr = mip;
-          outPtr++;
-          inPtr++;
-        }
-        outPtr += outIncY;
-        inPtr += inIncY;
+        // the mean is historically divided by the number of slices minus one
+        const int size = std::max(numSlices - 1, 1);
+        vtkMitkThickSlicesFilterSumRow(inRow, sliceInc, numSlices, width, nullptr, sum.data());
+        for (int x = 0; x < width; x++)
+          outPtr[x] = static_cast<T>(sum[x] / size);
       }
+      break;
     }
-    break;
+
+    outPtr += width + outIncY;
   }
 }
 
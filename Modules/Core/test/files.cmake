@@ -109,6 +109,11 @@ set(MODULE_TESTS
   mitkLineTest.cpp
   mitkArbitraryTimeGeometryTest
   mitkItkImageIOTest.cpp
+  mitkMemoryMappedImageDataStorageTest.cpp
+  mitkImageVolumeLoaderTest.cpp
+  mitkImageAccessorLockManagerTest.cpp
+  mitkImageStatisticsHolderTest.cpp
+  mitkResliceCacheTest.cpp
   mitkRotatedSlice4DTest.cpp
   mitkLevelWindowManagerCppUnitTest.cpp
   mitkVectorPropertyTest.cpp
@@ -125,6 +130,7 @@ set(MODULE_TESTS
   mitkPointSetDataInteractorTest.cpp #since mitkInteractionTestHelper is currently creating a vtkRenderWindow
   mitkSurfaceVtkMapper2DTest.cpp #new rendering test in CppUnit style
   mitkSurfaceVtkMapper2D3DTest.cpp # comparisons/consistency 2D/3D
+  mitkSlicePrefetcherTest.cpp #prefetches with a vtkRenderWindow
 )
 endif()
 
@@ -25,13 +25,19 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkInteractionConst.h>
 #include <mitkNumericTypes.h>
 #include <mitkRotationOperation.h>
+#include <mitkSliceNavigationController.h>
+#include <mitkSlicedGeometry3D.h>
 #include <mitkStandardFileLocations.h>
 #include <mitkTestingMacros.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <math.h>
 
+#include <itkTimeProbe.h>
+
 #include <mitkGeometry3D.h>
 
 #include <vtkActor.h>
@@ -432,6 +438,101 @@ public:
     PixelvalueBasedTestByPlane(imageInMitk, mitk::PlaneGeometry::Axial);
   }
 
+  /*
+   * Compares the slices copied by the axis aligned fast path to the slices of vtkImageReslice for the planes
+   * a SliceNavigationController creates for a non-isotropic volume.
+   */
+  static void AxisAlignedFastPathTest()
+  {
+    typedef itk::Image<short, 3> ImageType;
+
+    ImageType::SizeType size;
+    size[0] = 96;
+    size[1] = 80;
+    size[2] = 48;
+
+    ImageType::SpacingType spacing;
+    spacing[0] = 0.7;
+    spacing[1] = 0.7;
+    spacing[2] = 2.5;
+
+    ImageType::PointType origin;
+    origin[0] = -12.3;
+    origin[1] = 4.0;
+    origin[2] = 101.25;
+
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions(size);
+    image->SetSpacing(spacing);
+    image->SetOrigin(origin);
+    image->Allocate();
+
+    srand(42);
+    itk::ImageRegionIterator<ImageType> iterator(image, image->GetLargestPossibleRegion());
+    for (iterator.GoToBegin(); !iterator.IsAtEnd(); ++iterator)
+    {
+      iterator.Set(static_cast<short>(rand() % 4096 - 1024));
+    }
+
+    mitk::Image::Pointer imageInMitk;
+    CastToMitkImage(image, imageInMitk);
+
+    const mitk::SliceNavigationController::ViewDirection directions[3] = {
+      mitk::SliceNavigationController::Axial,
+      mitk::SliceNavigationController::Sagittal,
+      mitk::SliceNavigationController::Frontal};
+
+    for (auto direction : directions)
+    {
+      mitk::SliceNavigationController::Pointer navigationController = mitk::SliceNavigationController::New();
+      navigationController->SetInputWorldTimeGeometry(imageInMitk->GetTimeGeometry());
+      navigationController->SetViewDirection(direction);
+      navigationController->Update();
+
+      auto *slicedGeometry = dynamic_cast<mitk::SlicedGeometry3D *>(
+        navigationController->GetCreatedWorldGeometry()->GetGeometryForTimeStep(0).GetPointer());
+      MITK_TEST_CONDITION_REQUIRED(slicedGeometry != nullptr, "Sliced world geometry");
+
+      bool equal = true;
+      double fastTime = 0.0;
+      double vtkTime = 0.0;
+      for (unsigned int slice = 0; slice < slicedGeometry->GetSlices(); ++slice)
+      {
+        vtkSmartPointer<vtkImageData> slices[2];
+        for (int fast = 0; fast < 2; ++fast)
+        {
+          mitk::ExtractSliceFilter::Pointer slicer = mitk::ExtractSliceFilter::New();
+          slicer->SetInput(imageInMitk);
+          slicer->SetWorldGeometry(slicedGeometry->GetPlaneGeometry(slice));
+          slicer->SetResliceTransformByGeometry(imageInMitk->GetGeometry());
+          slicer->SetVtkOutputRequest(true);
+          slicer->SetAxisAlignedFastPath(fast == 1);
+
+          itk::TimeProbe clock;
+          clock.Start();
+          slicer->Update();
+          clock.Stop();
+          (fast == 1 ? fastTime : vtkTime) += clock.GetTotal();
+
+          slices[fast] = vtkSmartPointer<vtkImageData>::New();
+          slices[fast]->DeepCopy(slicer->GetVtkOutput());
+        }
+
+        int extents[2][6];
+        slices[0]->GetExtent(extents[0]);
+        slices[1]->GetExtent(extents[1]);
+        const size_t numberOfBytes = static_cast<size_t>(slices[0]->GetNumberOfPoints()) * slices[0]->GetScalarSize();
+        equal = equal && std::equal(extents[0], extents[0] + 6, extents[1]) &&
+                slices[0]->GetScalarType() == slices[1]->GetScalarType() && numberOfBytes > 0 &&
+                std::memcmp(slices[0]->GetScalarPointer(), slices[1]->GetScalarPointer(), numberOfBytes) == 0;
+      }
+
+      MITK_INFO << "Extracting " << slicedGeometry->GetSlices() << " slices (view direction " << direction
+                << "): vtkImageReslice " << vtkTime << "s, axis aligned copy " << fastTime << "s";
+      MITK_TEST_CONDITION(equal, "Axis aligned slices equal vtkImageReslice, view direction " << direction);
+    }
+  }
+
   static void PixelvalueBasedTestByPlane(mitk::Image *imageInMitk, mitk::PlaneGeometry::PlaneOrientation orientation)
   {
     typedef itk::Image<unsigned short, 3> ImageType;
@@ -830,6 +931,9 @@ int mitkExtractSliceFilterTest(int /*argc*/, char * /*argv*/ [])
   // pixelvalue based testing
   mitkExtractSliceFilterTestClass::PixelvalueBasedTest();
 
+  // fast path for planes on the voxel grid
+  mitkExtractSliceFilterTestClass::AxisAlignedFastPathTest();
+
   // initialize sphere test volume
   mitkExtractSliceFilterTestClass::InitializeTestVolume();
 
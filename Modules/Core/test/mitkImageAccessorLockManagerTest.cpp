@@ -0,0 +1,202 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImage.h"
+#include "mitkImageAccessorLockManager.h"
+#include "mitkImagePixelReadAccessor.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+class mitkImageAccessorLockManagerTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageAccessorLockManagerTestSuite);
+  MITK_TEST(LockShared_SameRegion_IsGranted);
+  MITK_TEST(LockExclusive_OverlappingRegion_ThrowsIfNotWaiting);
+  MITK_TEST(LockExclusive_AdjacentRegion_IsGranted);
+  MITK_TEST(LockExclusive_LockOfSameThread_Throws);
+  MITK_TEST(LockExclusive_LockedByOtherThread_WaitsForRelease);
+  MITK_TEST(Accessors_MultipleThreads_Throughput);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  unsigned char m_Buffer[100];
+  mitk::Image::Pointer m_Image;
+
+  void *At(size_t offset) { return m_Buffer + offset; }
+
+public:
+  void setUp() override
+  {
+    unsigned int dimensions[3] = {64, 64, 16};
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<short>(), 3, dimensions);
+
+    // slices are parts of the channel, so accessors of the whole image and of slices overlap
+    std::vector<short> data(dimensions[0] * dimensions[1] * dimensions[2], 0);
+    m_Image->SetChannel(data.data());
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void LockShared_SameRegion_IsGranted()
+  {
+    mitk::ImageAccessorLockManager locks;
+    int first, second;
+    locks.Lock(&first, At(0), At(50), false, false);
+    CPPUNIT_ASSERT_NO_THROW(locks.Lock(&second, At(0), At(50), false, false));
+    CPPUNIT_ASSERT_NO_THROW(locks.Lock(&second, At(10), At(20), false, false));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of locks", (size_t)3, locks.GetNumberOfLocks());
+
+    locks.Unlock(&first, At(0), At(50));
+    locks.Unlock(&second, At(0), At(50));
+    locks.Unlock(&second, At(10), At(20));
+    CPPUNIT_ASSERT_MESSAGE("All locks are released", !locks.IsLocked(At(0), At(100)));
+  }
+
+  void LockExclusive_OverlappingRegion_ThrowsIfNotWaiting()
+  {
+    mitk::ImageAccessorLockManager locks;
+    int reader, writer;
+    locks.Lock(&reader, At(10), At(20), false, false);
+
+    CPPUNIT_ASSERT_THROW(locks.Lock(&writer, At(0), At(11), true, false), mitk::MemoryIsLockedException);
+    CPPUNIT_ASSERT_THROW(locks.Lock(&writer, At(12), At(13), true, false), mitk::MemoryIsLockedException);
+    CPPUNIT_ASSERT_THROW(locks.Lock(&writer, At(0), At(100), true, false), mitk::MemoryIsLockedException);
+
+    locks.Unlock(&reader, At(10), At(20));
+    locks.Lock(&writer, At(0), At(100), true, false);
+    CPPUNIT_ASSERT_THROW(locks.Lock(&reader, At(50), At(60), false, false), mitk::MemoryIsLockedException);
+  }
+
+  void LockExclusive_AdjacentRegion_IsGranted()
+  {
+    mitk::ImageAccessorLockManager locks;
+    int first, second;
+    locks.Lock(&first, At(10), At(20), true, false);
+    CPPUNIT_ASSERT_NO_THROW(locks.Lock(&second, At(20), At(30), true, false));
+    CPPUNIT_ASSERT_NO_THROW(locks.Lock(&second, At(0), At(10), true, false));
+  }
+
+  void LockExclusive_LockOfSameThread_Throws()
+  {
+    mitk::ImageWriteAccessor writer(m_Image, m_Image->GetSliceData(3));
+    CPPUNIT_ASSERT_THROW(mitk::ImageReadAccessor reader(m_Image, m_Image->GetSliceData(3)), mitk::Exception);
+    CPPUNIT_ASSERT_THROW(mitk::ImageReadAccessor reader(m_Image), mitk::Exception);
+    CPPUNIT_ASSERT_NO_THROW(mitk::ImageReadAccessor reader(m_Image, m_Image->GetSliceData(4)));
+  }
+
+  void LockExclusive_LockedByOtherThread_WaitsForRelease()
+  {
+    std::atomic<bool> released(false);
+    std::atomic<bool> writerReleasedFirst(false);
+
+    auto *reader = new mitk::ImageReadAccessor(m_Image, m_Image->GetSliceData(0));
+    std::thread writerThread([&]() {
+      mitk::ImageWriteAccessor writer(m_Image);
+      writerReleasedFirst = !released;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    released = true;
+    delete reader;
+    writerThread.join();
+
+    CPPUNIT_ASSERT_MESSAGE("Write access waited for read access", !writerReleasedFirst);
+  }
+
+  /** Measures how many accessors per second can be acquired by concurrent threads */
+  void Accessors_MultipleThreads_Throughput()
+  {
+    const unsigned int numberOfThreads = std::max(2u, std::thread::hardware_concurrency());
+    const unsigned int accessorsPerThread = 20000;
+    const int numberOfSlices = m_Image->GetDimension(2);
+
+    std::vector<mitk::ImageDataItem::Pointer> slices;
+    for (int s = 0; s < numberOfSlices; ++s)
+    {
+      slices.push_back(m_Image->GetSliceData(s));
+    }
+
+    std::atomic<unsigned int> failures(0);
+    auto readers = [&](unsigned int threadIndex) {
+      for (unsigned int i = 0; i < accessorsPerThread; ++i)
+      {
+        try
+        {
+          mitk::ImagePixelReadAccessor<short, 2> accessor(m_Image, slices[(threadIndex + i) % numberOfSlices]);
+        }
+        catch (const mitk::Exception &)
+        {
+          ++failures;
+        }
+      }
+    };
+    auto writers = [&](unsigned int threadIndex) {
+      for (unsigned int i = 0; i < accessorsPerThread / 10; ++i)
+      {
+        try
+        {
+          mitk::ImageWriteAccessor accessor(m_Image, slices[(threadIndex + i) % numberOfSlices]);
+          *static_cast<short *>(accessor.GetData()) = static_cast<short>(i);
+        }
+        catch (const mitk::Exception &)
+        {
+          ++failures;
+        }
+      }
+    };
+
+    auto measure = [&](bool withWriter) {
+      std::vector<std::thread> threads;
+      const auto start = std::chrono::steady_clock::now();
+      for (unsigned int t = 0; t < numberOfThreads; ++t)
+      {
+        if (withWriter && t == 0)
+          threads.emplace_back(writers, t);
+        else
+          threads.emplace_back(readers, t);
+      }
+      for (auto &thread : threads)
+        thread.join();
+      const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+      return seconds.count();
+    };
+
+    const double readOnlySeconds = measure(false);
+    const double mixedSeconds = measure(true);
+
+    MITK_INFO << numberOfThreads << " threads acquired " << numberOfThreads * accessorsPerThread
+              << " read accessors in " << readOnlySeconds << " s ("
+              << numberOfThreads * accessorsPerThread / readOnlySeconds << " accessors/s)";
+    MITK_INFO << "with one concurrent writer thread: " << mixedSeconds << " s";
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("All accessors were granted", 0u, failures.load());
+    // a write access to the whole image is only granted if no lock is left
+    CPPUNIT_ASSERT_NO_THROW_MESSAGE(
+      "All locks are released",
+      mitk::ImageWriteAccessor accessor(m_Image, nullptr, mitk::ImageAccessorBase::ExceptionIfLocked));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageAccessorLockManager)
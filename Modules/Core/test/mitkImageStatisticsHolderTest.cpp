@@ -0,0 +1,169 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImage.h"
+#include "mitkImageStatisticsHolder.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <itkCommand.h>
+#include <itkVectorImage.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+class mitkImageStatisticsHolderTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageStatisticsHolderTestSuite);
+  MITK_TEST(GetExtrema_ShortImage_MatchesReference);
+  MITK_TEST(GetExtrema_FloatTimeSteps_ComputedPerTimeStep);
+  MITK_TEST(GetExtrema_VectorImage_UsesComponent);
+  MITK_TEST(GetExtrema_ConstantImage_SecondExtremaEqualExtrema);
+  MITK_TEST(ComputeInBackground_PublishesExtrema);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  /** Reference implementation by sorting all values */
+  template <typename T>
+  void CheckExtrema(mitk::Image *image, int t, std::vector<T> values)
+  {
+    std::sort(values.begin(), values.end());
+    const size_t countOfMin = std::count(values.begin(), values.end(), values.front());
+    const size_t countOfMax = std::count(values.begin(), values.end(), values.back());
+
+    std::vector<T> distinct(values);
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+    mitk::ImageStatisticsHolder *statistics = image->GetStatistics();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Min", (mitk::ScalarType)distinct.front(), statistics->GetScalarValueMin(t));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Max", (mitk::ScalarType)distinct.back(), statistics->GetScalarValueMax(t));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("2nd min", (mitk::ScalarType)distinct[1], statistics->GetScalarValue2ndMin(t));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "2nd max", (mitk::ScalarType)distinct[distinct.size() - 2], statistics->GetScalarValue2ndMax(t));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Count of min", (mitk::ScalarType)countOfMin, statistics->GetCountOfMinValuedVoxels(t));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Count of max", (mitk::ScalarType)countOfMax, statistics->GetCountOfMaxValuedVoxels(t));
+  }
+
+  mitk::Image::Pointer m_Image;
+  std::vector<short> m_Values;
+
+public:
+  void setUp() override
+  {
+    // large enough to be split among several threads
+    unsigned int dimensions[3] = {128, 128, 32};
+    m_Values.resize(dimensions[0] * dimensions[1] * dimensions[2]);
+    srand(42);
+    for (auto &value : m_Values)
+      value = static_cast<short>(rand() % 2000 - 1000);
+
+    // extrema in different parts of the buffer
+    m_Values[10] = m_Values[m_Values.size() - 10] = -3000;
+    m_Values[m_Values.size() / 2] = -2999;
+    m_Values[m_Values.size() / 3] = m_Values[m_Values.size() / 4] = 3000;
+    m_Values[5] = 2999;
+
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<short>(), 3, dimensions);
+    m_Image->SetVolume(m_Values.data());
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void GetExtrema_ShortImage_MatchesReference() { this->CheckExtrema(m_Image, 0, m_Values); }
+
+  void GetExtrema_FloatTimeSteps_ComputedPerTimeStep()
+  {
+    unsigned int dimensions[4] = {64, 64, 8, 2};
+    const size_t numberOfPixels = dimensions[0] * dimensions[1] * dimensions[2];
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<float>(), 4, dimensions);
+
+    for (int t = 0; t < 2; ++t)
+    {
+      std::vector<float> values(numberOfPixels);
+      for (size_t i = 0; i < numberOfPixels; ++i)
+        values[i] = static_cast<float>((i * 7919) % 1001) * (t + 1) * 0.5f;
+      image->SetVolume(values.data(), t);
+      this->CheckExtrema(image.GetPointer(), t, values);
+    }
+  }
+
+  void GetExtrema_VectorImage_UsesComponent()
+  {
+    unsigned int dimensions[3] = {16, 16, 4};
+    const size_t numberOfPixels = dimensions[0] * dimensions[1] * dimensions[2];
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakePixelType<itk::VectorImage<unsigned char, 3>>(2), 3, dimensions);
+
+    std::vector<unsigned char> values(2 * numberOfPixels);
+    for (size_t i = 0; i < numberOfPixels; ++i)
+    {
+      values[2 * i] = 0;
+      values[2 * i + 1] = static_cast<unsigned char>(i % 200 + 10);
+    }
+    image->SetVolume(values.data());
+
+    mitk::ImageStatisticsHolder *statistics = image->GetStatistics();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Min of second component", 10.0, statistics->GetScalarValueMin(0, 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Max of second component", 209.0, statistics->GetScalarValueMax(0, 1));
+  }
+
+  void GetExtrema_ConstantImage_SecondExtremaEqualExtrema()
+  {
+    std::fill(m_Values.begin(), m_Values.end(), 7);
+    m_Image->SetVolume(m_Values.data());
+
+    mitk::ImageStatisticsHolder *statistics = m_Image->GetStatistics();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Min", 7.0, statistics->GetScalarValueMin());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("2nd min", 7.0, statistics->GetScalarValue2ndMin());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("2nd max", 7.0, statistics->GetScalarValue2ndMax());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Count of min", (mitk::ScalarType)m_Values.size(), statistics->GetCountOfMinValuedVoxels());
+  }
+
+  void ComputeInBackground_PublishesExtrema()
+  {
+    std::atomic<unsigned int> numberOfEvents(0);
+    auto counter = itk::CStyleCommand::New();
+    counter->SetClientData(&numberOfEvents);
+    counter->SetCallback([](itk::Object *, const itk::EventObject &, void *clientData) {
+      ++*static_cast<std::atomic<unsigned int> *>(clientData);
+    });
+    m_Image->AddObserver(mitk::ImageStatisticsComputedEvent(), counter);
+
+    mitk::ImageStatisticsHolder *statistics = m_Image->GetStatistics();
+    statistics->ComputeImageStatisticsInBackground();
+
+    // waits for the background computation
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Min", -3000.0, statistics->GetScalarValueMin());
+    CPPUNIT_ASSERT_MESSAGE("Statistics are published", statistics->IsImageStatisticsComputed());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Max", 3000.0, statistics->GetScalarValueMaxNoRecompute());
+
+    // the event follows the publication of the results
+    for (int i = 0; i < 500 && numberOfEvents == 0; ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Event is invoked once", 1u, numberOfEvents.load());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageStatisticsHolder)
@@ -0,0 +1,141 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImage.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageVolumeLoader.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  /** Fills every volume with its time step and counts the calls. */
+  class CountingVolumeLoader : public mitk::ImageVolumeLoader
+  {
+  public:
+    mitkClassMacro(CountingVolumeLoader, mitk::ImageVolumeLoader);
+    itkFactorylessNewMacro(Self);
+
+    virtual bool LoadVolume(int t, int /*n*/, void *buffer, size_t size) override
+    {
+      m_Calls.push_back(t);
+      std::fill_n(static_cast<unsigned char *>(buffer), size, static_cast<unsigned char>(t));
+      return true;
+    }
+
+    std::vector<int> m_Calls;
+
+  protected:
+    CountingVolumeLoader() {}
+  };
+}
+
+class mitkImageVolumeLoaderTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageVolumeLoaderTestSuite);
+  MITK_TEST(SetVolumeLoader_NoAccess_NothingLoaded);
+  MITK_TEST(GetVolumeData_LoadsOnlyRequestedTimeStep);
+  MITK_TEST(GetSliceData_LoadsVolumeOfSlice);
+  MITK_TEST(MemoryBudget_ReleasesLeastRecentlyUsedVolume);
+  MITK_TEST(MemoryBudget_KeepsAccessedVolume);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+  CountingVolumeLoader::Pointer m_Loader;
+  size_t m_VolumeSize;
+
+public:
+  void setUp() override
+  {
+    unsigned int dimensions[4] = {8, 8, 4, 10};
+    m_VolumeSize = 8 * 8 * 4;
+
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 4, dimensions);
+
+    m_Loader = CountingVolumeLoader::New();
+    m_Image->SetVolumeLoader(m_Loader);
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Loader = nullptr;
+  }
+
+  unsigned char GetFirstValue(int t)
+  {
+    mitk::ImageReadAccessor accessor(m_Image, m_Image->GetVolumeData(t));
+    return static_cast<const unsigned char *>(accessor.GetData())[0];
+  }
+
+  void SetVolumeLoader_NoAccess_NothingLoaded()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Volumes can be provided", m_Image->IsVolumeSet(9));
+    CPPUNIT_ASSERT_MESSAGE("Nothing is loaded up front", m_Loader->m_Calls.empty());
+  }
+
+  void GetVolumeData_LoadsOnlyRequestedTimeStep()
+  {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Loaded content", (unsigned char)7, this->GetFirstValue(7));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Repeated access", (unsigned char)7, this->GetFirstValue(7));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Volume is loaded exactly once", (size_t)1, m_Loader->m_Calls.size());
+  }
+
+  void GetSliceData_LoadsVolumeOfSlice()
+  {
+    mitk::ImageReadAccessor accessor(m_Image, m_Image->GetSliceData(2, 3));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Slice content", (unsigned char)3, static_cast<const unsigned char *>(accessor.GetData())[0]);
+    CPPUNIT_ASSERT_MESSAGE("Only the volume of the slice is loaded",
+                           m_Loader->m_Calls.size() == 1 && m_Loader->m_Calls[0] == 3);
+  }
+
+  void MemoryBudget_ReleasesLeastRecentlyUsedVolume()
+  {
+    m_Image->SetVolumeLoaderMemoryBudget(2 * m_VolumeSize);
+
+    this->GetFirstValue(0);
+    this->GetFirstValue(1);
+    this->GetFirstValue(0); // 1 is least recently used now
+    this->GetFirstValue(2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Three volumes loaded", (size_t)3, m_Loader->m_Calls.size());
+
+    this->GetFirstValue(0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Recently used volume is kept", (size_t)3, m_Loader->m_Calls.size());
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Released volume is loaded again", (unsigned char)1, this->GetFirstValue(1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Four loads in total", (size_t)4, m_Loader->m_Calls.size());
+  }
+
+  void MemoryBudget_KeepsAccessedVolume()
+  {
+    m_Image->SetVolumeLoaderMemoryBudget(m_VolumeSize);
+
+    mitk::Image::ImageDataItemPointer volume = m_Image->GetVolumeData(0);
+    this->GetFirstValue(1);
+    this->GetFirstValue(2);
+
+    CPPUNIT_ASSERT_MESSAGE("Referenced volume is still part of the image", m_Image->GetVolumeData(0) == volume);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Referenced volume is not loaded again", (size_t)3, m_Loader->m_Calls.size());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageVolumeLoader)
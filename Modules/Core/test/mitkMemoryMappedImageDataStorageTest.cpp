@@ -0,0 +1,175 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkIOUtil.h"
+#include "mitkImage.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
+#include "mitkMemoryMappedImageDataStorage.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <cstdio>
+#include <fstream>
+
+class mitkMemoryMappedImageDataStorageTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkMemoryMappedImageDataStorageTestSuite);
+  MITK_TEST(Map_ByteRange_ReturnsFileContent);
+  MITK_TEST(Map_RangeBeyondEndOfFile_Throws);
+  MITK_TEST(SetImportChannel_MappedStorage_ReferencesFileContent);
+  MITK_TEST(SetImportVolume_MappedStorage_ReferencesFileContent);
+  MITK_TEST(WriteAccess_CopyOnWrite_DoesNotModifyFile);
+  MITK_TEST(WriteAccess_ReadOnly_Throws);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static const unsigned int m_HeaderSize = 13;
+  unsigned int m_Dimensions[4];
+  size_t m_PayloadSize;
+  std::string m_FileName;
+
+  const unsigned short *GetPayload(const void *data) const { return static_cast<const unsigned short *>(data); }
+
+public:
+  void setUp() override
+  {
+    m_Dimensions[0] = 4;
+    m_Dimensions[1] = 3;
+    m_Dimensions[2] = 2;
+    m_Dimensions[3] = 2;
+
+    const size_t numberOfPixels = m_Dimensions[0] * m_Dimensions[1] * m_Dimensions[2] * m_Dimensions[3];
+    m_PayloadSize = numberOfPixels * sizeof(unsigned short);
+
+    // an odd header size makes sure that unaligned offsets are handled
+    std::ofstream stream;
+    m_FileName = mitk::IOUtil::CreateTemporaryFile(stream, std::ios_base::out | std::ios_base::binary);
+    const std::string header(m_HeaderSize, 'h');
+    stream.write(header.data(), header.size());
+    for (size_t i = 0; i < numberOfPixels; ++i)
+    {
+      unsigned short value = static_cast<unsigned short>(i);
+      stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    stream.close();
+  }
+
+  void tearDown() override { std::remove(m_FileName.c_str()); }
+
+  mitk::Image::Pointer CreateImage()
+  {
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<unsigned short>(), 4, m_Dimensions);
+    return image;
+  }
+
+  void Map_ByteRange_ReturnsFileContent()
+  {
+    mitk::MemoryMappedImageDataStorage::Pointer storage =
+      mitk::MemoryMappedImageDataStorage::New(m_FileName, m_HeaderSize, m_PayloadSize);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mapped size", m_PayloadSize, storage->GetSize());
+    CPPUNIT_ASSERT_MESSAGE("Copy-on-write mapping is writable", !storage->IsReadOnly());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("First mapped value", (unsigned short)0, GetPayload(storage->GetData())[0]);
+    const size_t numberOfPixels = m_PayloadSize / sizeof(unsigned short);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Last mapped value",
+                                 (unsigned short)(numberOfPixels - 1),
+                                 GetPayload(storage->GetData())[numberOfPixels - 1]);
+  }
+
+  void Map_RangeBeyondEndOfFile_Throws()
+  {
+    CPPUNIT_ASSERT_THROW(mitk::MemoryMappedImageDataStorage::New(m_FileName, m_HeaderSize + 1, m_PayloadSize),
+                         mitk::Exception);
+    CPPUNIT_ASSERT_THROW(mitk::MemoryMappedImageDataStorage::New(m_FileName + ".missing", 0, 1), mitk::Exception);
+  }
+
+  void SetImportChannel_MappedStorage_ReferencesFileContent()
+  {
+    mitk::MemoryMappedImageDataStorage::Pointer storage =
+      mitk::MemoryMappedImageDataStorage::New(m_FileName, m_HeaderSize, m_PayloadSize);
+    mitk::Image::Pointer image = this->CreateImage();
+
+    CPPUNIT_ASSERT_MESSAGE("Import of mapped channel", image->SetImportChannel(storage.GetPointer(), 0));
+    CPPUNIT_ASSERT_MESSAGE("Channel is set", image->IsChannelSet(0));
+
+    mitk::ImageReadAccessor channelAccess(image);
+    CPPUNIT_ASSERT_MESSAGE("Channel data is not copied", channelAccess.GetData() == storage->GetData());
+
+    // the second volume starts in the middle of the mapped range
+    mitk::ImageReadAccessor volumeAccess(image, image->GetVolumeData(1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("First value of second volume",
+                                 (unsigned short)(m_PayloadSize / 2 / sizeof(unsigned short)),
+                                 GetPayload(volumeAccess.GetData())[0]);
+  }
+
+  void SetImportVolume_MappedStorage_ReferencesFileContent()
+  {
+    const size_t volumeSize = m_PayloadSize / 2;
+    mitk::MemoryMappedImageDataStorage::Pointer storage =
+      mitk::MemoryMappedImageDataStorage::New(m_FileName, m_HeaderSize, m_PayloadSize);
+    mitk::Image::Pointer image = this->CreateImage();
+
+    CPPUNIT_ASSERT_MESSAGE("Import of mapped volume", image->SetImportVolume(storage.GetPointer(), 1, 0, volumeSize));
+    CPPUNIT_ASSERT_MESSAGE("Only the imported volume is set", image->IsVolumeSet(1) && !image->IsVolumeSet(0));
+
+    mitk::ImageReadAccessor volumeAccess(image, image->GetVolumeData(1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mapped volume references file content",
+                                 (unsigned short)(volumeSize / sizeof(unsigned short)),
+                                 GetPayload(volumeAccess.GetData())[0]);
+
+    CPPUNIT_ASSERT_THROW(image->SetImportVolume(storage.GetPointer(), 0, 0, volumeSize + sizeof(unsigned short)),
+                         mitk::Exception);
+  }
+
+  void WriteAccess_CopyOnWrite_DoesNotModifyFile()
+  {
+    mitk::Image::Pointer image = this->CreateImage();
+    {
+      mitk::MemoryMappedImageDataStorage::Pointer storage = mitk::MemoryMappedImageDataStorage::New(
+        m_FileName, m_HeaderSize, m_PayloadSize, mitk::MemoryMappedImageDataStorage::CopyOnWrite);
+      image->SetImportChannel(storage.GetPointer(), 0);
+    }
+
+    {
+      mitk::ImageWriteAccessor writeAccess(image);
+      static_cast<unsigned short *>(writeAccess.GetData())[0] = 4711;
+    }
+
+    mitk::ImageReadAccessor readAccess(image);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Written value is visible", (unsigned short)4711, GetPayload(readAccess.GetData())[0]);
+
+    mitk::MemoryMappedImageDataStorage::Pointer fileContent =
+      mitk::MemoryMappedImageDataStorage::New(m_FileName, m_HeaderSize, m_PayloadSize);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("File is unchanged", (unsigned short)0, GetPayload(fileContent->GetData())[0]);
+  }
+
+  void WriteAccess_ReadOnly_Throws()
+  {
+    mitk::MemoryMappedImageDataStorage::Pointer storage = mitk::MemoryMappedImageDataStorage::New(
+      m_FileName, m_HeaderSize, m_PayloadSize, mitk::MemoryMappedImageDataStorage::ReadOnly);
+    mitk::Image::Pointer image = this->CreateImage();
+    image->SetImportChannel(storage.GetPointer(), 0);
+
+    CPPUNIT_ASSERT_MESSAGE("Read-only mapping", storage->IsReadOnly());
+    CPPUNIT_ASSERT_THROW(mitk::ImageWriteAccessor writeAccess(image), mitk::Exception);
+    CPPUNIT_ASSERT_THROW(mitk::ImageWriteAccessor writeAccess(image, image->GetSliceData(0)), mitk::Exception);
+    CPPUNIT_ASSERT_NO_THROW(mitk::ImageReadAccessor readAccess(image));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkMemoryMappedImageDataStorage)
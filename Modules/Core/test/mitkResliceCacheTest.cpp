@@ -0,0 +1,173 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkResliceCache.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+
+/**
+ * \brief Test class for mitkResliceCache
+ */
+class mitkResliceCacheTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkResliceCacheTestSuite);
+  MITK_TEST(Get_SameKey_ReturnsCopyOfSlice);
+  MITK_TEST(Get_DifferentKey_ReturnsNothing);
+  MITK_TEST(Add_ExceedingBudget_EvictsLeastRecentlyUsed);
+  MITK_TEST(Validate_ModifiedInput_ClearsCache);
+  MITK_TEST(Add_ZeroBudget_DoesNotCache);
+  MITK_TEST(AddPrefetched_OutdatedInput_IsDropped);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::PlaneGeometry::Pointer CreatePlane(double sliceIndex)
+  {
+    mitk::Vector3D spacing;
+    spacing.Fill(1.0);
+    mitk::Point3D origin;
+    origin.Fill(0.0);
+    origin[2] = sliceIndex;
+
+    mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(100, 100, spacing, mitk::PlaneGeometry::Axial, sliceIndex);
+    plane->SetOrigin(origin);
+    return plane;
+  }
+
+  vtkSmartPointer<vtkImageData> CreateSlice(short value)
+  {
+    vtkSmartPointer<vtkImageData> slice = vtkSmartPointer<vtkImageData>::New();
+    slice->SetDimensions(100, 100, 1);
+    slice->AllocateScalars(VTK_SHORT, 1);
+    auto *pixels = static_cast<short *>(slice->GetScalarPointer());
+    std::fill(pixels, pixels + 100 * 100, value);
+    return slice;
+  }
+
+  mitk::ResliceCache::SlicePointer AddSlice(mitk::ResliceCache &cache, const mitk::ResliceCache::Key &key, short value)
+  {
+    vtkSmartPointer<vtkMatrix4x4> axes = vtkSmartPointer<vtkMatrix4x4>::New();
+    axes->SetElement(2, 3, value);
+    mitk::ScalarType spacing[2] = {0.5, 0.75};
+    return cache.Add(key, this->CreateSlice(value), axes, spacing);
+  }
+
+  short GetValue(const mitk::ResliceCache::SlicePointer &slice)
+  {
+    return *static_cast<short *>(slice->m_Image->GetScalarPointer());
+  }
+
+public:
+  void Get_SameKey_ReturnsCopyOfSlice()
+  {
+    mitk::ResliceCache cache;
+    mitk::PlaneGeometry::Pointer plane = this->CreatePlane(3);
+    this->AddSlice(cache, mitk::ResliceCache::Key(plane, 0, 0, false), 42);
+
+    // an equal plane that is another object
+    mitk::ResliceCache::SlicePointer slice = cache.Get(mitk::ResliceCache::Key(this->CreatePlane(3), 0, 0, false));
+    CPPUNIT_ASSERT_MESSAGE("Cached slice is found", slice != nullptr);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Pixels", short(42), this->GetValue(slice));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Reslice axes", 42.0, slice->m_ResliceAxes->GetElement(2, 3));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Spacing", 0.75, slice->m_Spacing[1]);
+    CPPUNIT_ASSERT_MESSAGE("Memory size", cache.GetMemorySize() >= 100 * 100 * sizeof(short));
+  }
+
+  void Get_DifferentKey_ReturnsNothing()
+  {
+    mitk::ResliceCache cache;
+    mitk::PlaneGeometry::Pointer plane = this->CreatePlane(3);
+    this->AddSlice(cache, mitk::ResliceCache::Key(plane, 0, 0, false), 42);
+
+    CPPUNIT_ASSERT_MESSAGE("Other plane",
+                           cache.Get(mitk::ResliceCache::Key(this->CreatePlane(4), 0, 0, false)) == nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Other time step", cache.Get(mitk::ResliceCache::Key(plane, 1, 0, false)) == nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Other interpolation", cache.Get(mitk::ResliceCache::Key(plane, 0, 1, false)) == nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Other resampling", cache.Get(mitk::ResliceCache::Key(plane, 0, 0, true)) == nullptr);
+  }
+
+  void Add_ExceedingBudget_EvictsLeastRecentlyUsed()
+  {
+    mitk::ResliceCache cache;
+    mitk::ResliceCache::SlicePointer first = this->AddSlice(cache, mitk::ResliceCache::Key(this->CreatePlane(0), 0, 0, false), 0);
+    cache.SetMemoryBudget(3 * first->m_MemorySize);
+
+    this->AddSlice(cache, mitk::ResliceCache::Key(this->CreatePlane(1), 0, 0, false), 1);
+    this->AddSlice(cache, mitk::ResliceCache::Key(this->CreatePlane(2), 0, 0, false), 2);
+
+    // slice 0 becomes the most recently used one
+    CPPUNIT_ASSERT_MESSAGE("Slice 0", cache.Get(mitk::ResliceCache::Key(this->CreatePlane(0), 0, 0, false)) != nullptr);
+    this->AddSlice(cache, mitk::ResliceCache::Key(this->CreatePlane(3), 0, 0, false), 3);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of slices", size_t(3), cache.GetNumberOfSlices());
+    CPPUNIT_ASSERT_MESSAGE("Budget", cache.GetMemorySize() <= cache.GetMemoryBudget());
+    CPPUNIT_ASSERT_MESSAGE("Slice 1 is evicted",
+                           cache.Get(mitk::ResliceCache::Key(this->CreatePlane(1), 0, 0, false)) == nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Slice 0 is kept", cache.Get(mitk::ResliceCache::Key(this->CreatePlane(0), 0, 0, false)) != nullptr);
+
+    // evicted slices stay valid as long as they are rendered
+    cache.SetMemoryBudget(first->m_MemorySize);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of slices", size_t(1), cache.GetNumberOfSlices());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Evicted slice", short(0), this->GetValue(first));
+  }
+
+  void Validate_ModifiedInput_ClearsCache()
+  {
+    mitk::ResliceCache cache;
+    cache.Validate(10);
+    this->AddSlice(cache, mitk::ResliceCache::Key(this->CreatePlane(0), 0, 0, false), 0);
+
+    cache.Validate(10);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Unmodified input", size_t(1), cache.GetNumberOfSlices());
+
+    cache.Validate(11);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Modified input", size_t(0), cache.GetNumberOfSlices());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Memory size", size_t(0), cache.GetMemorySize());
+  }
+
+  void Add_ZeroBudget_DoesNotCache()
+  {
+    mitk::ResliceCache cache(0);
+    CPPUNIT_ASSERT_MESSAGE("Nothing is added",
+                           this->AddSlice(cache, mitk::ResliceCache::Key(this->CreatePlane(0), 0, 0, false), 0) == nullptr);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of slices", size_t(0), cache.GetNumberOfSlices());
+  }
+
+  void AddPrefetched_OutdatedInput_IsDropped()
+  {
+    mitk::ResliceCache cache;
+    cache.Validate(10);
+
+    vtkSmartPointer<vtkMatrix4x4> axes = vtkSmartPointer<vtkMatrix4x4>::New();
+    mitk::ScalarType spacing[2] = {1.0, 1.0};
+    const mitk::ResliceCache::Key key(this->CreatePlane(0), 0, 0, false);
+
+    // resliced in the background from a state of the image that was modified meanwhile
+    CPPUNIT_ASSERT_MESSAGE("Outdated slice", cache.Add(key, this->CreateSlice(0), axes, spacing, 9) == nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Outdated slice is not cached", !cache.Contains(key));
+
+    CPPUNIT_ASSERT_MESSAGE("Current slice", cache.Add(key, this->CreateSlice(0), axes, spacing, 10) != nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Current slice is cached", cache.Contains(key));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkResliceCache)
@@ -0,0 +1,200 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkImageGenerator.h>
+#include <mitkImageVtkMapper2D.h>
+#include <mitkRenderingTestHelper.h>
+#include <mitkSlicePrefetcher.h>
+
+#include <atomic>
+#include <future>
+
+namespace
+{
+  /** \brief Gives the test access to the job queue, so that it can occupy the worker. */
+  class TestSlicePrefetcher : public mitk::SlicePrefetcher
+  {
+  public:
+    mitkClassMacro(TestSlicePrefetcher, mitk::SlicePrefetcher);
+    itkFactorylessNewMacro(Self);
+
+    using SlicePrefetcher::Enqueue;
+  };
+}
+
+/**
+ * \brief Test class for mitkSlicePrefetcher
+ */
+class mitkSlicePrefetcherTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSlicePrefetcherTestSuite);
+  MITK_TEST(Prefetch_NextSlices_AreRenderedFromCache);
+  MITK_TEST(Cancel_PendingJobs_AreDropped);
+  MITK_TEST(SliceChange_ReplacesOrCancelsPendingJobs);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::RenderingTestHelper m_RenderingTestHelper;
+  mitk::ImageVtkMapper2D *m_Mapper;
+  /** \brief Prefetcher with a single worker, destroyed in tearDown() after the worker is released. */
+  TestSlicePrefetcher::Pointer m_Prefetcher;
+  std::promise<void> m_Release;
+  bool m_IsReleased;
+  std::shared_future<void> m_Released;
+  std::atomic<int> m_NumberOfMarkerJobsRun;
+
+  mitk::BaseRenderer *GetRenderer()
+  {
+    return mitk::BaseRenderer::GetInstance(m_RenderingTestHelper.GetVtkRenderWindow());
+  }
+
+  /** \brief Occupies the only worker until ReleaseWorker() and queues @a numberOfJobs marker jobs behind it. */
+  void BlockWorker(int numberOfJobs)
+  {
+    std::vector<mitk::SlicePrefetcher::JobType> jobs;
+    std::shared_future<void> released = m_Released;
+    std::promise<void> started;
+    std::future<void> isStarted = started.get_future();
+    jobs.push_back([&started, released]() {
+      started.set_value();
+      released.wait();
+    });
+    m_Prefetcher->Enqueue(jobs);
+    isStarted.wait();
+
+    jobs.clear();
+    for (int i = 0; i < numberOfJobs; ++i)
+      jobs.push_back([this]() { ++m_NumberOfMarkerJobsRun; });
+    m_Prefetcher->Enqueue(jobs);
+  }
+
+  void ReleaseWorker()
+  {
+    if (!m_IsReleased)
+      m_Release.set_value();
+    m_IsReleased = true;
+  }
+
+public:
+  mitkSlicePrefetcherTestSuite()
+    : m_RenderingTestHelper(300, 300), m_Mapper(nullptr), m_IsReleased(false), m_NumberOfMarkerJobsRun(0)
+  {
+  }
+
+  void setUp() override
+  {
+    m_RenderingTestHelper = mitk::RenderingTestHelper(300, 300);
+    m_RenderingTestHelper.SetMapperIDToRender2D();
+
+    mitk::DataNode::Pointer node = mitk::DataNode::New();
+    node->SetData(mitk::ImageGenerator::GenerateGradientImage<unsigned char>(20, 20, 20));
+    m_RenderingTestHelper.AddNodeToStorage(node);
+    m_RenderingTestHelper.SetViewDirection(mitk::SliceNavigationController::Axial);
+    m_Mapper = dynamic_cast<mitk::ImageVtkMapper2D *>(node->GetMapper(mitk::BaseRenderer::Standard2D));
+
+    m_Prefetcher = TestSlicePrefetcher::New();
+    m_Prefetcher->SetNumberOfThreads(1);
+    m_Release = std::promise<void>();
+    m_Released = m_Release.get_future().share();
+    m_IsReleased = false;
+    m_NumberOfMarkerJobsRun = 0;
+  }
+
+  void tearDown() override
+  {
+    this->GetRenderer()->GetSliceNavigationController()->SetSlicePrefetcher(nullptr);
+    this->ReleaseWorker();
+    m_Prefetcher = nullptr;
+    m_Mapper = nullptr;
+  }
+
+  void Prefetch_NextSlices_AreRenderedFromCache()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Image is rendered by an ImageVtkMapper2D", m_Mapper != nullptr);
+
+    mitk::BaseRenderer *renderer = this->GetRenderer();
+    mitk::SliceNavigationController *controller = renderer->GetSliceNavigationController();
+    // only the prefetcher of the test prefetches
+    controller->SetSlicePrefetcher(nullptr);
+
+    m_RenderingTestHelper.Render();
+    mitk::ResliceCache &cache = m_Mapper->GetResliceCache();
+    const size_t numberOfSlices = cache.GetNumberOfSlices();
+    const unsigned int pos = controller->GetSlice()->GetPos();
+
+    mitk::SlicePrefetcher::Pointer prefetcher = mitk::SlicePrefetcher::New();
+    prefetcher->Prefetch(renderer, pos, 1, 2);
+    prefetcher->Wait();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The next two slices are cached", numberOfSlices + 2, cache.GetNumberOfSlices());
+
+    controller->GetSlice()->SetPos(pos + 1);
+    m_RenderingTestHelper.Render();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Rendering a prefetched slice reuses the cached slice", numberOfSlices + 2, cache.GetNumberOfSlices());
+
+    controller->GetSlice()->SetPos(pos + 5);
+    m_RenderingTestHelper.Render();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Rendering a slice that was not prefetched adds it", numberOfSlices + 3, cache.GetNumberOfSlices());
+  }
+
+  void Cancel_PendingJobs_AreDropped()
+  {
+    this->BlockWorker(3);
+    CPPUNIT_ASSERT_EQUAL(4u, m_Prefetcher->GetNumberOfPendingJobs());
+
+    m_Prefetcher->Cancel();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Only the running job is left", 1u, m_Prefetcher->GetNumberOfPendingJobs());
+
+    this->ReleaseWorker();
+    m_Prefetcher->Wait();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Cancelled jobs do not run", 0, m_NumberOfMarkerJobsRun.load());
+  }
+
+  void SliceChange_ReplacesOrCancelsPendingJobs()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Image is rendered by an ImageVtkMapper2D", m_Mapper != nullptr);
+
+    mitk::SliceNavigationController *controller = this->GetRenderer()->GetSliceNavigationController();
+    controller->SetSlicePrefetcher(m_Prefetcher);
+    controller->GetSlice()->SetPos(0);
+
+    const size_t numberOfSlices = m_Mapper->GetResliceCache().GetNumberOfSlices();
+    this->BlockWorker(10);
+
+    // scrolling queues the next slices instead of the jobs of the previous position
+    controller->GetSlice()->SetPos(1);
+    const unsigned int numberOfPendingJobs = m_Prefetcher->GetNumberOfPendingJobs();
+    CPPUNIT_ASSERT_MESSAGE("Scrolling replaces the queued jobs",
+                           numberOfPendingJobs >= 1 + 2 &&
+                             numberOfPendingJobs <= 1 + m_Prefetcher->GetMaximumNumberOfSlices());
+
+    // jumping drops them
+    controller->GetSlice()->SetPos(1 + m_Prefetcher->GetMaximumNumberOfSlices() + 1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Jumping cancels pending jobs", 1u, m_Prefetcher->GetNumberOfPendingJobs());
+
+    this->ReleaseWorker();
+    m_Prefetcher->Wait();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Replaced jobs do not run", 0, m_NumberOfMarkerJobsRun.load());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Cancelled slices are not cached", numberOfSlices, m_Mapper->GetResliceCache().GetNumberOfSlices());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSlicePrefetcher)
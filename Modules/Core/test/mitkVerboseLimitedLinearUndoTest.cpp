@@ -15,6 +15,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkInteractionConst.h"
+#include "mitkLimitedLinearUndo.h"
 #include "mitkOperation.h"
 #include "mitkUndoController.h"
 #include "mitkVerboseLimitedLinearUndo.h"
@@ -36,6 +37,21 @@ namespace mitk
     TestOperation(OperationType operationType) : Operation(operationType) { g_GlobalCounter++; };
     ~TestOperation() override { g_GlobalCounter--; };
   };
+
+  /**
+  * @brief Operation whose buffer is compressed later, e.g. on another thread
+  **/
+  class CompressingTestOperation : public TestOperation
+  {
+  public:
+    CompressingTestOperation() : TestOperation(OpTEST), m_IsCompressed(false) {}
+    void Compress() { m_IsCompressed = true; }
+    std::size_t GetMemorySize() override { return m_IsCompressed ? 100 : 100000; }
+    bool IsMemorySizeFinal() override { return m_IsCompressed; }
+
+  private:
+    bool m_IsCompressed;
+  };
 } // namespace
 
 /**
@@ -124,11 +140,59 @@ int mitkVerboseLimitedLinearUndoTest(int /* argc */, char * /*argv*/ [])
   }
   MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 4, "checking added operations in UndoModel");
 
+  // a memory budget below the size of both operationEvents should delete the older one
+  auto *undoModel = dynamic_cast<mitk::LimitedLinearUndo *>(mitk::UndoController::GetCurrentUndoModel());
+  MITK_TEST_CONDITION_REQUIRED(undoModel != nullptr, "checking LimitedLinearUndo as UndoModel");
+  const std::size_t memorySize = undoModel->GetMemorySize();
+  undoModel->SetMemoryBudget(memorySize - 1);
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 2, "checking deleting oldest operations to keep memory budget");
+  MITK_TEST_CONDITION_REQUIRED(undoModel->GetMemorySize() < memorySize, "checking memory size after deleting");
+
+  // the newest operationEvent is kept even if it exceeds the budget
+  undoModel->SetMemoryBudget(1);
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 2, "checking newest operations are kept");
+  undoModel->SetMemoryBudget(0);
+
+  // sending a new OperationEvent
+  auto doOp = new mitk::TestOperation(mitk::OpTEST);
+  auto undoOp = new mitk::TestOperation(mitk::OpTEST);
+  myUndoController->SetOperationEvent(new mitk::OperationEvent(nullptr, doOp, undoOp, "Test"));
+  mitk::OperationEvent::IncCurrObjectEventId();
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 4, "checking added operations in UndoModel");
+
+  // the undone operationEvent in the RedoList does not count towards the memory budget
+  doOp = new mitk::TestOperation(mitk::OpTEST);
+  undoOp = new mitk::TestOperation(mitk::OpTEST);
+  myUndoController->SetOperationEvent(new mitk::OperationEvent(nullptr, doOp, undoOp, "Test"));
+  mitk::OperationEvent::IncCurrObjectEventId();
+  const std::size_t memorySizeBeforeUndo = undoModel->GetMemorySize();
+  myUndoController->Undo();
+  MITK_TEST_CONDITION_REQUIRED(undoModel->GetMemorySize() < memorySizeBeforeUndo,
+                               "checking memory size without RedoList");
+  undoModel->SetMemoryBudget(undoModel->GetMemorySize());
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 6, "checking RedoList does not delete operations of the UndoList");
+  undoModel->SetMemoryBudget(0);
+
+  // an operation that is still compressed counts with its current size until it is queried again
+  auto compressingOp = new mitk::CompressingTestOperation();
+  undoOp = new mitk::TestOperation(mitk::OpTEST);
+  myUndoController->SetOperationEvent(new mitk::OperationEvent(nullptr, compressingOp, undoOp, "Test"));
+  mitk::OperationEvent::IncCurrObjectEventId();
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 6, "checking added operations in UndoModel");
+  const std::size_t memorySizeBeforeCompression = undoModel->GetMemorySize();
+  compressingOp->Compress();
+  const std::size_t memorySizeAfterCompression = undoModel->GetMemorySize();
+  MITK_TEST_CONDITION_REQUIRED(memorySizeAfterCompression + 100000 - 100 == memorySizeBeforeCompression,
+                               "checking memory size after compression");
+  undoModel->SetMemoryBudget(memorySizeAfterCompression);
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 6, "checking compressed size keeps the memory budget");
+  undoModel->SetMemoryBudget(0);
+
   delete myUndoController;
 
-  // after deleting UndoController g_GlobalCounter will still be 4 because m_CurrentUndoModel inside myUndoModel is a
+  // after deleting UndoController g_GlobalCounter will still be 6 because m_CurrentUndoModel inside myUndoModel is a
   // static singleton
-  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 4, "checking singleton UndoModel");
+  MITK_TEST_CONDITION_REQUIRED(g_GlobalCounter == 6, "checking singleton UndoModel");
 
   // always end with this!
   MITK_TEST_END()
@@ -24,6 +24,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkDataArray.h>
 #include <vtkImageData.h>
 #include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <cstdlib>
 
 class vtkMitkThickSlicesFilterTestHelper
 {
@@ -60,6 +64,76 @@ public:
     MITK_INFO << "actual value: " << static_cast<double>(value[0]);
     MITK_TEST_CONDITION_REQUIRED(value[0] == expectedValue, "Resulting image has correct pixel-value");
   }
+
+  /** Compares the projections of a thick slab with an odd row length and negative values to a pixel-wise reference */
+  static void TestRandomSlab()
+  {
+    const int dimX = 37;
+    const int dimY = 23;
+    const int dimZ = 25;
+    vtkSmartPointer<vtkImageData> slab = vtkSmartPointer<vtkImageData>::New();
+    slab->SetExtent(0, dimX - 1, 0, dimY - 1, -(dimZ / 2), dimZ / 2);
+    slab->AllocateScalars(VTK_SHORT, 1);
+    auto *values = static_cast<short *>(slab->GetScalarPointer());
+    srand(3);
+    for (int i = 0; i < dimX * dimY * dimZ; ++i)
+      values[i] = static_cast<short>(rand() % 4000 - 2000);
+
+    vtkSmartPointer<vtkMitkThickSlicesFilter> filter = vtkSmartPointer<vtkMitkThickSlicesFilter>::New();
+    filter->SetInputData(slab);
+
+    for (int mode = vtkMitkThickSlicesFilter::MIP; mode <= vtkMitkThickSlicesFilter::MEAN; ++mode)
+    {
+      filter->SetThickSliceMode(mode);
+      filter->SetNumberOfThreads(1);
+      filter->Modified();
+      filter->Update();
+      vtkSmartPointer<vtkImageData> singleThreaded = vtkSmartPointer<vtkImageData>::New();
+      singleThreaded->DeepCopy(filter->GetOutput());
+
+      filter->SetNumberOfThreads(4);
+      filter->Modified();
+      filter->Update();
+      auto *result = static_cast<short *>(filter->GetOutput()->GetScalarPointer());
+      auto *singleThreadedResult = static_cast<short *>(singleThreaded->GetScalarPointer());
+
+      bool equalsReference = true;
+      bool equalsSingleThreaded = true;
+      for (int i = 0; i < dimX * dimY; ++i)
+      {
+        double minimum = values[i];
+        double maximum = values[i];
+        double sum = 0;
+        for (int z = 0; z < dimZ; ++z)
+        {
+          minimum = std::min<double>(minimum, values[z * dimX * dimY + i]);
+          maximum = std::max<double>(maximum, values[z * dimX * dimY + i]);
+          sum += values[z * dimX * dimY + i];
+        }
+
+        double expected = result[i];
+        switch (mode)
+        {
+          case vtkMitkThickSlicesFilter::MIP:
+            expected = maximum;
+            break;
+          case vtkMitkThickSlicesFilter::MINIP:
+            expected = minimum;
+            break;
+          case vtkMitkThickSlicesFilter::SUM:
+            expected = static_cast<short>((1.0 / dimZ) * sum);
+            break;
+          case vtkMitkThickSlicesFilter::MEAN:
+            expected = static_cast<short>(sum / (dimZ - 1));
+            break;
+        }
+        equalsReference = equalsReference && result[i] == expected;
+        equalsSingleThreaded = equalsSingleThreaded && result[i] == singleThreadedResult[i];
+      }
+      MITK_TEST_CONDITION(equalsReference, "Projection mode " << mode << " matches reference");
+      MITK_TEST_CONDITION(equalsSingleThreaded, "Projection mode " << mode << " does not depend on the number of threads");
+    }
+  }
 };
 
 /**
@@ -155,5 +229,7 @@ int vtkMitkThickSlicesFilterTest(int, char *[])
 
   thickSliceFilter->Delete();
 
+  vtkMitkThickSlicesFilterTestHelper::TestRandomSlab();
+
   MITK_TEST_END()
 }
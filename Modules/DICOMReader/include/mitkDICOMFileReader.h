@@ -30,6 +30,59 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 namespace mitk
 {
+/**
+  \ingroup DICOMReaderModule
+  \brief Invoked by a DICOMFileReader during progressive loading (see DICOMFileReader::SetProgressiveLoading())
+  whenever a slice has been filled into the mitk::Image of an output.
+
+  The event is invoked in the thread that calls LoadImages(). The image is already part of the output,
+  so observers can e.g. add it to a data storage and request a render update when the first slice arrives.
+*/
+class MITKDICOMREADER_EXPORT DICOMSliceLoadedEvent : public itk::AnyEvent
+{
+public:
+  typedef DICOMSliceLoadedEvent Self;
+  typedef itk::AnyEvent Superclass;
+
+  DICOMSliceLoadedEvent(Image *image = nullptr,
+                        unsigned int slice = 0,
+                        unsigned int numberOfLoadedSlices = 0,
+                        unsigned int numberOfSlices = 0)
+    : m_Image(image),
+      m_Slice(slice),
+      m_NumberOfLoadedSlices(numberOfLoadedSlices),
+      m_NumberOfSlices(numberOfSlices)
+  {
+  }
+  DICOMSliceLoadedEvent(const Self &s)
+    : itk::AnyEvent(s),
+      m_Image(s.m_Image),
+      m_Slice(s.m_Slice),
+      m_NumberOfLoadedSlices(s.m_NumberOfLoadedSlices),
+      m_NumberOfSlices(s.m_NumberOfSlices)
+  {
+  }
+  virtual ~DICOMSliceLoadedEvent() {}
+  virtual const char *GetEventName() const override { return "DICOMSliceLoadedEvent"; }
+  virtual bool CheckEvent(const ::itk::EventObject *e) const override { return dynamic_cast<const Self *>(e); }
+  virtual ::itk::EventObject *MakeObject() const override { return new Self(*this); }
+
+  /// The (partially loaded) image, see DICOMImageBlockDescriptor::GetMitkImage() of the outputs
+  Image *GetImage() const { return m_Image; }
+  /// Slice that has just been set, see Image::IsSliceSet()
+  unsigned int GetSlice() const { return m_Slice; }
+  unsigned int GetNumberOfLoadedSlices() const { return m_NumberOfLoadedSlices; }
+  unsigned int GetNumberOfSlices() const { return m_NumberOfSlices; }
+
+private:
+  Image *m_Image;
+  unsigned int m_Slice;
+  unsigned int m_NumberOfLoadedSlices;
+  unsigned int m_NumberOfSlices;
+
+  void operator=(const Self &);
+};
+
 // TODO Philips3D!
 // TODO http://bugs.mitk.org/show_bug.cgi?id=11572 ?
 
@@ -79,12 +132,21 @@ public:
   /// Individual outputs, only meaningful after calling AnalyzeInputFiles(). \throws std::invalid_argument
   const DICOMImageBlockDescriptor& GetOutput( unsigned int index ) const;
 
-  // void AllocateOutputImages(); TODO for later implementation of slice-by-slice loading
-
   /// Load the mitk::Image%s in our outputs, the DICOMImageBlockDescriptor. To be called only after
   /// AnalyzeInputFiles(). Take care of potential exceptions!
   virtual bool LoadImages() = 0;
 
+  /**
+    \brief Progressive loading: the images of the outputs are allocated before any pixel data is read,
+    then the slices are filled in as they are decoded, starting with the central slice.
+
+    Every filled in slice is reported by a DICOMSliceLoadedEvent and marked in the image (Image::IsSliceSet())
+    and in the output (DICOMImageBlockDescriptor::IsSliceLoaded()). Readers that cannot load an output
+    progressively load it as a whole. Default is off.
+  */
+  void SetProgressiveLoading( bool progressive );
+  bool GetProgressiveLoading() const;
+
   virtual DICOMTagPathList GetTagsOfInterest() const = 0;
 
   /// A way to provide external knowledge about files and tag values is appreciated.
@@ -165,6 +227,8 @@ private:
   std::string m_ConfigLabel;
   std::string m_ConfigDescription;
 
+  bool m_ProgressiveLoading;
+
   AdditionalTagsMapType m_AdditionalTagsOfInterest;
   mitk::DICOMImageBlockDescriptor::TagLookupTableToPropertyFunctor m_TagLookupTableToPropertyFunctor;
 };
@@ -19,8 +19,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDICOMTagCache.h"
 
+#include <map>
 #include <set>
 #include <memory>
+#include <vector>
 
 #include <gdcmScanner.h>
 
@@ -39,6 +41,15 @@ namespace mitk
       itkFactorylessNewMacro( DICOMGDCMTagCache );
       itkCloneMacro(Self);
 
+      /** \brief Value of a tag like reported by a gdcm::Scanner, which distinguishes null from empty values. */
+      struct TagValue
+      {
+        bool m_IsNull;
+        std::string m_Value;
+      };
+
+      typedef std::map<DICOMTag, TagValue> TagValueMap;
+
       virtual DICOMDatasetFinding GetTagValue(DICOMImageFrameInfo* frame, const DICOMTag& tag) const override;
 
       virtual FindingsListType GetTagValue(DICOMImageFrameInfo* frame, const DICOMTagPath& path) const override;
@@ -47,7 +58,23 @@ namespace mitk
 
       void InitCache(const std::set<DICOMTag>& scannedTags, const std::shared_ptr<gdcm::Scanner>& scanner, const StringList& inputFiles);
 
-      const gdcm::Scanner& GetScanner() const;
+      /**
+        \brief Initializes the cache from the results of several scanners (e.g. of a parallel scan of
+        parts of the input files) and from tag values that are known without scanning (e.g. read from
+        a persistent cache file). Known values take precedence over the results of the scanners.
+      */
+      void InitCache(const std::set<DICOMTag>& scannedTags,
+                     const std::vector<std::shared_ptr<gdcm::Scanner>>& scanners,
+                     const std::map<std::string, TagValueMap>& knownValues,
+                     const StringList& inputFiles);
+
+      /**
+        \brief Returns the scanner of the scan.
+        \throw mitk::Exception if the cache was not initialized by a single scanner that scanned all input files,
+        e.g. after a parallel scan or if values were read from a persistent cache.
+        \deprecated Use GetTagValue() or GetFrameInfoList(), which work for all scans.
+      */
+      DEPRECATED(const gdcm::Scanner& GetScanner() const);
 
   protected:
 
@@ -56,7 +83,12 @@ namespace mitk
 
       std::set<DICOMTag> m_ScannedTags;
 
+      /** only set if a single scanner scanned all input files */
       std::shared_ptr<gdcm::Scanner> m_Scanner;
+      std::vector<std::shared_ptr<gdcm::Scanner>> m_Scanners;
+
+      /** storage of the known values, the frame infos point into it like into the storage of a gdcm::Scanner */
+      std::set<std::string> m_KnownValues;
 
       DICOMDatasetAccessingImageFrameList m_ScanResult;
 
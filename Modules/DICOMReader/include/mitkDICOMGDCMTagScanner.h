@@ -45,6 +45,14 @@ namespace mitk
     results, care should be taken that all the tags and files of interest
     are communicated to DICOMGDCMTagScanner before requesting the results!
 
+    The input files are partitioned among several threads (see SetNumberOfThreads()),
+    each of them scanning its part with an own gdcm::Scanner. Like gdcm::Scanner,
+    reading a file stops after the last tag of interest.
+
+    Optionally the scan results can be persisted in a file (see SetPersistentCacheFile()).
+    Files are identified by their path, modification time and size, so scanning the same
+    unchanged files again only reads the cache file.
+
     @remark This scanner does only support the scanning for simple value tag.
     If you need to scann for sequence items or non-top-level elements, this scanner
     will not be sufficient. See i.a. DICOMDCMTKTagScanner for these cases.
@@ -105,6 +113,29 @@ namespace mitk
       */
       virtual DICOMDatasetFinding GetTagValue(DICOMImageFrameInfo* frame, const DICOMTag& tag) const;
 
+      /**
+        \brief Set the maximum number of threads that scan the input files in parallel.
+        Defaults to itk::MultiThreader::GetGlobalDefaultNumberOfThreads().
+      */
+      void SetNumberOfThreads(unsigned int numberOfThreads);
+      unsigned int GetNumberOfThreads() const;
+
+      /**
+        \brief Set a file in which the scan results are persisted across scans and sessions.
+        Scan() takes the tag values of all input files that have been scanned for all tags of
+        interest before and that have not changed since then from this file. Only the remaining
+        files are scanned, afterwards their results are added to the file.
+        An empty filename (the default) disables the persistence.
+      */
+      void SetPersistentCacheFile(const std::string& filename);
+      std::string GetPersistentCacheFile() const;
+
+      /**
+        \brief Returns the number of input files whose tag values have been taken from the
+        persistent cache file during the last Scan().
+      */
+      size_t GetNumberOfFilesFromPersistentCache() const;
+
     protected:
 
       DICOMGDCMTagScanner();
@@ -115,7 +146,15 @@ namespace mitk
       DICOMGDCMTagCache::Pointer m_Cache;
       std::shared_ptr<gdcm::Scanner> m_GDCMScanner;
 
+      unsigned int m_NumberOfThreads;
+      std::string m_PersistentCacheFile;
+      size_t m_NumberOfFilesFromPersistentCache;
+
     private:
+
+      /** scans the files, in parallel if more than one thread is used, and returns the used scanners */
+      std::vector<std::shared_ptr<gdcm::Scanner>> ScanFiles(const StringList& filenames);
+
       DICOMGDCMTagScanner(const DICOMGDCMTagScanner&);
   };
 }
@@ -263,6 +263,14 @@ class MITKDICOMREADER_EXPORT DICOMITKSeriesGDCMReader : public DICOMFileReader
       return m_SimpleVolumeReading;
     };
 
+    /**
+      \brief Number of threads used for scanning the input files and for decoding the slices of each block.
+      Defaults to itk::MultiThreader::GetGlobalDefaultNumberOfThreads(), 1 restores sequential loading
+      by itk::ImageSeriesReader.
+    */
+    void SetNumberOfThreads(unsigned int numberOfThreads);
+    unsigned int GetNumberOfThreads() const;
+
     double GetToleratedOriginError() const;
     bool IsToleratedOriginOffsetAbsolute() const;
 
@@ -337,6 +345,11 @@ class MITKDICOMREADER_EXPORT DICOMITKSeriesGDCMReader : public DICOMFileReader
 
     bool m_SimpleVolumeReading;
 
+    unsigned int m_NumberOfThreads;
+
+    /// \brief Collects the timings of LoadImages(), only valid during LoadImages()
+    mutable itk::TimeProbesCollectorBase* m_LoadingTimeProbes;
+
   private:
 
     SortingBlockList m_SortingResultInProgress;
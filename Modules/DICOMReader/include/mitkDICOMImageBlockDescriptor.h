@@ -122,17 +122,13 @@ namespace mitk
     /// Convenience function around GetProperty()
     int GetIntProperty(const std::string& key, int defaultValue) const;
 
-  private:
-
-    // For future implementation: load slice-by-slice, mark this using these methods
+    /// Marks frames (by index in GetImageFrameList()) as loaded during progressive loading, see DICOMFileReader::SetProgressiveLoading()
     void SetSliceIsLoaded(unsigned int index, bool isLoaded);
-    // For future implementation: load slice-by-slice, mark this using these methods
+    /// Whether the frame has been loaded into the mitk::Image during progressive loading
     bool IsSliceLoaded(unsigned int index) const;
-    // For future implementation: load slice-by-slice, mark this using these methods
+    /// Whether all frames have been loaded into the mitk::Image during progressive loading
     bool AllSlicesAreLoaded() const;
 
-  public:
-
     /// Describe how the mitk::Image's pixel spacing should be interpreted
     PixelSpacingInterpretation GetPixelSpacingInterpretation() const;
 
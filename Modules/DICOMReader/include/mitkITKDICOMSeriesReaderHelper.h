@@ -23,9 +23,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkGDCMImageIO.h>
 
+#include <functional>
+
 /* Forward deceleration of an DCMTK class. Used in the txx but part of the interface.*/
 class OFDateTime;
 
+namespace itk
+{
+  class TimeProbesCollectorBase;
+}
+
 namespace mitk
 {
 
@@ -40,9 +47,41 @@ class ITKDICOMSeriesReaderHelper
     typedef std::vector<std::string> StringContainer;
     typedef std::list<StringContainer> StringContainerList;
 
+    ITKDICOMSeriesReaderHelper();
+
+    /**
+      \brief Number of threads that decode the slices of a 3D block in parallel (default 1).
+      With more than one thread, every thread reads and decodes complete files (e.g. JPEG 2000 or
+      JPEG-LS compressed frames) directly into the buffer of the resulting image.
+      Blocks whose files do not share one pixel layout are loaded by itk::ImageSeriesReader.
+    */
+    void SetNumberOfThreads(unsigned int numberOfThreads);
+    unsigned int GetNumberOfThreads() const;
+
+    /**
+      \brief Optional collector for the timings of the loading steps (not owned, may be nullptr).
+    */
+    void SetTimeProbesCollector(itk::TimeProbesCollectorBase* timeProbes);
+
     Image::Pointer Load( const StringContainer& filenames, bool correctTilt, const GantryTiltInformation& tiltInfo );
     Image::Pointer Load3DnT( const StringContainerList& filenamesLists, bool correctTilt, const GantryTiltInformation& tiltInfo );
 
+    /// Called with the allocated but still empty image before any slice is decoded
+    typedef std::function<void(Image*)> ImageAllocatedCallback;
+    /// Called whenever a slice has been set in the image
+    typedef std::function<void(Image*, unsigned int)> SliceLoadedCallback;
+
+    /**
+      \brief Progressive variant of Load() for blocks without gantry tilt correction.
+
+      The image is allocated from the geometry of the files first, then the slices are decoded by
+      GetNumberOfThreads() threads, starting with the central slice and moving outwards.
+      Slices are set in the image and reported in the calling thread.
+    */
+    Image::Pointer LoadProgressively( const StringContainer& filenames,
+                                      const ImageAllocatedCallback& imageAllocated,
+                                      const SliceLoadedCallback& sliceLoaded );
+
     static bool CanHandleFile(const std::string& filename);
 
   private:
@@ -87,6 +126,27 @@ class ITKDICOMSeriesReaderHelper
     typename ImageType::Pointer
     FixUpTiltedGeometry( ImageType* input, const GantryTiltInformation& tiltInfo );
 
+    /** Decodes the file filenames[i] into buffer + i * bytesPerSlice using several threads.
+        Returns false if any file does not match the given pixel layout, nothing is guaranteed
+        about the buffer content then. */
+    bool DecodeSlicesInParallel( const StringContainer& filenames,
+                                 itk::ImageIOBase::IOPixelType pixelType,
+                                 itk::ImageIOBase::IOComponentType componentType,
+                                 size_t bytesPerSlice,
+                                 char* buffer ) const;
+
+    /** Decodes the files on several threads, starting with the central one and moving outwards, and passes
+        every decoded slice (index in filenames, pixel data) to sliceDecoded in the calling thread.
+        Returns false if any file does not match the given pixel layout, slices passed so far remain valid. */
+    bool DecodeSlicesProgressively( const StringContainer& filenames,
+                                    itk::ImageIOBase::IOPixelType pixelType,
+                                    itk::ImageIOBase::IOComponentType componentType,
+                                    size_t bytesPerSlice,
+                                    const std::function<void(unsigned int, const char*)>& sliceDecoded ) const;
+
+    void StartTimeProbe(const char* id) const;
+    void StopTimeProbe(const char* id) const;
+
     template <typename PixelType>
     Image::Pointer
     LoadDICOMByITK( const StringContainer& filenames,
@@ -94,6 +154,13 @@ class ITKDICOMSeriesReaderHelper
                     const GantryTiltInformation& tiltInfo,
                     itk::GDCMImageIO::Pointer& io);
 
+    template <typename PixelType>
+    Image::Pointer
+    LoadDICOMByITKProgressively( const StringContainer& filenames,
+                                 const ImageAllocatedCallback& imageAllocated,
+                                 const SliceLoadedCallback& sliceLoaded,
+                                 itk::GDCMImageIO::Pointer& io);
+
     template <typename PixelType>
     Image::Pointer
     LoadDICOMByITK3DnT( const StringContainerList& filenames,
@@ -101,7 +168,8 @@ class ITKDICOMSeriesReaderHelper
                         const GantryTiltInformation& tiltInfo,
                         itk::GDCMImageIO::Pointer& io);
 
-
+    unsigned int m_NumberOfThreads;
+    itk::TimeProbesCollectorBase* m_TimeProbes;
 };
 
 }
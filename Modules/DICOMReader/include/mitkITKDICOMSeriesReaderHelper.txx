@@ -19,7 +19,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkResampleImageFilter.h>
 //#include <itkAffineTransform.h>
 //#include <itkLinearInterpolateImageFunction.h>
-//#include <itkTimeProbesCollectorBase.h>
+
+#include "mitkImageWriteAccessor.h"
 
 #include "dcmtk/ofstd/ofdatime.h"
 
@@ -38,6 +39,10 @@ mitk::ITKDICOMSeriesReaderHelper
   typedef itk::Image<PixelType, 3> ImageType;
   typedef itk::ImageSeriesReader<ImageType> ReaderType;
 
+  // the pixel type has been chosen by the layout of the first file
+  const itk::ImageIOBase::IOPixelType ioPixelType = io->GetPixelType();
+  const itk::ImageIOBase::IOComponentType ioComponentType = io->GetComponentType();
+
   io = itk::GDCMImageIO::New();
   typename ReaderType::Pointer reader = ReaderType::New();
 
@@ -49,17 +54,67 @@ mitk::ITKDICOMSeriesReaderHelper
                              // see NormalDirectionConsistencySorter.
 
   reader->SetFileNames(filenames);
-  reader->Update();
-  typename ImageType::Pointer readVolume = reader->GetOutput();
 
-  // if we detected that the images are from a tilted gantry acquisition, we need to push some pixels into the right position
-  if (correctTilt)
+  bool decoded = false;
+  if (m_NumberOfThreads > 1 && filenames.size() > 1)
   {
-    readVolume = FixUpTiltedGeometry( reader->GetOutput(), tiltInfo );
+    this->StartTimeProbe("Decoding slices in parallel");
+
+    // geometry as determined by the series reader, without reading any pixels
+    reader->UpdateOutputInformation();
+    const typename ImageType::RegionType region = reader->GetOutput()->GetLargestPossibleRegion();
+    const size_t bytesPerSlice = region.GetSize()[0] * region.GetSize()[1] * sizeof(PixelType);
+
+    if (correctTilt)
+    {
+      // the shearing needs an itk image as input
+      typename ImageType::Pointer readVolume = ImageType::New();
+      readVolume->CopyInformation(reader->GetOutput());
+      readVolume->SetRegions(region);
+      readVolume->Allocate();
+
+      decoded = this->DecodeSlicesInParallel(filenames, ioPixelType, ioComponentType, bytesPerSlice,
+                                             reinterpret_cast<char*>(readVolume->GetBufferPointer()));
+      if (decoded)
+      {
+        readVolume = FixUpTiltedGeometry( readVolume.GetPointer(), tiltInfo );
+        image->InitializeByItk(readVolume.GetPointer());
+        image->SetImportVolume(readVolume->GetBufferPointer());
+      }
+    }
+    else
+    {
+      image->InitializeByItk(reader->GetOutput());
+      ImageWriteAccessor accessor(image);
+      decoded = this->DecodeSlicesInParallel(filenames, ioPixelType, ioComponentType, bytesPerSlice,
+                                             static_cast<char*>(accessor.GetData()));
+    }
+
+    this->StopTimeProbe("Decoding slices in parallel");
+
+    if (!decoded)
+    {
+      MITK_DEBUG << "Files differ in pixel layout, loading them by itk::ImageSeriesReader";
+      image = mitk::Image::New();
+    }
   }
 
-  image->InitializeByItk(readVolume.GetPointer());
-  image->SetImportVolume(readVolume->GetBufferPointer());
+  if (!decoded)
+  {
+    this->StartTimeProbe("Reading slices by itk::ImageSeriesReader");
+    reader->Update();
+    typename ImageType::Pointer readVolume = reader->GetOutput();
+
+    // if we detected that the images are from a tilted gantry acquisition, we need to push some pixels into the right position
+    if (correctTilt)
+    {
+      readVolume = FixUpTiltedGeometry( reader->GetOutput(), tiltInfo );
+    }
+
+    image->InitializeByItk(readVolume.GetPointer());
+    image->SetImportVolume(readVolume->GetBufferPointer());
+    this->StopTimeProbe("Reading slices by itk::ImageSeriesReader");
+  }
 
 #ifdef MBILOG_ENABLE_DEBUG
 
@@ -75,6 +130,74 @@ mitk::ITKDICOMSeriesReaderHelper
   return image;
 }
 
+template <typename PixelType>
+mitk::Image::Pointer
+mitk::ITKDICOMSeriesReaderHelper
+::LoadDICOMByITKProgressively(
+    const StringContainer& filenames,
+    const ImageAllocatedCallback& imageAllocated,
+    const SliceLoadedCallback& sliceLoaded,
+    itk::GDCMImageIO::Pointer& io)
+{
+  typedef itk::Image<PixelType, 3> ImageType;
+  typedef itk::ImageSeriesReader<ImageType> ReaderType;
+
+  // the pixel type has been chosen by the layout of the first file
+  const itk::ImageIOBase::IOPixelType ioPixelType = io->GetPixelType();
+  const itk::ImageIOBase::IOComponentType ioComponentType = io->GetComponentType();
+
+  io = itk::GDCMImageIO::New();
+  typename ReaderType::Pointer reader = ReaderType::New();
+
+  reader->SetImageIO(io);
+  reader->ReverseOrderOff(); // see LoadDICOMByITK()
+  reader->SetFileNames(filenames);
+
+  // allocate the image from the geometry as determined by the series reader, without reading any pixels
+  reader->UpdateOutputInformation();
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->InitializeByItk(reader->GetOutput());
+
+  if (imageAllocated)
+  {
+    imageAllocated(image);
+  }
+
+  const typename ImageType::SizeType size = reader->GetOutput()->GetLargestPossibleRegion().GetSize();
+  const size_t bytesPerSlice = size[0] * size[1] * sizeof(PixelType);
+  const unsigned int numberOfSlices = size[2];
+
+  auto setSlice = [&](unsigned int slice, const char* data)
+  {
+    image->SetSlice(data, slice);
+    if (sliceLoaded)
+    {
+      sliceLoaded(image, slice);
+    }
+  };
+
+  this->StartTimeProbe("Decoding slices progressively");
+  const bool decoded = filenames.size() == numberOfSlices &&
+                       this->DecodeSlicesProgressively(filenames, ioPixelType, ioComponentType, bytesPerSlice, setSlice);
+  this->StopTimeProbe("Decoding slices progressively");
+
+  if (!decoded)
+  {
+    MITK_DEBUG << "Files differ in pixel layout, loading them by itk::ImageSeriesReader";
+
+    this->StartTimeProbe("Reading slices by itk::ImageSeriesReader");
+    reader->Update();
+    const char* volume = reinterpret_cast<const char*>(reader->GetOutput()->GetBufferPointer());
+    for (unsigned int slice = 0; slice < numberOfSlices; ++slice)
+    {
+      setSlice(slice, volume + slice * bytesPerSlice);
+    }
+    this->StopTimeProbe("Reading slices by itk::ImageSeriesReader");
+  }
+
+  return image;
+}
+
 #define MITK_DEBUG_OUTPUT_FILELIST(list)\
   MITK_DEBUG << "-------------------------------------------"; \
   for (StringContainer::const_iterator _iter = (list).cbegin(); _iter!=(list).cend(); ++_iter) \
@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 mitk::DICOMFileReader
 ::DICOMFileReader()
 :itk::Object()
+,m_ProgressiveLoading( false )
 {
 }
 
@@ -36,6 +37,7 @@ mitk::DICOMFileReader
 ,m_Outputs( other.m_Outputs )
 ,m_ConfigLabel( other.m_ConfigLabel )
 ,m_ConfigDescription( other.m_ConfigDescription )
+,m_ProgressiveLoading( other.m_ProgressiveLoading )
 {
 }
 
@@ -49,10 +51,25 @@ mitk::DICOMFileReader
     m_Outputs = other.m_Outputs;
     m_ConfigLabel = other.m_ConfigLabel;
     m_ConfigDescription = other.m_ConfigDescription;
+    m_ProgressiveLoading = other.m_ProgressiveLoading;
   }
   return *this;
 }
 
+void
+mitk::DICOMFileReader
+::SetProgressiveLoading(bool progressive)
+{
+  m_ProgressiveLoading = progressive;
+}
+
+bool
+mitk::DICOMFileReader
+::GetProgressiveLoading() const
+{
+  return m_ProgressiveLoading;
+}
+
 void
 mitk::DICOMFileReader
 ::SetConfigurationLabel(const std::string& label)
@@ -18,6 +18,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDICOMEnums.h"
 #include "mitkDICOMGDCMImageFrameInfo.h"
 
+#include <mitkExceptionMacro.h>
+
 mitk::DICOMGDCMTagCache::DICOMGDCMTagCache()
 {
 }
@@ -86,23 +88,60 @@ mitk::DICOMDatasetAccessingImageFrameList mitk::DICOMGDCMTagCache::GetFrameInfoL
 
 void
 mitk::DICOMGDCMTagCache::InitCache(const std::set<DICOMTag>& scannedTags, const std::shared_ptr<gdcm::Scanner>& scanner, const StringList& inputFiles)
+{
+  this->InitCache(scannedTags, std::vector<std::shared_ptr<gdcm::Scanner>>(1, scanner), std::map<std::string, TagValueMap>(), inputFiles);
+}
+
+void
+mitk::DICOMGDCMTagCache::InitCache(const std::set<DICOMTag>& scannedTags,
+                                   const std::vector<std::shared_ptr<gdcm::Scanner>>& scanners,
+                                   const std::map<std::string, TagValueMap>& knownValues,
+                                   const StringList& inputFiles)
 {
   m_ScannedTags = scannedTags;
   m_InputFilenames = inputFiles;
-  m_Scanner = scanner;
+  m_Scanners = scanners;
+  m_Scanner = scanners.size() == 1 && knownValues.empty() ? scanners.front() : nullptr;
+  m_KnownValues.clear();
 
   m_ScanResult.clear();
   m_ScanResult.reserve(m_InputFilenames.size());
 
   for (auto inputIter = m_InputFilenames.cbegin(); inputIter != m_InputFilenames.cend(); ++inputIter)
   {
-    m_ScanResult.push_back(DICOMGDCMImageFrameInfo::New(DICOMImageFrameInfo::New(*inputIter, 0),
-      m_Scanner->GetMapping(inputIter->c_str())).GetPointer());
+    gdcm::Scanner::TagToValue mapping;
+
+    const auto known = knownValues.find(*inputIter);
+    if (known != knownValues.cend())
+    {
+      for (const auto& tagValue : known->second)
+      {
+        mapping[gdcm::Tag(tagValue.first.GetGroup(), tagValue.first.GetElement())] =
+          tagValue.second.m_IsNull ? nullptr : m_KnownValues.insert(tagValue.second.m_Value).first->c_str();
+      }
+    }
+    else
+    {
+      for (const auto& scanner : m_Scanners)
+      {
+        if (scanner->IsKey(inputIter->c_str()))
+        {
+          mapping = scanner->GetMapping(inputIter->c_str());
+          break;
+        }
+      }
+    }
+
+    m_ScanResult.push_back(DICOMGDCMImageFrameInfo::New(DICOMImageFrameInfo::New(*inputIter, 0), mapping).GetPointer());
   }
 }
 
 const gdcm::Scanner&
 mitk::DICOMGDCMTagCache::GetScanner() const
 {
+  if (!m_Scanner)
+  {
+    mitkThrow() << "DICOMGDCMTagCache::GetScanner() is not available, the cache was not created by a single scanner. Use GetTagValue() instead.";
+  }
   return *(this->m_Scanner);
 }
@@ -17,10 +17,202 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDICOMGDCMTagScanner.h"
 #include "mitkDICOMGDCMTagCache.h"
 #include "mitkDICOMGDCMImageFrameInfo.h"
+#include "mitkLogMacros.h"
 
 #include <gdcmScanner.h>
 
+#include <itkMultiThreader.h>
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+  /** Tag values of one file as stored in the persistent cache file */
+  struct PersistentCacheEntry
+  {
+    std::int64_t m_ModificationTime;
+    std::uint64_t m_Size;
+    std::set<mitk::DICOMTag> m_ScannedTags;
+    mitk::DICOMGDCMTagCache::TagValueMap m_Values;
+  };
+
+  typedef std::map<std::string, PersistentCacheEntry> PersistentCacheType;
+
+  const char* const PersistentCacheSignature = "MITK DICOM tag cache 2\n";
+
+  bool GetFileKey(const std::string& filename, std::int64_t& modificationTime, std::uint64_t& size)
+  {
+    if (!itksys::SystemTools::FileExists(filename.c_str(), true))
+    {
+      return false;
+    }
+    modificationTime = itksys::SystemTools::ModifiedTime(filename.c_str());
+    size = itksys::SystemTools::FileLength(filename.c_str());
+    return true;
+  }
+
+  // the cache file is a local helper, so values are stored in native byte order
+  template <typename T>
+  void WriteValue(std::ostream& stream, T value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  bool ReadValue(std::istream& stream, T& value)
+  {
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+  }
+
+  void WriteString(std::ostream& stream, const std::string& value)
+  {
+    WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(value.size()));
+    stream.write(value.data(), value.size());
+  }
+
+  bool ReadString(std::istream& stream, std::string& value)
+  {
+    std::uint32_t length = 0;
+    if (!ReadValue(stream, length))
+    {
+      return false;
+    }
+    value.resize(length);
+    return length == 0 || static_cast<bool>(stream.read(&value[0], length));
+  }
+
+  void WriteTag(std::ostream& stream, const mitk::DICOMTag& tag)
+  {
+    WriteValue<std::uint16_t>(stream, static_cast<std::uint16_t>(tag.GetGroup()));
+    WriteValue<std::uint16_t>(stream, static_cast<std::uint16_t>(tag.GetElement()));
+  }
+
+  bool ReadTag(std::istream& stream, mitk::DICOMTag& tag)
+  {
+    std::uint16_t group = 0;
+    std::uint16_t element = 0;
+    if (!ReadValue(stream, group) || !ReadValue(stream, element))
+    {
+      return false;
+    }
+    tag = mitk::DICOMTag(group, element);
+    return true;
+  }
+
+  PersistentCacheType ReadPersistentCache(const std::string& filename)
+  {
+    PersistentCacheType cache;
+
+    std::ifstream stream(filename.c_str(), std::ios::binary);
+    if (!stream.is_open())
+    {
+      return cache;
+    }
+
+    std::string signature(std::char_traits<char>::length(PersistentCacheSignature), '\0');
+    if (!stream.read(&signature[0], signature.size()) || signature != PersistentCacheSignature)
+    {
+      MITK_WARN << "Ignoring DICOM tag cache file of unknown format: " << filename;
+      return cache;
+    }
+
+    std::string path;
+    while (ReadString(stream, path))
+    {
+      PersistentCacheEntry entry;
+      std::uint32_t numberOfTags = 0;
+      std::uint32_t numberOfValues = 0;
+      bool valid = ReadValue(stream, entry.m_ModificationTime) && ReadValue(stream, entry.m_Size) &&
+                   ReadValue(stream, numberOfTags);
+
+      mitk::DICOMTag tag(0, 0);
+      for (std::uint32_t i = 0; valid && i < numberOfTags; ++i)
+      {
+        valid = ReadTag(stream, tag);
+        entry.m_ScannedTags.insert(tag);
+      }
+
+      valid = valid && ReadValue(stream, numberOfValues);
+      std::uint8_t isNull = 0;
+      mitk::DICOMGDCMTagCache::TagValue value;
+      for (std::uint32_t i = 0; valid && i < numberOfValues; ++i)
+      {
+        valid = ReadTag(stream, tag) && ReadValue(stream, isNull) && ReadString(stream, value.m_Value);
+        value.m_IsNull = isNull != 0;
+        entry.m_Values[tag] = value;
+      }
+
+      if (!valid)
+      {
+        MITK_WARN << "Ignoring corrupt DICOM tag cache file: " << filename;
+        return PersistentCacheType();
+      }
+
+      cache[path] = entry;
+    }
+
+    return cache;
+  }
+
+  void WritePersistentCache(const std::string& filename, const PersistentCacheType& cache)
+  {
+    // write to a temporary file first, so that a crash or a concurrent reader never sees a partial cache
+    const std::string temporaryFilename = filename + ".tmp";
+    {
+      std::ofstream stream(temporaryFilename.c_str(), std::ios::binary | std::ios::trunc);
+      if (!stream.is_open())
+      {
+        MITK_WARN << "Could not write DICOM tag cache file: " << filename;
+        return;
+      }
+
+      stream.write(PersistentCacheSignature, std::char_traits<char>::length(PersistentCacheSignature));
+      for (const auto& fileEntry : cache)
+      {
+        const PersistentCacheEntry& entry = fileEntry.second;
+        WriteString(stream, fileEntry.first);
+        WriteValue(stream, entry.m_ModificationTime);
+        WriteValue(stream, entry.m_Size);
+
+        WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(entry.m_ScannedTags.size()));
+        for (const auto& tag : entry.m_ScannedTags)
+        {
+          WriteTag(stream, tag);
+        }
+
+        WriteValue<std::uint32_t>(stream, static_cast<std::uint32_t>(entry.m_Values.size()));
+        for (const auto& tagValue : entry.m_Values)
+        {
+          WriteTag(stream, tagValue.first);
+          WriteValue<std::uint8_t>(stream, tagValue.second.m_IsNull ? 1 : 0);
+          WriteString(stream, tagValue.second.m_Value);
+        }
+      }
+
+      if (!stream.good())
+      {
+        MITK_WARN << "Could not write DICOM tag cache file: " << filename;
+        return;
+      }
+    }
+
+    itksys::SystemTools::RemoveFile(filename.c_str());
+    if (std::rename(temporaryFilename.c_str(), filename.c_str()) != 0)
+    {
+      MITK_WARN << "Could not write DICOM tag cache file: " << filename;
+      itksys::SystemTools::RemoveFile(temporaryFilename.c_str());
+    }
+  }
+}
+
 mitk::DICOMGDCMTagScanner::DICOMGDCMTagScanner()
+  : m_NumberOfThreads(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()),
+    m_NumberOfFilesFromPersistentCache(0)
 {
   m_GDCMScanner = std::make_shared<gdcm::Scanner>();
 }
@@ -94,15 +286,143 @@ void mitk::DICOMGDCMTagScanner::SetInputFiles( const StringList& filenames )
 }
 
 
+void mitk::DICOMGDCMTagScanner::SetNumberOfThreads(unsigned int numberOfThreads)
+{
+  m_NumberOfThreads = std::max(numberOfThreads, 1u);
+}
+
+unsigned int mitk::DICOMGDCMTagScanner::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
+void mitk::DICOMGDCMTagScanner::SetPersistentCacheFile(const std::string& filename)
+{
+  m_PersistentCacheFile = filename;
+}
+
+std::string mitk::DICOMGDCMTagScanner::GetPersistentCacheFile() const
+{
+  return m_PersistentCacheFile;
+}
+
+size_t mitk::DICOMGDCMTagScanner::GetNumberOfFilesFromPersistentCache() const
+{
+  return m_NumberOfFilesFromPersistentCache;
+}
+
+std::vector<std::shared_ptr<gdcm::Scanner>> mitk::DICOMGDCMTagScanner::ScanFiles(const StringList& filenames)
+{
+  const size_t numberOfThreads = std::min<size_t>(m_NumberOfThreads, filenames.size());
+
+  if (numberOfThreads <= 1)
+  {
+    m_GDCMScanner->Scan(filenames);
+    return std::vector<std::shared_ptr<gdcm::Scanner>>(1, m_GDCMScanner);
+  }
+
+  // contiguous parts of the file list, files of one series are often stored next to each other
+  std::vector<StringList> parts(numberOfThreads);
+  std::vector<std::shared_ptr<gdcm::Scanner>> scanners(numberOfThreads);
+  for (size_t i = 0; i < numberOfThreads; ++i)
+  {
+    parts[i].assign(filenames.cbegin() + filenames.size() * i / numberOfThreads,
+                    filenames.cbegin() + filenames.size() * (i + 1) / numberOfThreads);
+
+    scanners[i] = std::make_shared<gdcm::Scanner>();
+    for (const auto& tag : m_ScannedTags)
+    {
+      scanners[i]->AddTag(gdcm::Tag(tag.GetGroup(), tag.GetElement()));
+    }
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < numberOfThreads; ++i)
+  {
+    threads.emplace_back([&parts, &scanners, i]() { scanners[i]->Scan(parts[i]); });
+  }
+  scanners[0]->Scan(parts[0]);
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  return scanners;
+}
+
 void mitk::DICOMGDCMTagScanner::Scan()
 {
   // TODO integrate push/pop locale??
-  m_GDCMScanner->Scan( m_InputFilenames );
+  PersistentCacheType persistentCache;
+  std::map<std::string, DICOMGDCMTagCache::TagValueMap> knownValues;
+  StringList filesToScan;
+
+  if (m_PersistentCacheFile.empty())
+  {
+    filesToScan = m_InputFilenames;
+  }
+  else
+  {
+    persistentCache = ReadPersistentCache(m_PersistentCacheFile);
+
+    for (const auto& filename : m_InputFilenames)
+    {
+      std::int64_t modificationTime = 0;
+      std::uint64_t size = 0;
+      const auto entry = persistentCache.find(filename);
+      if (entry != persistentCache.cend() && GetFileKey(filename, modificationTime, size) &&
+          entry->second.m_ModificationTime == modificationTime && entry->second.m_Size == size &&
+          std::includes(entry->second.m_ScannedTags.cbegin(), entry->second.m_ScannedTags.cend(),
+                        m_ScannedTags.cbegin(), m_ScannedTags.cend()))
+      {
+        knownValues[filename] = entry->second.m_Values;
+      }
+      else
+      {
+        filesToScan.push_back(filename);
+      }
+    }
+  }
+  m_NumberOfFilesFromPersistentCache = knownValues.size();
+
+  std::vector<std::shared_ptr<gdcm::Scanner>> scanners;
+  if (!filesToScan.empty() || m_PersistentCacheFile.empty())
+  {
+    scanners = this->ScanFiles(filesToScan);
+  }
 
   DICOMGDCMTagCache::Pointer newCache = DICOMGDCMTagCache::New();
-  newCache->InitCache(m_ScannedTags, m_GDCMScanner, m_InputFilenames);
+  newCache->InitCache(m_ScannedTags, scanners, knownValues, m_InputFilenames);
 
   m_Cache = newCache;
+
+  if (!m_PersistentCacheFile.empty() && !filesToScan.empty())
+  {
+    for (const auto& scanner : scanners)
+    {
+      for (const auto& filename : filesToScan)
+      {
+        PersistentCacheEntry entry;
+        if (!scanner->IsKey(filename.c_str()) || !GetFileKey(filename, entry.m_ModificationTime, entry.m_Size))
+        {
+          continue;
+        }
+
+        entry.m_ScannedTags = m_ScannedTags;
+        const gdcm::Scanner::TagToValue& mapping = scanner->GetMapping(filename.c_str());
+        for (const auto& tagValue : mapping)
+        {
+          DICOMGDCMTagCache::TagValue& value = entry.m_Values[DICOMTag(tagValue.first.GetGroup(), tagValue.first.GetElement())];
+          value.m_IsNull = tagValue.second == nullptr;
+          value.m_Value = value.m_IsNull ? "" : tagValue.second;
+        }
+        persistentCache[filename] = entry;
+      }
+    }
+
+    WritePersistentCache(m_PersistentCacheFile, persistentCache);
+  }
 }
 
 mitk::DICOMTagCache::Pointer
@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define ENABLE_TIMING
 
 #include <itkTimeProbesCollectorBase.h>
+#include <itkMultiThreader.h>
 #include <gdcmUIDs.h>
 #include "mitkDICOMITKSeriesGDCMReader.h"
 #include "mitkITKDICOMSeriesReaderHelper.h"
@@ -25,6 +26,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDICOMTagBasedSorter.h"
 #include "mitkDICOMGDCMTagScanner.h"
 
+#include <algorithm>
+
 itk::MutexLock::Pointer mitk::DICOMITKSeriesGDCMReader::s_LocaleMutex = itk::MutexLock::New();
 
 
@@ -32,6 +35,8 @@ mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( unsigned int decimalPl
 : DICOMFileReader()
 , m_FixTiltByShearing( true )
 , m_SimpleVolumeReading( simpleVolumeImport )
+, m_NumberOfThreads( itk::MultiThreader::GetGlobalDefaultNumberOfThreads() )
+, m_LoadingTimeProbes( nullptr )
 , m_DecimalPlacesForOrientation( decimalPlacesForOrientation )
 , m_ExternalCache(false)
 {
@@ -42,6 +47,9 @@ mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( unsigned int decimalPl
 mitk::DICOMITKSeriesGDCMReader::DICOMITKSeriesGDCMReader( const DICOMITKSeriesGDCMReader& other )
 : DICOMFileReader( other )
 , m_FixTiltByShearing( false )
+, m_SimpleVolumeReading( other.m_SimpleVolumeReading )
+, m_NumberOfThreads( other.m_NumberOfThreads )
+, m_LoadingTimeProbes( nullptr )
 , m_SortingResultInProgress( other.m_SortingResultInProgress )
 , m_Sorter( other.m_Sorter )
 , m_EquiDistantBlocksSorter( other.m_EquiDistantBlocksSorter->Clone() )
@@ -65,6 +73,7 @@ mitk::DICOMITKSeriesGDCMReader& mitk::DICOMITKSeriesGDCMReader::
   {
     DICOMFileReader::operator                =( other );
     this->m_FixTiltByShearing                = other.m_FixTiltByShearing;
+    this->m_NumberOfThreads                  = other.m_NumberOfThreads;
     this->m_SortingResultInProgress          = other.m_SortingResultInProgress;
     this->m_Sorter                           = other.m_Sorter; // TODO should clone the list items
     this->m_EquiDistantBlocksSorter          = other.m_EquiDistantBlocksSorter->Clone();
@@ -112,6 +121,17 @@ bool mitk::DICOMITKSeriesGDCMReader::operator==( const DICOMFileReader& other )
   }
 }
 
+void mitk::DICOMITKSeriesGDCMReader::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  this->Modified();
+  m_NumberOfThreads = std::max( numberOfThreads, 1u );
+}
+
+unsigned int mitk::DICOMITKSeriesGDCMReader::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
 void mitk::DICOMITKSeriesGDCMReader::SetFixTiltByShearing( bool on )
 {
   this->Modified();
@@ -241,6 +261,7 @@ void mitk::DICOMITKSeriesGDCMReader::AnalyzeInputFiles()
 
     filescanner->SetInputFiles( inputFilenames );
     filescanner->AddTagPaths( this->GetTagsOfInterest() );
+    filescanner->SetNumberOfThreads( m_NumberOfThreads );
 
     PushLocale();
     filescanner->Scan();
@@ -424,13 +445,24 @@ mitk::ReaderImplementationLevel
 
 bool mitk::DICOMITKSeriesGDCMReader::LoadImages()
 {
+  itk::TimeProbesCollectorBase timer;
+  m_LoadingTimeProbes = &timer;
+
   bool success = true;
 
+  timeStart( "Loading images" );
   unsigned int numberOfOutputs = this->GetNumberOfOutputs();
   for ( unsigned int o = 0; o < numberOfOutputs; ++o )
   {
     success &= this->LoadMitkImageForOutput( o );
   }
+  timeStop( "Loading images" );
+
+  m_LoadingTimeProbes = nullptr;
+
+#if defined( MBILOG_ENABLE_DEBUG ) || defined( ENABLE_TIMING )
+  timer.Report( std::cout );
+#endif
 
   return success;
 }
@@ -451,11 +483,44 @@ bool mitk::DICOMITKSeriesGDCMReader::LoadMitkImageForImageBlockDescriptor(
   }
 
   mitk::ITKDICOMSeriesReaderHelper helper;
+  helper.SetNumberOfThreads( m_NumberOfThreads );
+  helper.SetTimeProbesCollector( m_LoadingTimeProbes );
   bool success( true );
   try
   {
-    mitk::Image::Pointer mitkImage = helper.Load( filenames, m_FixTiltByShearing && hasTilt, tiltInfo );
+    mitk::Image::Pointer mitkImage;
+
+    // tilted blocks must be resampled as a whole
+    if ( this->GetProgressiveLoading() && !( m_FixTiltByShearing && hasTilt ) )
+    {
+      unsigned int numberOfLoadedSlices = 0;
+      mitkImage = helper.LoadProgressively(
+        filenames,
+        [&block]( Image* image ) { block.SetMitkImage( image ); },
+        [&]( Image* image, unsigned int slice ) {
+          if ( slice < frames.size() )
+          {
+            block.SetSliceIsLoaded( slice, true );
+          }
+          // slices are reported again if decoding falls back to itk::ImageSeriesReader
+          numberOfLoadedSlices = std::min( numberOfLoadedSlices + 1, image->GetDimension( 2 ) );
+          this->InvokeEvent( DICOMSliceLoadedEvent( image, slice, numberOfLoadedSlices, image->GetDimension( 2 ) ) );
+        } );
+    }
+    else
+    {
+      mitkImage = helper.Load( filenames, m_FixTiltByShearing && hasTilt, tiltInfo );
+    }
+
     block.SetMitkImage( mitkImage );
+
+    if ( mitkImage.IsNotNull() )
+    {
+      for ( unsigned int index = 0; index < frames.size(); ++index )
+      {
+        block.SetSliceIsLoaded( index, true );
+      }
+    }
   }
   catch ( const std::exception& e )
   {
@@ -35,11 +35,262 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "dcmtk/dcmdata/dcvrda.h"
 
+#include <itkTimeProbesCollectorBase.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 
 const mitk::DICOMTag mitk::ITKDICOMSeriesReaderHelper::AcquisitionDateTag = mitk::DICOMTag( 0x0008, 0x0022 );
 const mitk::DICOMTag mitk::ITKDICOMSeriesReaderHelper::AcquisitionTimeTag = mitk::DICOMTag( 0x0008, 0x0032 );
 const mitk::DICOMTag mitk::ITKDICOMSeriesReaderHelper::TriggerTimeTag = mitk::DICOMTag( 0x0018, 0x1060 );
 
+namespace
+{
+  // multi-frame files or files with a different pixel type (e.g. due to rescaling) are left to
+  // itk::ImageSeriesReader, which converts pixels as needed
+  bool HasPixelLayout( const itk::ImageIOBase* io,
+                       itk::ImageIOBase::IOPixelType pixelType,
+                       itk::ImageIOBase::IOComponentType componentType,
+                       size_t bytesPerSlice )
+  {
+    return io->GetPixelType() == pixelType && io->GetComponentType() == componentType
+           && ( io->GetNumberOfDimensions() <= 2 || io->GetDimensions( 2 ) <= 1 )
+           && io->GetImageSizeInBytes() == bytesPerSlice;
+  }
+}
+
+mitk::ITKDICOMSeriesReaderHelper::ITKDICOMSeriesReaderHelper()
+  : m_NumberOfThreads( 1 ), m_TimeProbes( nullptr )
+{
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::SetNumberOfThreads( unsigned int numberOfThreads )
+{
+  m_NumberOfThreads = std::max( numberOfThreads, 1u );
+}
+
+unsigned int mitk::ITKDICOMSeriesReaderHelper::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::SetTimeProbesCollector( itk::TimeProbesCollectorBase* timeProbes )
+{
+  m_TimeProbes = timeProbes;
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::StartTimeProbe( const char* id ) const
+{
+  if ( m_TimeProbes != nullptr )
+  {
+    m_TimeProbes->Start( id );
+  }
+}
+
+void mitk::ITKDICOMSeriesReaderHelper::StopTimeProbe( const char* id ) const
+{
+  if ( m_TimeProbes != nullptr )
+  {
+    m_TimeProbes->Stop( id );
+  }
+}
+
+bool mitk::ITKDICOMSeriesReaderHelper::DecodeSlicesInParallel( const StringContainer& filenames,
+                                                               itk::ImageIOBase::IOPixelType pixelType,
+                                                               itk::ImageIOBase::IOComponentType componentType,
+                                                               size_t bytesPerSlice,
+                                                               char* buffer ) const
+{
+  const size_t numberOfThreads = std::min<size_t>( m_NumberOfThreads, filenames.size() );
+
+  // files are handed out one by one, decoding times of compressed frames vary a lot
+  std::atomic<size_t> nextFile( 0 );
+  std::atomic<bool> layoutMatches( true );
+  std::exception_ptr firstException;
+  std::mutex exceptionMutex;
+
+  auto decode = [&]() {
+    itk::GDCMImageIO::Pointer io = itk::GDCMImageIO::New();
+    for ( size_t i = nextFile++; i < filenames.size() && layoutMatches; i = nextFile++ )
+    {
+      try
+      {
+        io->SetFileName( filenames[i] );
+        io->ReadImageInformation();
+
+        if ( !HasPixelLayout( io, pixelType, componentType, bytesPerSlice ) )
+        {
+          layoutMatches = false;
+          break;
+        }
+
+        io->Read( buffer + i * bytesPerSlice );
+      }
+      catch ( ... )
+      {
+        std::lock_guard<std::mutex> lock( exceptionMutex );
+        if ( !firstException )
+        {
+          firstException = std::current_exception();
+        }
+        layoutMatches = false;
+        break;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for ( size_t t = 1; t < numberOfThreads; ++t )
+  {
+    threads.emplace_back( decode );
+  }
+  decode();
+
+  for ( auto& thread : threads )
+  {
+    thread.join();
+  }
+
+  if ( firstException )
+  {
+    std::rethrow_exception( firstException );
+  }
+
+  return layoutMatches;
+}
+
+bool mitk::ITKDICOMSeriesReaderHelper::DecodeSlicesProgressively(
+  const StringContainer& filenames,
+  itk::ImageIOBase::IOPixelType pixelType,
+  itk::ImageIOBase::IOComponentType componentType,
+  size_t bytesPerSlice,
+  const std::function<void( unsigned int, const char* )>& sliceDecoded ) const
+{
+  const unsigned int numberOfSlices = filenames.size();
+
+  // central slice first, then alternating towards both ends
+  std::vector<unsigned int> order;
+  order.reserve( numberOfSlices );
+  const unsigned int center = numberOfSlices / 2;
+  order.push_back( center );
+  for ( unsigned int distance = 1; order.size() < numberOfSlices; ++distance )
+  {
+    if ( center + distance < numberOfSlices )
+    {
+      order.push_back( center + distance );
+    }
+    if ( distance <= center )
+    {
+      order.push_back( center - distance );
+    }
+  }
+
+  std::atomic<size_t> nextSlice( 0 );
+  std::atomic<bool> abort( false );
+
+  // guarded by mutex
+  std::mutex mutex;
+  std::condition_variable sliceAvailable;
+  std::deque<std::pair<unsigned int, std::vector<char>>> decodedSlices;
+  size_t numberOfFinishedThreads = 0;
+  bool layoutMatches = true;
+  std::exception_ptr firstException;
+
+  auto decode = [&]() {
+    itk::GDCMImageIO::Pointer io = itk::GDCMImageIO::New();
+    for ( size_t i = nextSlice++; i < order.size() && !abort; i = nextSlice++ )
+    {
+      std::vector<char> buffer( bytesPerSlice );
+      try
+      {
+        io->SetFileName( filenames[order[i]] );
+        io->ReadImageInformation();
+        if ( !HasPixelLayout( io, pixelType, componentType, bytesPerSlice ) )
+        {
+          std::lock_guard<std::mutex> lock( mutex );
+          layoutMatches = false;
+          abort = true;
+          break;
+        }
+        io->Read( buffer.data() );
+      }
+      catch ( ... )
+      {
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( !firstException )
+        {
+          firstException = std::current_exception();
+        }
+        abort = true;
+        break;
+      }
+
+      std::lock_guard<std::mutex> lock( mutex );
+      decodedSlices.emplace_back( order[i], std::move( buffer ) );
+      sliceAvailable.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock( mutex );
+    ++numberOfFinishedThreads;
+    sliceAvailable.notify_one();
+  };
+
+  const size_t numberOfThreads = std::min<size_t>( m_NumberOfThreads, numberOfSlices );
+  std::vector<std::thread> threads;
+  for ( size_t t = 0; t < numberOfThreads; ++t )
+  {
+    threads.emplace_back( decode );
+  }
+
+  auto joinThreads = [&threads]() {
+    for ( auto& thread : threads )
+    {
+      thread.join();
+    }
+  };
+
+  // the slices are passed on in this thread, so that observers of the image need not care about threads
+  try
+  {
+    std::unique_lock<std::mutex> lock( mutex );
+    while ( true )
+    {
+      sliceAvailable.wait( lock, [&]() { return !decodedSlices.empty() || numberOfFinishedThreads == numberOfThreads; } );
+      if ( decodedSlices.empty() )
+      {
+        break;
+      }
+
+      const std::pair<unsigned int, std::vector<char>> decodedSlice = std::move( decodedSlices.front() );
+      decodedSlices.pop_front();
+
+      lock.unlock();
+      sliceDecoded( decodedSlice.first, decodedSlice.second.data() );
+      lock.lock();
+    }
+  }
+  catch ( ... )
+  {
+    abort = true;
+    joinThreads();
+    throw;
+  }
+
+  joinThreads();
+
+  if ( firstException )
+  {
+    std::rethrow_exception( firstException );
+  }
+
+  return layoutMatches;
+}
+
 #define switch3DCase( IOType, T ) \
   case IOType:                    \
     return LoadDICOMByITK<T>( filenames, correctTilt, tiltInfo, io );
@@ -125,6 +376,88 @@ mitk::Image::Pointer mitk::ITKDICOMSeriesReaderHelper::Load( const StringContain
   return nullptr;
 }
 
+#define switch3DProgressiveCase( IOType, T ) \
+  case IOType:                              \
+    return LoadDICOMByITKProgressively<T>( filenames, imageAllocated, sliceLoaded, io );
+
+mitk::Image::Pointer mitk::ITKDICOMSeriesReaderHelper::LoadProgressively( const StringContainer& filenames,
+                                                                          const ImageAllocatedCallback& imageAllocated,
+                                                                          const SliceLoadedCallback& sliceLoaded )
+{
+  if ( filenames.empty() )
+  {
+    MITK_DEBUG
+      << "Calling LoadDicomSeries with empty filename string container. Probably invalid application logic.";
+    return nullptr; // this is not actually an error but the result is very simple
+  }
+
+  typedef itk::GDCMImageIO DcmIoType;
+  DcmIoType::Pointer io = DcmIoType::New();
+
+  try
+  {
+    if ( io->CanReadFile( filenames.front().c_str() ) )
+    {
+      io->SetFileName( filenames.front().c_str() );
+      io->ReadImageInformation();
+
+      if ( io->GetPixelType() == itk::ImageIOBase::SCALAR )
+      {
+        switch ( io->GetComponentType() )
+        {
+          switch3DProgressiveCase( DcmIoType::UCHAR, unsigned char )
+          switch3DProgressiveCase( DcmIoType::CHAR, char )
+          switch3DProgressiveCase( DcmIoType::USHORT, unsigned short )
+          switch3DProgressiveCase( DcmIoType::SHORT, short )
+          switch3DProgressiveCase( DcmIoType::UINT, unsigned int )
+          switch3DProgressiveCase( DcmIoType::INT, int )
+          switch3DProgressiveCase( DcmIoType::ULONG, long unsigned int )
+          switch3DProgressiveCase( DcmIoType::LONG, long int )
+          switch3DProgressiveCase( DcmIoType::FLOAT, float )
+          switch3DProgressiveCase( DcmIoType::DOUBLE, double )
+          default:
+            MITK_ERROR << "Found unsupported DICOM scalar pixel type: (enum value) " << io->GetComponentType();
+        }
+      }
+      else if ( io->GetPixelType() == itk::ImageIOBase::RGB )
+      {
+        switch ( io->GetComponentType() )
+        {
+          switch3DProgressiveCase( DcmIoType::UCHAR, itk::RGBPixel<unsigned char> )
+          switch3DProgressiveCase( DcmIoType::CHAR, itk::RGBPixel<char> )
+          switch3DProgressiveCase( DcmIoType::USHORT, itk::RGBPixel<unsigned short> )
+          switch3DProgressiveCase( DcmIoType::SHORT, itk::RGBPixel<short> )
+          switch3DProgressiveCase( DcmIoType::UINT, itk::RGBPixel<unsigned int> )
+          switch3DProgressiveCase( DcmIoType::INT, itk::RGBPixel<int> )
+          switch3DProgressiveCase( DcmIoType::ULONG, itk::RGBPixel<long unsigned int> )
+          switch3DProgressiveCase( DcmIoType::LONG, itk::RGBPixel<long int> )
+          switch3DProgressiveCase( DcmIoType::FLOAT, itk::RGBPixel<float> )
+          switch3DProgressiveCase( DcmIoType::DOUBLE, itk::RGBPixel<double> )
+          default:
+            MITK_ERROR << "Found unsupported DICOM scalar pixel type: (enum value) " << io->GetComponentType();
+        }
+      }
+
+      MITK_ERROR << "Unsupported DICOM pixel type";
+      return nullptr;
+    }
+  }
+  catch ( const itk::MemoryAllocationError& e )
+  {
+    MITK_ERROR << "Out of memory. Cannot load DICOM series: " << e.what();
+  }
+  catch ( const std::exception& e )
+  {
+    MITK_ERROR << "Error encountered when loading DICOM series:" << e.what();
+  }
+  catch ( ... )
+  {
+    MITK_ERROR << "Unspecified error encountered when loading DICOM series.";
+  }
+
+  return nullptr;
+}
+
 #define switch3DnTCase( IOType, T ) \
   case IOType:                      \
     return LoadDICOMByITK3DnT<T>( filenamesLists, correctTilt, tiltInfo, io );
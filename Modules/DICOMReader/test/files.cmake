@@ -1,6 +1,9 @@
 set(MODULE_TESTS
   mitkDICOMReaderConfiguratorTest.cpp
   mitkDICOMDCMTKTagScannerTest.cpp
+  mitkDICOMGDCMTagScannerTest.cpp
+  mitkDICOMITKSeriesGDCMReaderParallelLoadingTest.cpp
+  mitkDICOMITKSeriesGDCMReaderProgressiveLoadingTest.cpp
   mitkDICOMSimpleVolumeImportTest.cpp
   mitkDICOMTagPathTest.cpp
   mitkDICOMPropertyTest.cpp
@@ -0,0 +1,183 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMGDCMTagCache.h"
+#include "mitkDICOMGDCMTagScanner.h"
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include "mitkIOUtil.h"
+
+#include <itksys/SystemTools.hxx>
+
+class mitkDICOMGDCMTagScannerTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDICOMGDCMTagScannerTestSuite);
+
+  MITK_TEST(ParallelScanning);
+  MITK_TEST(PersistentCache);
+  MITK_TEST(PersistentCacheKeepsMissingValues);
+  MITK_TEST(CacheProvidesTagValuesOfAllScans);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  mitk::StringList ctFiles;
+  mitk::StringList expectedUIDs;
+  mitk::DICOMTag instanceUID = mitk::DICOMTag(0x0008, 0x0018);
+  std::string tempDir;
+
+  mitk::DICOMGDCMTagScanner::Pointer Scan(unsigned int numberOfThreads, const std::string& cacheFile = "")
+  {
+    mitk::DICOMGDCMTagScanner::Pointer scanner = mitk::DICOMGDCMTagScanner::New();
+    scanner->SetInputFiles(ctFiles);
+    scanner->AddTag(instanceUID);
+    scanner->SetNumberOfThreads(numberOfThreads);
+    scanner->SetPersistentCacheFile(cacheFile);
+    scanner->Scan();
+    return scanner;
+  }
+
+  void CheckInstanceUIDs(mitk::DICOMGDCMTagScanner* scanner)
+  {
+    mitk::DICOMDatasetAccessingImageFrameList frames = scanner->GetFrameInfoList();
+    CPPUNIT_ASSERT_MESSAGE("Testing DICOMGDCMTagScanner::GetFrameInfoList()", frames.size() == 4);
+
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+      mitk::DICOMDatasetFinding finding = frames[i]->GetTagValueAsString(instanceUID).front();
+      CPPUNIT_ASSERT_MESSAGE("Testing validity of instance uid finding", finding.isValid);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Testing value of instance uid finding", expectedUIDs[i], finding.value);
+    }
+  }
+
+public:
+
+  void setUp() override
+  {
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/100"));
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/101"));
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/102"));
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/104"));
+
+    expectedUIDs.push_back("1.2.276.0.99.1.4.8323329.3795.1303917947.940051");
+    expectedUIDs.push_back("1.2.276.0.99.1.4.8323329.3795.1303917947.940052");
+    expectedUIDs.push_back("1.2.276.0.99.1.4.8323329.3795.1303917947.940053");
+    expectedUIDs.push_back("1.2.276.0.99.1.4.8323329.3795.1303917947.940055");
+
+    tempDir = mitk::IOUtil::CreateTemporaryDirectory("mitkDICOMGDCMTagScannerTest_XXXXXX");
+  }
+
+  void tearDown() override
+  {
+    itksys::SystemTools::RemoveADirectory(tempDir.c_str());
+  }
+
+  void ParallelScanning()
+  {
+    this->CheckInstanceUIDs(this->Scan(1));
+    this->CheckInstanceUIDs(this->Scan(4));
+    // more threads than files
+    this->CheckInstanceUIDs(this->Scan(16));
+  }
+
+  void PersistentCache()
+  {
+    const std::string cacheFile = tempDir + "/tags.cache";
+
+    mitk::DICOMGDCMTagScanner::Pointer scanner = this->Scan(4, cacheFile);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("First scan reads all files", size_t(0), scanner->GetNumberOfFilesFromPersistentCache());
+    this->CheckInstanceUIDs(scanner);
+    CPPUNIT_ASSERT_MESSAGE("Cache file is written", itksys::SystemTools::FileExists(cacheFile.c_str(), true));
+
+    scanner = this->Scan(4, cacheFile);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Second scan uses the cache", size_t(4), scanner->GetNumberOfFilesFromPersistentCache());
+    this->CheckInstanceUIDs(scanner);
+
+    // files have not been scanned for the additional tag yet
+    scanner = mitk::DICOMGDCMTagScanner::New();
+    scanner->SetInputFiles(ctFiles);
+    scanner->AddTag(instanceUID);
+    scanner->AddTag(mitk::DICOMTag(0x0020, 0x0013));
+    scanner->SetPersistentCacheFile(cacheFile);
+    scanner->Scan();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Additional tags are scanned", size_t(0), scanner->GetNumberOfFilesFromPersistentCache());
+    this->CheckInstanceUIDs(scanner);
+  }
+
+  void PersistentCacheKeepsMissingValues()
+  {
+    const std::string cacheFile = tempDir + "/tags.cache";
+    // a private tag that the test files don't contain
+    const mitk::DICOMTag missingTag(0x0009, 0x1001);
+
+    std::vector<mitk::DICOMDatasetAccessingImageFrameList> frameLists;
+    for (int i = 0; i < 2; ++i)
+    {
+      mitk::DICOMGDCMTagScanner::Pointer scanner = mitk::DICOMGDCMTagScanner::New();
+      scanner->SetInputFiles(ctFiles);
+      scanner->AddTag(instanceUID);
+      scanner->AddTag(missingTag);
+      scanner->SetPersistentCacheFile(cacheFile);
+      scanner->Scan();
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Only the second scan uses the cache", size_t(i * 4), scanner->GetNumberOfFilesFromPersistentCache());
+      frameLists.push_back(scanner->GetFrameInfoList());
+    }
+
+    for (size_t i = 0; i < frameLists[0].size(); ++i)
+    {
+      mitk::DICOMDatasetFinding scanned = frameLists[0][i]->GetTagValueAsString(missingTag).front();
+      mitk::DICOMDatasetFinding cached = frameLists[1][i]->GetTagValueAsString(missingTag).front();
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Cached and scanned findings of a missing tag are equally valid", scanned.isValid, cached.isValid);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Cached and scanned values of a missing tag are equal", scanned.value, cached.value);
+    }
+  }
+
+  mitk::DICOMGDCMTagCache::Pointer GetGDCMTagCache(mitk::DICOMGDCMTagScanner* scanner)
+  {
+    mitk::DICOMGDCMTagCache::Pointer cache = dynamic_cast<mitk::DICOMGDCMTagCache*>(scanner->GetScanCache().GetPointer());
+    CPPUNIT_ASSERT_MESSAGE("Scan cache is a DICOMGDCMTagCache", cache.IsNotNull());
+    return cache;
+  }
+
+  void CheckCachedInstanceUIDs(mitk::DICOMGDCMTagCache* cache)
+  {
+    for (size_t i = 0; i < ctFiles.size(); ++i)
+    {
+      mitk::DICOMImageFrameInfo::Pointer frame = mitk::DICOMImageFrameInfo::New(ctFiles[i], 0);
+      mitk::DICOMDatasetFinding finding = cache->GetTagValue(frame, instanceUID);
+      CPPUNIT_ASSERT_MESSAGE("Testing validity of cached instance uid finding", finding.isValid);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Testing value of cached instance uid finding", expectedUIDs[i], finding.value);
+    }
+  }
+
+  void CacheProvidesTagValuesOfAllScans()
+  {
+    const std::string cacheFile = tempDir + "/tags.cache";
+
+    // single threaded scan, parallel scan and scan from the persistent cache
+    this->CheckCachedInstanceUIDs(this->GetGDCMTagCache(this->Scan(1)));
+    this->CheckCachedInstanceUIDs(this->GetGDCMTagCache(this->Scan(4)));
+
+    this->Scan(1, cacheFile);
+    this->CheckCachedInstanceUIDs(this->GetGDCMTagCache(this->Scan(1, cacheFile)));
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDICOMGDCMTagScanner)
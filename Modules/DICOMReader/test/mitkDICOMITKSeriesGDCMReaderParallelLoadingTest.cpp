@@ -0,0 +1,74 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMITKSeriesGDCMReader.h"
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+class mitkDICOMITKSeriesGDCMReaderParallelLoadingTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDICOMITKSeriesGDCMReaderParallelLoadingTestSuite);
+
+  MITK_TEST(ParallelDecodingEqualsSequentialDecoding);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  mitk::StringList ctFiles;
+
+  mitk::DICOMITKSeriesGDCMReader::Pointer Load(unsigned int numberOfThreads)
+  {
+    mitk::DICOMITKSeriesGDCMReader::Pointer reader = mitk::DICOMITKSeriesGDCMReader::New();
+    reader->SetNumberOfThreads(numberOfThreads);
+    reader->SetInputFiles(ctFiles);
+    reader->AnalyzeInputFiles();
+    CPPUNIT_ASSERT_MESSAGE("Testing DICOMITKSeriesGDCMReader::LoadImages()", reader->LoadImages());
+    return reader;
+  }
+
+public:
+
+  void setUp() override
+  {
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/100"));
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/101"));
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/102"));
+  }
+
+  void tearDown() override
+  {
+  }
+
+  void ParallelDecodingEqualsSequentialDecoding()
+  {
+    mitk::DICOMITKSeriesGDCMReader::Pointer sequential = this->Load(1);
+    mitk::DICOMITKSeriesGDCMReader::Pointer parallel = this->Load(4);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of blocks", sequential->GetNumberOfOutputs(), parallel->GetNumberOfOutputs());
+    for (unsigned int o = 0; o < sequential->GetNumberOfOutputs(); ++o)
+    {
+      mitk::Image::Pointer expected = sequential->GetOutput(o).GetMitkImage();
+      mitk::Image::Pointer actual = parallel->GetOutput(o).GetMitkImage();
+      CPPUNIT_ASSERT_MESSAGE("Image is loaded", actual.IsNotNull());
+      CPPUNIT_ASSERT_MESSAGE("Parallel decoding yields the same image", mitk::Equal(*expected, *actual, mitk::eps, true));
+    }
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDICOMITKSeriesGDCMReaderParallelLoading)
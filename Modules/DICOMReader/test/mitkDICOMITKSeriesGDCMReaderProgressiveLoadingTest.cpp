@@ -0,0 +1,121 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMITKSeriesGDCMReader.h"
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <itkCommand.h>
+
+#include <vector>
+
+class mitkDICOMITKSeriesGDCMReaderProgressiveLoadingTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkDICOMITKSeriesGDCMReaderProgressiveLoadingTestSuite);
+
+  MITK_TEST(ProgressiveLoadingEqualsLoadingAsAWhole);
+  MITK_TEST(ProgressiveLoadingStartsWithCentralSlice);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  /** Remembers the reported slices and whether the image had the slice set at that time */
+  struct ReportedSlices
+  {
+    std::vector<unsigned int> slices;
+    bool allSlicesSetWhenReported = true;
+  };
+
+  mitk::StringList ctFiles;
+
+  static void OnSliceLoaded(itk::Object*, const itk::EventObject& event, void* clientData)
+  {
+    const mitk::DICOMSliceLoadedEvent* sliceLoadedEvent = dynamic_cast<const mitk::DICOMSliceLoadedEvent*>(&event);
+    ReportedSlices* reported = static_cast<ReportedSlices*>(clientData);
+    reported->slices.push_back(sliceLoadedEvent->GetSlice());
+    reported->allSlicesSetWhenReported &= sliceLoadedEvent->GetImage()->IsSliceSet(sliceLoadedEvent->GetSlice());
+  }
+
+  mitk::DICOMITKSeriesGDCMReader::Pointer Load(bool progressive, ReportedSlices* reported = nullptr)
+  {
+    mitk::DICOMITKSeriesGDCMReader::Pointer reader = mitk::DICOMITKSeriesGDCMReader::New();
+    reader->SetProgressiveLoading(progressive);
+    reader->SetInputFiles(ctFiles);
+    reader->AnalyzeInputFiles();
+
+    if (reported != nullptr)
+    {
+      itk::CStyleCommand::Pointer command = itk::CStyleCommand::New();
+      command->SetClientData(reported);
+      command->SetCallback(&OnSliceLoaded);
+      reader->AddObserver(mitk::DICOMSliceLoadedEvent(), command);
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Testing DICOMITKSeriesGDCMReader::LoadImages()", reader->LoadImages());
+    return reader;
+  }
+
+public:
+
+  void setUp() override
+  {
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/100"));
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/101"));
+    ctFiles.push_back(GetTestDataFilePath("TinyCTAbdomen/102"));
+  }
+
+  void tearDown() override
+  {
+  }
+
+  void ProgressiveLoadingEqualsLoadingAsAWhole()
+  {
+    mitk::DICOMITKSeriesGDCMReader::Pointer whole = this->Load(false);
+    mitk::DICOMITKSeriesGDCMReader::Pointer progressive = this->Load(true);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of blocks", whole->GetNumberOfOutputs(), progressive->GetNumberOfOutputs());
+    for (unsigned int o = 0; o < whole->GetNumberOfOutputs(); ++o)
+    {
+      mitk::Image::Pointer actual = progressive->GetOutput(o).GetMitkImage();
+      CPPUNIT_ASSERT_MESSAGE("Image is loaded", actual.IsNotNull());
+      CPPUNIT_ASSERT_MESSAGE("Image is complete", actual->IsVolumeSet());
+      CPPUNIT_ASSERT_MESSAGE("All slices are marked as loaded", progressive->GetOutput(o).AllSlicesAreLoaded());
+      CPPUNIT_ASSERT_MESSAGE("Progressive loading yields the same image",
+                             mitk::Equal(*whole->GetOutput(o).GetMitkImage(), *actual, mitk::eps, true));
+    }
+  }
+
+  void ProgressiveLoadingStartsWithCentralSlice()
+  {
+    ReportedSlices reported;
+    mitk::DICOMITKSeriesGDCMReader::Pointer reader = this->Load(true, &reported);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of blocks", 1u, reader->GetNumberOfOutputs());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Every slice is reported", ctFiles.size(), reported.slices.size());
+    CPPUNIT_ASSERT_MESSAGE("Slices are set when they are reported", reported.allSlicesSetWhenReported);
+
+    // with one thread the order of decoding is the order of reporting
+    reader->SetNumberOfThreads(1);
+    reported = ReportedSlices();
+    reader->LoadImages();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Central slice comes first", 1u, reported.slices.front());
+  }
+
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkDICOMITKSeriesGDCMReaderProgressiveLoading)
@@ -34,6 +34,7 @@ namespace itk {
 template< class TPixelType >
 DftImageFilter< TPixelType >
 ::DftImageFilter()
+    : m_UseSeparableDft(true)
 {
     this->SetNumberOfRequiredInputs( 1 );
 }
@@ -42,7 +43,47 @@ template< class TPixelType >
 void DftImageFilter< TPixelType >
 ::BeforeThreadedGenerateData()
 {
+    m_TransformedY.clear();
+    m_TwiddlesX.clear();
+    if (!m_UseSeparableDft)
+        return;
 
+    typename OutputImageType::Pointer outputImage = static_cast< OutputImageType * >(this->ProcessObject::GetOutput(0));
+    typename InputImageType::Pointer inputImage  = static_cast< InputImageType * >( this->ProcessObject::GetInput(0) );
+
+    int szx = outputImage->GetLargestPossibleRegion().GetSize(0);
+    int szy = outputImage->GetLargestPossibleRegion().GetSize(1);
+    int yOffset = (szy%2==1) ? (szy-1)/2 : szy/2;
+
+    // k and x are integers, so all phases are multiples of 2pi/sz
+    std::vector< vcl_complex<double> > twiddlesY(szy);
+    for (int m=0; m<szy; m++)
+        twiddlesY[m] = exp( std::complex<double>(0, -2 * M_PI * (double)m/szy) );
+    m_TwiddlesX.resize(szx);
+    for (int m=0; m<szx; m++)
+        m_TwiddlesX[m] = exp( std::complex<double>(0, -2 * M_PI * (double)m/szx) );
+
+    m_TransformedY.assign(szy*szx, vcl_complex<double>(0,0));
+    for (int ky=0; ky<szy; ky++)
+    {
+        vcl_complex<double>* row = &m_TransformedY[ky*szx];
+        for (int y=0; y<szy; y++)
+        {
+            int phase = ((ky-yOffset)*(y-yOffset))%szy;
+            if (phase<0)
+                phase += szy;
+            const vcl_complex<double> twiddle = twiddlesY[phase];
+
+            typename InputImageType::IndexType index;
+            index[1] = y;
+            for (int x=0; x<szx; x++)
+            {
+                index[0] = x;
+                const typename InputImageType::PixelType& pix = inputImage->GetPixel(index);
+                row[x] += vcl_complex<double>(pix.real(), pix.imag()) * twiddle;
+            }
+        }
+    }
 }
 
 template< class TPixelType >
@@ -59,6 +100,30 @@ void DftImageFilter< TPixelType >
     int szx = outputImage->GetLargestPossibleRegion().GetSize(0);
     int szy = outputImage->GetLargestPossibleRegion().GetSize(1);
 
+    if (m_UseSeparableDft)
+    {
+        int xOffset = (szx%2==1) ? (szx-1)/2 : szx/2;
+        int yOffset = (szy%2==1) ? (szy-1)/2 : szy/2;
+        while( !oit.IsAtEnd() )
+        {
+            int kx = oit.GetIndex()[0] - xOffset;
+            const vcl_complex<double>* row = &m_TransformedY[oit.GetIndex()[1]*szx];
+
+            vcl_complex<double> s(0,0);
+            for (int x=0; x<szx; x++)
+            {
+                int phase = (kx*(x-xOffset))%szx;
+                if (phase<0)
+                    phase += szx;
+                s += row[x] * m_TwiddlesX[phase];
+            }
+
+            oit.Set(s);
+            ++oit;
+        }
+        return;
+    }
+
     while( !oit.IsAtEnd() )
     {
         double kx = oit.GetIndex()[0];
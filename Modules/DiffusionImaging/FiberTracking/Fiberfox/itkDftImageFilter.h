@@ -26,12 +26,16 @@ This file is based heavily on a corresponding ITK filter.
 #include <itkImageToImageFilter.h>
 #include <itkDiffusionTensor3D.h>
 #include <vcl_complex.h>
+#include <vector>
 #include <mitkFiberfoxParameters.h>
 
 namespace itk{
 
 /**
-* \brief 2D Discrete Fourier Transform Filter (complex to real). Special issue for Fiberfox -> rearranges slice. */
+* \brief 2D Discrete Fourier Transform Filter (complex to real). Special issue for Fiberfox -> rearranges slice.
+*
+* The transformation is separated into y- and x-direction using a precomputed table of twiddle factors,
+* so that each output pixel only sums over one image row instead of the whole image. */
 
 template< class TPixelType >
 class DftImageFilter :
@@ -59,6 +63,9 @@ public:
 
     void SetParameters( FiberfoxParameters<double> param ){ m_Parameters = param; }
 
+    itkSetMacro( UseSeparableDft, bool )    ///< Use the separable transformation (default). Otherwise the direct DFT is used.
+    itkGetMacro( UseSeparableDft, bool )
+
 protected:
     DftImageFilter();
     ~DftImageFilter() {}
@@ -69,6 +76,9 @@ protected:
 private:
 
     FiberfoxParameters<double>          m_Parameters;
+    bool                                m_UseSeparableDft;
+    std::vector< vcl_complex<double> >  m_TwiddlesX;        ///< exp(-i2pi*m/szx)
+    std::vector< vcl_complex<double> >  m_TransformedY;     ///< input transformed along y-direction, ky rows of x columns
 };
 
 }
@@ -41,6 +41,8 @@ namespace itk {
     , m_UseConstantRandSeed(false)
     , m_SpikesPerSlice(0)
     , m_IsBaseline(true)
+    , m_UseSeparableDft(true)
+    , m_DoSeparableDft(false)
   {
     m_DiffusionGradientDirection.Fill(0.0);
 
@@ -125,6 +127,93 @@ namespace itk {
     }
 
     m_ReadoutScheme->AdjustEchoTime();
+
+    // off-resonance effects couple the position with the readout time and can not be separated
+    bool eddyCurrents = m_Parameters->m_SignalGen.m_EddyStrength>0 && m_Parameters->m_Misc.m_CheckAddEddyCurrentsBox && !m_IsBaseline;
+    m_DoSeparableDft = m_UseSeparableDft && !eddyCurrents && m_Parameters->m_SignalGen.m_FrequencyMap.IsNull();
+    if (m_DoSeparableDft)
+      PrepareSeparableDft();
+  }
+
+  template< class TPixelType >
+  void KspaceImageFilter< TPixelType >::PrepareSeparableDft()
+  {
+    int kxMax = m_Parameters->m_SignalGen.m_CroppedRegion.GetSize(0);
+    int kyMax = m_Parameters->m_SignalGen.m_CroppedRegion.GetSize(1);
+    int xMax = m_CompartmentImages.at(0)->GetLargestPossibleRegion().GetSize(0);
+    int yMax = m_CompartmentImages.at(0)->GetLargestPossibleRegion().GetSize(1);
+    double yMaxFov = yMax*m_Parameters->m_SignalGen.m_CroppingFactor;
+
+    // same shifts (0 -- N) --> (-N/2 -- N/2) as in the direct DFT
+    std::vector< double > kx(kxMax), ky(kyMax), x(xMax), y(yMax);
+    for (int i=0; i<kxMax; i++)
+      kx[i] = i - (kxMax%2==1 ? (kxMax-1)/2.0 : kxMax/2.0);
+    for (int i=0; i<kyMax; i++)
+      ky[i] = i - (kyMax%2==1 ? (kyMax-1)/2.0 : kyMax/2.0);
+    for (int i=0; i<xMax; i++)
+      x[i] = i - (xMax%2==1 ? (xMax-1)/2.0 : xMax/2.0);
+    for (int i=0; i<yMax; i++)
+      y[i] = i - (yMax%2==1 ? (yMax-1)/2.0 : yMax/2.0);
+
+    // signal weights of each compartment without relaxation, coil sensitivity is evaluated once per pixel
+    std::vector< double > weights(xMax*yMax, m_Parameters->m_SignalGen.m_SignalScale);
+    if (m_Parameters->m_SignalGen.m_CoilSensitivityProfile!=SignalGenerationParameters::COIL_CONSTANT)
+    {
+      for (int j=0; j<yMax; j++)
+        for (int i=0; i<xMax; i++)
+        {
+          DoubleVectorType pos; pos[0] = x[i]; pos[1] = y[j]; pos[2] = m_Z;
+          pos = m_Transform*pos/1000;
+          weights[j*xMax+i] *= CoilSensitivity(pos);
+        }
+    }
+
+    // phase encoding twiddles exp(i2pi*ky*y/yMaxFov), signal from outside the FOV is wrapped around
+    std::vector< vcl_complex<double> > phaseTwiddles(kyMax*yMax);
+    for (int j=0; j<yMax; j++)
+    {
+      double yWrapped = y[j];
+      if (yWrapped<-yMaxFov/2){ yWrapped += yMaxFov; }
+      else if (yWrapped>=yMaxFov/2) { yWrapped -= yMaxFov; }
+
+      for (int k=0; k<kyMax; k++)
+        phaseTwiddles[k*yMax+j] = exp( std::complex<double>(0, 2 * M_PI * ky[k]*yWrapped/yMaxFov) );
+    }
+
+    // the relaxation factors depend on the readout time, so the compartments can only be summed up front without relaxation
+    unsigned int numTransforms = m_Parameters->m_SignalGen.m_DoSimulateRelaxation ? m_CompartmentImages.size() : 1;
+    m_PhaseEncodedImages.assign(numTransforms, std::vector< vcl_complex<double> >(kyMax*xMax, vcl_complex<double>(0,0)));
+    std::vector< double > signal(xMax*yMax);
+    for (unsigned int c=0; c<m_CompartmentImages.size(); c++)
+    {
+      const double* buffer = m_CompartmentImages.at(c)->GetBufferPointer();
+      for (int p=0; p<xMax*yMax; p++)
+        signal[p] = buffer[p]*weights[p];
+
+      std::vector< vcl_complex<double> >& transform = m_PhaseEncodedImages.at(numTransforms>1 ? c : 0);
+      for (int k=0; k<kyMax; k++)
+      {
+        vcl_complex<double>* row = &transform[k*xMax];
+        for (int j=0; j<yMax; j++)
+        {
+          const vcl_complex<double> twiddle = phaseTwiddles[k*yMax+j];
+          const double* line = &signal[j*xMax];
+          for (int i=0; i<xMax; i++)
+            row[i] += line[i]*twiddle;
+        }
+      }
+    }
+
+    // readout twiddles exp(i2pi*kx*x/xMax) including the gradient delay induced offset of even and odd lines
+    double lineOffset = m_Parameters->m_SignalGen.m_KspaceLineOffset;
+    for (int l=0; l<2; l++)
+    {
+      m_ReadoutTwiddles[l].resize(kxMax*xMax);
+      double offset = l==0 ? lineOffset : -lineOffset;
+      for (int k=0; k<kxMax; k++)
+        for (int i=0; i<xMax; i++)
+          m_ReadoutTwiddles[l][k*xMax+i] = exp( std::complex<double>(0, 2 * M_PI * (kx[k]+offset)*x[i]/xMax) );
+    }
   }
 
   template< class TPixelType >
@@ -250,65 +339,85 @@ namespace itk {
         }
 
         vcl_complex<double> s(0,0);
-        InputIteratorType it(m_CompartmentImages.at(0), m_CompartmentImages.at(0)->GetLargestPossibleRegion() );
-        while( !it.IsAtEnd() )
+        if (m_DoSeparableDft)
         {
-          double x = it.GetIndex()[0];
-          double y = it.GetIndex()[1];
-          if ((int)xMax%2==1){ x -= (xMax-1)/2; }
-          else{ x -= xMax/2; }
-          if ((int)yMax%2==1){ y -= (yMax-1)/2; }
-          else{ y -= yMax/2; }
-
-          DoubleVectorType pos; pos[0] = x; pos[1] = y; pos[2] = m_Z;
-          pos = m_Transform*pos/1000;   // vector from image center to current position (in meter)
-
-          vcl_complex<double> f(0, 0);
-
-          // sum compartment signals and simulate relaxation
-          for (unsigned int i=0; i<m_CompartmentImages.size(); i++)
-            if ( m_Parameters->m_SignalGen.m_DoSimulateRelaxation)
-              f += std::complex<double>( m_CompartmentImages.at(i)->GetPixel(it.GetIndex()) * relaxFactor.at(i) *  m_Parameters->m_SignalGen.m_SignalScale, 0);
-            else
-              f += std::complex<double>( m_CompartmentImages.at(i)->GetPixel(it.GetIndex()) *  m_Parameters->m_SignalGen.m_SignalScale );
-
-          if (m_Parameters->m_SignalGen.m_CoilSensitivityProfile!=SignalGenerationParameters::COIL_CONSTANT)
-            f *= CoilSensitivity(pos);
-
-          // simulate eddy currents and other distortions
-          double omega = 0;   // frequency offset
-          if (  m_Parameters->m_SignalGen.m_EddyStrength>0 && m_Parameters->m_Misc.m_CheckAddEddyCurrentsBox && !m_IsBaseline)
+          // remaining readout direction of the transformation, see PrepareSeparableDft()
+          int xPixels = static_cast<int>(xMax);
+          const vcl_complex<double>* twiddles = &m_ReadoutTwiddles[oit.GetIndex()[1]%2][kIdx[0]*xPixels];
+          for (unsigned int c=0; c<m_PhaseEncodedImages.size(); c++)
           {
-            omega += (m_DiffusionGradientDirection[0]*pos[0]+m_DiffusionGradientDirection[1]*pos[1]+m_DiffusionGradientDirection[2]*pos[2]) * eddyDecay;
+            const vcl_complex<double>* row = &m_PhaseEncodedImages[c][kIdx[1]*xPixels];
+            vcl_complex<double> sc(0,0);
+            for (int i=0; i<xPixels; i++)
+              sc += row[i]*twiddles[i];
+
+            if (m_Parameters->m_SignalGen.m_DoSimulateRelaxation)
+              sc *= relaxFactor.at(c);
+            s += sc;
           }
-
-          if (m_Parameters->m_SignalGen.m_FrequencyMap.IsNotNull()) // simulate distortions
+        }
+        else
+        {
+          InputIteratorType it(m_CompartmentImages.at(0), m_CompartmentImages.at(0)->GetLargestPossibleRegion() );
+          while( !it.IsAtEnd() )
           {
-            itk::Point<double, 3> point3D;
-            ItkDoubleImgType::IndexType index; index[0] = it.GetIndex()[0]; index[1] = it.GetIndex()[1]; index[2] = m_Zidx;
-            if (m_Parameters->m_SignalGen.m_DoAddMotion)    // we have to account for the head motion since this also moves our frequency map
+            double x = it.GetIndex()[0];
+            double y = it.GetIndex()[1];
+            if ((int)xMax%2==1){ x -= (xMax-1)/2; }
+            else{ x -= xMax/2; }
+            if ((int)yMax%2==1){ y -= (yMax-1)/2; }
+            else{ y -= yMax/2; }
+
+            DoubleVectorType pos; pos[0] = x; pos[1] = y; pos[2] = m_Z;
+            pos = m_Transform*pos/1000;   // vector from image center to current position (in meter)
+
+            vcl_complex<double> f(0, 0);
+
+            // sum compartment signals and simulate relaxation
+            for (unsigned int i=0; i<m_CompartmentImages.size(); i++)
+              if ( m_Parameters->m_SignalGen.m_DoSimulateRelaxation)
+                f += std::complex<double>( m_CompartmentImages.at(i)->GetPixel(it.GetIndex()) * relaxFactor.at(i) *  m_Parameters->m_SignalGen.m_SignalScale, 0);
+              else
+                f += std::complex<double>( m_CompartmentImages.at(i)->GetPixel(it.GetIndex()) *  m_Parameters->m_SignalGen.m_SignalScale );
+
+            if (m_Parameters->m_SignalGen.m_CoilSensitivityProfile!=SignalGenerationParameters::COIL_CONSTANT)
+              f *= CoilSensitivity(pos);
+
+            // simulate eddy currents and other distortions
+            double omega = 0;   // frequency offset
+            if (  m_Parameters->m_SignalGen.m_EddyStrength>0 && m_Parameters->m_Misc.m_CheckAddEddyCurrentsBox && !m_IsBaseline)
             {
-              m_Parameters->m_SignalGen.m_FrequencyMap->TransformIndexToPhysicalPoint(index, point3D);
-              point3D = m_FiberBundle->TransformPoint( point3D.GetVnlVector(),
-                                                       -m_Rotation[0], -m_Rotation[1], -m_Rotation[2],
-                                                       -m_Translation[0], -m_Translation[1], -m_Translation[2] );
-              omega += InterpolateFmapValue(point3D);
+              omega += (m_DiffusionGradientDirection[0]*pos[0]+m_DiffusionGradientDirection[1]*pos[1]+m_DiffusionGradientDirection[2]*pos[2]) * eddyDecay;
             }
-            else
-            {
-              omega += m_Parameters->m_SignalGen.m_FrequencyMap->GetPixel(index);
 
+            if (m_Parameters->m_SignalGen.m_FrequencyMap.IsNotNull()) // simulate distortions
+            {
+              itk::Point<double, 3> point3D;
+              ItkDoubleImgType::IndexType index; index[0] = it.GetIndex()[0]; index[1] = it.GetIndex()[1]; index[2] = m_Zidx;
+              if (m_Parameters->m_SignalGen.m_DoAddMotion)    // we have to account for the head motion since this also moves our frequency map
+              {
+                m_Parameters->m_SignalGen.m_FrequencyMap->TransformIndexToPhysicalPoint(index, point3D);
+                point3D = m_FiberBundle->TransformPoint( point3D.GetVnlVector(),
+                                                         -m_Rotation[0], -m_Rotation[1], -m_Rotation[2],
+                                                         -m_Translation[0], -m_Translation[1], -m_Translation[2] );
+                omega += InterpolateFmapValue(point3D);
+              }
+              else
+              {
+                omega += m_Parameters->m_SignalGen.m_FrequencyMap->GetPixel(index);
+
+              }
             }
-          }
 
-          // if signal comes from outside FOV, mirror it back (wrap-around artifact - aliasing)
-          if (y<-yMaxFov/2){ y += yMaxFov; }
-          else if (y>=yMaxFov/2) { y -= yMaxFov; }
+            // if signal comes from outside FOV, mirror it back (wrap-around artifact - aliasing)
+            if (y<-yMaxFov/2){ y += yMaxFov; }
+            else if (y>=yMaxFov/2) { y -= yMaxFov; }
 
-          // actual DFT term
-          s += f * exp( std::complex<double>(0, 2 * M_PI * (kx*x/xMax + ky*y/yMaxFov + omega*t/1000 )) );
+            // actual DFT term
+            s += f * exp( std::complex<double>(0, 2 * M_PI * (kx*x/xMax + ky*y/yMaxFov + omega*t/1000 )) );
 
-          ++it;
+            ++it;
+          }
         }
         s /= numPix;
 
@@ -42,7 +42,9 @@ namespace itk{
 * - Image distortions (off-frequency effects)
 * - Gibbs ringing
 * - Eddy current effects
-* Based on a discrete fourier transformation.
+* Based on a discrete fourier transformation. Without off-resonance effects (eddy currents, frequency map) the transformation
+* is separated into phase encoding and readout direction using precomputed twiddle factors, which reduces the costs per slice
+* from O(N^2) to O(N^1.5) for N pixels while yielding the same result as the direct transformation.
 * See "Fiberfox: Facilitating the creation of realistic white matter software phantoms" (DOI: 10.1002/mrm.25045) for details.
 */
 
@@ -84,6 +86,8 @@ namespace itk{
     itkSetMacro( CoilPosition, DoubleVectorType )
     itkGetMacro( KSpaceImage, typename InputImageType::Pointer )    ///< k-space magnitude image
     itkGetMacro( SpikeLog, std::string )
+    itkSetMacro( UseSeparableDft, bool )            ///< Use the separable transformation if possible (default). Otherwise the direct DFT is always used.
+    itkGetMacro( UseSeparableDft, bool )
 
     void SetParameters( FiberfoxParameters<double>* param ){ m_Parameters = param; }
 
@@ -102,6 +106,7 @@ namespace itk{
     void ThreadedGenerateData( const OutputImageRegionType &outputRegionForThread, ThreadIdType threadID);
     void AfterThreadedGenerateData();
     double InterpolateFmapValue(itk::Point<float, 3> itkP);
+    void PrepareSeparableDft();   ///< Transforms the compartment images along the phase encoding direction and precomputes the readout twiddle factors.
 
     DoubleVectorType                        m_CoilPosition;
     FiberfoxParameters<double>*             m_Parameters;
@@ -129,6 +134,11 @@ namespace itk{
     typename InputImageType::Pointer        m_ReadoutTimeImage;
     AcquisitionType*                        m_ReadoutScheme;
 
+    bool                                    m_UseSeparableDft;
+    bool                                    m_DoSeparableDft;
+    std::vector< std::vector< vcl_complex<double> > > m_PhaseEncodedImages;  ///< per compartment (or summed if relaxation is not simulated), ky rows of x columns
+    std::vector< vcl_complex<double> >      m_ReadoutTwiddles[2];           ///< exp(i2pi*kx*x/xMax) with positive and negative line offset, kx rows of x columns
+
   private:
 
   };
@@ -7,6 +7,7 @@ SET(MODULE_CUSTOM_TESTS
   mitkFiberExtractionTest.cpp
   mitkFiberGenerationTest.cpp
   mitkFiberfoxSignalGenerationTest.cpp
+  mitkFiberfoxKspaceTransformTest.cpp
   mitkMachineLearningTrackingTest.cpp
   mitkFiberProcessingTest.cpp
 )
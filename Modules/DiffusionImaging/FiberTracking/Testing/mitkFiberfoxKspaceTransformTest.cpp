@@ -0,0 +1,196 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkFiberfoxParameters.h>
+#include <itkKspaceImageFilter.h>
+#include <itkDftImageFilter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkTimeProbe.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "mitkTestFixture.h"
+
+/**
+ * \brief Compares the separable k-space transformations of Fiberfox to the direct DFT and logs the run times of both.
+ */
+class mitkFiberfoxKspaceTransformTestSuite : public mitk::TestFixture
+{
+
+    CPPUNIT_TEST_SUITE(mitkFiberfoxKspaceTransformTestSuite);
+    MITK_TEST(DftImageFilter_Separable_EqualsDirectDft);
+    MITK_TEST(KspaceImageFilter_Separable_EqualsDirectDft);
+    MITK_TEST(KspaceImageFilter_CroppedFovWithGhosts_EqualsDirectDft);
+    CPPUNIT_TEST_SUITE_END();
+
+    typedef itk::KspaceImageFilter< double >            KspaceFilterType;
+    typedef itk::DftImageFilter< double >               DftFilterType;
+    typedef KspaceFilterType::InputImageType            CompartmentImageType;
+    typedef KspaceFilterType::OutputImageType           ComplexSliceType;
+
+private:
+
+    std::vector< CompartmentImageType::Pointer > m_Compartments;
+
+    CompartmentImageType::Pointer CreateCompartment(unsigned int sizeX, unsigned int sizeY)
+    {
+        itk::ImageRegion<2> region;
+        region.SetSize(0, sizeX);
+        region.SetSize(1, sizeY);
+
+        CompartmentImageType::Pointer image = CompartmentImageType::New();
+        image->SetRegions(region);
+        image->Allocate();
+
+        itk::ImageRegionIterator< CompartmentImageType > it(image, region);
+        while (!it.IsAtEnd())
+        {
+            it.Set((double)(rand()%1000)/1000);
+            ++it;
+        }
+        return image;
+    }
+
+    mitk::FiberfoxParameters<double> CreateParameters(double croppingFactor)
+    {
+        mitk::FiberfoxParameters<double> parameters;
+        parameters.m_SignalGen.m_ImageRegion.SetSize(0, m_Compartments.at(0)->GetLargestPossibleRegion().GetSize(0));
+        parameters.m_SignalGen.m_ImageRegion.SetSize(1, m_Compartments.at(0)->GetLargestPossibleRegion().GetSize(1));
+        parameters.m_SignalGen.m_ImageRegion.SetSize(2, 1);
+        parameters.m_SignalGen.m_CroppingFactor = croppingFactor;
+        parameters.m_SignalGen.m_CroppedRegion = parameters.m_SignalGen.m_ImageRegion;
+        parameters.m_SignalGen.m_CroppedRegion.SetSize(1, parameters.m_SignalGen.m_ImageRegion.GetSize(1)*croppingFactor);
+        parameters.m_Misc.m_CheckAddNoiseBox = false;
+        return parameters;
+    }
+
+    ComplexSliceType::Pointer SimulateKspace(mitk::FiberfoxParameters<double> parameters, bool separable)
+    {
+        std::vector< double > t2(m_Compartments.size(), 100);
+        std::vector< double > t1(m_Compartments.size(), 800);
+        t2[0] = 80;
+
+        itk::Vector<double,3> coilPosition;
+        coilPosition.Fill(0.0);
+        coilPosition[0] = 30;
+
+        KspaceFilterType::Pointer filter = KspaceFilterType::New();
+        filter->SetCompartmentImages(m_Compartments);
+        filter->SetT2(t2);
+        filter->SetT1(t1);
+        filter->SetUseConstantRandSeed(true);
+        filter->SetParameters(&parameters);
+        filter->SetZ(0);
+        filter->SetZidx(0);
+        filter->SetCoilPosition(coilPosition);
+        filter->SetUseSeparableDft(separable);
+
+        itk::TimeProbe clock;
+        clock.Start();
+        filter->Update();
+        clock.Stop();
+        MITK_INFO << (separable ? "Separable" : "Direct") << " k-space simulation: " << clock.GetTotal() << "s";
+
+        return filter->GetOutput();
+    }
+
+    void CompareSlices(ComplexSliceType::Pointer expected, ComplexSliceType::Pointer actual)
+    {
+        CPPUNIT_ASSERT_MESSAGE("Slice size", expected->GetLargestPossibleRegion()==actual->GetLargestPossibleRegion());
+
+        double maxMagnitude = 0;
+        itk::ImageRegionConstIterator< ComplexSliceType > it(expected, expected->GetLargestPossibleRegion());
+        while (!it.IsAtEnd())
+        {
+            maxMagnitude = std::max(maxMagnitude, (double)std::abs(it.Get()));
+            ++it;
+        }
+        CPPUNIT_ASSERT_MESSAGE("Slice contains signal", maxMagnitude>0);
+
+        // only the order of summation differs
+        for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("k-space sample", 0.0, (double)std::abs(it.Get()-actual->GetPixel(it.GetIndex())), 1e-9*maxMagnitude);
+    }
+
+public:
+
+    void setUp() override
+    {
+        srand(0);
+        m_Compartments.clear();
+        m_Compartments.push_back(CreateCompartment(41, 36));
+        m_Compartments.push_back(CreateCompartment(41, 36));
+    }
+
+    void tearDown() override
+    {
+        m_Compartments.clear();
+    }
+
+    void DftImageFilter_Separable_EqualsDirectDft()
+    {
+        ComplexSliceType::Pointer slice = ComplexSliceType::New();
+        slice->SetRegions(m_Compartments.at(0)->GetLargestPossibleRegion());
+        slice->Allocate();
+        itk::ImageRegionIterator< ComplexSliceType > it(slice, slice->GetLargestPossibleRegion());
+        while (!it.IsAtEnd())
+        {
+            it.Set(ComplexSliceType::PixelType(m_Compartments.at(0)->GetPixel(it.GetIndex()), m_Compartments.at(1)->GetPixel(it.GetIndex())));
+            ++it;
+        }
+
+        ComplexSliceType::Pointer results[2];
+        for (int separable=0; separable<2; separable++)
+        {
+            DftFilterType::Pointer dft = DftFilterType::New();
+            dft->SetInput(slice);
+            dft->SetUseSeparableDft(separable==1);
+
+            itk::TimeProbe clock;
+            clock.Start();
+            dft->Update();
+            clock.Stop();
+            MITK_INFO << (separable==1 ? "Separable" : "Direct") << " DFT: " << clock.GetTotal() << "s";
+
+            results[separable] = dft->GetOutput();
+        }
+        CompareSlices(results[0], results[1]);
+    }
+
+    void KspaceImageFilter_Separable_EqualsDirectDft()
+    {
+        mitk::FiberfoxParameters<double> parameters = CreateParameters(1.0);
+        parameters.m_SignalGen.m_DoSimulateRelaxation = true;
+        parameters.m_SignalGen.m_CoilSensitivityProfile = mitk::SignalGenerationParameters::COIL_EXPONENTIAL;
+
+        CompareSlices(SimulateKspace(parameters, false), SimulateKspace(parameters, true));
+    }
+
+    void KspaceImageFilter_CroppedFovWithGhosts_EqualsDirectDft()
+    {
+        mitk::FiberfoxParameters<double> parameters = CreateParameters(0.75);
+        parameters.m_SignalGen.m_DoSimulateRelaxation = false;
+        parameters.m_SignalGen.m_KspaceLineOffset = 0.2;
+        parameters.m_SignalGen.m_PartialFourier = 0.7;
+        parameters.m_SignalGen.m_CoilSensitivityProfile = mitk::SignalGenerationParameters::COIL_LINEAR;
+
+        CompareSlices(SimulateKspace(parameters, false), SimulateKspace(parameters, true));
+    }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkFiberfoxKspaceTransform)
@@ -23,12 +23,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkMacro.h>
 
+#include <memory>
+
 // ------- INFORMATION ----------
 /// SET FUNCTIONS
 // void SetInput( ItkImage ) // Compulsory
 // void SetStartIndex (const IndexType & StartIndex); // Compulsory
 // void SetEndIndex(const IndexType & EndIndex); // Compulsory
 // void SetFullNeighborsMode(bool) // Optional (default=false), if false N4, if true N26
+// void SetCalcMode(CalcModeType) // Optional (default=A_STAR), A_STAR estimates the remaining costs to the end point
+// with the minimal costs of the cost function, DIJKSTRA does not. Multiple end points and CalcAllDistances always
+// use DIJKSTRA
 // void SetActivateTimeOut(bool) // Optional (default=false), for debug issues: after 30s algorithms terminates. You can
 // have a look at the VectorOrderImage to see how far it came
 // void SetMakeOutputImage(bool) // Optional (default=true), Generate an outputimage of the path. You can also get the
@@ -72,6 +77,7 @@ namespace itk
     typedef typename TInputImageType::PixelType InputImagePixelType;
     typedef typename TInputImageType::SizeType InputImageSizeType;
     typedef typename TInputImageType::IndexType IndexType;
+    typedef typename TInputImageType::OffsetType OffsetType;
     typedef typename itk::ImageRegionIteratorWithIndex<InputImageType> InputImageIteratorType;
 
     typedef TOutputImageType OutputImageType;
@@ -96,6 +102,12 @@ namespace itk
       bool operator()(ShortestPathNode *a, ShortestPathNode *b) { return (a->distAndEst > b->distAndEst); }
     };
 
+    enum CalcModeType
+    {
+      DIJKSTRA,
+      A_STAR
+    };
+
     // \brief Set Starpoint for ShortestPath Calculation
     void SetStartIndex(const IndexType &StartIndex);
 
@@ -114,6 +126,11 @@ namespace itk
     // N8 in 2D
     itkSetMacro(Graph_fullNeighbors, bool)
 
+      // \brief (default=A_STAR), A_STAR searches towards the end point, the cost function has to return a
+      // GetMinCost() that is not higher than the costs of a step of length 1
+      itkSetMacro(CalcMode, CalcModeType);
+    itkGetMacro(CalcMode, CalcModeType);
+
       // \brief (default=true), Produce output image, which shows the shortest path. But you can also get the shortest
       // Path directly as vector with the function GetVectorPath
       itkSetMacro(MakeOutputImage, bool);
@@ -163,7 +180,12 @@ namespace itk
       m_endPoints; // if you fill this vector, the algo will not rest until all endPoints have been reached
     std::vector<IndexType> m_endPointsClosed;
 
-    ShortestPathNode *m_Nodes; // main list that contains all nodes
+    // nodes are allocated in pages of NodesPerPage nodes, when the search reaches the page for the first time
+    static const NodeNumType NodesPerPage = 4096;
+    std::vector<std::unique_ptr<ShortestPathNode[]>> m_NodePages;
+    ShortestPathNodeHeap m_DiscoveredNodes; // open nodes, ordered by distAndEst
+    std::vector<OffsetType> m_NeighborOffsets; // first the direct neighbors, then the diagonal ones
+    InputImageSizeType m_ImageSize;
     NodeNumType m_Graph_NumberOfNodes;
     NodeNumType m_Graph_StartNode;
     NodeNumType m_Graph_EndNode;
@@ -187,6 +209,9 @@ namespace itk
 
     bool m_Initialized;
 
+    CalcModeType m_CalcMode;
+    double m_MinCost;
+
     CostFunctionTypePointer m_CostFunction;
     IndexType m_StartIndex, m_EndIndex;
     std::vector<IndexType> m_VectorPath;
@@ -215,6 +240,12 @@ namespace itk
     // \brief Convert image coordinate to a indexnumber of a node in m_Nodes
     unsigned int CoordToNode(IndexType);
 
+    // \brief Returns the node, creates its page if the search reaches it for the first time
+    ShortestPathNode *GetNode(NodeNumType nodeNum);
+
+    // \brief Returns the node or nullptr if the search did not reach its page
+    const ShortestPathNode *FindNode(NodeNumType nodeNum) const;
+
     // \brief Returns the neighbors of a node
     std::vector<ShortestPathNode *> GetNeighbors(NodeNumType nodeNum, bool FullNeighbors);
 
@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkMemoryUtilities.h"
 #include "time.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -29,16 +30,23 @@ namespace itk
   // Constructor  (initialize standard values)
   template <class TInputImageType, class TOutputImageType>
   ShortestPathImageFilter<TInputImageType, TOutputImageType>::ShortestPathImageFilter()
-    : m_Nodes(nullptr),
-      m_Graph_NumberOfNodes(0),
+    : m_Graph_NumberOfNodes(0),
+      m_Graph_StartNode(0),
+      m_Graph_EndNode(0),
+      m_Graph_fullNeighbors(false),
       m_FullNeighborsMode(false),
       m_MakeOutputImage(true),
       m_StoreVectorOrder(false),
       m_CalcAllDistances(false),
       multipleEndPoints(false),
       m_ActivateTimeOut(false),
-      m_Initialized(false)
+      m_Initialized(false),
+      m_CalcMode(A_STAR),
+      m_MinCost(0)
   {
+    m_StartIndex.Fill(0);
+    m_EndIndex.Fill(0);
+    m_ImageSize.Fill(0);
     m_endPoints.clear();
     m_endPointsClosed.clear();
 
@@ -52,40 +60,23 @@ namespace itk
   template <class TInputImageType, class TOutputImageType>
   ShortestPathImageFilter<TInputImageType, TOutputImageType>::~ShortestPathImageFilter()
   {
-    delete[] m_Nodes;
   }
 
   template <class TInputImageType, class TOutputImageType>
   inline typename ShortestPathImageFilter<TInputImageType, TOutputImageType>::IndexType
     ShortestPathImageFilter<TInputImageType, TOutputImageType>::NodeToCoord(NodeNumType node)
   {
-    const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
-    int dim = InputImageType::ImageDimension;
     IndexType coord;
-    if (dim == 2)
+    if ((m_Graph_NumberOfNodes > 0) && (node >= m_Graph_NumberOfNodes))
     {
-      coord[1] = node / size[0];
-      coord[0] = node % size[0];
-      if (((unsigned long)coord[0] >= size[0]) || ((unsigned long)coord[1] >= size[1]))
-      {
-        coord[0] = 0;
-        coord[1] = 0;
-      }
+      coord.Fill(0);
+      return coord;
     }
-    if (dim == 3)
+    for (unsigned int i = 0; i < InputImageType::ImageDimension; ++i)
     {
-      coord[2] = node / (size[0] * size[1]);
-      coord[1] = (node % (size[0] * size[1])) / size[0];
-      coord[0] = (node % (size[0] * size[1])) % size[0];
-      if (((unsigned long)coord[0] >= size[0]) || ((unsigned long)coord[1] >= size[1]) ||
-          ((unsigned long)coord[2] >= size[2]))
-      {
-        coord[0] = 0;
-        coord[1] = 0;
-        coord[2] = 0;
-      }
+      coord[i] = node % m_ImageSize[i];
+      node = node / m_ImageSize[i];
     }
-
     return coord;
   }
 
@@ -93,23 +84,15 @@ namespace itk
   inline typename itk::NodeNumType ShortestPathImageFilter<TInputImageType, TOutputImageType>::CoordToNode(
     IndexType coord)
   {
-    const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
-    int dim = InputImageType::ImageDimension;
     NodeNumType node = 0;
-    if (dim == 2)
+    NodeNumType stride = 1;
+    for (unsigned int i = 0; i < InputImageType::ImageDimension; ++i)
     {
-      node = (coord[1] * size[0]) + coord[0];
-    }
-    if (dim == 3)
-    {
-      node = (coord[2] * size[0] * size[1]) + (coord[1] * size[0]) + coord[0];
+      node += coord[i] * stride;
+      stride *= m_ImageSize[i];
     }
     if ((m_Graph_NumberOfNodes > 0) && (node >= m_Graph_NumberOfNodes))
     {
-      /*MITK_INFO << "WARNING! Coordinates outside image!";
-      MITK_INFO << "Coords = " << coord ;
-      MITK_INFO << "ImageDim = " << dim ;
-      MITK_INFO << "RequestedRegionSize = " << size ;*/
       node = 0;
     }
 
@@ -119,26 +102,43 @@ namespace itk
   template <class TInputImageType, class TOutputImageType>
   inline bool ShortestPathImageFilter<TInputImageType, TOutputImageType>::CoordIsInBounds(IndexType coord)
   {
-    const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
-    int dim = InputImageType::ImageDimension;
-
-    if (dim == 2)
+    for (unsigned int i = 0; i < InputImageType::ImageDimension; ++i)
     {
-      if ((coord[0] >= 0) && ((unsigned long)coord[0] < size[0]) && (coord[1] >= 0) &&
-          ((unsigned long)coord[1] < size[1]))
-      {
-        return true;
-      }
+      if ((coord[i] < 0) || ((unsigned long)coord[i] >= m_ImageSize[i]))
+        return false;
     }
-    if (dim == 3)
+    return true;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline ShortestPathNode *ShortestPathImageFilter<TInputImageType, TOutputImageType>::GetNode(NodeNumType nodeNum)
+  {
+    std::unique_ptr<ShortestPathNode[]> &page = m_NodePages[nodeNum / NodesPerPage];
+    if (!page)
     {
-      if ((coord[0] >= 0) && ((unsigned long)coord[0] < size[0]) && (coord[1] >= 0) &&
-          ((unsigned long)coord[1] < size[1]) && (coord[2] >= 0) && ((unsigned long)coord[2] < size[2]))
+      // the search reached this page for the first time
+      page.reset(new ShortestPathNode[NodesPerPage]);
+      const NodeNumType firstNode = nodeNum - nodeNum % NodesPerPage;
+      for (NodeNumType i = 0; i < NodesPerPage; ++i)
       {
-        return true;
+        page[i].distAndEst = -1;
+        page[i].distance = -1;
+        page[i].prevNode = -1;
+        page[i].mainListIndex = firstNode + i;
+        page[i].heapIndex = ShortestPathNode::NotInHeap;
+        page[i].closed = false;
       }
     }
-    return false;
+    return &page[nodeNum % NodesPerPage];
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline const ShortestPathNode *ShortestPathImageFilter<TInputImageType, TOutputImageType>::FindNode(
+    NodeNumType nodeNum) const
+  {
+    if (nodeNum >= m_Graph_NumberOfNodes || !m_NodePages[nodeNum / NodesPerPage])
+      return nullptr;
+    return &m_NodePages[nodeNum / NodesPerPage][nodeNum % NodesPerPage];
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -146,229 +146,17 @@ namespace itk
     unsigned int nodeNum, bool FullNeighbors)
   {
     // returns a vector of nodepointers.. these nodes are the neighbors
-    int dim = InputImageType::ImageDimension;
     IndexType Coord = NodeToCoord(nodeNum);
-    IndexType NeighborCoord;
     std::vector<ShortestPathNode *> nodeList;
 
-    int neighborDistance = 1; // if i increase that, i might not hit the endnote
-
-    // maybe use itkNeighborhoodIterator here, might be faster
-
-    if (dim == 2)
+    // the first 2*ImageDimension offsets are the direct neighbors (N4 / N6), the rest are diagonal (N8 / N26)
+    const std::size_t numberOfNeighbors =
+      FullNeighbors ? m_NeighborOffsets.size() : 2 * InputImageType::ImageDimension;
+    for (std::size_t i = 0; i < numberOfNeighbors; ++i)
     {
-      // N4
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] - neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] + neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] + neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] - neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      if (FullNeighbors)
-      {
-        // N8
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-      }
-    }
-    if (dim == 3)
-    {
-      // N6
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] - neighborDistance;
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] + neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] + neighborDistance;
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] - neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2] + neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2] - neighborDistance;
+      IndexType NeighborCoord = Coord + m_NeighborOffsets[i];
       if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      if (FullNeighbors)
-      {
-        // N26
-        // Middle Slice
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // BackSlice (Diagonal)
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // BackSlice (Non-Diag)
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // FrontSlice (Diagonal)
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // FrontSlice(Non-Diag)
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-      }
+        nodeList.push_back(GetNode(CoordToNode(NeighborCoord)));
     }
     return nodeList;
   }
@@ -418,52 +206,76 @@ namespace itk
   inline double ShortestPathImageFilter<TInputImageType, TOutputImageType>::getEstimatedCostsToTarget(
     const typename TInputImageType::IndexType &a)
   {
+    // Dijkstra, or a search without a single target: no estimation
+    if (m_CalcMode != A_STAR || multipleEndPoints || m_CalcAllDistances)
+      return 0;
+
     // Returns the minimal possible costs for a path from "a" to targetnode.
-    itk::Vector<float, 3> v;
-    v[0] = m_EndIndex[0] - a[0];
-    v[1] = m_EndIndex[1] - a[1];
-    v[2] = m_EndIndex[2] - a[2];
+    double squaredDistance = 0;
+    for (unsigned int i = 0; i < InputImageType::ImageDimension; ++i)
+    {
+      const double v = m_EndIndex[i] - a[i];
+      squaredDistance += v * v;
+    }
 
-    return m_CostFunction->GetMinCost() * v.GetNorm();
+    return m_MinCost * std::sqrt(squaredDistance);
   }
 
   template <class TInputImageType, class TOutputImageType>
   void ShortestPathImageFilter<TInputImageType, TOutputImageType>::InitGraph()
   {
-    if (!m_Initialized)
-    {
-      // Clean up previous stuff
-      CleanUp();
+    // Clean up previous stuff
+    CleanUp();
 
-      // Calc Number of nodes
-      m_ImageDimensions = TInputImageType::ImageDimension;
-      const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
-      m_Graph_NumberOfNodes = 1;
-      for (NodeNumType i = 0; i < m_ImageDimensions; ++i)
-        m_Graph_NumberOfNodes = m_Graph_NumberOfNodes * size[i];
+    // Calc Number of nodes
+    m_ImageDimensions = TInputImageType::ImageDimension;
+    m_ImageSize = this->GetInput()->GetRequestedRegion().GetSize();
+    m_Graph_NumberOfNodes = 1;
+    for (NodeNumType i = 0; i < m_ImageDimensions; ++i)
+      m_Graph_NumberOfNodes = m_Graph_NumberOfNodes * m_ImageSize[i];
 
-      // Initialize mainNodeList with that number
-      m_Nodes = new ShortestPathNode[m_Graph_NumberOfNodes];
+    // the indices may have been set before the input was updated
+    m_Graph_StartNode = CoordToNode(m_StartIndex);
+    m_Graph_EndNode = CoordToNode(m_EndIndex);
 
-      // Initialize each node in nodelist
-      for (NodeNumType i = 0; i < m_Graph_NumberOfNodes; i++)
+    // Nodes are only created for the pages the search reaches, so a search between two close points does not
+    // allocate and initialize a node for every pixel
+    m_NodePages.resize((m_Graph_NumberOfNodes + NodesPerPage - 1) / NodesPerPage);
+
+    // Offsets to the neighbors, the direct neighbors first
+    m_NeighborOffsets.clear();
+    std::vector<OffsetType> diagonalOffsets;
+    unsigned int numberOfOffsets = 1;
+    for (unsigned int i = 0; i < m_ImageDimensions; ++i)
+      numberOfOffsets *= 3;
+    for (unsigned int n = 0; n < numberOfOffsets; ++n)
+    {
+      OffsetType offset;
+      unsigned int rest = n;
+      unsigned int nonZero = 0;
+      for (unsigned int i = 0; i < m_ImageDimensions; ++i)
       {
-        m_Nodes[i].distAndEst = -1;
-        m_Nodes[i].distance = -1;
-        m_Nodes[i].prevNode = -1;
-        m_Nodes[i].mainListIndex = i;
-        m_Nodes[i].closed = false;
+        offset[i] = static_cast<int>(rest % 3) - 1;
+        rest /= 3;
+        if (offset[i] != 0)
+          ++nonZero;
       }
-
-      m_Initialized = true;
+      if (nonZero == 1)
+        m_NeighborOffsets.push_back(offset);
+      else if (nonZero > 1)
+        diagonalOffsets.push_back(offset);
     }
+    m_NeighborOffsets.insert(m_NeighborOffsets.end(), diagonalOffsets.begin(), diagonalOffsets.end());
+
+    m_Initialized = true;
 
     // In the beginning, the Startnode needs a distance of 0
-    m_Nodes[m_Graph_StartNode].distance = 0;
-    m_Nodes[m_Graph_StartNode].distAndEst = 0;
+    GetNode(m_Graph_StartNode)->distance = 0;
+    GetNode(m_Graph_StartNode)->distAndEst = 0;
 
     // initalize cost function
     m_CostFunction->Initialize();
+    m_MinCost = m_CostFunction->GetMinCost();
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -480,43 +292,25 @@ namespace itk
     DistanceType curNodeDistance = 0;
     NodeNumType numberOfNodesChecked = 0;
 
-    // Create Multimap (tree structure for fast searching)
-    std::multimap<double, ShortestPathNode *> myMap;
-    std::pair<std::multimap<double, ShortestPathNode *>::iterator, std::multimap<double, ShortestPathNode *>::iterator>
-      ret;
-    std::multimap<double, ShortestPathNode *>::iterator it;
+    const std::size_t numberOfNeighbors = (m_FullNeighborsMode || m_Graph_fullNeighbors)
+                                            ? m_NeighborOffsets.size()
+                                            : 2 * InputImageType::ImageDimension;
 
     // At first, only startNote is discovered.
-    myMap.insert(
-      std::pair<double, ShortestPathNode *>(m_Nodes[m_Graph_StartNode].distAndEst, &m_Nodes[m_Graph_StartNode]));
+    m_DiscoveredNodes.Clear();
+    m_DiscoveredNodes.Push(GetNode(m_Graph_StartNode));
 
     // While there are discovered Nodes, pick the one with lowest distance,
     // update its neighbors and eventually delete it from the discovered Nodes list.
-    while (!myMap.empty())
+    while (!m_DiscoveredNodes.IsEmpty())
     {
       numberOfNodesChecked++;
-      /*if ( (numberOfNodesChecked % (m_Graph_NumberOfNodes/100)) == 0)
-      {
-        MITK_INFO << "Checked " << ( numberOfNodesChecked / (m_Graph_NumberOfNodes/100) ) << "% List: " << myMap.size()
-      << "\n";
-      }*/
-
-      // Get element with lowest score
-      mainNodeListIndex = myMap.begin()->second->mainListIndex;
-      curNodeDistance = myMap.begin()->second->distance;
-      myMap.begin()->second->closed = true; // close it
-
-      // Debug:
-      // MITK_INFO << "INFO: size " << myMap.size();
-      /*
-      for (it = myMap.begin(); it != myMap.end(); ++it)
-      {
-      MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-      }
-      */
 
       // Kicks out element with lowest score
-      myMap.erase(myMap.begin());
+      ShortestPathNode *curNode = m_DiscoveredNodes.Pop();
+      curNode->closed = true; // close it
+      mainNodeListIndex = curNode->mainListIndex;
+      curNodeDistance = curNode->distance;
 
       // if wanted, store vector order
       if (m_StoreVectorOrder)
@@ -525,138 +319,32 @@ namespace itk
       }
 
       // Check neighbors
-      std::vector<ShortestPathNode *> neighborNodes = GetNeighbors(mainNodeListIndex, m_Graph_fullNeighbors);
-      for (NodeNumType i = 0; i < neighborNodes.size(); i++)
+      IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
+      for (std::size_t i = 0; i < numberOfNeighbors; i++)
       {
-        if (neighborNodes[i]->closed)
-          continue; // this nodes is already closed, go to next neighbor
+        IndexType coordNeighborNode = coordCurNode + m_NeighborOffsets[i];
+        if (!CoordIsInBounds(coordNeighborNode))
+          continue;
 
-        IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
-        IndexType coordNeighborNode = NodeToCoord(neighborNodes[i]->mainListIndex);
+        ShortestPathNode *neighborNode = GetNode(CoordToNode(coordNeighborNode));
+        if (neighborNode->closed)
+          continue; // this nodes is already closed, go to next neighbor
 
         // calculate the new Distance to the current neighbor
         double newDistance = curNodeDistance + (m_CostFunction->GetCost(coordCurNode, coordNeighborNode));
 
         // if it is shorter than any yet known path to this neighbor, than the current path is better. Save that!
-        if ((newDistance < neighborNodes[i]->distance) || (neighborNodes[i]->distance == -1))
+        if ((newDistance < neighborNode->distance) || (neighborNode->distance == -1))
         {
-          // if that neighbornode is not in discoverednodeList yet, Push it there and update
-          if (neighborNodes[i]->distance == -1)
-          {
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-            /*
-            MITK_INFO << "Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            MITK_INFO << "INFO: size " << myMap.size();
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }
-            */
-          }
-          // or if is already in discoverednodelist, update
-          else
-          {
-            /*
-            it = myMap.find(neighborNodes[i]->distAndEst);
-            if (it == myMap.end() )
-            {
-            MITK_INFO << "Nothing!";
-            // look further
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            if ((*it).second->mainListIndex == lookForId)
-            {
-            MITK_INFO << "But it is there!!!";
-            MITK_INFO << "Searched for: " << lookFor << "   but had: " << (*it).second->distAndEst;
-            }
+          neighborNode->distance = newDistance;
+          neighborNode->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
+          neighborNode->prevNode = mainNodeListIndex;
 
-            }
-            }
-            */
-
-            // 1st : find and delete old element
-            bool found = false;
-            ret = myMap.equal_range(neighborNodes[i]->distAndEst);
-
-            if ((ret.first == ret.second))
-            {
-              /*+++++++++++++ no exact match +++++++++++++*/
-              // MITK_INFO << "No exact match!"; // if this happens, you are screwed
-              /*
-              MITK_INFO << "Was looking for: " << lookFor << "  ID: " << lookForId;
-              if (ret.first != myMap.end() )
-              {
-              it = ret.first;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              ++it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              --it;
-              --it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              }
-
-              // look if that ID is found in the map
-              for (it = myMap.begin(); it != myMap.end(); ++it)
-              {
-              if ((*it).second->mainListIndex == lookForId)
-              {
-              MITK_INFO << "But it is there!!!";
-              MITK_INFO << "Searched dist: " << lookFor << "  found dist: " << (*it).second->distAndEst;
-              }
-
-              }
-              */
-            }
-            else
-            {
-              for (it = ret.first; it != ret.second; ++it)
-              {
-                if (it->second->mainListIndex == neighborNodes[i]->mainListIndex)
-                {
-                  found = true;
-                  myMap.erase(it);
-                  /*
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  MITK_INFO << "Erase: " << it->first << "|" << it->second->mainListIndex;
-
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  for (it = myMap.begin(); it != myMap.end(); ++it)
-                  {
-                  MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-                  }
-                  */
-                  break;
-                }
-              }
-            }
-
-            if (!found)
-            {
-              // MITK_INFO << "Could not find it! :(";
-              continue;
-            }
-
-            // 2nd: update and insert new element
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            // myMap.insert( std::pair<double,ShortestPathNode*> (neighborNodes[i]->distAndEst, neighborNodes[i]));
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-
-            // MITK_INFO << "Re-Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            // m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            // MITK_INFO << "INFO: size " << myMap.size();
-            /*for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }*/
-          }
+          // if that neighbornode is not in the discovered nodes yet, push it there, otherwise move it up
+          if (neighborNode->heapIndex == ShortestPathNode::NotInHeap)
+            m_DiscoveredNodes.Push(neighborNode);
+          else
+            m_DiscoveredNodes.DecreaseKey(neighborNode);
         }
       }
       // finished with checking all neighbors.
@@ -791,9 +479,12 @@ namespace itk
     {
       IndexType index = distanceImageIt.GetIndex();
       myNodeNum = CoordToNode(index);
-      double newVal = m_Nodes[myNodeNum].distance;
+      // pixels the search did not reach have no node
+      const ShortestPathNode *node = FindNode(myNodeNum);
+      double newVal = node ? node->distance : -1;
       distanceImageIt.Set(newVal);
     }
+    return image;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -826,7 +517,7 @@ namespace itk
       while (prevNode != m_Graph_StartNode)
       {
         m_VectorPath.push_back(NodeToCoord(prevNode));
-        prevNode = m_Nodes[prevNode].prevNode;
+        prevNode = GetNode(prevNode)->prevNode;
       }
       m_VectorPath.push_back(NodeToCoord(prevNode));
       // reverse it
@@ -843,7 +534,7 @@ namespace itk
         while (prevNode != m_Graph_StartNode)
         {
           m_VectorPath.push_back(NodeToCoord(prevNode));
-          prevNode = m_Nodes[prevNode].prevNode;
+          prevNode = GetNode(prevNode)->prevNode;
         }
         m_VectorPath.push_back(NodeToCoord(prevNode));
 
@@ -862,8 +553,8 @@ namespace itk
     m_VectorPath.clear();
     // TODO: if multiple Path, clear all multiple Paths
 
-    if (m_Nodes)
-      delete[] m_Nodes;
+    m_DiscoveredNodes.Clear();
+    m_NodePages.clear();
   }
 
   template <class TInputImageType, class TOutputImageType>
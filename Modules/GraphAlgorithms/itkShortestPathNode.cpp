@@ -25,4 +25,77 @@ namespace itk
   //  {
   //    return (this->mainListIndex == a.mainListIndex);
   //  }
+
+  void ShortestPathNodeHeap::Push(ShortestPathNode *node)
+  {
+    m_Heap.push_back(node);
+    node->heapIndex = static_cast<NodeNumType>(m_Heap.size() - 1);
+    MoveUp(node->heapIndex);
+  }
+
+  ShortestPathNode *ShortestPathNodeHeap::Pop()
+  {
+    ShortestPathNode *top = m_Heap.front();
+    top->heapIndex = ShortestPathNode::NotInHeap;
+
+    ShortestPathNode *last = m_Heap.back();
+    m_Heap.pop_back();
+    if (!m_Heap.empty())
+    {
+      Place(last, 0);
+      MoveDown(0);
+    }
+    return top;
+  }
+
+  void ShortestPathNodeHeap::DecreaseKey(ShortestPathNode *node)
+  {
+    MoveUp(node->heapIndex);
+  }
+
+  void ShortestPathNodeHeap::Clear()
+  {
+    for (ShortestPathNode *node : m_Heap)
+      node->heapIndex = ShortestPathNode::NotInHeap;
+    m_Heap.clear();
+  }
+
+  void ShortestPathNodeHeap::MoveUp(NodeNumType position)
+  {
+    ShortestPathNode *node = m_Heap[position];
+    while (position > 0)
+    {
+      NodeNumType parent = (position - 1) / 2;
+      if (m_Heap[parent]->distAndEst <= node->distAndEst)
+        break;
+      Place(m_Heap[parent], position);
+      position = parent;
+    }
+    Place(node, position);
+  }
+
+  void ShortestPathNodeHeap::MoveDown(NodeNumType position)
+  {
+    ShortestPathNode *node = m_Heap[position];
+    const NodeNumType size = static_cast<NodeNumType>(m_Heap.size());
+    for (;;)
+    {
+      NodeNumType child = 2 * position + 1;
+      if (child >= size)
+        break;
+      if (child + 1 < size && m_Heap[child + 1]->distAndEst < m_Heap[child]->distAndEst)
+        ++child;
+      if (node->distAndEst <= m_Heap[child]->distAndEst)
+        break;
+      Place(m_Heap[child], position);
+      position = child;
+    }
+    Place(node, position);
+  }
+
+  void ShortestPathNodeHeap::Place(ShortestPathNode *node, NodeNumType position)
+  {
+    m_Heap[position] = node;
+    node->heapIndex = position;
+  }
 }
@@ -18,6 +18,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "MitkGraphAlgorithmsExports.h"
 
+#include <vector>
+
 namespace itk
 {
   typedef double DistanceType; // Type to declare the costs
@@ -31,7 +33,39 @@ namespace itk
     DistanceType distAndEst;   // Distance+Estimated Distnace to target
     NodeNumType prevNode;      // previous node. Important to find the Shortest Path
     NodeNumType mainListIndex; // Indexnumber of this node in m_Nodes
+    NodeNumType heapIndex;     // position in the ShortestPathNodeHeap, NotInHeap if it is not discovered or closed
     bool closed;               // determines if this node is closes, so its optimal path to startNode is known
+
+    static const NodeNumType NotInHeap = static_cast<NodeNumType>(-1);
+  };
+
+  // \brief Binary min-heap of the discovered nodes, ordered by distAndEst
+  //
+  // Every node knows its position in the heap, so a node whose distance got shorter is moved up in O(log n)
+  // instead of being searched for and reinserted.
+  class MITKGRAPHALGORITHMS_EXPORT ShortestPathNodeHeap
+  {
+  public:
+    bool IsEmpty() const { return m_Heap.empty(); }
+    std::size_t GetSize() const { return m_Heap.size(); }
+
+    // \brief Inserts a node that is not in the heap yet
+    void Push(ShortestPathNode *node);
+
+    // \brief Removes and returns the node with the lowest distAndEst
+    ShortestPathNode *Pop();
+
+    // \brief Restores the order after the distAndEst of a node in the heap was lowered
+    void DecreaseKey(ShortestPathNode *node);
+
+    void Clear();
+
+  private:
+    void MoveUp(NodeNumType position);
+    void MoveDown(NodeNumType position);
+    void Place(ShortestPathNode *node, NodeNumType position);
+
+    std::vector<ShortestPathNode *> m_Heap;
   };
 
   // bool operator<(const ShortestPathNode &a) const;
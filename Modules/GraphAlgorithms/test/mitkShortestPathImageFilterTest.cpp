@@ -0,0 +1,282 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// TEST
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// STD
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <random>
+#include <vector>
+
+// ITK
+#include <itkImage.h>
+#include <itkImageRegionIterator.h>
+#include <itkShortestPathImageFilter.h>
+
+namespace
+{
+  // \brief Costs of a step are its length times the pixel value of the target pixel
+  template <class TInputImageType>
+  class WeightedLengthCostFunction : public itk::ShortestPathCostFunction<TInputImageType>
+  {
+  public:
+    typedef WeightedLengthCostFunction Self;
+    typedef itk::ShortestPathCostFunction<TInputImageType> Superclass;
+    typedef itk::SmartPointer<Self> Pointer;
+    typedef typename TInputImageType::IndexType IndexType;
+
+    itkFactorylessNewMacro(Self);
+    itkTypeMacro(WeightedLengthCostFunction, ShortestPathCostFunction);
+
+    double GetCost(IndexType p1, IndexType p2) override
+    {
+      double squaredLength = 0;
+      for (unsigned int i = 0; i < TInputImageType::ImageDimension; ++i)
+        squaredLength += (p1[i] - p2[i]) * (p1[i] - p2[i]);
+      return std::sqrt(squaredLength) * this->m_Image->GetPixel(p2);
+    }
+
+    double GetMinCost() override { return m_MinCost; }
+
+    void Initialize() override
+    {
+      m_MinCost = std::numeric_limits<double>::max();
+      itk::ImageRegionConstIterator<TInputImageType> it(this->m_Image, this->m_Image->GetLargestPossibleRegion());
+      for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+        m_MinCost = std::min(m_MinCost, static_cast<double>(it.Get()));
+    }
+
+  protected:
+    WeightedLengthCostFunction() : m_MinCost(0) {}
+    double m_MinCost;
+  };
+}
+
+/**
+ * Compares the paths of the ShortestPathImageFilter with a plain Dijkstra search on random 2D and 3D cost images
+ * and reports the time of the Dijkstra and A* searches.
+ */
+class mitkShortestPathImageFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkShortestPathImageFilterTestSuite);
+  MITK_TEST(Update_2DCostImage_FindsShortestPath);
+  MITK_TEST(Update_3DCostImage_FindsShortestPath);
+  MITK_TEST(Update_NewEndIndex_FindsShortestPathAgain);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<float, 2> Image2DType;
+  typedef itk::Image<float, 3> Image3DType;
+
+  template <class TImageType>
+  typename TImageType::Pointer CreateCostImage(unsigned int size)
+  {
+    typename TImageType::SizeType imageSize;
+    imageSize.Fill(size);
+    typename TImageType::Pointer image = TImageType::New();
+    image->SetRegions(imageSize);
+    image->Allocate();
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(1.0f, 10.0f);
+    itk::ImageRegionIterator<TImageType> it(image, image->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+      it.Set(distribution(generator));
+    return image;
+  }
+
+  template <class TImageType>
+  double GetPathCosts(TImageType *image, const std::vector<typename TImageType::IndexType> &path)
+  {
+    auto costFunction = WeightedLengthCostFunction<TImageType>::New();
+    costFunction->SetImage(image);
+    double costs = 0;
+    for (std::size_t i = 1; i < path.size(); ++i)
+      costs += costFunction->GetCost(path[i - 1], path[i]);
+    return costs;
+  }
+
+  // Dijkstra with a priority queue and lazy deletion, full neighborhood
+  template <class TImageType>
+  double GetReferenceCosts(TImageType *image,
+                           const typename TImageType::IndexType &start,
+                           const typename TImageType::IndexType &end)
+  {
+    const unsigned int dimension = TImageType::ImageDimension;
+    const typename TImageType::SizeType size = image->GetLargestPossibleRegion().GetSize();
+    auto costFunction = WeightedLengthCostFunction<TImageType>::New();
+    costFunction->SetImage(image);
+
+    auto toNumber = [&](const typename TImageType::IndexType &index) {
+      unsigned long number = 0;
+      unsigned long stride = 1;
+      for (unsigned int i = 0; i < dimension; ++i)
+      {
+        number += index[i] * stride;
+        stride *= size[i];
+      }
+      return number;
+    };
+
+    unsigned long numberOfPixels = 1;
+    for (unsigned int i = 0; i < dimension; ++i)
+      numberOfPixels *= size[i];
+    std::vector<double> distances(numberOfPixels, std::numeric_limits<double>::max());
+
+    typedef std::pair<double, typename TImageType::IndexType> QueueEntry;
+    auto compare = [](const QueueEntry &a, const QueueEntry &b) { return a.first > b.first; };
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, decltype(compare)> queue(compare);
+    distances[toNumber(start)] = 0;
+    queue.push(QueueEntry(0, start));
+
+    unsigned int numberOfOffsets = 1;
+    for (unsigned int i = 0; i < dimension; ++i)
+      numberOfOffsets *= 3;
+
+    while (!queue.empty())
+    {
+      QueueEntry entry = queue.top();
+      queue.pop();
+      if (entry.first > distances[toNumber(entry.second)])
+        continue;
+      if (entry.second == end)
+        return entry.first;
+
+      for (unsigned int n = 0; n < numberOfOffsets; ++n)
+      {
+        typename TImageType::IndexType neighbor = entry.second;
+        unsigned int rest = n;
+        bool inside = true;
+        for (unsigned int i = 0; i < dimension; ++i)
+        {
+          neighbor[i] += static_cast<int>(rest % 3) - 1;
+          rest /= 3;
+          inside &= neighbor[i] >= 0 && neighbor[i] < static_cast<long>(size[i]);
+        }
+        if (!inside || neighbor == entry.second)
+          continue;
+
+        const double distance = entry.first + costFunction->GetCost(entry.second, neighbor);
+        if (distance < distances[toNumber(neighbor)])
+        {
+          distances[toNumber(neighbor)] = distance;
+          queue.push(QueueEntry(distance, neighbor));
+        }
+      }
+    }
+    return -1;
+  }
+
+  template <class TImageType>
+  std::vector<typename TImageType::IndexType> FindPath(
+    TImageType *image,
+    const typename TImageType::IndexType &start,
+    const typename TImageType::IndexType &end,
+    typename itk::ShortestPathImageFilter<TImageType, TImageType>::CalcModeType calcMode,
+    double &milliseconds)
+  {
+    typedef itk::ShortestPathImageFilter<TImageType, TImageType> FilterType;
+    auto costFunction = WeightedLengthCostFunction<TImageType>::New();
+    costFunction->SetImage(image);
+
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetCostFunction(costFunction);
+    filter->SetFullNeighborsMode(true);
+    filter->SetMakeOutputImage(false);
+    filter->SetCalcMode(calcMode);
+    filter->SetStartIndex(start);
+    filter->SetEndIndex(end);
+
+    auto startTime = std::chrono::steady_clock::now();
+    filter->Update();
+    milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    return filter->GetVectorPath();
+  }
+
+  template <class TImageType>
+  void CheckShortestPath(unsigned int size)
+  {
+    typedef itk::ShortestPathImageFilter<TImageType, TImageType> FilterType;
+    typename TImageType::Pointer image = CreateCostImage<TImageType>(size);
+
+    typename TImageType::IndexType start, end;
+    start.Fill(size / 8);
+    end.Fill(size - 1 - size / 8);
+
+    double dijkstraTime = 0;
+    double aStarTime = 0;
+    auto dijkstraPath = FindPath<TImageType>(image, start, end, FilterType::DIJKSTRA, dijkstraTime);
+    auto aStarPath = FindPath<TImageType>(image, start, end, FilterType::A_STAR, aStarTime);
+    const double referenceCosts = GetReferenceCosts<TImageType>(image, start, end);
+
+    CPPUNIT_ASSERT_MESSAGE("Path starts at the start index", dijkstraPath.front() == start && aStarPath.front() == start);
+    CPPUNIT_ASSERT_MESSAGE("Path ends at the end index", dijkstraPath.back() == end && aStarPath.back() == end);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Dijkstra finds the shortest path", referenceCosts,
+      GetPathCosts<TImageType>(image, dijkstraPath), 1e-6 * referenceCosts);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("A* finds the shortest path", referenceCosts,
+      GetPathCosts<TImageType>(image, aStarPath), 1e-6 * referenceCosts);
+
+    MITK_INFO << TImageType::ImageDimension << "D cost image of size " << size << ": Dijkstra " << dijkstraTime
+              << " ms, A* " << aStarTime << " ms";
+  }
+
+public:
+  void Update_2DCostImage_FindsShortestPath() { CheckShortestPath<Image2DType>(512); }
+
+  void Update_3DCostImage_FindsShortestPath() { CheckShortestPath<Image3DType>(64); }
+
+  void Update_NewEndIndex_FindsShortestPathAgain()
+  {
+    typedef itk::ShortestPathImageFilter<Image2DType, Image2DType> FilterType;
+    Image2DType::Pointer image = CreateCostImage<Image2DType>(128);
+    auto costFunction = WeightedLengthCostFunction<Image2DType>::New();
+    costFunction->SetImage(image);
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetCostFunction(costFunction);
+    filter->SetFullNeighborsMode(true);
+    filter->SetMakeOutputImage(false);
+
+    Image2DType::IndexType start, end;
+    start.Fill(10);
+    filter->SetStartIndex(start);
+
+    // like the live wire, the end point moves while the start point stays
+    for (int i = 0; i < 3; ++i)
+    {
+      end[0] = 100 + 10 * i;
+      end[1] = 60 - 20 * i;
+      filter->SetEndIndex(end);
+      filter->Modified();
+      filter->Update();
+
+      const std::vector<Image2DType::IndexType> path = filter->GetVectorPath();
+      CPPUNIT_ASSERT_MESSAGE("Path ends at the new end index", path.back() == end);
+      const double referenceCosts = GetReferenceCosts<Image2DType>(image, start, end);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(referenceCosts, GetPathCosts<Image2DType>(image, path), 1e-6 * referenceCosts);
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkShortestPathImageFilter)
@@ -15,10 +15,27 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkNavigationDataDelayFilter.h"
+#include "mitkIGTTimeStamp.h"
+
+#include <chrono>
+
+namespace
+{
+  // Time of the update in milliseconds. The IGT clock returns -1 as long as it is not started, a monotonic clock is
+  // used instead then.
+  mitk::NavigationData::TimeStampType GetUpdateTime()
+  {
+    const double elapsed = mitk::IGTTimeStamp::GetInstance()->GetElapsed();
+    if (elapsed >= 0)
+      return elapsed;
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+}
 
 mitk::NavigationDataDelayFilter::NavigationDataDelayFilter(unsigned int delay) : m_Delay(delay)
 {
   m_Tolerance = 0;
+  m_BufferCapacity = 1024;
 }
 mitk::NavigationDataDelayFilter::~NavigationDataDelayFilter()
 {
@@ -26,54 +43,37 @@ mitk::NavigationDataDelayFilter::~NavigationDataDelayFilter()
 
 void mitk::NavigationDataDelayFilter::GenerateData()
 {
-  // Check if number of outputs has changed since the previous call. If yes, reset buffer.
-  // This actually compares the number of Navigation Datas in each step and compares it to the current number of inputs.
-  // If these values differ, the number of inputrs have changed.
-  if ( (m_Buffer.size() > 0) &&  (this->GetNumberOfInputs() != m_Buffer.front().second.size()) )
-    m_Buffer.empty();
-
-  // Put current navigationdatas from input into buffer
-  itk::TimeStamp now;
-  now.Modified();
-
-  std::vector<mitk::NavigationData::Pointer> ndList;
-  for (unsigned int i = 0; i < this->GetNumberOfInputs() ; ++i)
-  {
-    mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
-    nd->Graft(this->GetInput(i));
-    ndList.push_back(nd);
-  }
-
-  m_Buffer.push( std::make_pair(now.GetMTime(), ndList) );
-
-  // Find most recent member from buffer that is old enough to output, considering the Delay
-  // remove all sets that are too old already in the process
-  BufferType current;
-  bool foundCurrent = false;
-
-  while ( (m_Buffer.size() > 0) && (m_Buffer.front().first + m_Delay <= now.GetMTime() + m_Tolerance ) )
+  // Check if number of inputs has changed since the previous call. If yes, reset buffers.
+  if (m_Buffers.size() != this->GetNumberOfInputs())
   {
-    foundCurrent = true;
-    current = m_Buffer.front();
-    m_Buffer.pop();
+    m_Buffers.clear();
+    for (unsigned int i = 0; i < this->GetNumberOfInputs(); ++i)
+      m_Buffers.push_back(mitk::NavigationDataRingBuffer::New(m_BufferCapacity));
   }
 
-  // update outputs with tracking data from previous step, or none if empty
-  if ( !foundCurrent) return;
-
-  for (unsigned int i = 0; i < this->GetNumberOfOutputs() ; ++i)
+  for (unsigned int i = 0; i < this->GetNumberOfOutputs() && i < m_Buffers.size(); ++i)
   {
     mitk::NavigationData* output = this->GetOutput(i);
     assert(output);
-    const mitk::NavigationData* input = current.second[i];
+    const mitk::NavigationData* input = this->GetInput(i);
     assert(input);
 
-    if (input->IsDataValid() == false)
-    {
-      output->SetDataValid(false);
+    // Put current navigation data from input into buffer, sources without timestamps get the time of the update
+    mitk::NavigationDataRingBuffer::Sample sample(input);
+    if (sample.m_IGTTimeStamp == 0)
+      sample.m_IGTTimeStamp = GetUpdateTime();
+
+    mitk::NavigationDataRingBuffer::Sample latest;
+    if (m_Buffers[i]->GetLatest(latest) && sample.m_IGTTimeStamp < latest.m_IGTTimeStamp)
+      m_Buffers[i] = mitk::NavigationDataRingBuffer::New(m_BufferCapacity); // the clock was restarted
+    m_Buffers[i]->Push(sample);
+
+    // update output with the state of the input at the delayed time, or not at all if it is not buffered yet
+    mitk::NavigationDataRingBuffer::Sample delayed;
+    if (!m_Buffers[i]->GetInterpolated(sample.m_IGTTimeStamp - m_Delay + m_Tolerance, delayed))
       continue;
-    }
+
     output->Graft(input); // First, copy all information from input to output
-    output->SetDataValid(true); // operation was successful, therefore data of output is valid.
+    delayed.CopyTo(output);
   }
-}
\ No newline at end of file
+}
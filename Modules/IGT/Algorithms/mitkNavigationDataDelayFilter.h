@@ -21,12 +21,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "MitkIGTExports.h"
 #include "mitkNavigationDataToNavigationDataFilter.h"
 #include "mitkNavigationData.h"
+#include "mitkNavigationDataRingBuffer.h"
 #include <mitkCommon.h>
 
-//ITK header
-#include <itkTimeStamp.h>
-
-#include <queue>
+#include <vector>
 
 namespace mitk {
   /**Documentation
@@ -35,19 +33,29 @@ namespace mitk {
   * This Filter is used to delay Navigationdata by a certain amount of time.
   * It is used to synchronize TRacking data with other sources.
   *
+  * The samples of each input are kept in a NavigationDataRingBuffer. Each output is set to the state of its input
+  * at the IGT timestamp of the input minus the delay, interpolated between the buffered samples. Outputs are not
+  * updated until enough samples have been buffered. Inputs without an IGT timestamp get the time of the update, from
+  * the IGT clock if it is started and from a monotonic clock otherwise.
+  *
   * \ingroup IGT
   */
   class MITKIGT_EXPORT NavigationDataDelayFilter : public NavigationDataToNavigationDataFilter
   {
-    //     |pairs of| timestamp and |one navigation Data for each input
-    typedef std::pair<itk::ModifiedTimeType, std::vector<mitk::NavigationData::Pointer> > BufferType;
-
   public:
 
     mitkClassMacro(NavigationDataDelayFilter, NavigationDataToNavigationDataFilter);
     mitkNewMacro1Param(NavigationDataDelayFilter, unsigned int);
 
     itkSetMacro(Delay, unsigned int);
+    itkGetConstMacro(Delay, unsigned int);
+
+    /**
+    * \brief Number of samples buffered per input. Must cover the delay at the update rate of the pipeline.
+    * Takes effect when the buffers are recreated, i.e. when the number of inputs changes.
+    */
+    itkSetMacro(BufferCapacity, unsigned int);
+    itkGetConstMacro(BufferCapacity, unsigned int);
 
   protected:
 
@@ -57,16 +65,16 @@ namespace mitk {
     virtual void GenerateData() override;
 
     /**
-    * \brief This field containes the buffered navigation datas. It is a queue of (pair of (time and vector of (several navigation datas from one point in time))
-    * In more clarity: The top level queue contains (one Navigation Data for each inout and the time these NDs have been recorded at).
+    * \brief One buffer of timestamped samples for each input.
     */
-    std::queue<BufferType> m_Buffer;
+    std::vector<NavigationDataRingBuffer::Pointer> m_Buffers;
 
     /**
     * \brief The amount of time by which the Navigationdatas are delayed in milliseconds
     */
     unsigned int m_Delay;
     unsigned int m_Tolerance;
+    unsigned int m_BufferCapacity;
   };
 } // namespace mitk
 
@@ -29,6 +29,7 @@ mitk::NavigationDataRecorder::NavigationDataRecorder()
 
 mitk::NavigationDataRecorder::~NavigationDataRecorder()
 {
+  // an open stream file is completed by the destructor of m_StreamWriter
   //mitk::IGTTimeStamp::GetInstance()->Stop(this); //commented out because of bug 18952
 }
 
@@ -69,15 +70,18 @@ void mitk::NavigationDataRecorder::GenerateData()
   }
 
   // if limitation is set and has been reached, stop recording
-  if ((m_RecordCountLimit > 0) && (m_NavigationDataSet->Size() >= static_cast<unsigned int>(m_RecordCountLimit)))
+  if ((m_RecordCountLimit > 0) && (this->GetNumberOfRecordedSteps() >= m_RecordCountLimit))
     m_Recording = false;
   // We can skip the rest of the method, if recording is deactivated
   if (!m_Recording) return;
   // We can skip the rest of the method, if we read only valid data
   if (m_RecordOnlyValidData && atLeastOneInputIsInvalid) return;
 
-  // Add data to set
-  m_NavigationDataSet->AddNavigationDatas(clonedDatas);
+  // Add data to stream or set
+  if (m_StreamWriter.IsNotNull())
+    m_StreamWriter->Write(clonedDatas);
+  else
+    m_NavigationDataSet->AddNavigationDatas(clonedDatas);
 }
 
 void mitk::NavigationDataRecorder::StartRecording()
@@ -96,6 +100,9 @@ void mitk::NavigationDataRecorder::StartRecording()
 
   if (m_NavigationDataSet.IsNull())
     m_NavigationDataSet = mitk::NavigationDataSet::New(GetNumberOfIndexedInputs());
+
+  if (!m_StreamFileName.empty() && m_StreamWriter.IsNull())
+    this->OpenStream();
 }
 
 void mitk::NavigationDataRecorder::StopRecording()
@@ -106,12 +113,24 @@ void mitk::NavigationDataRecorder::StopRecording()
     return;
   }
   m_Recording = false;
+
+  if (m_StreamWriter.IsNotNull())
+    m_StreamWriter->Flush();
 }
 
 void mitk::NavigationDataRecorder::ResetRecording()
 {
   m_NavigationDataSet = mitk::NavigationDataSet::New(GetNumberOfIndexedInputs());
 
+  // complete the stream file, the next recording overwrites it
+  if (m_StreamWriter.IsNotNull())
+  {
+    m_StreamWriter->Close();
+    m_StreamWriter = nullptr;
+  }
+  if (m_Recording && !m_StreamFileName.empty())
+    this->OpenStream();
+
   if (m_Recording)
   {
     mitk::IGTTimeStamp::GetInstance()->Stop(this);
@@ -121,5 +140,17 @@ void mitk::NavigationDataRecorder::ResetRecording()
 
 int mitk::NavigationDataRecorder::GetNumberOfRecordedSteps()
 {
+  if (m_StreamWriter.IsNotNull())
+    return m_StreamWriter->GetNumberOfFrames();
   return m_NavigationDataSet->Size();
-}
\ No newline at end of file
+}
+
+void mitk::NavigationDataRecorder::OpenStream()
+{
+  std::vector<std::string> toolNames;
+  for (unsigned int index = 0; index < GetNumberOfIndexedInputs(); index++)
+    toolNames.push_back(this->GetInput(index)->GetName());
+
+  m_StreamWriter = mitk::NavigationDataStreamWriter::New();
+  m_StreamWriter->Open(m_StreamFileName, GetNumberOfIndexedInputs(), toolNames);
+}
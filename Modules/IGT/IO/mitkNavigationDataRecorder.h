@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkNavigationDataToNavigationDataFilter.h"
 #include "mitkNavigationData.h"
 #include "mitkNavigationDataSet.h"
+#include "mitkNavigationDataStreamWriter.h"
 
 namespace mitk
 {
@@ -31,6 +32,11 @@ namespace mitk
   * With StopRecording() the stream is stopped, but can be resumed anytime.
   * To start recording to a new NavigationDataSet, call ResetRecording();
   *
+  * If a stream file name is set before recording is started, the data is streamed to this file
+  * (see mitk::NavigationDataStreamWriter) instead of being kept in the NavigationDataSet, so that the
+  * memory needed for recording does not grow with the length of the recording. The file is completed
+  * by ResetRecording() or when the recorder is destroyed.
+  *
   * \warning Do not add inputs while the recorder ist recording. The recorder can't handle that and will cause a nullpointer exception.
   * \ingroup IGT
   */
@@ -81,6 +87,13 @@ namespace mitk
     */
     itkGetMacro(RecordOnlyValidData, bool);
 
+    /**
+    * \brief Sets the file that the data is streamed to. An empty name (default) records into the NavigationDataSet.
+    * Takes effect with the next call of StartRecording() or ResetRecording(). The file is overwritten.
+    */
+    itkSetStringMacro(StreamFileName);
+    itkGetStringMacro(StreamFileName);
+
     /**
     * \brief Starts recording NavigationData into the NAvigationDataSet
     */
@@ -115,6 +128,12 @@ namespace mitk
 
     virtual ~NavigationDataRecorder();
 
+    /**
+    * \brief Creates m_StreamWriter for m_StreamFileName.
+    * @throw mitk::IGTIOException if the file cannot be created
+    */
+    void OpenStream();
+
     unsigned int m_NumberOfInputs; ///< counts the numbers of added input NavigationDatas
 
     mitk::NavigationDataSet::Pointer m_NavigationDataSet;
@@ -128,6 +147,10 @@ namespace mitk
     int m_RecordCountLimit; ///< limits the number of frames, recording will be stopped if the limit is reached. -1 disables the limit
 
     bool m_RecordOnlyValidData; //< indicates whether only valid data is recorded
+
+    std::string m_StreamFileName; ///< file that the data is streamed to, empty if recording into m_NavigationDataSet
+
+    mitk::NavigationDataStreamWriter::Pointer m_StreamWriter; ///< writes to m_StreamFileName while a stream recording is open
   };
 }
 #endif // #define _MITK_POINT_SET_SOURCE_H
@@ -0,0 +1,133 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataStreamPlayer.h"
+
+//Exceptions
+#include "mitkIGTException.h"
+
+mitk::NavigationDataStreamPlayer::NavigationDataStreamPlayer()
+  : m_Reader(mitk::NavigationDataStreamReader::New()), m_CurrentSnapshot(0), m_Repeat(false)
+{
+  this->SetName("Navigation Data Stream Player Source");
+}
+
+mitk::NavigationDataStreamPlayer::~NavigationDataStreamPlayer()
+{
+}
+
+void mitk::NavigationDataStreamPlayer::SetFileName(const std::string& fileName)
+{
+  m_Reader->Open(fileName);
+  m_CurrentSnapshot = 0;
+
+  const unsigned int numberOfTools = m_Reader->GetNumberOfTools();
+  if (this->GetNumberOfOutputs() == 0)
+  {
+    this->SetNumberOfRequiredOutputs(numberOfTools);
+    for (unsigned int n = 0; n < numberOfTools; ++n)
+    {
+      DataObjectPointer newOutput = this->MakeOutput(n);
+      this->SetNthOutput(n, newOutput);
+    }
+  }
+  else if (this->GetNumberOfOutputs() != numberOfTools)
+  {
+    mitkThrowException(mitk::IGTException)
+      << "Number of tools cannot be changed in existing player. Please create "
+      << "a new player, if the stream has another number of tools.";
+  }
+
+  this->Modified();
+  this->GenerateData();
+}
+
+unsigned int mitk::NavigationDataStreamPlayer::GetNumberOfSnapshots() const
+{
+  return m_Reader->GetNumberOfFrames();
+}
+
+unsigned int mitk::NavigationDataStreamPlayer::GetCurrentSnapshotNumber() const
+{
+  return m_CurrentSnapshot;
+}
+
+bool mitk::NavigationDataStreamPlayer::IsAtEnd() const
+{
+  return m_CurrentSnapshot + 1 >= this->GetNumberOfSnapshots();
+}
+
+void mitk::NavigationDataStreamPlayer::GoToSnapshot(unsigned int i)
+{
+  if (this->GetNumberOfSnapshots() == 0 || (!m_Repeat && this->GetNumberOfSnapshots() <= i))
+  {
+    mitkThrowException(mitk::IGTException) << "Snapshot " << i << " does not exist and repeat is off: can't go to that snapshot!";
+  }
+
+  m_CurrentSnapshot = i % this->GetNumberOfSnapshots();
+  this->GenerateData();
+}
+
+bool mitk::NavigationDataStreamPlayer::GoToNextSnapshot()
+{
+  if (this->IsAtEnd())
+  {
+    if (!m_Repeat || this->GetNumberOfSnapshots() == 0)
+      return false;
+
+    // set data back to start if repeat is enabled
+    m_CurrentSnapshot = 0;
+  }
+  else
+  {
+    ++m_CurrentSnapshot;
+  }
+
+  this->GenerateData();
+  return true;
+}
+
+void mitk::NavigationDataStreamPlayer::GoToTimeStamp(NavigationData::TimeStampType timeStamp)
+{
+  m_CurrentSnapshot = m_Reader->FindFrame(timeStamp);
+  this->GenerateData();
+}
+
+void mitk::NavigationDataStreamPlayer::GenerateData()
+{
+  if (m_CurrentSnapshot >= this->GetNumberOfSnapshots())
+  {
+    // no data available
+    for (unsigned int index = 0; index < this->GetNumberOfOutputs(); index++)
+      this->GetOutput(index)->SetDataValid(false);
+    return;
+  }
+
+  const std::vector<mitk::NavigationData::Pointer> navigationDatas = m_Reader->GetFrame(m_CurrentSnapshot);
+  for (unsigned int index = 0; index < this->GetNumberOfOutputs(); index++)
+  {
+    mitk::NavigationData* output = this->GetOutput(index);
+    if( !output ) { mitkThrowException(mitk::IGTException) << "Output of index "<<index<<" is null."; }
+
+    output->Graft(navigationDatas.at(index));
+  }
+}
+
+void mitk::NavigationDataStreamPlayer::UpdateOutputInformation()
+{
+  this->Modified();  // make sure that we need to be updated
+  Superclass::UpdateOutputInformation();
+}
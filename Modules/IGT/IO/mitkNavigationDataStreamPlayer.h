@@ -0,0 +1,100 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNavigationDataStreamPlayer_H_HEADER_INCLUDED_
+#define MITKNavigationDataStreamPlayer_H_HEADER_INCLUDED_
+
+#include "mitkNavigationDataSource.h"
+#include "mitkNavigationDataStreamReader.h"
+
+namespace mitk
+{
+  /**Documentation
+  * \brief Plays binary NavigationData streams (see mitk::NavigationDataRecorder::SetStreamFileName()) directly from disk.
+  *
+  * Unlike mitk::NavigationDataSequentialPlayer, the recording is not loaded into a NavigationDataSet. Only the time
+  * index and the chunk of the current snapshot are held in memory, so that long recordings can be played and
+  * GoToTimeStamp() can jump to any point in time without reading the whole file.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGT_EXPORT NavigationDataStreamPlayer : public NavigationDataSource
+  {
+  public:
+    mitkClassMacro(NavigationDataStreamPlayer, NavigationDataSource);
+    itkFactorylessNewMacro(Self)
+
+    /**
+    * \brief Set to true if the player should start again at the first snapshot after the last one.
+    */
+    itkSetMacro(Repeat, bool)
+    itkGetMacro(Repeat, bool)
+
+    /**
+    * \brief Opens the stream, creates one output per tool and puts the first snapshot into the outputs.
+    *
+    * @throw mitk::IGTIOException if the file cannot be read
+    * @throw mitk::IGTException if the number of tools differs from the number of existing outputs
+    */
+    void SetFileName(const std::string& fileName);
+
+    unsigned int GetNumberOfSnapshots() const;
+
+    unsigned int GetCurrentSnapshotNumber() const;
+
+    /**
+    * \return true if the last snapshot is in the outputs
+    */
+    bool IsAtEnd() const;
+
+    /**
+    * \brief Puts the i-th snapshot into the outputs. Index begins at 0.
+    * @throw mitk::IGTException if the snapshot does not exist and repeat is off
+    */
+    void GoToSnapshot(unsigned int i);
+
+    /**
+    * \brief Advances the outputs to the next snapshot.
+    * \return false if no next snapshot is available (happens only if m_Repeat is set to false)
+    */
+    bool GoToNextSnapshot();
+
+    /**
+    * \brief Puts the last snapshot recorded at or before @a timeStamp (IGT time in ms) into the outputs.
+    */
+    void GoToTimeStamp(NavigationData::TimeStampType timeStamp);
+
+    /**
+    * \brief Used for pipeline update just to tell the pipeline that we always have to update.
+    */
+    virtual void UpdateOutputInformation() override;
+
+  protected:
+    NavigationDataStreamPlayer();
+    virtual ~NavigationDataStreamPlayer();
+
+    /**
+    * \brief Grafts the current snapshot into the outputs.
+    */
+    virtual void GenerateData() override;
+
+    NavigationDataStreamReader::Pointer m_Reader;
+    unsigned int m_CurrentSnapshot;
+    bool m_Repeat;
+  };
+} // namespace mitk
+
+#endif /* MITKNavigationDataStreamPlayer_H_HEADER_INCLUDED_ */
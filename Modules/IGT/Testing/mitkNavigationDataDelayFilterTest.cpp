@@ -0,0 +1,96 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkNavigationDataDelayFilter.h>
+#include <mitkIGTTimeStamp.h>
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <chrono>
+#include <thread>
+
+class mitkNavigationDataDelayFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNavigationDataDelayFilterTestSuite);
+  MITK_TEST(Update_WithTimeStamps_OutputsDelayedState);
+  MITK_TEST(Update_WithoutTimeStampsAndIGTClock_OutputsDelayedState);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::NavigationData::Pointer m_Input;
+  mitk::NavigationDataDelayFilter::Pointer m_Filter;
+
+  void SetInputState(double x, mitk::NavigationData::TimeStampType timeStamp)
+  {
+    mitk::Point3D position;
+    mitk::FillVector3D(position, x, 2 * x, 3 * x);
+    m_Input->SetPosition(position);
+    m_Input->SetIGTTimeStamp(timeStamp);
+    m_Input->SetDataValid(true);
+  }
+
+public:
+  void setUp() override
+  {
+    m_Input = mitk::NavigationData::New();
+    m_Filter = mitk::NavigationDataDelayFilter::New(10);
+    m_Filter->SetInput(m_Input);
+  }
+
+  void tearDown() override
+  {
+    m_Filter = nullptr;
+    m_Input = nullptr;
+  }
+
+  void Update_WithTimeStamps_OutputsDelayedState()
+  {
+    this->SetInputState(1.0, 100.0);
+    m_Filter->Update();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Output is not updated before the delay is buffered",
+                                         0.0, m_Filter->GetOutput()->GetPosition()[0], mitk::eps);
+
+    this->SetInputState(2.0, 110.0);
+    m_Filter->Update();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("State at 100 ms", 1.0, m_Filter->GetOutput()->GetPosition()[0], mitk::eps);
+
+    this->SetInputState(4.0, 115.0);
+    m_Filter->Update();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("State at 105 ms", 1.5, m_Filter->GetOutput()->GetPosition()[0], mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("z", 4.5, m_Filter->GetOutput()->GetPosition()[2], mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Timestamp", 105.0, m_Filter->GetOutput()->GetIGTTimeStamp(), mitk::eps);
+    CPPUNIT_ASSERT_MESSAGE("Valid", m_Filter->GetOutput()->IsDataValid());
+  }
+
+  void Update_WithoutTimeStampsAndIGTClock_OutputsDelayedState()
+  {
+    CPPUNIT_ASSERT_MESSAGE("IGT clock is not started", mitk::IGTTimeStamp::GetInstance()->GetElapsed() < 0);
+
+    this->SetInputState(1.0, 0.0);
+    m_Filter->Update();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Output is not updated before the delay is buffered",
+                                         0.0, m_Filter->GetOutput()->GetPosition()[0], mitk::eps);
+
+    // the delayed time lies after the first update, so the output is between both states or equals the second one
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    this->SetInputState(2.0, 0.0);
+    m_Filter->Update();
+    CPPUNIT_ASSERT_MESSAGE("Output is updated", m_Filter->GetOutput()->GetPosition()[0] > 1.0);
+    CPPUNIT_ASSERT_MESSAGE("Output is delayed or the newest state",
+                           m_Filter->GetOutput()->GetPosition()[0] <= 2.0 + mitk::eps);
+  }
+};
+MITK_TEST_SUITE_REGISTRATION(mitkNavigationDataDelayFilter)
@@ -0,0 +1,157 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkNavigationDataRingBuffer.h>
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <itkMath.h>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+class mitkNavigationDataRingBufferTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNavigationDataRingBufferTestSuite);
+  MITK_TEST(GetLatest_Empty_ReturnsFalse);
+  MITK_TEST(GetInterpolated_BetweenSamples_InterpolatesPositionAndOrientation);
+  MITK_TEST(GetInterpolated_OutsideOfBuffer_ClampsToNewestOrFails);
+  MITK_TEST(GetInterpolated_InvalidNeighbour_IsInvalid);
+  MITK_TEST(Push_ExceedingCapacity_OverwritesOldestSamples);
+  MITK_TEST(Read_ConcurrentProducer_ReturnsConsistentSamples);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::NavigationDataRingBuffer::Sample CreateSample(double timeStamp, double x, double angle = 0.0, bool valid = true)
+  {
+    mitk::NavigationDataRingBuffer::Sample sample;
+    sample.m_Position[0] = x;
+    sample.m_Position[1] = 2 * x;
+    sample.m_Position[2] = 3 * x;
+    sample.m_Orientation = mitk::Quaternion(0.0, 0.0, std::sin(angle / 2), std::cos(angle / 2)); // rotation around z
+    sample.m_IGTTimeStamp = timeStamp;
+    sample.m_DataValid = valid;
+    return sample;
+  }
+
+public:
+
+  void GetLatest_Empty_ReturnsFalse()
+  {
+    mitk::NavigationDataRingBuffer::Pointer buffer = mitk::NavigationDataRingBuffer::New(8);
+    mitk::NavigationDataRingBuffer::Sample sample;
+    CPPUNIT_ASSERT_MESSAGE("Empty buffer has no latest sample", !buffer->GetLatest(sample));
+    CPPUNIT_ASSERT_MESSAGE("Empty buffer has no interpolated sample", !buffer->GetInterpolated(0.0, sample));
+
+    buffer->Push(this->CreateSample(10.0, 1.0));
+    CPPUNIT_ASSERT_MESSAGE("Latest sample", buffer->GetLatest(sample));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Timestamp of latest sample", 10.0, sample.m_IGTTimeStamp, mitk::eps);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of samples", 1u, buffer->GetNumberOfSamples());
+  }
+
+  void GetInterpolated_BetweenSamples_InterpolatesPositionAndOrientation()
+  {
+    mitk::NavigationDataRingBuffer::Pointer buffer = mitk::NavigationDataRingBuffer::New(8);
+    buffer->Push(this->CreateSample(10.0, 0.0, 0.0));
+    buffer->Push(this->CreateSample(20.0, 4.0, itk::Math::pi / 2));
+    buffer->Push(this->CreateSample(30.0, 8.0, itk::Math::pi / 2));
+
+    mitk::NavigationDataRingBuffer::Sample sample;
+    CPPUNIT_ASSERT_MESSAGE("Sample at 15 ms", buffer->GetInterpolated(15.0, sample));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("x", 2.0, sample.m_Position[0], mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("z", 6.0, sample.m_Position[2], mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Timestamp", 15.0, sample.m_IGTTimeStamp, mitk::eps);
+    CPPUNIT_ASSERT_MESSAGE("Valid", sample.m_DataValid);
+
+    // half of the rotation by 90 degrees
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Orientation z", std::sin(itk::Math::pi / 8), sample.m_Orientation.z(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Orientation r", std::cos(itk::Math::pi / 8), sample.m_Orientation.r(), 1e-9);
+
+    CPPUNIT_ASSERT_MESSAGE("Sample at 27.5 ms", buffer->GetInterpolated(27.5, sample));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("x", 7.0, sample.m_Position[0], mitk::eps);
+
+    CPPUNIT_ASSERT_MESSAGE("Sample at 20 ms", buffer->GetInterpolated(20.0, sample));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("x", 4.0, sample.m_Position[0], mitk::eps);
+  }
+
+  void GetInterpolated_OutsideOfBuffer_ClampsToNewestOrFails()
+  {
+    mitk::NavigationDataRingBuffer::Pointer buffer = mitk::NavigationDataRingBuffer::New(8);
+    buffer->Push(this->CreateSample(10.0, 0.0));
+    buffer->Push(this->CreateSample(20.0, 4.0));
+
+    mitk::NavigationDataRingBuffer::Sample sample;
+    CPPUNIT_ASSERT_MESSAGE("Before the oldest sample", !buffer->GetInterpolated(9.0, sample));
+    CPPUNIT_ASSERT_MESSAGE("After the newest sample", buffer->GetInterpolated(100.0, sample));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Newest sample", 4.0, sample.m_Position[0], mitk::eps);
+  }
+
+  void GetInterpolated_InvalidNeighbour_IsInvalid()
+  {
+    mitk::NavigationDataRingBuffer::Pointer buffer = mitk::NavigationDataRingBuffer::New(8);
+    buffer->Push(this->CreateSample(10.0, 0.0));
+    buffer->Push(this->CreateSample(20.0, 4.0, 0.0, false));
+    buffer->Push(this->CreateSample(30.0, 8.0));
+
+    mitk::NavigationDataRingBuffer::Sample sample;
+    CPPUNIT_ASSERT_MESSAGE("Sample at 15 ms", buffer->GetInterpolated(15.0, sample));
+    CPPUNIT_ASSERT_MESSAGE("Invalid", !sample.m_DataValid);
+  }
+
+  void Push_ExceedingCapacity_OverwritesOldestSamples()
+  {
+    mitk::NavigationDataRingBuffer::Pointer buffer = mitk::NavigationDataRingBuffer::New(4);
+    for (unsigned int i = 0; i < 10; ++i)
+      buffer->Push(this->CreateSample(10.0 * i, i));
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of samples", 4u, buffer->GetNumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of pushed samples", std::uint64_t(10), buffer->GetNumberOfPushedSamples());
+
+    mitk::NavigationDataRingBuffer::Sample sample;
+    CPPUNIT_ASSERT_MESSAGE("Overwritten sample", !buffer->GetInterpolated(55.0, sample));
+    CPPUNIT_ASSERT_MESSAGE("Buffered sample", buffer->GetInterpolated(75.0, sample));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("x", 7.5, sample.m_Position[0], mitk::eps);
+  }
+
+  void Read_ConcurrentProducer_ReturnsConsistentSamples()
+  {
+    mitk::NavigationDataRingBuffer::Pointer buffer = mitk::NavigationDataRingBuffer::New(16);
+    const unsigned int numberOfSamples = 200000;
+    std::atomic<bool> consistent(true);
+
+    // the consumer checks that no sample mixes the values of two pushes
+    std::thread consumer([&]() {
+      mitk::NavigationDataRingBuffer::Sample sample;
+      while (buffer->GetNumberOfPushedSamples() < numberOfSamples)
+      {
+        if (buffer->GetLatest(sample) && sample.m_Position[0] != sample.m_IGTTimeStamp)
+          consistent = false;
+
+        if (buffer->GetInterpolated(buffer->GetNumberOfPushedSamples() - 4.5, sample) &&
+            std::abs(sample.m_Position[0] - sample.m_IGTTimeStamp) > 1e-6)
+          consistent = false;
+      }
+    });
+
+    for (unsigned int i = 0; i < numberOfSamples; ++i)
+      buffer->Push(this->CreateSample(i, i));
+    consumer.join();
+
+    CPPUNIT_ASSERT_MESSAGE("Consistent samples", consistent);
+  }
+};
+MITK_TEST_SUITE_REGISTRATION(mitkNavigationDataRingBuffer)
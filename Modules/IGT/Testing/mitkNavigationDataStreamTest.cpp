@@ -0,0 +1,177 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkNavigationDataStreamPlayer.h>
+#include <mitkNavigationDataStreamReader.h>
+#include <mitkNavigationDataStreamWriter.h>
+#include <mitkIOUtil.h>
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include "mitkIGTIOException.h"
+
+class mitkNavigationDataStreamTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNavigationDataStreamTestSuite);
+  MITK_TEST(WriteAndRead_AllFrames_AreEqual);
+  MITK_TEST(FindFrame_ArbitraryTimeStamp_ReturnsFrameBefore);
+  MITK_TEST(Read_NotClosedFile_RebuildsIndex);
+  MITK_TEST(Player_GoToTimeStamp_SetsOutputs);
+  MITK_TEST(Open_NoStream_ThrowsException);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::string m_FileName;
+  const unsigned int m_NumberOfFrames = 1000;
+
+  // frame i is recorded at 10 * i ms
+  std::vector<mitk::NavigationData::Pointer> CreateFrame(unsigned int i)
+  {
+    std::vector<mitk::NavigationData::Pointer> frame;
+    for (unsigned int tool = 0; tool < 2; ++tool)
+    {
+      mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
+      mitk::NavigationData::PositionType position;
+      position[0] = i;
+      position[1] = tool;
+      position[2] = -1.5 * i;
+      nd->SetPosition(position);
+      nd->SetOrientation(mitk::NavigationData::OrientationType(0.0, 0.6, 0.0, 0.8));
+      nd->SetIGTTimeStamp(10.0 * i);
+      nd->SetDataValid(i % 7 != 0);
+      if (tool == 1)
+        nd->SetPositionAccuracy(0.5);
+      frame.push_back(nd);
+    }
+    return frame;
+  }
+
+  void WriteFrames(mitk::NavigationDataStreamWriter* writer, unsigned int numberOfFrames)
+  {
+    std::vector<std::string> toolNames;
+    toolNames.push_back("Pointer");
+    toolNames.push_back("Reference");
+
+    writer->SetFramesPerChunk(64);
+    writer->Open(m_FileName, 2, toolNames);
+    for (unsigned int i = 0; i < numberOfFrames; ++i)
+      writer->Write(this->CreateFrame(i));
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_FileName = mitk::IOUtil::CreateTemporaryFile("NavigationDataStreamTest-XXXXXX.nds");
+  }
+
+  void tearDown() override
+  {
+    itksys::SystemTools::RemoveFile(m_FileName.c_str());
+  }
+
+  void WriteAndRead_AllFrames_AreEqual()
+  {
+    mitk::NavigationDataStreamWriter::Pointer writer = mitk::NavigationDataStreamWriter::New();
+    this->WriteFrames(writer, m_NumberOfFrames);
+    writer->Close();
+
+    mitk::NavigationDataStreamReader::Pointer reader = mitk::NavigationDataStreamReader::New();
+    reader->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of tools", 2u, reader->GetNumberOfTools());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Tool name", std::string("Reference"), reader->GetToolName(1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of frames", m_NumberOfFrames, reader->GetNumberOfFrames());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Last timestamp", 10.0 * (m_NumberOfFrames - 1), reader->GetLastTimeStamp(), mitk::eps);
+
+    for (unsigned int i = 0; i < m_NumberOfFrames; i += 37)
+    {
+      std::vector<mitk::NavigationData::Pointer> expected = this->CreateFrame(i);
+      std::vector<mitk::NavigationData::Pointer> frame = reader->GetFrame(i);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of tools in frame", size_t(2), frame.size());
+      for (unsigned int tool = 0; tool < 2; ++tool)
+      {
+        expected[tool]->SetName(reader->GetToolName(tool));
+        CPPUNIT_ASSERT_MESSAGE("NavigationData of frame", mitk::Equal(*expected[tool], *frame[tool], mitk::eps, true));
+      }
+    }
+
+    mitk::NavigationDataSet::Pointer navigationDataSet = reader->ReadNavigationDataSet();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Size of NavigationDataSet", m_NumberOfFrames, navigationDataSet->Size());
+  }
+
+  void FindFrame_ArbitraryTimeStamp_ReturnsFrameBefore()
+  {
+    mitk::NavigationDataStreamWriter::Pointer writer = mitk::NavigationDataStreamWriter::New();
+    this->WriteFrames(writer, m_NumberOfFrames);
+    writer->Close();
+
+    mitk::NavigationDataStreamReader::Pointer reader = mitk::NavigationDataStreamReader::New();
+    reader->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Before first frame", 0u, reader->FindFrame(-5.0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Exact timestamp", 500u, reader->FindFrame(5000.0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Between frames", 500u, reader->FindFrame(5009.0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("End of chunk", 639u, reader->FindFrame(6395.0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("After last frame", m_NumberOfFrames - 1, reader->FindFrame(1e9));
+  }
+
+  void Read_NotClosedFile_RebuildsIndex()
+  {
+    // the writer is still open, e.g. the application crashed during recording
+    mitk::NavigationDataStreamWriter::Pointer writer = mitk::NavigationDataStreamWriter::New();
+    this->WriteFrames(writer, 100);
+
+    mitk::NavigationDataStreamReader::Pointer reader = mitk::NavigationDataStreamReader::New();
+    reader->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Complete chunks are read", 64u, reader->GetNumberOfFrames());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Search in rebuilt index", 42u, reader->FindFrame(420.0));
+  }
+
+  void Player_GoToTimeStamp_SetsOutputs()
+  {
+    mitk::NavigationDataStreamWriter::Pointer writer = mitk::NavigationDataStreamWriter::New();
+    this->WriteFrames(writer, m_NumberOfFrames);
+    writer->Close();
+
+    mitk::NavigationDataStreamPlayer::Pointer player = mitk::NavigationDataStreamPlayer::New();
+    player->SetFileName(m_FileName);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of outputs", 2u, static_cast<unsigned int>(player->GetNumberOfOutputs()));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of snapshots", m_NumberOfFrames, player->GetNumberOfSnapshots());
+
+    player->GoToTimeStamp(7777.0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Current snapshot", 777u, player->GetCurrentSnapshotNumber());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Position of output", 777.0, player->GetOutput(0)->GetPosition()[0], mitk::eps);
+
+    CPPUNIT_ASSERT_MESSAGE("Next snapshot", player->GoToNextSnapshot());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Timestamp of output", 7780.0, player->GetOutput(1)->GetIGTTimeStamp(), mitk::eps);
+
+    player->GoToSnapshot(m_NumberOfFrames - 1);
+    CPPUNIT_ASSERT_MESSAGE("At end", player->IsAtEnd());
+    CPPUNIT_ASSERT_MESSAGE("No next snapshot without repeat", !player->GoToNextSnapshot());
+  }
+
+  void Open_NoStream_ThrowsException()
+  {
+    std::ofstream file(m_FileName.c_str());
+    file << "no navigation data stream";
+    file.close();
+
+    mitk::NavigationDataStreamReader::Pointer reader = mitk::NavigationDataStreamReader::New();
+    CPPUNIT_ASSERT_THROW(reader->Open(m_FileName), mitk::IGTIOException);
+  }
+};
+MITK_TEST_SUITE_REGISTRATION(mitkNavigationDataStream)
@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkIGTExports.h>
 #include <mitkCommon.h>
 #include <mitkNumericTypes.h>
+#include <mitkNavigationDataRingBuffer.h>
 #include <itkFastMutexLock.h>
 
 namespace mitk
@@ -52,6 +53,8 @@ namespace mitk
     virtual const char* GetErrorMessage() const;     ///< if the data is not valid, ErrorMessage should contain a string explaining why it is invalid (the Set-method should be implemented in subclasses, it should not be accessible by the user)
     itkSetMacro(IGTTimeStamp, double);               ///< Sets the IGT timestamp of the tracking tool object (time in milliseconds)
     itkGetConstMacro(IGTTimeStamp, double);          ///< Gets the IGT timestamp of the tracking tool object (time in milliseconds). Returns 0 if the timestamp was not set.
+    itkSetObjectMacro(NavigationDataBuffer, NavigationDataRingBuffer); ///< Sets a buffer that the tracking thread of the device writes every sample of this tool into. Has to be set before tracking is started.
+    itkGetObjectMacro(NavigationDataBuffer, NavigationDataRingBuffer); ///< Returns the sample buffer of this tool or nullptr. Devices that do not support buffering ignore it.
 
   protected:
     TrackingTool();
@@ -60,6 +63,7 @@ namespace mitk
     std::string m_ErrorMessage;                      ///< if a tool is invalid, this member should contain a human readable explanation of why it is invalid
     double m_IGTTimeStamp;                           ///< contains the time at which the tracking data was recorded
     itk::FastMutexLock::Pointer m_MyMutex;           ///< mutex to control concurrent access to the tool
+    NavigationDataRingBuffer::Pointer m_NavigationDataBuffer; ///< optional lock-free buffer of the tracked samples
   };
 } // namespace mitk
 #endif /* MITKTRACKINGTOOL_H_HEADER_INCLUDED_ */
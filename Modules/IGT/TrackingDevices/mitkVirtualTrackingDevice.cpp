@@ -266,7 +266,20 @@ void mitk::VirtualTrackingDevice::TrackTools()
 
       currentTool->SetTrackingError(2 * (rand() / (RAND_MAX + 1.0)));  // tracking error in 0 .. 2 Range
       currentTool->SetDataValid(true);
+      currentTool->SetIGTTimeStamp(mitk::IGTTimeStamp::GetInstance()->GetElapsed());
       currentTool->Modified();
+
+      // hand the sample over to the consumers without locking
+      mitk::NavigationDataRingBuffer* buffer = currentTool->GetNavigationDataBuffer();
+      if (buffer != nullptr)
+      {
+        mitk::NavigationDataRingBuffer::Sample sample;
+        sample.m_Position = mp;
+        sample.m_Orientation = quat;
+        sample.m_IGTTimeStamp = currentTool->GetIGTTimeStamp();
+        sample.m_DataValid = true;
+        buffer->Push(sample);
+      }
     }
     itksys::SystemTools::Delay(m_RefreshRate);
     /* Update the local copy of m_StopTracking */
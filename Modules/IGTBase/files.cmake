@@ -4,6 +4,9 @@ set(CPP_FILES
   mitkRealTimeClock.cpp
   mitkNavigationData.cpp
   mitkNavigationDataSet.cpp
+  mitkNavigationDataRingBuffer.cpp
+  mitkNavigationDataStreamReader.cpp
+  mitkNavigationDataStreamWriter.cpp
   mitkStaticIGTHelperFunctions.cpp
   mitkQuaternionAveraging.cpp
   mitkIGTMimeTypes.cpp
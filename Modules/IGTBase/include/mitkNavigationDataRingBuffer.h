@@ -0,0 +1,125 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNAVIGATIONDATARINGBUFFER_H_HEADER_INCLUDED_
+#define MITKNAVIGATIONDATARINGBUFFER_H_HEADER_INCLUDED_
+
+#include "MitkIGTBaseExports.h"
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <mitkCommon.h>
+#include <mitkNavigationData.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace mitk {
+
+  /**Documentation
+  * \brief Lock-free ring buffer of timestamped tracking samples with one producer and any number of consumers.
+  *
+  * The producer (usually the tracking thread of a tracking device) writes samples with Push(), consumers read
+  * them with GetLatest() or GetInterpolated() from any thread without locking. The memory of the buffer is allocated
+  * once in the constructor, the oldest samples are overwritten when the buffer is full.
+  *
+  * Every slot is guarded by a sequence counter (seqlock): the producer marks the slot as being written before
+  * it changes the values, consumers repeat or reject a read if the slot was written concurrently.
+  * The timestamps of the pushed samples have to increase monotonically.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGTBASE_EXPORT NavigationDataRingBuffer : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(NavigationDataRingBuffer, itk::Object);
+    mitkNewMacro1Param(Self, unsigned int);
+
+    /**
+    * \brief One tracking sample, the timestamp is an IGT timestamp in milliseconds.
+    */
+    struct Sample
+    {
+      Sample();
+      explicit Sample(const NavigationData* data);
+
+      /** \brief Copies position, orientation, validity and timestamp into @a data. */
+      void CopyTo(NavigationData* data) const;
+
+      NavigationData::PositionType m_Position;
+      NavigationData::OrientationType m_Orientation;
+      NavigationData::TimeStampType m_IGTTimeStamp;
+      bool m_DataValid;
+    };
+
+    /**
+    * \brief Appends a sample, overwriting the oldest one if the buffer is full. Must only be called by the producer.
+    */
+    void Push(const Sample& sample);
+    void Push(const NavigationData* data);
+
+    /**
+    * \brief Copies the newest sample to @a sample. Returns false if the buffer is empty.
+    */
+    bool GetLatest(Sample& sample) const;
+
+    /**
+    * \brief Returns the state at @a timeStamp, interpolated between the neighbouring samples.
+    *
+    * Positions are interpolated linearly, orientations by spherical linear interpolation. The interpolated sample
+    * is valid only if both neighbours are valid. Timestamps after the newest sample give the newest sample.
+    * Returns false if @a timeStamp is older than the oldest sample in the buffer or the buffer is empty.
+    */
+    bool GetInterpolated(NavigationData::TimeStampType timeStamp, Sample& sample) const;
+
+    unsigned int GetCapacity() const;
+
+    /** \brief Number of samples that can be read, at most the capacity. */
+    unsigned int GetNumberOfSamples() const;
+
+    /** \brief Number of samples pushed since the construction of the buffer. */
+    std::uint64_t GetNumberOfPushedSamples() const;
+
+  protected:
+    /** \param capacity number of samples, at least 2 */
+    NavigationDataRingBuffer(unsigned int capacity);
+    virtual ~NavigationDataRingBuffer();
+
+    /** 3 position, 4 orientation, timestamp and validity */
+    static const unsigned int NumberOfValues = 9;
+
+    struct Slot
+    {
+      /** 2 * (index + 1) of the stored sample, odd while the sample is written */
+      std::atomic<std::uint64_t> m_Sequence;
+      std::atomic<double> m_Values[NumberOfValues];
+    };
+
+    /**
+    * \brief Reads the sample with the global @a index. Returns false if it was overwritten before or during the read.
+    */
+    bool Read(std::uint64_t index, Sample& sample) const;
+
+    static Quaternion Slerp(const Quaternion& from, const Quaternion& to, double t);
+
+    const unsigned int m_Capacity;
+    std::unique_ptr<Slot[]> m_Slots;
+    /** number of pushed samples, only incremented by the producer */
+    std::atomic<std::uint64_t> m_NumberOfPushedSamples;
+  };
+} // namespace mitk
+
+#endif /* MITKNAVIGATIONDATARINGBUFFER_H_HEADER_INCLUDED_ */
@@ -0,0 +1,107 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNAVIGATIONDATASTREAMREADER_H_HEADER_INCLUDED_
+#define MITKNAVIGATIONDATASTREAMREADER_H_HEADER_INCLUDED_
+
+#include <MitkIGTBaseExports.h>
+#include <mitkNavigationDataSet.h>
+#include <mitkNavigationDataStreamWriter.h>
+
+namespace mitk {
+
+  /**Documentation
+  * \brief Random access to the frames of a file written by NavigationDataStreamWriter.
+  *
+  * Opening a file reads only its header and its time index. Frames are read chunk by chunk when they are
+  * requested; the most recently read chunk is kept in memory, so that sequential access reads every chunk once.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGTBASE_EXPORT NavigationDataStreamReader : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(NavigationDataStreamReader, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    typedef NavigationDataStreamWriter::ChunkInfo ChunkInfo;
+
+    /**
+    * \brief Opens the file and reads its time index. If the file has no index, it is rebuilt from the chunk headers.
+    *
+    * @throw mitk::IGTIOException if the file cannot be opened or is no NavigationData stream
+    */
+    void Open(const std::string& fileName);
+
+    void Close();
+
+    bool IsOpen() const;
+
+    unsigned int GetNumberOfTools() const;
+    std::string GetToolName(unsigned int toolIndex) const;
+
+    unsigned int GetNumberOfFrames() const;
+
+    /** \brief Timestamp of the first frame, 0 if the file contains no frames. */
+    NavigationData::TimeStampType GetFirstTimeStamp() const;
+
+    /** \brief Timestamp of the last frame, 0 if the file contains no frames. */
+    NavigationData::TimeStampType GetLastTimeStamp() const;
+
+    /**
+    * \brief Returns the NavigationDatas of all tools of the frame.
+    *
+    * @throw mitk::IGTIOException if the index is out of range or the file cannot be read
+    */
+    std::vector<NavigationData::Pointer> GetFrame(unsigned int frameIndex);
+
+    /**
+    * \brief Returns the index of the last frame whose timestamp is not later than @a timeStamp,
+    * or 0 if @a timeStamp is before the first frame. Reads at most one chunk.
+    */
+    unsigned int FindFrame(NavigationData::TimeStampType timeStamp);
+
+    /**
+    * \brief Reads all frames into a NavigationDataSet.
+    */
+    NavigationDataSet::Pointer ReadNavigationDataSet();
+
+  protected:
+    NavigationDataStreamReader();
+    virtual ~NavigationDataStreamReader();
+
+    void ReadHeader();
+    bool ReadIndex();
+    void RebuildIndex();
+    void LoadChunk(std::size_t chunkIndex);
+    void ReadBytes(void* data, std::size_t size);
+
+    std::ifstream m_Stream;
+    std::string m_FileName;
+    std::uint64_t m_FileSize;
+    std::uint64_t m_DataOffset;
+
+    std::vector<std::string> m_ToolNames;
+    std::vector<ChunkInfo> m_Index;
+    std::uint64_t m_NumberOfFrames;
+
+    /** frames of the chunk that was read last */
+    std::size_t m_LoadedChunk;
+    std::vector<std::vector<NavigationData::Pointer> > m_LoadedFrames;
+  };
+} // namespace mitk
+
+#endif /* MITKNAVIGATIONDATASTREAMREADER_H_HEADER_INCLUDED_ */
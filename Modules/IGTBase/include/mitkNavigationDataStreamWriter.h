@@ -0,0 +1,126 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNAVIGATIONDATASTREAMWRITER_H_HEADER_INCLUDED_
+#define MITKNAVIGATIONDATASTREAMWRITER_H_HEADER_INCLUDED_
+
+#include <MitkIGTBaseExports.h>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <mitkCommon.h>
+#include <mitkNavigationData.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace mitk {
+
+  /**Documentation
+  * \brief Appends NavigationData of several tools to a binary, chunked stream file.
+  *
+  * Each call of Write() appends one frame, i.e. one NavigationData per tool. Frames are collected in a chunk of
+  * FramesPerChunk frames which is written to disk as soon as it is full, so that the memory needed for recording
+  * does not grow with the length of the recording. When the file is closed, a time index of all chunks is appended,
+  * which allows NavigationDataStreamReader to seek to any timestamp without reading the whole file.
+  * Files that were not closed (e.g. after a crash) stay readable up to the last complete chunk.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGTBASE_EXPORT NavigationDataStreamWriter : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(NavigationDataStreamWriter, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /**
+    * \brief Entry of the time index, describes one chunk of the file.
+    */
+    struct ChunkInfo
+    {
+      std::uint64_t m_Offset;
+      std::uint64_t m_FirstFrame;
+      std::uint32_t m_NumberOfFrames;
+      NavigationData::TimeStampType m_FirstTimeStamp;
+      NavigationData::TimeStampType m_LastTimeStamp;
+    };
+
+    /**
+    * \brief Number of frames per chunk, takes effect when the next file is opened. Default is 256.
+    */
+    itkSetMacro(FramesPerChunk, unsigned int);
+    itkGetConstMacro(FramesPerChunk, unsigned int);
+
+    /**
+    * \brief Creates the file and writes its header. An open file is closed before.
+    *
+    * @param toolNames names of the tools, missing names are left empty
+    * @throw mitk::IGTIOException if the file cannot be created
+    */
+    void Open(const std::string& fileName, unsigned int numberOfTools, const std::vector<std::string>& toolNames = std::vector<std::string>());
+
+    /**
+    * \brief Appends one frame, the timestamp of the frame is the timestamp of the first tool.
+    *
+    * @throw mitk::IGTIOException if no file is open, the number of NavigationDatas does not match the number of tools or writing fails
+    */
+    void Write(const std::vector<NavigationData::Pointer>& navigationDatas);
+
+    /**
+    * \brief Writes the current chunk to disk, even if it is not full.
+    */
+    void Flush();
+
+    /**
+    * \brief Writes the remaining frames and the time index and closes the file.
+    */
+    void Close();
+
+    bool IsOpen() const;
+
+    unsigned int GetNumberOfTools() const;
+
+    /**
+    * \brief Number of frames written since the file was opened.
+    */
+    unsigned int GetNumberOfFrames() const;
+
+  protected:
+    NavigationDataStreamWriter();
+    virtual ~NavigationDataStreamWriter();
+
+    void WriteChunk();
+    void WriteBytes(const void* data, std::size_t size);
+
+    unsigned int m_FramesPerChunk;
+    unsigned int m_NumberOfTools;
+    std::uint64_t m_NumberOfFrames;
+
+    std::ofstream m_Stream;
+    std::string m_FileName;
+
+    /** records of the frames of the current chunk */
+    std::string m_Chunk;
+    std::uint32_t m_NumberOfFramesInChunk;
+    NavigationData::TimeStampType m_ChunkFirstTimeStamp;
+    NavigationData::TimeStampType m_ChunkLastTimeStamp;
+
+    std::vector<ChunkInfo> m_Index;
+  };
+} // namespace mitk
+
+#endif /* MITKNAVIGATIONDATASTREAMWRITER_H_HEADER_INCLUDED_ */
@@ -35,4 +35,14 @@ mitk::CustomMimeType mitk::IGTMimeTypes::NAVIGATIONDATASETCSV_MIMETYPE()
   mimeType.SetCategory(category);
   mimeType.AddExtension("csv");
   return mimeType;
-}
\ No newline at end of file
+}
+
+mitk::CustomMimeType mitk::IGTMimeTypes::NAVIGATIONDATASETBINARY_MIMETYPE()
+{
+  mitk::CustomMimeType mimeType(IOMimeTypes::DEFAULT_BASE_NAME() + ".NavigationDataSet.nds");
+  std::string category = "NavigationDataSet";
+  mimeType.SetComment("NavigationDataSet (binary stream)");
+  mimeType.SetCategory(category);
+  mimeType.AddExtension("nds");
+  return mimeType;
+}
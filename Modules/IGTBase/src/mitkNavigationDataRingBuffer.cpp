@@ -0,0 +1,240 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataRingBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // a lookup is repeated if the producer overwrote the samples that were searched
+  const unsigned int NumberOfLookupAttempts = 4;
+}
+
+mitk::NavigationDataRingBuffer::Sample::Sample()
+  : m_Orientation(0.0, 0.0, 0.0, 1.0), m_IGTTimeStamp(0.0), m_DataValid(false)
+{
+  m_Position.Fill(0.0);
+}
+
+mitk::NavigationDataRingBuffer::Sample::Sample(const NavigationData* data)
+  : m_Position(data->GetPosition()),
+    m_Orientation(data->GetOrientation()),
+    m_IGTTimeStamp(data->GetIGTTimeStamp()),
+    m_DataValid(data->IsDataValid())
+{
+}
+
+void mitk::NavigationDataRingBuffer::Sample::CopyTo(NavigationData* data) const
+{
+  data->SetPosition(m_Position);
+  data->SetOrientation(m_Orientation);
+  data->SetIGTTimeStamp(m_IGTTimeStamp);
+  data->SetDataValid(m_DataValid);
+}
+
+mitk::NavigationDataRingBuffer::NavigationDataRingBuffer(unsigned int capacity)
+  : itk::Object(), m_Capacity(std::max(2u, capacity)), m_Slots(new Slot[std::max(2u, capacity)]), m_NumberOfPushedSamples(0)
+{
+  for (unsigned int i = 0; i < m_Capacity; ++i)
+  {
+    m_Slots[i].m_Sequence.store(0, std::memory_order_relaxed);
+    for (unsigned int j = 0; j < NumberOfValues; ++j)
+      m_Slots[i].m_Values[j].store(0.0, std::memory_order_relaxed);
+  }
+}
+
+mitk::NavigationDataRingBuffer::~NavigationDataRingBuffer()
+{
+}
+
+void mitk::NavigationDataRingBuffer::Push(const Sample& sample)
+{
+  const std::uint64_t index = m_NumberOfPushedSamples.load(std::memory_order_relaxed);
+  Slot& slot = m_Slots[index % m_Capacity];
+
+  slot.m_Sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (unsigned int i = 0; i < 3; ++i)
+    slot.m_Values[i].store(sample.m_Position[i], std::memory_order_relaxed);
+  slot.m_Values[3].store(sample.m_Orientation.x(), std::memory_order_relaxed);
+  slot.m_Values[4].store(sample.m_Orientation.y(), std::memory_order_relaxed);
+  slot.m_Values[5].store(sample.m_Orientation.z(), std::memory_order_relaxed);
+  slot.m_Values[6].store(sample.m_Orientation.r(), std::memory_order_relaxed);
+  slot.m_Values[7].store(sample.m_IGTTimeStamp, std::memory_order_relaxed);
+  slot.m_Values[8].store(sample.m_DataValid ? 1.0 : 0.0, std::memory_order_relaxed);
+
+  slot.m_Sequence.store(2 * index + 2, std::memory_order_release);
+  m_NumberOfPushedSamples.store(index + 1, std::memory_order_release);
+}
+
+void mitk::NavigationDataRingBuffer::Push(const NavigationData* data)
+{
+  if (data != nullptr)
+    this->Push(Sample(data));
+}
+
+bool mitk::NavigationDataRingBuffer::Read(std::uint64_t index, Sample& sample) const
+{
+  const Slot& slot = m_Slots[index % m_Capacity];
+
+  const std::uint64_t sequence = slot.m_Sequence.load(std::memory_order_acquire);
+  if (sequence != 2 * index + 2)
+    return false; // overwritten or still being written
+
+  double values[NumberOfValues];
+  for (unsigned int i = 0; i < NumberOfValues; ++i)
+    values[i] = slot.m_Values[i].load(std::memory_order_relaxed);
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.m_Sequence.load(std::memory_order_relaxed) != sequence)
+    return false;
+
+  for (unsigned int i = 0; i < 3; ++i)
+    sample.m_Position[i] = values[i];
+  sample.m_Orientation = Quaternion(values[3], values[4], values[5], values[6]);
+  sample.m_IGTTimeStamp = values[7];
+  sample.m_DataValid = values[8] != 0.0;
+  return true;
+}
+
+bool mitk::NavigationDataRingBuffer::GetLatest(Sample& sample) const
+{
+  for (unsigned int attempt = 0; attempt < NumberOfLookupAttempts; ++attempt)
+  {
+    const std::uint64_t numberOfSamples = m_NumberOfPushedSamples.load(std::memory_order_acquire);
+    if (numberOfSamples == 0)
+      return false;
+
+    if (this->Read(numberOfSamples - 1, sample))
+      return true;
+  }
+  return false;
+}
+
+bool mitk::NavigationDataRingBuffer::GetInterpolated(NavigationData::TimeStampType timeStamp, Sample& sample) const
+{
+  for (unsigned int attempt = 0; attempt < NumberOfLookupAttempts; ++attempt)
+  {
+    const std::uint64_t numberOfSamples = m_NumberOfPushedSamples.load(std::memory_order_acquire);
+    if (numberOfSamples == 0)
+      return false;
+
+    std::uint64_t newest = numberOfSamples - 1;
+    Sample newer;
+    if (!this->Read(newest, newer))
+      continue;
+    if (timeStamp >= newer.m_IGTTimeStamp)
+    {
+      sample = newer;
+      return true;
+    }
+
+    // the slot of the oldest sample is the next one the producer overwrites, so it is skipped
+    std::uint64_t oldest = numberOfSamples >= m_Capacity ? numberOfSamples - m_Capacity + 1 : 0;
+    Sample older;
+    if (!this->Read(oldest, older))
+      continue;
+    if (timeStamp < older.m_IGTTimeStamp)
+      return false;
+
+    // binary search for the samples enclosing the timestamp: older <= timeStamp < newer
+    bool overwritten = false;
+    while (newest - oldest > 1)
+    {
+      const std::uint64_t middle = oldest + (newest - oldest) / 2;
+      Sample current;
+      if (!this->Read(middle, current))
+      {
+        overwritten = true;
+        break;
+      }
+
+      if (current.m_IGTTimeStamp <= timeStamp)
+      {
+        oldest = middle;
+        older = current;
+      }
+      else
+      {
+        newest = middle;
+        newer = current;
+      }
+    }
+    if (overwritten)
+      continue;
+
+    const double interval = newer.m_IGTTimeStamp - older.m_IGTTimeStamp;
+    const double weight = interval > 0.0 ? (timeStamp - older.m_IGTTimeStamp) / interval : 0.0;
+
+    for (unsigned int i = 0; i < 3; ++i)
+      sample.m_Position[i] = older.m_Position[i] + weight * (newer.m_Position[i] - older.m_Position[i]);
+    sample.m_Orientation = Slerp(older.m_Orientation, newer.m_Orientation, weight);
+    sample.m_IGTTimeStamp = timeStamp;
+    sample.m_DataValid = older.m_DataValid && newer.m_DataValid;
+    return true;
+  }
+  return false;
+}
+
+mitk::Quaternion mitk::NavigationDataRingBuffer::Slerp(const Quaternion& from, const Quaternion& to, double t)
+{
+  double cosTheta = from.x() * to.x() + from.y() * to.y() + from.z() * to.z() + from.r() * to.r();
+
+  // q and -q are the same rotation, take the shorter arc
+  double sign = 1.0;
+  if (cosTheta < 0.0)
+  {
+    cosTheta = -cosTheta;
+    sign = -1.0;
+  }
+
+  double fromWeight = 1.0 - t;
+  double toWeight = t;
+  if (cosTheta < 0.9995) // otherwise the quaternions are almost equal and linear interpolation is sufficient
+  {
+    const double theta = std::acos(cosTheta);
+    const double sinTheta = std::sin(theta);
+    fromWeight = std::sin((1.0 - t) * theta) / sinTheta;
+    toWeight = std::sin(t * theta) / sinTheta;
+  }
+  toWeight *= sign;
+
+  Quaternion result(fromWeight * from.x() + toWeight * to.x(),
+                    fromWeight * from.y() + toWeight * to.y(),
+                    fromWeight * from.z() + toWeight * to.z(),
+                    fromWeight * from.r() + toWeight * to.r());
+  result.normalize();
+  return result;
+}
+
+unsigned int mitk::NavigationDataRingBuffer::GetCapacity() const
+{
+  return m_Capacity;
+}
+
+unsigned int mitk::NavigationDataRingBuffer::GetNumberOfSamples() const
+{
+  const std::uint64_t numberOfSamples = m_NumberOfPushedSamples.load(std::memory_order_acquire);
+  return static_cast<unsigned int>(std::min<std::uint64_t>(numberOfSamples, m_Capacity));
+}
+
+std::uint64_t mitk::NavigationDataRingBuffer::GetNumberOfPushedSamples() const
+{
+  return m_NumberOfPushedSamples.load(std::memory_order_acquire);
+}
@@ -0,0 +1,158 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNAVIGATIONDATASTREAMFORMAT_H_HEADER_INCLUDED_
+#define MITKNAVIGATIONDATASTREAMFORMAT_H_HEADER_INCLUDED_
+
+#include "mitkIGTIOException.h"
+#include "mitkNavigationData.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace mitk
+{
+  /**
+  * \brief Layout of the binary NavigationData stream files, shared by NavigationDataStreamWriter and NavigationDataStreamReader.
+  *
+  * All values are stored in the byte order of the recording machine, which is checked by the reader.
+  *
+  * \code
+  * header: char[8] magic, uint32 version, uint32 byte order mark, uint32 number of tools,
+  *         per tool: uint32 name length, name
+  * chunk:  uint32 chunk tag, uint32 number of frames, uint64 payload size,
+  *         double first time stamp, double last time stamp, payload
+  *         payload: per frame and tool one record:
+  *         uint8 flags, double time stamp, double position[3], double orientation[4] (x, y, z, r),
+  *         double covariance[21] (upper triangle, only if the covariance is not the identity)
+  * index:  uint32 index tag, uint64 number of chunks,
+  *         per chunk: uint64 file offset, uint64 first frame, uint32 number of frames, double first/last time stamp
+  * footer: uint64 file offset of the index, char[8] footer magic
+  * \endcode
+  *
+  * Index and footer are written when the file is closed. Files without them (e.g. after a crash) are read by
+  * scanning the chunk headers; a truncated last chunk is ignored.
+  */
+  namespace NavigationDataStreamFormat
+  {
+    const char Magic[8] = {'M', 'I', 'T', 'K', 'N', 'D', 'S', 'B'};
+    const char FooterMagic[8] = {'M', 'I', 'T', 'K', 'N', 'D', 'S', 'I'};
+    const std::uint32_t Version = 1;
+    const std::uint32_t ByteOrderMark = 0x01020304;
+    const std::uint32_t ChunkTag = 0x4B4E4843; // "CHNK"
+    const std::uint32_t IndexTag = 0x58444E49; // "INDX"
+
+    const std::uint64_t ChunkHeaderSize = 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t) + 2 * sizeof(double);
+    const std::uint64_t FooterSize = sizeof(std::uint64_t) + sizeof(FooterMagic);
+
+    enum RecordFlags
+    {
+      DataValid = 1,
+      HasPosition = 2,
+      HasOrientation = 4,
+      HasCovariance = 8
+    };
+
+    template <typename T>
+    void Append(std::string &buffer, const T &value)
+    {
+      buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    T Extract(const char *&data, const char *end)
+    {
+      if (static_cast<std::size_t>(end - data) < sizeof(T))
+        mitkThrowException(mitk::IGTIOException) << "Unexpected end of NavigationData stream record.";
+
+      T value;
+      std::memcpy(&value, data, sizeof(T));
+      data += sizeof(T);
+      return value;
+    }
+
+    inline void AppendRecord(std::string &buffer, const NavigationData *data)
+    {
+      // the default identity covariance is not stored
+      const NavigationData::CovarianceMatrixType &covariance = data->GetCovErrorMatrix();
+      bool hasCovariance = false;
+      for (unsigned int row = 0; row < 6 && !hasCovariance; ++row)
+        for (unsigned int column = row; column < 6; ++column)
+          if (covariance[row][column] != (row == column ? 1.0 : 0.0))
+          {
+            hasCovariance = true;
+            break;
+          }
+
+      std::uint8_t flags = 0;
+      flags |= data->IsDataValid() ? DataValid : 0;
+      flags |= data->GetHasPosition() ? HasPosition : 0;
+      flags |= data->GetHasOrientation() ? HasOrientation : 0;
+      flags |= hasCovariance ? HasCovariance : 0;
+      Append(buffer, flags);
+
+      Append(buffer, data->GetIGTTimeStamp());
+      const NavigationData::PositionType position = data->GetPosition();
+      for (unsigned int i = 0; i < 3; ++i)
+        Append(buffer, static_cast<double>(position[i]));
+      const NavigationData::OrientationType orientation = data->GetOrientation();
+      Append(buffer, static_cast<double>(orientation.x()));
+      Append(buffer, static_cast<double>(orientation.y()));
+      Append(buffer, static_cast<double>(orientation.z()));
+      Append(buffer, static_cast<double>(orientation.r()));
+
+      if (hasCovariance)
+        for (unsigned int row = 0; row < 6; ++row)
+          for (unsigned int column = row; column < 6; ++column)
+            Append(buffer, static_cast<double>(covariance[row][column]));
+    }
+
+    inline NavigationData::Pointer ExtractRecord(const char *&data, const char *end, const std::string &name)
+    {
+      NavigationData::Pointer navigationData = NavigationData::New();
+      navigationData->SetName(name);
+
+      const std::uint8_t flags = Extract<std::uint8_t>(data, end);
+      navigationData->SetDataValid((flags & DataValid) != 0);
+      navigationData->SetHasPosition((flags & HasPosition) != 0);
+      navigationData->SetHasOrientation((flags & HasOrientation) != 0);
+
+      navigationData->SetIGTTimeStamp(Extract<double>(data, end));
+      NavigationData::PositionType position;
+      for (unsigned int i = 0; i < 3; ++i)
+        position[i] = Extract<double>(data, end);
+      navigationData->SetPosition(position);
+      const double x = Extract<double>(data, end);
+      const double y = Extract<double>(data, end);
+      const double z = Extract<double>(data, end);
+      const double r = Extract<double>(data, end);
+      navigationData->SetOrientation(NavigationData::OrientationType(x, y, z, r));
+
+      if ((flags & HasCovariance) != 0)
+      {
+        NavigationData::CovarianceMatrixType covariance;
+        for (unsigned int row = 0; row < 6; ++row)
+          for (unsigned int column = row; column < 6; ++column)
+            covariance[row][column] = covariance[column][row] = Extract<double>(data, end);
+        navigationData->SetCovErrorMatrix(covariance);
+      }
+      return navigationData;
+    }
+  }
+}
+
+#endif /* MITKNAVIGATIONDATASTREAMFORMAT_H_HEADER_INCLUDED_ */
@@ -0,0 +1,334 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataStreamReader.h"
+#include "mitkNavigationDataStreamFormat.h"
+#include "mitkIGTIOException.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+  const std::size_t NoChunk = std::numeric_limits<std::size_t>::max();
+
+  // size of one entry of the time index in the file
+  const std::uint64_t IndexEntrySize = 2 * sizeof(std::uint64_t) + sizeof(std::uint32_t) + 2 * sizeof(double);
+}
+
+mitk::NavigationDataStreamReader::NavigationDataStreamReader()
+  : itk::Object(), m_FileSize(0), m_DataOffset(0), m_NumberOfFrames(0), m_LoadedChunk(NoChunk)
+{
+}
+
+mitk::NavigationDataStreamReader::~NavigationDataStreamReader()
+{
+}
+
+void mitk::NavigationDataStreamReader::Open(const std::string& fileName)
+{
+  this->Close();
+
+  m_Stream.open(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!m_Stream.is_open())
+  {
+    mitkThrowException(mitk::IGTIOException) << "Could not open NavigationData stream '" << fileName << "'.";
+  }
+  m_FileName = fileName;
+
+  m_Stream.seekg(0, std::ios::end);
+  m_FileSize = static_cast<std::uint64_t>(m_Stream.tellg());
+  m_Stream.seekg(0, std::ios::beg);
+
+  this->ReadHeader();
+
+  if (!this->ReadIndex())
+  {
+    MITK_WARN << "NavigationData stream '" << fileName << "' has no time index, it was probably not closed properly. Rebuilding the index.";
+    this->RebuildIndex();
+  }
+
+  m_NumberOfFrames = 0;
+  for (const ChunkInfo& chunk : m_Index)
+    m_NumberOfFrames += chunk.m_NumberOfFrames;
+}
+
+void mitk::NavigationDataStreamReader::Close()
+{
+  if (m_Stream.is_open())
+    m_Stream.close();
+  m_Stream.clear();
+
+  m_ToolNames.clear();
+  m_Index.clear();
+  m_NumberOfFrames = 0;
+  m_LoadedChunk = NoChunk;
+  m_LoadedFrames.clear();
+}
+
+bool mitk::NavigationDataStreamReader::IsOpen() const
+{
+  return m_Stream.is_open();
+}
+
+unsigned int mitk::NavigationDataStreamReader::GetNumberOfTools() const
+{
+  return static_cast<unsigned int>(m_ToolNames.size());
+}
+
+std::string mitk::NavigationDataStreamReader::GetToolName(unsigned int toolIndex) const
+{
+  return toolIndex < m_ToolNames.size() ? m_ToolNames[toolIndex] : std::string();
+}
+
+unsigned int mitk::NavigationDataStreamReader::GetNumberOfFrames() const
+{
+  return static_cast<unsigned int>(m_NumberOfFrames);
+}
+
+mitk::NavigationData::TimeStampType mitk::NavigationDataStreamReader::GetFirstTimeStamp() const
+{
+  return m_Index.empty() ? 0.0 : m_Index.front().m_FirstTimeStamp;
+}
+
+mitk::NavigationData::TimeStampType mitk::NavigationDataStreamReader::GetLastTimeStamp() const
+{
+  return m_Index.empty() ? 0.0 : m_Index.back().m_LastTimeStamp;
+}
+
+std::vector<mitk::NavigationData::Pointer> mitk::NavigationDataStreamReader::GetFrame(unsigned int frameIndex)
+{
+  if (frameIndex >= m_NumberOfFrames)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Frame " << frameIndex << " requested, but the NavigationData stream has only " << m_NumberOfFrames << " frames.";
+  }
+
+  auto chunk = std::upper_bound(m_Index.begin(), m_Index.end(), static_cast<std::uint64_t>(frameIndex),
+    [](std::uint64_t frame, const ChunkInfo& info) { return frame < info.m_FirstFrame; });
+  const std::size_t chunkIndex = static_cast<std::size_t>(chunk - m_Index.begin()) - 1;
+
+  this->LoadChunk(chunkIndex);
+  return m_LoadedFrames[frameIndex - m_Index[chunkIndex].m_FirstFrame];
+}
+
+unsigned int mitk::NavigationDataStreamReader::FindFrame(NavigationData::TimeStampType timeStamp)
+{
+  // last chunk that starts before the timestamp
+  auto chunk = std::upper_bound(m_Index.begin(), m_Index.end(), timeStamp,
+    [](NavigationData::TimeStampType time, const ChunkInfo& info) { return time < info.m_FirstTimeStamp; });
+  if (chunk == m_Index.begin())
+    return 0;
+  --chunk;
+
+  // the next chunk starts after the timestamp, so the last frame of this chunk does not need to be read
+  if (timeStamp >= chunk->m_LastTimeStamp)
+    return static_cast<unsigned int>(chunk->m_FirstFrame + chunk->m_NumberOfFrames - 1);
+
+  this->LoadChunk(static_cast<std::size_t>(chunk - m_Index.begin()));
+  auto frame = std::upper_bound(m_LoadedFrames.begin(), m_LoadedFrames.end(), timeStamp,
+    [](NavigationData::TimeStampType time, const std::vector<NavigationData::Pointer>& navigationDatas)
+    { return navigationDatas.empty() || time < navigationDatas[0]->GetIGTTimeStamp(); });
+
+  const std::uint64_t frameInChunk = frame == m_LoadedFrames.begin() ? 0 : static_cast<std::uint64_t>(frame - m_LoadedFrames.begin()) - 1;
+  return static_cast<unsigned int>(chunk->m_FirstFrame + frameInChunk);
+}
+
+mitk::NavigationDataSet::Pointer mitk::NavigationDataStreamReader::ReadNavigationDataSet()
+{
+  NavigationDataSet::Pointer navigationDataSet = NavigationDataSet::New(this->GetNumberOfTools());
+  for (std::size_t chunkIndex = 0; chunkIndex < m_Index.size(); ++chunkIndex)
+  {
+    this->LoadChunk(chunkIndex);
+    for (const std::vector<NavigationData::Pointer>& navigationDatas : m_LoadedFrames)
+      navigationDataSet->AddNavigationDatas(navigationDatas);
+  }
+  return navigationDataSet;
+}
+
+void mitk::NavigationDataStreamReader::ReadHeader()
+{
+  char magic[sizeof(NavigationDataStreamFormat::Magic)];
+  this->ReadBytes(magic, sizeof(magic));
+  if (std::memcmp(magic, NavigationDataStreamFormat::Magic, sizeof(magic)) != 0)
+  {
+    mitkThrowException(mitk::IGTIOException) << "'" << m_FileName << "' is no NavigationData stream.";
+  }
+
+  std::uint32_t version = 0;
+  std::uint32_t byteOrderMark = 0;
+  std::uint32_t numberOfTools = 0;
+  this->ReadBytes(&version, sizeof(version));
+  this->ReadBytes(&byteOrderMark, sizeof(byteOrderMark));
+  if (byteOrderMark != NavigationDataStreamFormat::ByteOrderMark)
+  {
+    mitkThrowException(mitk::IGTIOException) << "NavigationData stream '" << m_FileName << "' was recorded with another byte order.";
+  }
+  if (version > NavigationDataStreamFormat::Version)
+  {
+    mitkThrowException(mitk::IGTIOException) << "NavigationData stream '" << m_FileName << "' has the unsupported version " << version << ".";
+  }
+
+  this->ReadBytes(&numberOfTools, sizeof(numberOfTools));
+  for (std::uint32_t i = 0; i < numberOfTools; ++i)
+  {
+    std::uint32_t length = 0;
+    this->ReadBytes(&length, sizeof(length));
+    if (length > m_FileSize)
+    {
+      mitkThrowException(mitk::IGTIOException) << "NavigationData stream '" << m_FileName << "' has a corrupt header.";
+    }
+    std::string name(length, '\0');
+    if (length > 0)
+      this->ReadBytes(&name[0], length);
+    m_ToolNames.push_back(name);
+  }
+
+  m_DataOffset = static_cast<std::uint64_t>(m_Stream.tellg());
+}
+
+bool mitk::NavigationDataStreamReader::ReadIndex()
+{
+  if (m_FileSize < m_DataOffset + NavigationDataStreamFormat::FooterSize)
+    return false;
+
+  std::uint64_t indexOffset = 0;
+  char footerMagic[sizeof(NavigationDataStreamFormat::FooterMagic)];
+  m_Stream.seekg(static_cast<std::streamoff>(m_FileSize - NavigationDataStreamFormat::FooterSize));
+  m_Stream.read(reinterpret_cast<char*>(&indexOffset), sizeof(indexOffset));
+  m_Stream.read(footerMagic, sizeof(footerMagic));
+  if (!m_Stream.good() || std::memcmp(footerMagic, NavigationDataStreamFormat::FooterMagic, sizeof(footerMagic)) != 0 ||
+      indexOffset < m_DataOffset || indexOffset > m_FileSize - NavigationDataStreamFormat::FooterSize)
+  {
+    m_Stream.clear();
+    return false;
+  }
+
+  std::uint32_t tag = 0;
+  std::uint64_t numberOfChunks = 0;
+  m_Stream.seekg(static_cast<std::streamoff>(indexOffset));
+  m_Stream.read(reinterpret_cast<char*>(&tag), sizeof(tag));
+  m_Stream.read(reinterpret_cast<char*>(&numberOfChunks), sizeof(numberOfChunks));
+  if (!m_Stream.good() || tag != NavigationDataStreamFormat::IndexTag ||
+      numberOfChunks > (m_FileSize - indexOffset) / IndexEntrySize)
+  {
+    m_Stream.clear();
+    return false;
+  }
+
+  std::string entries(static_cast<std::size_t>(numberOfChunks * IndexEntrySize), '\0');
+  if (!entries.empty())
+    m_Stream.read(&entries[0], static_cast<std::streamsize>(entries.size()));
+  if (!m_Stream.good())
+  {
+    m_Stream.clear();
+    return false;
+  }
+
+  const char* data = entries.data();
+  const char* end = data + entries.size();
+  m_Index.resize(static_cast<std::size_t>(numberOfChunks));
+  for (ChunkInfo& chunk : m_Index)
+  {
+    chunk.m_Offset = NavigationDataStreamFormat::Extract<std::uint64_t>(data, end);
+    chunk.m_FirstFrame = NavigationDataStreamFormat::Extract<std::uint64_t>(data, end);
+    chunk.m_NumberOfFrames = NavigationDataStreamFormat::Extract<std::uint32_t>(data, end);
+    chunk.m_FirstTimeStamp = NavigationDataStreamFormat::Extract<double>(data, end);
+    chunk.m_LastTimeStamp = NavigationDataStreamFormat::Extract<double>(data, end);
+  }
+  return true;
+}
+
+void mitk::NavigationDataStreamReader::RebuildIndex()
+{
+  m_Index.clear();
+
+  std::uint64_t offset = m_DataOffset;
+  std::uint64_t firstFrame = 0;
+  while (offset + NavigationDataStreamFormat::ChunkHeaderSize <= m_FileSize)
+  {
+    ChunkInfo chunk;
+    std::uint32_t tag = 0;
+    std::uint64_t payloadSize = 0;
+    m_Stream.seekg(static_cast<std::streamoff>(offset));
+    m_Stream.read(reinterpret_cast<char*>(&tag), sizeof(tag));
+    m_Stream.read(reinterpret_cast<char*>(&chunk.m_NumberOfFrames), sizeof(chunk.m_NumberOfFrames));
+    m_Stream.read(reinterpret_cast<char*>(&payloadSize), sizeof(payloadSize));
+    m_Stream.read(reinterpret_cast<char*>(&chunk.m_FirstTimeStamp), sizeof(chunk.m_FirstTimeStamp));
+    m_Stream.read(reinterpret_cast<char*>(&chunk.m_LastTimeStamp), sizeof(chunk.m_LastTimeStamp));
+
+    // stop at the index of the file or at a chunk that was not written completely
+    if (!m_Stream.good() || tag != NavigationDataStreamFormat::ChunkTag ||
+        payloadSize > m_FileSize - offset - NavigationDataStreamFormat::ChunkHeaderSize)
+      break;
+
+    chunk.m_Offset = offset;
+    chunk.m_FirstFrame = firstFrame;
+    m_Index.push_back(chunk);
+
+    firstFrame += chunk.m_NumberOfFrames;
+    offset += NavigationDataStreamFormat::ChunkHeaderSize + payloadSize;
+  }
+  m_Stream.clear();
+}
+
+void mitk::NavigationDataStreamReader::LoadChunk(std::size_t chunkIndex)
+{
+  if (chunkIndex == m_LoadedChunk)
+    return;
+
+  const ChunkInfo& chunk = m_Index.at(chunkIndex);
+  std::uint32_t tag = 0;
+  std::uint32_t numberOfFrames = 0;
+  std::uint64_t payloadSize = 0;
+  m_Stream.seekg(static_cast<std::streamoff>(chunk.m_Offset));
+  this->ReadBytes(&tag, sizeof(tag));
+  this->ReadBytes(&numberOfFrames, sizeof(numberOfFrames));
+  this->ReadBytes(&payloadSize, sizeof(payloadSize));
+  if (tag != NavigationDataStreamFormat::ChunkTag || numberOfFrames != chunk.m_NumberOfFrames ||
+      payloadSize > m_FileSize - chunk.m_Offset)
+  {
+    mitkThrowException(mitk::IGTIOException) << "NavigationData stream '" << m_FileName << "' has a corrupt chunk at offset " << chunk.m_Offset << ".";
+  }
+
+  std::string payload(static_cast<std::size_t>(payloadSize), '\0');
+  m_Stream.seekg(static_cast<std::streamoff>(chunk.m_Offset + NavigationDataStreamFormat::ChunkHeaderSize));
+  if (!payload.empty())
+    this->ReadBytes(&payload[0], payload.size());
+
+  m_LoadedChunk = NoChunk;
+  m_LoadedFrames.assign(numberOfFrames, std::vector<NavigationData::Pointer>());
+
+  const char* data = payload.data();
+  const char* end = data + payload.size();
+  for (std::vector<NavigationData::Pointer>& navigationDatas : m_LoadedFrames)
+  {
+    navigationDatas.reserve(m_ToolNames.size());
+    for (const std::string& toolName : m_ToolNames)
+      navigationDatas.push_back(NavigationDataStreamFormat::ExtractRecord(data, end, toolName));
+  }
+  m_LoadedChunk = chunkIndex;
+}
+
+void mitk::NavigationDataStreamReader::ReadBytes(void* data, std::size_t size)
+{
+  m_Stream.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+  if (!m_Stream.good())
+  {
+    m_Stream.clear();
+    mitkThrowException(mitk::IGTIOException) << "Could not read from NavigationData stream '" << m_FileName << "'.";
+  }
+}
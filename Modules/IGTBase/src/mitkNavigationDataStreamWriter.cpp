@@ -0,0 +1,200 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataStreamWriter.h"
+#include "mitkNavigationDataStreamFormat.h"
+#include "mitkIGTIOException.h"
+
+#include <algorithm>
+
+mitk::NavigationDataStreamWriter::NavigationDataStreamWriter()
+  : itk::Object(),
+    m_FramesPerChunk(256),
+    m_NumberOfTools(0),
+    m_NumberOfFrames(0),
+    m_NumberOfFramesInChunk(0),
+    m_ChunkFirstTimeStamp(0.0),
+    m_ChunkLastTimeStamp(0.0)
+{
+}
+
+mitk::NavigationDataStreamWriter::~NavigationDataStreamWriter()
+{
+  try
+  {
+    this->Close();
+  }
+  catch (const mitk::Exception& e)
+  {
+    MITK_ERROR << "Could not close NavigationData stream: " << e.GetDescription();
+  }
+}
+
+void mitk::NavigationDataStreamWriter::Open(const std::string& fileName, unsigned int numberOfTools, const std::vector<std::string>& toolNames)
+{
+  this->Close();
+
+  m_Stream.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_Stream.is_open())
+  {
+    mitkThrowException(mitk::IGTIOException) << "Could not create NavigationData stream '" << fileName << "'.";
+  }
+
+  m_FileName = fileName;
+  m_NumberOfTools = numberOfTools;
+  m_NumberOfFrames = 0;
+  m_NumberOfFramesInChunk = 0;
+  m_Chunk.clear();
+  m_Index.clear();
+
+  std::string header;
+  header.append(NavigationDataStreamFormat::Magic, sizeof(NavigationDataStreamFormat::Magic));
+  NavigationDataStreamFormat::Append(header, NavigationDataStreamFormat::Version);
+  NavigationDataStreamFormat::Append(header, NavigationDataStreamFormat::ByteOrderMark);
+  NavigationDataStreamFormat::Append(header, static_cast<std::uint32_t>(numberOfTools));
+  for (unsigned int i = 0; i < numberOfTools; ++i)
+  {
+    const std::string name = i < toolNames.size() ? toolNames[i] : std::string();
+    NavigationDataStreamFormat::Append(header, static_cast<std::uint32_t>(name.size()));
+    header.append(name);
+  }
+  this->WriteBytes(header.data(), header.size());
+
+  // one chunk of records is kept in memory
+  m_Chunk.reserve(static_cast<std::size_t>(std::max(1u, m_FramesPerChunk)) * numberOfTools * 256);
+}
+
+void mitk::NavigationDataStreamWriter::Write(const std::vector<NavigationData::Pointer>& navigationDatas)
+{
+  if (!m_Stream.is_open())
+  {
+    mitkThrowException(mitk::IGTIOException) << "NavigationData stream has to be opened before writing.";
+  }
+  if (navigationDatas.size() != m_NumberOfTools)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Expected NavigationData of " << m_NumberOfTools << " tools, got " << navigationDatas.size() << ".";
+  }
+
+  for (const NavigationData::Pointer& navigationData : navigationDatas)
+  {
+    if (navigationData.IsNull())
+    {
+      mitkThrowException(mitk::IGTIOException) << "Cannot write a null NavigationData.";
+    }
+    NavigationDataStreamFormat::AppendRecord(m_Chunk, navigationData);
+  }
+
+  const NavigationData::TimeStampType timeStamp = m_NumberOfTools > 0 ? navigationDatas[0]->GetIGTTimeStamp() : 0.0;
+  if (m_NumberOfFramesInChunk == 0)
+    m_ChunkFirstTimeStamp = timeStamp;
+  m_ChunkLastTimeStamp = timeStamp;
+  ++m_NumberOfFramesInChunk;
+  ++m_NumberOfFrames;
+
+  if (m_NumberOfFramesInChunk >= m_FramesPerChunk)
+    this->WriteChunk();
+}
+
+void mitk::NavigationDataStreamWriter::Flush()
+{
+  if (!m_Stream.is_open())
+    return;
+
+  this->WriteChunk();
+  m_Stream.flush();
+}
+
+void mitk::NavigationDataStreamWriter::Close()
+{
+  if (!m_Stream.is_open())
+    return;
+
+  this->WriteChunk();
+
+  const std::uint64_t indexOffset = static_cast<std::uint64_t>(m_Stream.tellp());
+  std::string index;
+  NavigationDataStreamFormat::Append(index, NavigationDataStreamFormat::IndexTag);
+  NavigationDataStreamFormat::Append(index, static_cast<std::uint64_t>(m_Index.size()));
+  for (const ChunkInfo& chunk : m_Index)
+  {
+    NavigationDataStreamFormat::Append(index, chunk.m_Offset);
+    NavigationDataStreamFormat::Append(index, chunk.m_FirstFrame);
+    NavigationDataStreamFormat::Append(index, chunk.m_NumberOfFrames);
+    NavigationDataStreamFormat::Append(index, chunk.m_FirstTimeStamp);
+    NavigationDataStreamFormat::Append(index, chunk.m_LastTimeStamp);
+  }
+  NavigationDataStreamFormat::Append(index, indexOffset);
+  index.append(NavigationDataStreamFormat::FooterMagic, sizeof(NavigationDataStreamFormat::FooterMagic));
+  this->WriteBytes(index.data(), index.size());
+
+  m_Stream.close();
+  m_Index.clear();
+  m_Chunk.clear();
+  m_Chunk.shrink_to_fit();
+}
+
+bool mitk::NavigationDataStreamWriter::IsOpen() const
+{
+  return m_Stream.is_open();
+}
+
+unsigned int mitk::NavigationDataStreamWriter::GetNumberOfTools() const
+{
+  return m_NumberOfTools;
+}
+
+unsigned int mitk::NavigationDataStreamWriter::GetNumberOfFrames() const
+{
+  return static_cast<unsigned int>(m_NumberOfFrames);
+}
+
+void mitk::NavigationDataStreamWriter::WriteChunk()
+{
+  if (m_NumberOfFramesInChunk == 0)
+    return;
+
+  ChunkInfo chunk;
+  chunk.m_Offset = static_cast<std::uint64_t>(m_Stream.tellp());
+  chunk.m_FirstFrame = m_NumberOfFrames - m_NumberOfFramesInChunk;
+  chunk.m_NumberOfFrames = m_NumberOfFramesInChunk;
+  chunk.m_FirstTimeStamp = m_ChunkFirstTimeStamp;
+  chunk.m_LastTimeStamp = m_ChunkLastTimeStamp;
+
+  std::string header;
+  NavigationDataStreamFormat::Append(header, NavigationDataStreamFormat::ChunkTag);
+  NavigationDataStreamFormat::Append(header, chunk.m_NumberOfFrames);
+  NavigationDataStreamFormat::Append(header, static_cast<std::uint64_t>(m_Chunk.size()));
+  NavigationDataStreamFormat::Append(header, chunk.m_FirstTimeStamp);
+  NavigationDataStreamFormat::Append(header, chunk.m_LastTimeStamp);
+  this->WriteBytes(header.data(), header.size());
+  this->WriteBytes(m_Chunk.data(), m_Chunk.size());
+
+  // complete chunks survive a crash of the application
+  m_Stream.flush();
+
+  m_Index.push_back(chunk);
+  m_Chunk.clear();
+  m_NumberOfFramesInChunk = 0;
+}
+
+void mitk::NavigationDataStreamWriter::WriteBytes(const void* data, std::size_t size)
+{
+  m_Stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  if (!m_Stream.good())
+  {
+    mitkThrowException(mitk::IGTIOException) << "Could not write to NavigationData stream '" << m_FileName << "'.";
+  }
+}
@@ -0,0 +1,199 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImageStatisticsCalculator.h"
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkIgnorePixelMaskGenerator.h>
+#include <mitkImageMaskGenerator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * \brief Test class for the chunked multi label computation of mitkImageStatisticsCalculator
+ *
+ * The results of the chunked computation are compared to those of the default computation.
+ */
+class mitkImageStatisticsCalculatorChunkedTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageStatisticsCalculatorChunkedTestSuite);
+  MITK_TEST(TestUnmaskedStatistics);
+  MITK_TEST(TestImageMaskStatistics);
+  MITK_TEST(TestSecondaryMaskStatistics);
+  MITK_TEST(TestChunkSizeDoesNotChangeStatistics);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void setUp() override
+  {
+    unsigned int dimensions[3] = {64, 48, 20};
+    const unsigned int numberOfPixels = dimensions[0] * dimensions[1] * dimensions[2];
+
+    std::vector<short> values(numberOfPixels);
+    std::vector<unsigned short> labels(numberOfPixels);
+    srand(7);
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+    {
+      values[i] = static_cast<short>(rand() % 2000 - 1000);
+      // four labels in slabs along x plus a background border
+      const unsigned int x = i % dimensions[0];
+      const unsigned int z = i / (dimensions[0] * dimensions[1]);
+      labels[i] = (z == 0 || z == dimensions[2] - 1) ? 0 : static_cast<unsigned short>(x / 16 + 1);
+    }
+
+    // unique extrema per label, so that their indices are well defined
+    for (unsigned short label = 0; label < 5; ++label)
+    {
+      const unsigned int first = label == 0 ? 100 : dimensions[0] * dimensions[1] * 5 + (label - 1) * 16 + 3;
+      values[first] = static_cast<short>(-2000 - label);
+      values[first + dimensions[0] * dimensions[1] * 3 + 5] = static_cast<short>(2000 + label);
+    }
+
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<short>(), 3, dimensions);
+    m_Image->SetVolume(values.data());
+
+    m_Mask = mitk::Image::New();
+    m_Mask->Initialize(mitk::MakeScalarPixelType<unsigned short>(), 3, dimensions);
+    m_Mask->SetVolume(labels.data());
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Mask = nullptr;
+  }
+
+  void TestUnmaskedStatistics()
+  {
+    this->CompareToDefaultComputation(nullptr, nullptr, std::vector<unsigned int>(1, 1));
+  }
+
+  void TestImageMaskStatistics()
+  {
+    mitk::ImageMaskGenerator::Pointer maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetImageMask(m_Mask);
+
+    this->CompareToDefaultComputation(maskGenerator.GetPointer(), nullptr, {0, 1, 2, 3, 4});
+  }
+
+  void TestSecondaryMaskStatistics()
+  {
+    mitk::ImageMaskGenerator::Pointer maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetImageMask(m_Mask);
+
+    mitk::IgnorePixelMaskGenerator::Pointer ignorePixelMaskGenerator = mitk::IgnorePixelMaskGenerator::New();
+    ignorePixelMaskGenerator->SetInputImage(m_Image);
+    ignorePixelMaskGenerator->SetIgnoredPixelValue(0);
+    ignorePixelMaskGenerator->SetTimeStep(0);
+
+    this->CompareToDefaultComputation(maskGenerator.GetPointer(), ignorePixelMaskGenerator.GetPointer(), {0, 1, 2, 3, 4});
+  }
+
+  void TestChunkSizeDoesNotChangeStatistics()
+  {
+    mitk::ImageMaskGenerator::Pointer maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetImageMask(m_Mask);
+
+    mitk::ImageStatisticsCalculator::Pointer calculator = mitk::ImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(maskGenerator.GetPointer());
+    calculator->SetUseChunkedComputation(true);
+
+    calculator->SetChunkSizeForStatistics(1);
+    mitk::ImageStatisticsCalculator::StatisticsContainer::Pointer lineChunks = calculator->GetStatistics(0, 2);
+
+    calculator->SetChunkSizeForStatistics(64 * 48 * 20);
+    calculator->Modified();
+    mitk::ImageStatisticsCalculator::StatisticsContainer::Pointer oneChunk = calculator->GetStatistics(0, 2);
+
+    this->CompareStatistics(oneChunk, lineChunks);
+  }
+
+private:
+
+  void CompareToDefaultComputation(mitk::MaskGenerator::Pointer maskGenerator,
+                                   mitk::MaskGenerator::Pointer secondaryMaskGenerator,
+                                   const std::vector<unsigned int> &labels)
+  {
+    mitk::ImageStatisticsCalculator::Pointer reference = mitk::ImageStatisticsCalculator::New();
+    reference->SetInputImage(m_Image);
+    reference->SetMask(maskGenerator);
+    reference->SetSecondaryMask(secondaryMaskGenerator);
+
+    mitk::ImageStatisticsCalculator::Pointer chunked = mitk::ImageStatisticsCalculator::New();
+    chunked->SetInputImage(m_Image);
+    chunked->SetMask(maskGenerator);
+    chunked->SetSecondaryMask(secondaryMaskGenerator);
+    chunked->SetUseChunkedComputation(true);
+    // many chunks for few threads
+    chunked->SetChunkSizeForStatistics(1000);
+
+    for (unsigned int label : labels)
+    {
+      MITK_INFO << "Comparing statistics of label " << label;
+      mitk::ImageStatisticsCalculator::StatisticsContainer::Pointer statistics = chunked->GetStatistics(0, label);
+      this->CompareStatistics(reference->GetStatistics(0, label), statistics);
+
+      CPPUNIT_ASSERT_MESSAGE("Percentiles are ordered",
+                             statistics->GetMin() <= statistics->GetPercentile(5) &&
+                             statistics->GetPercentile(5) <= statistics->GetPercentile(25) &&
+                             statistics->GetPercentile(25) <= statistics->GetPercentile(75) &&
+                             statistics->GetPercentile(75) <= statistics->GetMax());
+    }
+  }
+
+  void CompareStatistics(mitk::ImageStatisticsCalculator::StatisticsContainer::Pointer expected,
+                         mitk::ImageStatisticsCalculator::StatisticsContainer::Pointer actual)
+  {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Label", expected->GetLabel(), actual->GetLabel());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("N", expected->GetN(), actual->GetN());
+
+    // only the order of summation differs
+    mitk::ImageStatisticsCalculator::statisticsMapType expectedMap = expected->GetStatisticsAsMap();
+    mitk::ImageStatisticsCalculator::statisticsMapType actualMap = actual->GetStatisticsAsMap();
+    for (auto it = expectedMap.begin(); it != expectedMap.end(); ++it)
+    {
+      // the estimated percentiles depend on the order in which the sketches are merged
+      if (std::isnan(it->second) || it->first.compare(0, 10, "Percentile") == 0 || it->first == "IQR")
+      {
+        continue;
+      }
+      const double tolerance = 1e-9 * std::max(1., std::abs(it->second));
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(it->first, it->second, actualMap[it->first], tolerance);
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Min index", expected->GetMinIndex() == actual->GetMinIndex());
+    CPPUNIT_ASSERT_MESSAGE("Max index", expected->GetMaxIndex() == actual->GetMaxIndex());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Histogram size", expected->GetHistogram()->Size(), actual->GetHistogram()->Size());
+    for (unsigned int bin = 0; bin < expected->GetHistogram()->Size(); ++bin)
+    {
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Histogram frequency",
+                                   expected->GetHistogram()->GetFrequency(bin),
+                                   actual->GetHistogram()->GetFrequency(bin));
+    }
+  }
+
+  mitk::Image::Pointer m_Image;
+  mitk::Image::Pointer m_Mask;
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageStatisticsCalculatorChunked)
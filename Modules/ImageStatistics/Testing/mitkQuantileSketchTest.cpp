@@ -0,0 +1,164 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkQuantileSketch.h"
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <random>
+#include <vector>
+
+/**
+ * \brief Test class for mitkQuantileSketch
+ *
+ * Estimated quantiles are compared to the exact quantiles of the sorted values by their rank.
+ */
+class mitkQuantileSketchTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkQuantileSketchTestSuite);
+  MITK_TEST(TestEmptySketch);
+  MITK_TEST(TestFewValues);
+  MITK_TEST(TestSkewedDistribution);
+  MITK_TEST(TestMergedSketches);
+  MITK_TEST(TestConcurrentQueries);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void setUp() override
+  {
+    std::mt19937 generator(42);
+    std::lognormal_distribution<double> distribution(0., 1.5);
+    m_Values.resize(500000);
+    for (auto &value : m_Values)
+    {
+      value = distribution(generator);
+    }
+  }
+
+  void tearDown() override
+  {
+    m_Values.clear();
+  }
+
+  void TestEmptySketch()
+  {
+    mitk::QuantileSketch sketch;
+    CPPUNIT_ASSERT_MESSAGE("Empty sketch", sketch.IsEmpty());
+    CPPUNIT_ASSERT_MESSAGE("Quantile of empty sketch is NaN", std::isnan(sketch.GetQuantile(0.5)));
+  }
+
+  void TestFewValues()
+  {
+    mitk::QuantileSketch sketch;
+    for (int value = 1; value <= 5; ++value)
+    {
+      sketch.Add(value);
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Count", 5., sketch.GetCount());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Min", 1., sketch.GetQuantile(0.));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Median", 3., sketch.GetQuantile(0.5));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Max", 5., sketch.GetQuantile(1.));
+  }
+
+  void TestSkewedDistribution()
+  {
+    mitk::QuantileSketch sketch;
+    for (double value : m_Values)
+    {
+      sketch.Add(value);
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Memory is bounded", sketch.GetNumberOfCentroids() <= 200);
+    this->CheckQuantiles(sketch);
+  }
+
+  void TestMergedSketches()
+  {
+    // e.g. sketches of several threads
+    std::vector<mitk::QuantileSketch> sketches(3);
+    for (size_t i = 0; i < m_Values.size(); ++i)
+    {
+      sketches[(i / 1000) % sketches.size()].Add(m_Values[i]);
+    }
+
+    mitk::QuantileSketch merged;
+    for (const auto &sketch : sketches)
+    {
+      merged.Merge(sketch);
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Count", static_cast<double>(m_Values.size()), merged.GetCount());
+    this->CheckQuantiles(merged);
+  }
+
+  void TestConcurrentQueries()
+  {
+    // values are left in the buffer, the queries must not compress the shared sketch
+    mitk::QuantileSketch sketch;
+    for (size_t i = 0; i < 500; ++i)
+    {
+      sketch.Add(m_Values[i]);
+    }
+    const mitk::QuantileSketch &constSketch = sketch;
+    const double median = constSketch.GetQuantile(0.5);
+
+    std::vector<std::future<bool>> queries;
+    for (int thread = 0; thread < 4; ++thread)
+    {
+      queries.push_back(std::async(std::launch::async, [&constSketch, median]() {
+        bool equal = true;
+        for (int i = 0; i < 1000; ++i)
+        {
+          equal &= constSketch.GetQuantile(0.5) == median;
+        }
+        return equal;
+      }));
+    }
+
+    for (auto &query : queries)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Concurrent queries give the same quantile", query.get());
+    }
+  }
+
+private:
+
+  void CheckQuantiles(const mitk::QuantileSketch &sketch)
+  {
+    std::vector<double> sorted(m_Values);
+    std::sort(sorted.begin(), sorted.end());
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Min is exact", sorted.front(), sketch.GetMin());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Max is exact", sorted.back(), sketch.GetMax());
+
+    for (double q : {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99})
+    {
+      const double estimate = sketch.GetQuantile(q);
+      const double rank = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin()) / sorted.size();
+      MITK_INFO << "Quantile " << q << ": estimated " << estimate << " at rank " << rank;
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Rank of estimated quantile", q, rank, 0.005);
+    }
+  }
+
+  std::vector<double> m_Values;
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkQuantileSketch)
@@ -9,6 +9,7 @@ set(CPP_FILES
   mitkMultiLabelMaskGenerator.cpp
   mitkImageMaskGenerator.cpp
   mitkHistogramStatisticsCalculator.cpp
+  mitkQuantileSketch.cpp
   mitkMaskUtilities.cpp
   mitkIgnorePixelMaskGenerator.cpp
 )
@@ -25,6 +26,7 @@ set(H_FILES
   mitkMultiLabelMaskGenerator.h
   mitkImageMaskGenerator.h
   mitkHistogramStatisticsCalculator.h
+  mitkQuantileSketch.h
   mitkMaskUtilities.h
   mitkitkMaskImageFilter.h
   mitkIgnorePixelMaskGenerator.h
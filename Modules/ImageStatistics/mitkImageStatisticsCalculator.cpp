@@ -31,6 +31,131 @@
 #include <mitkMaskUtilities.h>
 
 #include "itkImageFileWriter.h"
+#include <itkMultiThreader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /** Sums, extrema and their positions of the pixels of one label as seen by one thread */
+    struct LabelAccumulator
+    {
+        LabelAccumulator()
+            : m_Count(0),
+              m_PositivePixelCount(0),
+              m_Sum(0.),
+              m_SumOfSquares(0.),
+              m_SumOfCubes(0.),
+              m_SumOfQuadruples(0.),
+              m_SumOfPositivePixels(0.),
+              m_Min(std::numeric_limits<double>::max()),
+              m_Max(std::numeric_limits<double>::lowest()),
+              m_MinOffset(0),
+              m_MaxOffset(0)
+        {
+        }
+
+        void Add(double value, itk::SizeValueType offset)
+        {
+            const double squared = value * value;
+            ++m_Count;
+            m_Sum += value;
+            m_SumOfSquares += squared;
+            m_SumOfCubes += squared * value;
+            m_SumOfQuadruples += squared * squared;
+            m_QuantileSketch.Add(value);
+
+            if (value > 0)
+            {
+                ++m_PositivePixelCount;
+                m_SumOfPositivePixels += value;
+            }
+
+            // chunks are processed in arbitrary order, the first occurrence wins to get a deterministic index
+            if (value < m_Min || (value == m_Min && offset < m_MinOffset))
+            {
+                m_Min = value;
+                m_MinOffset = offset;
+            }
+            if (value > m_Max || (value == m_Max && offset < m_MaxOffset))
+            {
+                m_Max = value;
+                m_MaxOffset = offset;
+            }
+        }
+
+        void Merge(const LabelAccumulator &other)
+        {
+            m_Count += other.m_Count;
+            m_PositivePixelCount += other.m_PositivePixelCount;
+            m_Sum += other.m_Sum;
+            m_SumOfSquares += other.m_SumOfSquares;
+            m_SumOfCubes += other.m_SumOfCubes;
+            m_SumOfQuadruples += other.m_SumOfQuadruples;
+            m_SumOfPositivePixels += other.m_SumOfPositivePixels;
+            m_QuantileSketch.Merge(other.m_QuantileSketch);
+
+            if (other.m_Min < m_Min || (other.m_Min == m_Min && other.m_MinOffset < m_MinOffset))
+            {
+                m_Min = other.m_Min;
+                m_MinOffset = other.m_MinOffset;
+            }
+            if (other.m_Max > m_Max || (other.m_Max == m_Max && other.m_MaxOffset < m_MaxOffset))
+            {
+                m_Max = other.m_Max;
+                m_MaxOffset = other.m_MaxOffset;
+            }
+        }
+
+        itk::SizeValueType m_Count;
+        itk::SizeValueType m_PositivePixelCount;
+        double m_Sum;
+        double m_SumOfSquares;
+        double m_SumOfCubes;
+        double m_SumOfQuadruples;
+        double m_SumOfPositivePixels;
+        double m_Min;
+        double m_Max;
+        itk::SizeValueType m_MinOffset;
+        itk::SizeValueType m_MaxOffset;
+        mitk::QuantileSketch m_QuantileSketch;
+    };
+
+    /** Calls processChunk(threadId, firstLine, endLine) for all chunks of lines, distributed among the threads */
+    template <typename TFunction>
+    void ProcessChunksInParallel(itk::SizeValueType numberOfLines, itk::SizeValueType linesPerChunk,
+                                 unsigned int numberOfThreads, TFunction processChunk)
+    {
+        const itk::SizeValueType numberOfChunks = (numberOfLines + linesPerChunk - 1) / linesPerChunk;
+        std::atomic<itk::SizeValueType> nextChunk(0);
+
+        auto worker = [&](unsigned int threadId)
+        {
+            for (itk::SizeValueType chunk = nextChunk++; chunk < numberOfChunks; chunk = nextChunk++)
+            {
+                const itk::SizeValueType firstLine = chunk * linesPerChunk;
+                processChunk(threadId, firstLine, std::min(firstLine + linesPerChunk, numberOfLines));
+            }
+        };
+
+        // small images are not worth starting threads
+        std::vector<std::thread> threads;
+        for (unsigned int threadId = 1; threadId < numberOfThreads && threadId < numberOfChunks; ++threadId)
+        {
+            threads.emplace_back(worker, threadId);
+        }
+        worker(0);
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
 
 namespace mitk
 {
@@ -110,6 +235,36 @@ namespace mitk
         return m_binSizeForHistogramStatistics;
     }
 
+    void ImageStatisticsCalculator::SetUseChunkedComputation(bool useChunkedComputation)
+    {
+        if (useChunkedComputation != m_UseChunkedComputation)
+        {
+            m_UseChunkedComputation = useChunkedComputation;
+            this->Modified();
+        }
+    }
+
+    bool ImageStatisticsCalculator::GetUseChunkedComputation() const
+    {
+        return m_UseChunkedComputation;
+    }
+
+    void ImageStatisticsCalculator::SetChunkSizeForStatistics(unsigned int numberOfPixels)
+    {
+        if (numberOfPixels == 0)
+        {
+            mitkThrow() << "Chunk size for statistics must be greater than zero";
+        }
+
+        // does not change the results, so no recomputation is necessary
+        m_ChunkSizeForStatistics = numberOfPixels;
+    }
+
+    unsigned int ImageStatisticsCalculator::GetChunkSizeForStatistics() const
+    {
+        return m_ChunkSizeForStatistics;
+    }
+
     ImageStatisticsCalculator::StatisticsContainer::Pointer ImageStatisticsCalculator::GetStatistics(unsigned int timeStep, unsigned int label)
     {
 
@@ -162,7 +317,12 @@ namespace mitk
 
 
             // Calculate statistics with/without mask
-            if (m_MaskGenerator.IsNull() && m_SecondaryMaskGenerator.IsNull())
+            if (m_UseChunkedComputation)
+            {
+                // all labels in one pass, masks are applied on the fly
+                AccessByItk_1(m_ImageTimeSlice, InternalCalculateStatisticsChunked, timeStep)
+            }
+            else if (m_MaskGenerator.IsNull() && m_SecondaryMaskGenerator.IsNull())
             {
                 // 1) calculate statistics unmasked:
                 AccessByItk_1(m_ImageTimeSlice, InternalCalculateStatisticsUnmasked, timeStep)
@@ -465,6 +625,365 @@ namespace mitk
         }
     }
 
+    template < typename TPixel, unsigned int VImageDimension > void ImageStatisticsCalculator::InternalCalculateStatisticsChunked(
+            typename itk::Image< TPixel, VImageDimension >* image,
+            unsigned int timeStep)
+    {
+        typedef itk::Image< TPixel, VImageDimension > ImageType;
+        typedef itk::Image< MaskPixelType, VImageDimension > MaskType;
+        typedef typename ImageType::IndexType IndexType;
+        typedef typename ImageType::OffsetType OffsetType;
+        typedef typename ImageType::RegionType RegionType;
+        typedef std::map<MaskPixelType, LabelAccumulator> AccumulatorMapType;
+        typedef std::map<MaskPixelType, HistogramType::Pointer> HistogramMapType;
+
+        // same workaround as in InternalCalculateStatisticsMasked: a secondary mask without primary mask is used as primary mask
+        bool swapMasks = false;
+        if (m_SecondaryMask.IsNotNull() && m_InternalMask.IsNull())
+        {
+            m_InternalMask = m_SecondaryMask;
+            m_SecondaryMask = nullptr;
+            swapMasks = true;
+        }
+
+        const bool masked = m_InternalMask.IsNotNull();
+        typename MaskType::Pointer maskImage;
+        typename MaskType::Pointer secondaryMaskImage;
+        if (masked)
+        {
+            try {
+                maskImage = ImageToItkImage< MaskPixelType, VImageDimension >(m_InternalMask);
+            }
+            catch (const itk::ExceptionObject &)
+            {
+                maskImage = MaskType::New();
+                CastToItkImage(m_InternalMask, maskImage);
+            }
+        }
+
+        if (m_SecondaryMask.IsNotNull())
+        {
+            // see InternalCalculateStatisticsMasked
+            if (m_InternalMask->GetDimension() == 2 && (m_SecondaryMask->GetDimension() == 3 || m_SecondaryMask->GetDimension() == 4))
+            {
+                mitk::Image::Pointer old_img = m_SecondaryMaskGenerator->GetReferenceImage();
+                m_SecondaryMaskGenerator->SetInputImage(m_MaskGenerator->GetReferenceImage());
+                m_SecondaryMask = m_SecondaryMaskGenerator->GetMask();
+                m_SecondaryMaskGenerator->SetInputImage(old_img);
+            }
+            secondaryMaskImage = ImageToItkImage< MaskPixelType, VImageDimension >(m_SecondaryMask);
+        }
+
+        // the mask region of the image is visited in place instead of being extracted, the offsets map mask indices to image indices
+        const RegionType region = masked ? maskImage->GetBufferedRegion() : image->GetBufferedRegion();
+        IndexType zeroIndex;
+        zeroIndex.Fill(0);
+        OffsetType imageOffset;
+        imageOffset.Fill(0);
+        OffsetType secondaryMaskOffset;
+        secondaryMaskOffset.Fill(0);
+
+        if (masked)
+        {
+            typename MaskUtilities< TPixel, VImageDimension >::Pointer maskUtil = MaskUtilities< TPixel, VImageDimension >::New();
+            maskUtil->SetImage(image);
+            maskUtil->SetMask(maskImage.GetPointer());
+            if (!maskUtil->CheckMaskSanity())
+            {
+                mitkThrow() << "Mask and image are not compatible";
+            }
+
+            IndexType maskOriginIndex;
+            image->TransformPhysicalPointToIndex(maskImage->GetOrigin(), maskOriginIndex);
+            imageOffset = maskOriginIndex - zeroIndex;
+
+            RegionType regionInImage = region;
+            regionInImage.SetIndex(region.GetIndex() + imageOffset);
+            if (!image->GetBufferedRegion().IsInside(regionInImage))
+            {
+                mitkThrow() << "Mask region needs to be inside of image region";
+            }
+
+            if (secondaryMaskImage.IsNotNull())
+            {
+                secondaryMaskImage->TransformPhysicalPointToIndex(maskImage->GetOrigin(), maskOriginIndex);
+                secondaryMaskOffset = maskOriginIndex - zeroIndex;
+            }
+        }
+
+        const typename RegionType::SizeType size = region.GetSize();
+        const itk::SizeValueType lineLength = size[0];
+        const itk::SizeValueType numberOfLines = lineLength > 0 ? region.GetNumberOfPixels() / lineLength : 0;
+
+        // offsets count the pixels of the visited region in buffer order
+        auto indexOfOffset = [&](itk::SizeValueType offset)
+        {
+            IndexType index = region.GetIndex();
+            for (unsigned int d = 0; d < VImageDimension; ++d)
+            {
+                index[d] += offset % size[d];
+                offset /= size[d];
+            }
+            return index;
+        };
+
+        // calls visit(label, value, offset) for every pixel of the lines [firstLine, endLine)
+        auto visitLines = [&](itk::SizeValueType firstLine, itk::SizeValueType endLine, auto visit)
+        {
+            for (itk::SizeValueType line = firstLine; line < endLine; ++line)
+            {
+                const itk::SizeValueType offset = line * lineLength;
+                const IndexType index = indexOfOffset(offset);
+                const TPixel *pixels = image->GetBufferPointer() + image->ComputeOffset(index + imageOffset);
+
+                if (!masked)
+                {
+                    for (itk::SizeValueType x = 0; x < lineLength; ++x)
+                    {
+                        visit(MaskPixelType(1), static_cast<double>(pixels[x]), offset + x);
+                    }
+                    continue;
+                }
+
+                const MaskPixelType *labels = maskImage->GetBufferPointer() + maskImage->ComputeOffset(index);
+                if (secondaryMaskImage.IsNull())
+                {
+                    for (itk::SizeValueType x = 0; x < lineLength; ++x)
+                    {
+                        visit(labels[x], static_cast<double>(pixels[x]), offset + x);
+                    }
+                    continue;
+                }
+
+                // pixels are only kept where the secondary mask is 1, all others count as label 0 (like itk::MaskImageFilter2)
+                const RegionType &secondaryRegion = secondaryMaskImage->GetBufferedRegion();
+                IndexType secondaryIndex = index + secondaryMaskOffset;
+                itk::OffsetValueType begin = secondaryRegion.GetIndex(0) - secondaryIndex[0];
+                itk::OffsetValueType end = begin + static_cast<itk::OffsetValueType>(secondaryRegion.GetSize(0));
+                begin = std::max<itk::OffsetValueType>(begin, 0);
+                end = std::min<itk::OffsetValueType>(end, lineLength);
+                for (unsigned int d = 1; d < VImageDimension; ++d)
+                {
+                    if (secondaryIndex[d] < secondaryRegion.GetIndex(d) ||
+                        secondaryIndex[d] >= secondaryRegion.GetIndex(d) + static_cast<itk::OffsetValueType>(secondaryRegion.GetSize(d)))
+                    {
+                        end = begin;
+                    }
+                }
+
+                const MaskPixelType *secondaryLabels = nullptr;
+                if (begin < end)
+                {
+                    secondaryIndex[0] += begin;
+                    secondaryLabels = secondaryMaskImage->GetBufferPointer() + secondaryMaskImage->ComputeOffset(secondaryIndex);
+                }
+
+                for (itk::OffsetValueType x = 0; x < static_cast<itk::OffsetValueType>(lineLength); ++x)
+                {
+                    const bool kept = x >= begin && x < end && secondaryLabels[x - begin] == 1;
+                    visit(kept ? labels[x] : MaskPixelType(0), static_cast<double>(pixels[x]), offset + x);
+                }
+            }
+        };
+
+        const unsigned int numberOfThreads = std::max<unsigned int>(1, itk::MultiThreader::GetGlobalDefaultNumberOfThreads());
+        const itk::SizeValueType linesPerChunk = std::max<itk::SizeValueType>(1, m_ChunkSizeForStatistics / std::max<itk::SizeValueType>(lineLength, 1));
+
+        // 1) moments and extrema of all labels
+        std::vector<AccumulatorMapType> accumulatorsPerThread(numberOfThreads);
+        ProcessChunksInParallel(numberOfLines, linesPerChunk, numberOfThreads,
+            [&](unsigned int threadId, itk::SizeValueType firstLine, itk::SizeValueType endLine)
+        {
+            AccumulatorMapType &threadAccumulators = accumulatorsPerThread[threadId];
+
+            // labels come in runs, so the accumulator of the last label is kept at hand
+            MaskPixelType lastLabel = 0;
+            LabelAccumulator *accumulator = nullptr;
+            visitLines(firstLine, endLine, [&](MaskPixelType label, double value, itk::SizeValueType offset)
+            {
+                if (accumulator == nullptr || label != lastLabel)
+                {
+                    accumulator = &threadAccumulators[label];
+                    lastLabel = label;
+                }
+                accumulator->Add(value, offset);
+            });
+        });
+
+        AccumulatorMapType accumulators;
+        for (const auto &threadAccumulators : accumulatorsPerThread)
+        {
+            for (const auto &labelAccumulator : threadAccumulators)
+            {
+                accumulators[labelAccumulator.first].Merge(labelAccumulator.second);
+            }
+        }
+        accumulatorsPerThread.clear();
+
+        // 2) histograms, their range depends on the extrema of each label
+        std::map<MaskPixelType, unsigned int> nBins;
+        for (const auto &labelAccumulator : accumulators)
+        {
+            unsigned int nBinsForHistogram;
+            if (m_UseBinSizeOverNBins)
+            {
+                nBinsForHistogram = std::max(static_cast<double>(std::ceil(labelAccumulator.second.m_Max - labelAccumulator.second.m_Min)) / m_binSizeForHistogramStatistics, 10.); // do not allow less than 10 bins
+            }
+            else
+            {
+                nBinsForHistogram = m_nBinsForHistogramStatistics;
+            }
+            nBins[labelAccumulator.first] = nBinsForHistogram;
+        }
+
+        auto createHistogram = [&](MaskPixelType label)
+        {
+            HistogramType::Pointer histogram = HistogramType::New();
+            HistogramType::SizeType histogramSize;
+            HistogramType::MeasurementVectorType lowerBound;
+            HistogramType::MeasurementVectorType upperBound;
+            histogramSize.SetSize(1);
+            lowerBound.SetSize(1);
+            upperBound.SetSize(1);
+            histogram->SetMeasurementVectorSize(1);
+            histogramSize[0] = nBins.at(label);
+            lowerBound[0] = accumulators.at(label).m_Min;
+            upperBound[0] = accumulators.at(label).m_Max;
+            histogram->Initialize(histogramSize, lowerBound, upperBound);
+            return histogram;
+        };
+
+        std::vector<HistogramMapType> histogramsPerThread(numberOfThreads);
+        ProcessChunksInParallel(numberOfLines, linesPerChunk, numberOfThreads,
+            [&](unsigned int threadId, itk::SizeValueType firstLine, itk::SizeValueType endLine)
+        {
+            HistogramMapType &threadHistograms = histogramsPerThread[threadId];
+            HistogramType::IndexType histogramIndex(1);
+            HistogramType::MeasurementVectorType histogramMeasurement(1);
+
+            MaskPixelType lastLabel = 0;
+            HistogramType *histogram = nullptr;
+            visitLines(firstLine, endLine, [&](MaskPixelType label, double value, itk::SizeValueType)
+            {
+                if (histogram == nullptr || label != lastLabel)
+                {
+                    HistogramType::Pointer &labelHistogram = threadHistograms[label];
+                    if (labelHistogram.IsNull())
+                    {
+                        labelHistogram = createHistogram(label);
+                    }
+                    histogram = labelHistogram.GetPointer();
+                    lastLabel = label;
+                }
+                histogramMeasurement[0] = value;
+                histogram->GetIndex(histogramMeasurement, histogramIndex);
+                histogram->IncreaseFrequencyOfIndex(histogramIndex, 1);
+            });
+        });
+
+        HistogramMapType histograms;
+        for (const auto &threadHistograms : histogramsPerThread)
+        {
+            for (const auto &labelHistogram : threadHistograms)
+            {
+                HistogramType::Pointer &histogram = histograms[labelHistogram.first];
+                if (histogram.IsNull())
+                {
+                    histogram = labelHistogram.second;
+                    continue;
+                }
+                for (unsigned int bin = 0; bin < histogram->Size(); ++bin)
+                {
+                    histogram->IncreaseFrequency(bin, labelHistogram.second->GetFrequency(bin));
+                }
+            }
+        }
+        histogramsPerThread.clear();
+
+        // compute the remainder of the statistics
+        m_StatisticsByTimeStep[timeStep].resize(0);
+        for (const auto &labelAccumulator : accumulators)
+        {
+            const LabelAccumulator &accumulator = labelAccumulator.second;
+            const double count = static_cast<double>(accumulator.m_Count);
+            const double mean = accumulator.m_Sum / count;
+            const double variance = (accumulator.m_SumOfSquares - accumulator.m_Sum * accumulator.m_Sum / count) / count;
+            const double secondMoment = accumulator.m_SumOfSquares / count;
+            const double thirdMoment = accumulator.m_SumOfCubes / count;
+            const double fourthMoment = accumulator.m_SumOfQuadruples / count;
+
+            StatisticsContainer::Pointer statisticsResult = StatisticsContainer::New();
+            statisticsResult->SetLabel(labelAccumulator.first);
+            statisticsResult->SetN(accumulator.m_Count);
+            statisticsResult->SetMean(mean);
+            statisticsResult->SetMin(accumulator.m_Min);
+            statisticsResult->SetMax(accumulator.m_Max);
+            statisticsResult->SetVariance(variance);
+            statisticsResult->SetStd(std::sqrt(variance));
+            // same estimators as itk::ExtendedLabelStatisticsImageFilter
+            statisticsResult->SetSkewness((thirdMoment - 3. * secondMoment * mean + 2. * std::pow(mean, 3.)) / std::pow(secondMoment - std::pow(mean, 2.), 1.5));
+            statisticsResult->SetKurtosis((fourthMoment - 4. * thirdMoment * mean + 6. * secondMoment * std::pow(mean, 2.) - 3. * std::pow(mean, 4.)) / std::pow(secondMoment - std::pow(mean, 2.), 2.));
+            statisticsResult->SetRMS(std::sqrt(std::pow(mean, 2.) + variance)); // variance = sigma^2
+            statisticsResult->SetMPP(accumulator.m_SumOfPositivePixels / static_cast<double>(accumulator.m_PositivePixelCount));
+            statisticsResult->SetQuantileSketch(accumulator.m_QuantileSketch);
+
+            const HistogramType::Pointer histogram = histograms[labelAccumulator.first];
+            mitk::HistogramStatisticsCalculator histStatCalc;
+            histStatCalc.SetHistogram(histogram);
+            histStatCalc.CalculateStatistics();
+            statisticsResult->SetEntropy(histStatCalc.GetEntropy());
+            statisticsResult->SetMedian(histStatCalc.GetMedian());
+            statisticsResult->SetUniformity(histStatCalc.GetUniformity());
+            statisticsResult->SetUPP(histStatCalc.GetUPP());
+            statisticsResult->SetHistogram(histogram);
+
+            vnl_vector<int> minIndex, maxIndex;
+            const IndexType tmpMinIndex = indexOfOffset(accumulator.m_MinOffset);
+            const IndexType tmpMaxIndex = indexOfOffset(accumulator.m_MaxOffset);
+            if (masked)
+            {
+                // like InternalCalculateStatisticsMasked: indices are reported in the coordinates of m_Image
+                mitk::Point3D worldCoordinateMin;
+                mitk::Point3D worldCoordinateMax;
+                mitk::Point3D indexCoordinateMin;
+                mitk::Point3D indexCoordinateMax;
+                m_InternalImageForStatistics->GetGeometry()->IndexToWorld(tmpMinIndex, worldCoordinateMin);
+                m_InternalImageForStatistics->GetGeometry()->IndexToWorld(tmpMaxIndex, worldCoordinateMax);
+                m_Image->GetGeometry()->WorldToIndex(worldCoordinateMin, indexCoordinateMin);
+                m_Image->GetGeometry()->WorldToIndex(worldCoordinateMax, indexCoordinateMax);
+
+                minIndex.set_size(3);
+                maxIndex.set_size(3);
+                for (unsigned int i=0; i < 3; i++)
+                {
+                    minIndex[i] = indexCoordinateMin[i];
+                    maxIndex[i] = indexCoordinateMax[i];
+                }
+            }
+            else
+            {
+                minIndex.set_size(VImageDimension);
+                maxIndex.set_size(VImageDimension);
+                for (unsigned int i=0; i < VImageDimension; i++)
+                {
+                    minIndex[i] = tmpMinIndex[i];
+                    maxIndex[i] = tmpMaxIndex[i];
+                }
+            }
+            statisticsResult->SetMinIndex(minIndex);
+            statisticsResult->SetMaxIndex(maxIndex);
+
+            m_StatisticsByTimeStep[timeStep].push_back(statisticsResult);
+        }
+
+        // swap maskGenerators back
+        if (swapMasks)
+        {
+            m_SecondaryMask = m_InternalMask;
+            m_InternalMask = nullptr;
+        }
+    }
+
     bool ImageStatisticsCalculator::IsUpdateRequired(unsigned int timeStep) const
     {
         unsigned long thisClassTimeStamp = this->GetMTime();
@@ -542,6 +1061,14 @@ namespace mitk
         statisticsAsMap["UPP"] = m_UPP;
         statisticsAsMap["Entropy"] = m_Entropy;
         statisticsAsMap["Label"] = m_Label;
+        if (!m_QuantileSketch.IsEmpty())
+        {
+            statisticsAsMap["Percentile5"] = GetPercentile(5);
+            statisticsAsMap["Percentile25"] = GetPercentile(25);
+            statisticsAsMap["Percentile75"] = GetPercentile(75);
+            statisticsAsMap["Percentile95"] = GetPercentile(95);
+            statisticsAsMap["IQR"] = GetPercentile(75) - GetPercentile(25);
+        }
 
         return statisticsAsMap;
     }
@@ -567,6 +1094,7 @@ namespace mitk
         m_minIndex.set_size(0);
         m_maxIndex.set_size(0);
         m_Label = 0;
+        m_QuantileSketch = QuantileSketch();
     }
 
     void ImageStatisticsCalculator::StatisticsContainer::Print()
@@ -4,6 +4,7 @@
 #include <MitkImageStatisticsExports.h>
 #include <mitkImage.h>
 #include <mitkMaskGenerator.h>
+#include <mitkQuantileSketch.h>
 #include <itkImage.h>
 #include <limits>
 #include <itkObject.h>
@@ -50,11 +51,13 @@ namespace mitk
          - RMS (Root Mean Square)
          - Label (if applicable, the label (unsigned short) of the mask the statistics belong to)
          - Entropy
+         - Percentile5, Percentile25, Percentile75, Percentile95 and IQR (interquartile range), if a quantile sketch is available
 
          It furthermore stores the following:
          - MinIndex (Index of Image where the Minimum is located)
          - MaxIndex (Index of Image where the Maximum is located)
-         - Histogram of Pixel Values*/
+         - Histogram of Pixel Values
+         - QuantileSketch of Pixel Values (only filled by the chunked computation, see ImageStatisticsCalculator::SetUseChunkedComputation)*/
         class MITKIMAGESTATISTICS_EXPORT StatisticsContainer : public itk::Object
         {
         public:
@@ -263,6 +266,27 @@ namespace mitk
                 return m_UPP;
             }
 
+            void SetQuantileSketch(const QuantileSketch &sketch)
+            {
+                m_QuantileSketch = sketch;
+                // compressed once here, so concurrent readers of the container do not copy the sketch
+                m_QuantileSketch.Compress();
+            }
+
+            /**Documentation
+            @brief The sketch can be merged with those of other labels or time steps to get percentiles of their union.*/
+            const QuantileSketch & GetQuantileSketch() const
+            {
+                return m_QuantileSketch;
+            }
+
+            /**Documentation
+            @brief Returns the estimated percentile @a p (in [0, 100]) of the pixel values or NaN if no quantile sketch is available.*/
+            RealType GetPercentile(RealType p) const
+            {
+                return m_QuantileSketch.GetQuantile(p / 100.);
+            }
+
             /**Documentation
             @brief Creates a StatisticsMapType containing all real valued statistics stored in this class (= all statistics except minIndex, maxIndex and the histogram) and prints its contents to std::cout*/
             void Print();
@@ -305,6 +329,7 @@ namespace mitk
                 rval->SetHistogram(this->GetHistogram());
                 rval->SetMinIndex(this->GetMinIndex());
                 rval->SetMaxIndex(this->GetMaxIndex());
+                rval->SetQuantileSketch(this->GetQuantileSketch());
                 return ioPtr;
             }
 
@@ -322,6 +347,7 @@ namespace mitk
             RealType m_Entropy;
             unsigned int m_Label;
             HistogramType::Pointer m_Histogram;
+            QuantileSketch m_QuantileSketch;
 
         };
 
@@ -362,11 +388,31 @@ namespace mitk
          */
         StatisticsContainer::Pointer GetStatistics(unsigned int timeStep=0, unsigned int label=1);
 
+        /**Documentation
+        @brief Compute the statistics of all labels in one threaded pass over the image instead of cropping and combining copies of image and masks.
+        The image is split into chunks of at most GetChunkSizeForStatistics() pixels that are distributed among the threads, each thread
+        accumulates the statistics of all labels it encounters and the results are merged at the end. A second pass of the same kind fills the
+        histograms, whose range depends on the extrema of each label. The results equal those of the default computation. Additionally, a
+        quantile sketch of each label is computed in the first pass, which provides percentiles independent of the histogram bins.
+        Off by default.*/
+        void SetUseChunkedComputation(bool useChunkedComputation);
+
+        bool GetUseChunkedComputation() const;
+
+        /**Documentation
+        @brief Set the maximum number of pixels that are processed by a thread as one unit of work when using the chunked computation.
+        A chunk always contains at least one image line.*/
+        void SetChunkSizeForStatistics(unsigned int numberOfPixels);
+
+        unsigned int GetChunkSizeForStatistics() const;
+
     protected:
         ImageStatisticsCalculator(){
             m_nBinsForHistogramStatistics = 100;
             m_binSizeForHistogramStatistics = 10;
             m_UseBinSizeOverNBins = false;
+            m_UseChunkedComputation = false;
+            m_ChunkSizeForStatistics = 1 << 18;
         };
 
 
@@ -384,6 +430,10 @@ namespace mitk
                 typename itk::Image< TPixel, VImageDimension >* image,
                 unsigned int timeStep);
 
+        template < typename TPixel, unsigned int VImageDimension > void InternalCalculateStatisticsChunked(
+                typename itk::Image< TPixel, VImageDimension >* image,
+                unsigned int timeStep);
+
         bool IsUpdateRequired(unsigned int timeStep) const;
 
         std::string GetNameOfClass()
@@ -405,6 +455,9 @@ namespace mitk
         double m_binSizeForHistogramStatistics;
         bool m_UseBinSizeOverNBins;
 
+        bool m_UseChunkedComputation;
+        unsigned int m_ChunkSizeForStatistics;
+
         std::vector<std::vector<StatisticsContainer::Pointer>> m_StatisticsByTimeStep;
         std::vector<unsigned long> m_StatisticsUpdateTimePerTimeStep;
     };
@@ -0,0 +1,201 @@
+#include <mitkQuantileSketch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const double pi = 3.14159265358979323846;
+
+    // scale function of the t-digest: centroids are small where q is close to 0 or 1
+    double QuantileToScale(double q, double compression)
+    {
+        return compression / (2. * pi) * std::asin(2. * q - 1.);
+    }
+
+    double ScaleToQuantile(double k, double compression)
+    {
+        const double angle = k * 2. * pi / compression;
+        if (angle >= pi / 2.)
+        {
+            return 1.;
+        }
+        return (std::sin(angle) + 1.) / 2.;
+    }
+}
+
+namespace mitk {
+
+QuantileSketch::QuantileSketch(double compression):
+    m_Compression(std::max(compression, 10.)),
+    m_Count(0.),
+    m_Min(std::numeric_limits<double>::infinity()),
+    m_Max(-std::numeric_limits<double>::infinity())
+{
+}
+
+void QuantileSketch::Add(double value, double weight)
+{
+    if (weight <= 0. || std::isnan(value))
+    {
+        return;
+    }
+
+    Centroid centroid;
+    centroid.m_Mean = value;
+    centroid.m_Weight = weight;
+    m_Buffer.push_back(centroid);
+
+    m_Count += weight;
+    m_Min = std::min(m_Min, value);
+    m_Max = std::max(m_Max, value);
+
+    if (m_Buffer.size() >= static_cast<size_t>(5 * m_Compression))
+    {
+        this->Compress();
+    }
+}
+
+void QuantileSketch::Merge(const QuantileSketch &other)
+{
+    if (other.IsEmpty())
+    {
+        return;
+    }
+
+    m_Buffer.insert(m_Buffer.end(), other.m_Centroids.begin(), other.m_Centroids.end());
+    m_Buffer.insert(m_Buffer.end(), other.m_Buffer.begin(), other.m_Buffer.end());
+    m_Count += other.m_Count;
+    m_Min = std::min(m_Min, other.m_Min);
+    m_Max = std::max(m_Max, other.m_Max);
+
+    this->Compress();
+}
+
+void QuantileSketch::Compress()
+{
+    if (m_Buffer.empty())
+    {
+        return;
+    }
+
+    m_Buffer.insert(m_Buffer.end(), m_Centroids.begin(), m_Centroids.end());
+    std::sort(m_Buffer.begin(), m_Buffer.end());
+    m_Centroids.clear();
+
+    double total = 0.;
+    for (const Centroid &centroid : m_Buffer)
+    {
+        total += centroid.m_Weight;
+    }
+
+    // greedily merge neighbours as long as the merged centroid does not span more than one unit of the scale function
+    Centroid current = m_Buffer.front();
+    double weightSoFar = 0.;
+    double weightLimit = total * ScaleToQuantile(QuantileToScale(0., m_Compression) + 1., m_Compression);
+    for (size_t i = 1; i < m_Buffer.size(); ++i)
+    {
+        const Centroid &next = m_Buffer[i];
+        if (weightSoFar + current.m_Weight + next.m_Weight <= weightLimit)
+        {
+            current.m_Mean += (next.m_Mean - current.m_Mean) * next.m_Weight / (current.m_Weight + next.m_Weight);
+            current.m_Weight += next.m_Weight;
+        }
+        else
+        {
+            weightSoFar += current.m_Weight;
+            m_Centroids.push_back(current);
+            weightLimit = total * ScaleToQuantile(QuantileToScale(weightSoFar / total, m_Compression) + 1., m_Compression);
+            current = next;
+        }
+    }
+    m_Centroids.push_back(current);
+    m_Buffer.clear();
+}
+
+double QuantileSketch::GetQuantile(double q) const
+{
+    if (this->IsEmpty())
+    {
+        return std::nan("");
+    }
+
+    if (!m_Buffer.empty())
+    {
+        // the sketch itself is not modified, other threads may read it
+        QuantileSketch compressed(*this);
+        compressed.Compress();
+        return compressed.GetQuantile(q);
+    }
+
+    if (q <= 0.)
+    {
+        return m_Min;
+    }
+    if (q >= 1.)
+    {
+        return m_Max;
+    }
+    if (m_Centroids.size() == 1)
+    {
+        return m_Centroids.front().m_Mean;
+    }
+
+    // the weight of a centroid is assumed to be spread evenly around its mean, the extrema are the ends of the distribution
+    const double rank = q * m_Count;
+    const Centroid &first = m_Centroids.front();
+    if (rank < first.m_Weight / 2.)
+    {
+        return m_Min + (first.m_Mean - m_Min) * rank / (first.m_Weight / 2.);
+    }
+
+    double weightSoFar = first.m_Weight / 2.;
+    for (size_t i = 0; i + 1 < m_Centroids.size(); ++i)
+    {
+        const Centroid &left = m_Centroids[i];
+        const Centroid &right = m_Centroids[i + 1];
+        const double distance = (left.m_Weight + right.m_Weight) / 2.;
+        if (rank < weightSoFar + distance)
+        {
+            return left.m_Mean + (right.m_Mean - left.m_Mean) * (rank - weightSoFar) / distance;
+        }
+        weightSoFar += distance;
+    }
+
+    const Centroid &last = m_Centroids.back();
+    return last.m_Mean + (m_Max - last.m_Mean) * std::min(1., (rank - weightSoFar) / (last.m_Weight / 2.));
+}
+
+double QuantileSketch::GetCount() const
+{
+    return m_Count;
+}
+
+double QuantileSketch::GetMin() const
+{
+    return m_Min;
+}
+
+double QuantileSketch::GetMax() const
+{
+    return m_Max;
+}
+
+bool QuantileSketch::IsEmpty() const
+{
+    return m_Count == 0.;
+}
+
+size_t QuantileSketch::GetNumberOfCentroids() const
+{
+    if (!m_Buffer.empty())
+    {
+        QuantileSketch compressed(*this);
+        compressed.Compress();
+        return compressed.m_Centroids.size();
+    }
+    return m_Centroids.size();
+}
+
+}
@@ -0,0 +1,79 @@
+#ifndef MITKQUANTILESKETCH
+#define MITKQUANTILESKETCH
+
+#include <MitkImageStatisticsExports.h>
+#include <cstddef>
+#include <vector>
+
+namespace mitk
+{
+/**
+     * @brief Approximates quantiles of a stream of values with bounded memory (t-digest).
+     *
+     * Values are clustered into weighted centroids. Centroids near the tails of the distribution are kept small, so extreme
+     * quantiles are very accurate while the median is accurate to a fraction of a percent of the rank. The number of centroids
+     * is bounded by the compression, independent of the number of values.
+     * Sketches are mergeable, e.g. sketches of different threads, chunks or time steps can be combined.
+     *
+     * Adding values is not thread safe: use one sketch per thread and merge them afterwards. The const methods do not
+     * modify the sketch, so several threads may read the same sketch. They are faster if the sketch has been compressed.
+     */
+    class MITKIMAGESTATISTICS_EXPORT QuantileSketch
+    {
+    public:
+        /**
+         * @brief Larger compressions give more accurate quantiles for more memory.
+         */
+        explicit QuantileSketch(double compression = 200.);
+
+        void Add(double value, double weight = 1.);
+
+        /**
+         * @brief Adds all values of @a other to this sketch.
+         */
+        void Merge(const QuantileSketch &other);
+
+        /**
+         * @brief Returns the estimated @a q quantile (q in [0, 1]) or NaN if no value has been added.
+         */
+        double GetQuantile(double q) const;
+
+        /**
+         * @brief Returns the total weight of all added values.
+         */
+        double GetCount() const;
+
+        double GetMin() const;
+
+        double GetMax() const;
+
+        bool IsEmpty() const;
+
+        size_t GetNumberOfCentroids() const;
+
+        /**
+         * @brief Merges the buffered values into the centroids, e.g. before the sketch is handed to other threads.
+         */
+        void Compress();
+
+    private:
+        struct Centroid
+        {
+            double m_Mean;
+            double m_Weight;
+
+            bool operator<(const Centroid &other) const { return m_Mean < other.m_Mean; }
+        };
+
+        double m_Compression;
+        double m_Count;
+        double m_Min;
+        double m_Max;
+
+        // values are collected unsorted and merged in batches, which keeps Add cheap
+        std::vector<Centroid> m_Centroids;
+        std::vector<Centroid> m_Buffer;
+    };
+}
+
+#endif
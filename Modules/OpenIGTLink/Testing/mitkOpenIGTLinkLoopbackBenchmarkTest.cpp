@@ -0,0 +1,147 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+//TEST
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+//STD
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+//MITK
+#include "mitkIGTLServer.h"
+#include "mitkIGTLClient.h"
+
+//IGTL
+#include "igtlImageMessage.h"
+
+static int PORT = 35353;
+static const std::string HOSTNAME = "localhost";
+
+/**
+* Streams ultrasound sized images from an IGTLServer to an IGTLClient over the
+* loopback device and reports throughput and latency. Every frame is sent once
+* the previous one was received, so the latency covers sending, receiving and
+* queueing of a single frame.
+*/
+class mitkOpenIGTLinkLoopbackBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkOpenIGTLinkLoopbackBenchmarkTestSuite);
+  MITK_TEST(StreamImages_ServerToClient_ReportsThroughputAndLatency);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::IGTLServer::Pointer m_Server;
+  mitk::IGTLClient::Pointer m_Client;
+
+  static const int ImageWidth = 640;
+  static const int ImageHeight = 480;
+  static const unsigned int NumberOfFrames = 300;
+
+  igtl::ImageMessage::Pointer CreateImageMessage(unsigned int frame)
+  {
+    igtl::ImageMessage::Pointer msg = igtl::ImageMessage::New();
+    msg->SetDimensions(ImageWidth, ImageHeight, 1);
+    msg->SetSpacing(0.1f, 0.1f, 1.0f);
+    msg->SetScalarType(igtl::ImageMessage::TYPE_UINT8);
+    msg->SetDeviceName("Loopback Benchmark");
+    msg->AllocateScalars();
+    std::fill_n(static_cast<unsigned char*>(msg->GetScalarPointer()), msg->GetImageSize(), static_cast<unsigned char>(frame));
+    return msg;
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Server = mitk::IGTLServer::New(true);
+    m_Client = mitk::IGTLClient::New(true);
+
+    m_Server->SetHostname(HOSTNAME);
+    m_Server->SetName("Benchmark Server");
+    m_Server->SetPortNumber(PORT);
+
+    m_Client->SetHostname(HOSTNAME);
+    m_Client->SetName("Benchmark Client");
+    m_Client->SetPortNumber(PORT);
+  }
+
+  void tearDown() override
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    m_Server = nullptr;
+    m_Client = nullptr;
+  }
+
+  void StreamImages_ServerToClient_ReportsThroughputAndLatency()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Could not open Connection with Server", m_Server->OpenConnection());
+    m_Server->StartCommunication();
+    CPPUNIT_ASSERT_MESSAGE("Could not connect to Server", m_Client->OpenConnection());
+    m_Client->StartCommunication();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // the frames are created beforehand, only the transfer is measured
+    std::vector<igtl::ImageMessage::Pointer> frames;
+    for (unsigned int i = 0; i < NumberOfFrames; ++i)
+      frames.push_back(this->CreateImageMessage(i));
+
+    std::vector<double> latencies;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < NumberOfFrames; ++i)
+    {
+      const auto sent = std::chrono::steady_clock::now();
+      m_Server->SendMessage(mitk::IGTLMessage::New(frames[i].GetPointer()));
+
+      igtl::ImageMessage::Pointer received;
+      while (received.IsNull() && std::chrono::steady_clock::now() - sent < std::chrono::seconds(1))
+      {
+        received = m_Client->GetMessageQueue()->PullImage2dMessage();
+        if (received.IsNull())
+          std::this_thread::yield();
+      }
+      if (received.IsNull())
+        break;
+
+      latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sent).count());
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Payload of the received frame", static_cast<int>(i % 256),
+        static_cast<int>(static_cast<unsigned char*>(received->GetScalarPointer())[0]));
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    CPPUNIT_ASSERT(m_Client->StopCommunication());
+    CPPUNIT_ASSERT(m_Server->StopCommunication());
+    CPPUNIT_ASSERT(m_Client->CloseConnection());
+    CPPUNIT_ASSERT(m_Server->CloseConnection());
+
+    CPPUNIT_ASSERT_MESSAGE("No frame was received", !latencies.empty());
+
+    std::sort(latencies.begin(), latencies.end());
+    const double megabytes = latencies.size() * static_cast<double>(ImageWidth * ImageHeight) / (1024.0 * 1024.0);
+    MITK_INFO << "Received " << latencies.size() << " of " << NumberOfFrames << " frames in " << seconds << " s: "
+              << latencies.size() / seconds << " frames/s, " << megabytes / seconds << " MB/s";
+    MITK_INFO << "Latency [ms]: median " << latencies[latencies.size() / 2]
+              << ", 95th percentile " << latencies[latencies.size() * 95 / 100]
+              << ", maximum " << latencies.back();
+    MITK_INFO << "Client message pool: " << m_Client->GetMessagePool()->GetNumberOfCreatedMessages() << " created, "
+              << m_Client->GetMessagePool()->GetNumberOfReusedMessages() << " reused messages";
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkOpenIGTLinkLoopbackBenchmark)
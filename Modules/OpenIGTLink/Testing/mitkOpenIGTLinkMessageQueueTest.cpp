@@ -0,0 +1,184 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+//TEST
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+//STD
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+
+//MITK
+#include "mitkIGTLBoundedQueue.h"
+#include "mitkIGTLMessageFactory.h"
+#include "mitkIGTLMessagePool.h"
+#include "mitkIGTLMessageQueue.h"
+
+//IGTL
+#include "igtlStringMessage.h"
+
+class mitkOpenIGTLinkMessageQueueTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkOpenIGTLinkMessageQueueTestSuite);
+  MITK_TEST(BoundedQueue_PushAndPop_KeepsOrder);
+  MITK_TEST(BoundedQueue_ConcurrentProducersAndConsumers_NoMessageLost);
+  MITK_TEST(MessageQueue_FullQueue_DropsOldestMessage);
+  MITK_TEST(MessageQueue_NoBuffering_KeepsLatestMessage);
+  MITK_TEST(MessagePool_ReleasedMessage_IsReused);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::IGTLMessageFactory::Pointer m_MessageFactory;
+
+  igtl::MessageBase::Pointer CreateStringMessage(const std::string& text)
+  {
+    igtl::StringMessage::Pointer msg = igtl::StringMessage::New();
+    msg->SetString(text.c_str());
+    return msg.GetPointer();
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_MessageFactory = mitk::IGTLMessageFactory::New();
+  }
+
+  void tearDown() override
+  {
+    m_MessageFactory = nullptr;
+  }
+
+  void BoundedQueue_PushAndPop_KeepsOrder()
+  {
+    mitk::IGTLBoundedQueue<int> queue(5);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Capacity is rounded up to a power of two", size_t(8), queue.GetCapacity());
+
+    for (int i = 0; i < 8; ++i)
+      CPPUNIT_ASSERT_MESSAGE("Push into queue that is not full", queue.TryPush(i));
+    CPPUNIT_ASSERT_MESSAGE("Push into full queue fails", !queue.TryPush(8));
+    CPPUNIT_ASSERT_EQUAL(size_t(8), queue.GetSize());
+
+    int value = -1;
+    for (int i = 0; i < 8; ++i)
+    {
+      CPPUNIT_ASSERT(queue.TryPop(value));
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Values are popped in the order they were pushed", i, value);
+    }
+    CPPUNIT_ASSERT_MESSAGE("Pop from empty queue fails", !queue.TryPop(value));
+  }
+
+  void BoundedQueue_ConcurrentProducersAndConsumers_NoMessageLost()
+  {
+    const int numberOfValuesPerProducer = 100000;
+    mitk::IGTLBoundedQueue<int> queue(64);
+    std::atomic<long long> sum(0);
+    std::atomic<int> numberOfPoppedValues(0);
+
+    auto producer = [&]() {
+      for (int i = 1; i <= numberOfValuesPerProducer; ++i)
+      {
+        while (!queue.TryPush(i))
+          std::this_thread::yield();
+      }
+    };
+    auto consumer = [&]() {
+      int value;
+      while (numberOfPoppedValues < 2 * numberOfValuesPerProducer)
+      {
+        if (queue.TryPop(value))
+        {
+          sum += value;
+          ++numberOfPoppedValues;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+    };
+
+    std::thread producer1(producer), producer2(producer), consumer1(consumer), consumer2(consumer);
+    producer1.join();
+    producer2.join();
+    consumer1.join();
+    consumer2.join();
+
+    const long long expectedSum = 2LL * numberOfValuesPerProducer * (numberOfValuesPerProducer + 1) / 2;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Every value was popped exactly once", expectedSum, sum.load());
+  }
+
+  void MessageQueue_FullQueue_DropsOldestMessage()
+  {
+    mitk::IGTLMessageQueue::Pointer queue = mitk::IGTLMessageQueue::New();
+    queue->EnableNoBufferingMode(false);
+
+    const unsigned int numberOfMessages = mitk::IGTLMessageQueue::BufferSize + 3;
+    for (unsigned int i = 0; i < numberOfMessages; ++i)
+      queue->PushMessage(this->CreateStringMessage(std::to_string(i)));
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Queue size is bounded", static_cast<int>(mitk::IGTLMessageQueue::BufferSize), queue->GetSize());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Number of dropped messages", 3ul, queue->GetNumberOfDroppedMessages());
+
+    igtl::StringMessage::Pointer msg = queue->PullStringMessage();
+    CPPUNIT_ASSERT(msg.IsNotNull());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Oldest messages were dropped", std::string("3"), std::string(msg->GetString()));
+  }
+
+  void MessageQueue_NoBuffering_KeepsLatestMessage()
+  {
+    mitk::IGTLMessageQueue::Pointer queue = mitk::IGTLMessageQueue::New();
+    queue->EnableNoBufferingMode(true);
+
+    for (unsigned int i = 0; i < 10; ++i)
+      queue->PushMessage(this->CreateStringMessage(std::to_string(i)));
+
+    CPPUNIT_ASSERT_EQUAL(1, queue->GetSize());
+    igtl::StringMessage::Pointer msg = queue->PullStringMessage();
+    CPPUNIT_ASSERT(msg.IsNotNull());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Latest message is kept", std::string("9"), std::string(msg->GetString()));
+    CPPUNIT_ASSERT_MESSAGE("Queue is empty", queue->PullStringMessage().IsNull());
+  }
+
+  void MessagePool_ReleasedMessage_IsReused()
+  {
+    mitk::IGTLMessagePool::Pointer pool = mitk::IGTLMessagePool::New(m_MessageFactory);
+
+    // receive the header of a packed string message
+    igtl::MessageBase::Pointer sent = this->CreateStringMessage("header");
+    sent->Pack();
+    igtl::MessageHeader::Pointer header = pool->AcquireHeader();
+    memcpy(header->GetPackPointer(), sent->GetPackPointer(), header->GetPackSize());
+    header->Unpack();
+
+    igtl::MessageBase::Pointer first = pool->AcquireMessage(header);
+    CPPUNIT_ASSERT_MESSAGE("Message of supported type is created", first.IsNotNull());
+    igtl::MessageBase::Pointer second = pool->AcquireMessage(header);
+    CPPUNIT_ASSERT_MESSAGE("Message in use is not handed out again", first.GetPointer() != second.GetPointer());
+
+    igtl::MessageBase* released = first.GetPointer();
+    first = nullptr;
+    igtl::MessageBase::Pointer third = pool->AcquireMessage(header);
+    CPPUNIT_ASSERT_MESSAGE("Released message is reused", third.GetPointer() == released);
+    CPPUNIT_ASSERT_EQUAL(2ul, pool->GetNumberOfCreatedMessages());
+    CPPUNIT_ASSERT_EQUAL(1ul, pool->GetNumberOfReusedMessages());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkOpenIGTLinkMessageQueue)
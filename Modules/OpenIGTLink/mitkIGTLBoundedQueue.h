@@ -0,0 +1,172 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKIGTLBOUNDEDQUEUE_H
+#define MITKIGTLBOUNDEDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace mitk {
+  /**
+  * \class IGTLBoundedQueue
+  * \brief Lock-free queue with a fixed capacity for any number of producers
+  * and consumers.
+  *
+  * Every cell of the ring carries a sequence number which tells producers and
+  * consumers whether the cell is free or filled, so TryPush() and TryPop()
+  * neither lock nor allocate. The capacity is rounded up to a power of two.
+  * A popped cell is reset to a default constructed value, thus smart pointers
+  * do not keep their objects alive inside of the queue.
+  *
+  * \ingroup OpenIGTLink
+  */
+  template <typename T>
+  class IGTLBoundedQueue
+  {
+  public:
+    explicit IGTLBoundedQueue(std::size_t capacity)
+      : m_Capacity(RoundUpToPowerOfTwo(capacity)),
+        m_Cells(new Cell[m_Capacity]),
+        m_EnqueuePosition(0),
+        m_DequeuePosition(0)
+    {
+      for (std::size_t i = 0; i < m_Capacity; ++i)
+        m_Cells[i].m_Sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /**
+    * \brief Appends the value, returns false if the queue is full
+    */
+    bool TryPush(const T& value)
+    {
+      std::size_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+      Cell* cell;
+      for (;;)
+      {
+        cell = &m_Cells[position & (m_Capacity - 1)];
+        const std::size_t sequence = cell->m_Sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0)
+        {
+          if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            break;
+        }
+        else if (difference < 0)
+        {
+          return false;
+        }
+        else
+        {
+          position = m_EnqueuePosition.load(std::memory_order_relaxed);
+        }
+      }
+      cell->m_Value = value;
+      cell->m_Sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+    * \brief Removes the oldest value, returns false if the queue is empty
+    */
+    bool TryPop(T& value)
+    {
+      std::size_t position = m_DequeuePosition.load(std::memory_order_relaxed);
+      Cell* cell;
+      for (;;)
+      {
+        cell = &m_Cells[position & (m_Capacity - 1)];
+        const std::size_t sequence = cell->m_Sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+        if (difference == 0)
+        {
+          if (m_DequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            break;
+        }
+        else if (difference < 0)
+        {
+          return false;
+        }
+        else
+        {
+          position = m_DequeuePosition.load(std::memory_order_relaxed);
+        }
+      }
+      value = cell->m_Value;
+      cell->m_Value = T();
+      cell->m_Sequence.store(position + m_Capacity, std::memory_order_release);
+      return true;
+    }
+
+    /**
+    * \brief Removes all values, returns the number of removed values
+    */
+    std::size_t Clear()
+    {
+      std::size_t numberOfValues = 0;
+      T value;
+      while (this->TryPop(value))
+        ++numberOfValues;
+      return numberOfValues;
+    }
+
+    /**
+    * \brief Number of values in the queue, only a snapshot if other threads
+    * push or pop at the same time
+    */
+    std::size_t GetSize() const
+    {
+      const std::size_t enqueuePosition = m_EnqueuePosition.load(std::memory_order_relaxed);
+      const std::size_t dequeuePosition = m_DequeuePosition.load(std::memory_order_relaxed);
+      return enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0;
+    }
+
+    std::size_t GetCapacity() const
+    {
+      return m_Capacity;
+    }
+
+  private:
+    IGTLBoundedQueue(const IGTLBoundedQueue&);
+    IGTLBoundedQueue& operator=(const IGTLBoundedQueue&);
+
+    static std::size_t RoundUpToPowerOfTwo(std::size_t value)
+    {
+      std::size_t result = 2;
+      while (result < value)
+        result <<= 1;
+      return result;
+    }
+
+    struct Cell
+    {
+      std::atomic<std::size_t> m_Sequence;
+      T m_Value;
+    };
+
+    const std::size_t m_Capacity;
+    std::unique_ptr<Cell[]> m_Cells;
+
+    // producers and consumers work on different cache lines
+    char m_Padding0[64];
+    std::atomic<std::size_t> m_EnqueuePosition;
+    char m_Padding1[64];
+    std::atomic<std::size_t> m_DequeuePosition;
+  };
+}
+
+#endif
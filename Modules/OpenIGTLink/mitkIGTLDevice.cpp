@@ -59,6 +59,7 @@ m_MultiThreader(nullptr), m_SendThreadID(0), m_ReceiveThreadID(0), m_ConnectThre
 
   m_MessageFactory = mitk::IGTLMessageFactory::New();
   m_MessageQueue = mitk::IGTLMessageQueue::New();
+  m_MessagePool = mitk::IGTLMessagePool::New(m_MessageFactory);
 }
 
 mitk::IGTLDevice::~IGTLDevice()
@@ -122,12 +123,8 @@ bool mitk::IGTLDevice::TestConnection()
 
 unsigned int mitk::IGTLDevice::ReceivePrivate(igtl::Socket* socket)
 {
-  // Create a message buffer to receive header
-  igtl::MessageHeader::Pointer headerMsg;
-  headerMsg = igtl::MessageHeader::New();
-
-  // Initialize receive buffer
-  headerMsg->InitPack();
+  // Get a message buffer to receive header, the buffer is initialized already
+  igtl::MessageHeader::Pointer headerMsg = m_MessagePool->AcquireHeader();
 
   // Receive generic header from the socket
   int r =
@@ -156,26 +153,6 @@ unsigned int mitk::IGTLDevice::ReceivePrivate(igtl::Socket* socket)
 
     if (crcCheck & igtl::MessageHeader::UNPACK_HEADER)
     {
-      // Allocate a time stamp
-      igtl::TimeStamp::Pointer ts;
-      ts = igtl::TimeStamp::New();
-
-      // Get time stamp
-      igtlUint32 sec;
-      igtlUint32 nanosec;
-
-      headerMsg->GetTimeStamp(ts);
-      ts->GetTimeStamp(&sec, &nanosec);
-
-      //      std::cerr << "Time stamp: "
-      //                << sec << "."
-      //                << nanosec << std::endl;
-
-      //      std::cerr << "Dev type and name: " << headerMsg->GetDeviceType() << " "
-      //                << headerMsg->GetDeviceName() << std::endl;
-
-      // headerMsg->Print(std::cout);
-
       //check the type of the received message
       //if it is a GET_, STP_ or RTS_ command push it into the command queue
       //otherwise continue reading the whole message from the socket
@@ -189,9 +166,10 @@ unsigned int mitk::IGTLDevice::ReceivePrivate(igtl::Socket* socket)
         return IGTL_STATUS_OK;
       }
 
-      //Create a message according to the header message
+      //Get a message according to the header message, messages that were
+      //released by all consumers are reused
       igtl::MessageBase::Pointer curMessage;
-      curMessage = m_MessageFactory->CreateInstance(headerMsg);
+      curMessage = m_MessagePool->AcquireMessage(headerMsg);
 
       //check if the curMessage is created properly, if not the message type is
       //not supported and the message has to be skipped
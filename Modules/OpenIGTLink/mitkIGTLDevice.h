@@ -33,6 +33,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "MitkOpenIGTLinkExports.h"
 #include "mitkIGTLMessageFactory.h"
 #include "mitkIGTLMessageQueue.h"
+#include "mitkIGTLMessagePool.h"
 #include "mitkIGTLMessage.h"
 
 namespace mitk {
@@ -197,6 +198,11 @@ namespace mitk {
      */
     itkGetMacro(MessageFactory, mitk::IGTLMessageFactory::Pointer);
 
+    /**
+     * \brief Returns the pool of the messages that are received by this device
+     */
+    itkGetMacro(MessagePool, mitk::IGTLMessagePool::Pointer);
+
     /**
     * \brief static start method for the sending thread.
     * \param data a void pointer to the IGTLDevice object.
@@ -354,6 +360,9 @@ namespace mitk {
     /** A message factory that provides the New() method for all msg types */
     mitk::IGTLMessageFactory::Pointer m_MessageFactory;
 
+    /** Pool of the received messages, only used by the receiving thread */
+    mitk::IGTLMessagePool::Pointer m_MessagePool;
+
     bool m_LogMessages;
 
   private:
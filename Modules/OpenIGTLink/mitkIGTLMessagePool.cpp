@@ -0,0 +1,87 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkIGTLMessagePool.h"
+
+mitk::IGTLMessagePool::IGTLMessagePool(mitk::IGTLMessageFactory::Pointer factory)
+  : m_MessageFactory(factory),
+    m_MaximumNumberOfMessagesPerType(8),
+    m_NumberOfCreatedMessages(0),
+    m_NumberOfReusedMessages(0)
+{
+}
+
+mitk::IGTLMessagePool::~IGTLMessagePool()
+{
+}
+
+igtl::MessageHeader::Pointer mitk::IGTLMessagePool::AcquireHeader()
+{
+  igtl::MessageHeader::Pointer header;
+
+  // a header is still referenced if it was pushed into the command queue
+  for (const igtl::MessageHeader::Pointer& pooledHeader : m_Headers)
+  {
+    if (pooledHeader->GetReferenceCount() == 1)
+    {
+      header = pooledHeader;
+      break;
+    }
+  }
+
+  if (header.IsNull())
+  {
+    header = igtl::MessageHeader::New();
+    if (m_Headers.size() < m_MaximumNumberOfMessagesPerType)
+      m_Headers.push_back(header);
+  }
+
+  header->InitPack();
+  return header;
+}
+
+igtl::MessageBase::Pointer mitk::IGTLMessagePool::AcquireMessage(igtl::MessageHeader* header)
+{
+  if (header == nullptr)
+    return nullptr;
+
+  std::vector<igtl::MessageBase::Pointer>& messages = m_Messages[header->GetDeviceType()];
+
+  // only the pool refers to the message, so nobody can see it being overwritten
+  for (const igtl::MessageBase::Pointer& message : messages)
+  {
+    if (message->GetReferenceCount() == 1)
+    {
+      ++m_NumberOfReusedMessages;
+      return message;
+    }
+  }
+
+  igtl::MessageBase::Pointer message = m_MessageFactory->CreateInstance(header);
+  if (message.IsNotNull())
+  {
+    ++m_NumberOfCreatedMessages;
+    if (messages.size() < m_MaximumNumberOfMessagesPerType)
+      messages.push_back(message);
+  }
+  return message;
+}
+
+void mitk::IGTLMessagePool::Clear()
+{
+  m_Messages.clear();
+  m_Headers.clear();
+}
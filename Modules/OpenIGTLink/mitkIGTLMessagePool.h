@@ -0,0 +1,95 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKIGTLMESSAGEPOOLH_HEADER_INCLUDED_
+#define MITKIGTLMESSAGEPOOLH_HEADER_INCLUDED_
+
+#include "MitkOpenIGTLinkExports.h"
+#include "mitkCommon.h"
+#include "mitkIGTLMessageFactory.h"
+
+#include "itkObject.h"
+
+#include "igtlMessageBase.h"
+#include "igtlMessageHeader.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mitk {
+  /**
+  * \brief Pool of reusable OpenIGTLink messages for the receiving thread of an IGTLDevice
+  *
+  * Instead of creating a new message for every received header, the pool hands out a
+  * message of the same device type that is not referenced anywhere else any more, i.e.
+  * it was pulled from the message queue and released by all consumers. The message keeps
+  * its pack buffer, so streaming messages of constant size (e.g. images) does not allocate
+  * once the pool is warmed up. Messages are created with the message factory if all pooled
+  * messages of the type are still in use.
+  *
+  * The pool is not thread safe, it is meant to be used by a single receiving thread.
+  */
+  class MITKOPENIGTLINK_EXPORT IGTLMessagePool : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(IGTLMessagePool, itk::Object)
+    mitkNewMacro1Param(Self, mitk::IGTLMessageFactory::Pointer);
+
+    /**
+    * \brief Maximum number of pooled messages per device type. Default is 8.
+    */
+    itkSetMacro(MaximumNumberOfMessagesPerType, unsigned int);
+    itkGetConstMacro(MaximumNumberOfMessagesPerType, unsigned int);
+
+    /**
+    * \brief Returns an initialized header to receive the next message into
+    */
+    igtl::MessageHeader::Pointer AcquireHeader();
+
+    /**
+    * \brief Returns a message for the device type of the given header, or nullptr
+    * if the type is not supported by the message factory
+    */
+    igtl::MessageBase::Pointer AcquireMessage(igtl::MessageHeader* header);
+
+    /**
+    * \brief Removes all pooled messages
+    */
+    void Clear();
+
+    itkGetConstMacro(NumberOfCreatedMessages, unsigned long);
+    itkGetConstMacro(NumberOfReusedMessages, unsigned long);
+
+  protected:
+    IGTLMessagePool(mitk::IGTLMessageFactory::Pointer factory);
+    virtual ~IGTLMessagePool();
+
+    mitk::IGTLMessageFactory::Pointer m_MessageFactory;
+    unsigned int m_MaximumNumberOfMessagesPerType;
+
+    std::map<std::string, std::vector<igtl::MessageBase::Pointer> > m_Messages;
+    std::vector<igtl::MessageHeader::Pointer> m_Headers;
+
+    unsigned long m_NumberOfCreatedMessages;
+    unsigned long m_NumberOfReusedMessages;
+
+  private:
+    IGTLMessagePool(const IGTLMessagePool&);
+  };
+}
+
+#endif
@@ -23,8 +23,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkFastMutexLock.h"
 #include "mitkCommon.h"
 
-#include <deque>
+#include <atomic>
 #include <mitkIGTLMessage.h>
+#include "mitkIGTLBoundedQueue.h"
 
 //OpenIGTLink
 #include "igtlMessageBase.h"
@@ -38,6 +39,11 @@ namespace mitk {
   * \class IGTLMessageQueue
   * \brief Thread safe message queue to store OpenIGTLink messages.
   *
+  * Every message type has its own lock-free queue with a capacity of
+  * BufferSize messages, so the receiving thread never waits for a consumer
+  * and the memory of the queue does not grow while nobody pulls messages.
+  * If a queue is full, its oldest message is dropped.
+  *
   * \ingroup OpenIGTLink
   */
   class MITKOPENIGTLINK_EXPORT IGTLMessageQueue : public itk::Object
@@ -49,11 +55,17 @@ namespace mitk {
 
       /**
        * \brief Different buffering types
-       * Infinit buffering means that you can push as many messages as you want
+       * Infinit buffering means that you can push as many messages as you want,
+       * but only the latest BufferSize messages of each type are kept
        * NoBuffering means that the queue just stores a single message
        */
     enum BufferingType { Infinit, NoBuffering };
 
+    /**
+    * \brief Maximum number of messages of one type in the queue
+    */
+    static const unsigned int BufferSize = 64;
+
     void PushSendMessage(mitk::IGTLMessage::Pointer message);
 
     /**
@@ -108,35 +120,49 @@ namespace mitk {
      */
     void EnableNoBufferingMode(bool enable);
 
+    /**
+    * \brief Returns the number of messages that were dropped because the queue
+    * of their type was full
+    */
+    unsigned long GetNumberOfDroppedMessages() const;
+
   protected:
     IGTLMessageQueue();
     virtual ~IGTLMessageQueue();
 
   protected:
+    template <typename T>
+    void Push(IGTLBoundedQueue<T>& queue, const T& message);
+
+    template <typename T>
+    T Pull(IGTLBoundedQueue<T>& queue);
+
     /**
-    * \brief Mutex to take car of the queue
+    * \brief Mutex to take care of the latest message, the queues do not need one
     */
     itk::FastMutexLock::Pointer m_Mutex;
 
     /**
-    * \brief the queue that stores pointer to the inserted messages
+    * \brief the queues that store pointer to the inserted messages
     */
-    std::deque< igtl::MessageBase::Pointer > m_CommandQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image2dQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image3dQueue;
-    std::deque< igtl::TransformMessage::Pointer > m_TransformQueue;
-    std::deque< igtl::TrackingDataMessage::Pointer > m_TrackingDataQueue;
-    std::deque< igtl::StringMessage::Pointer > m_StringQueue;
-    std::deque< igtl::MessageBase::Pointer > m_MiscQueue;
+    IGTLBoundedQueue< igtl::MessageBase::Pointer > m_CommandQueue;
+    IGTLBoundedQueue< igtl::ImageMessage::Pointer > m_Image2dQueue;
+    IGTLBoundedQueue< igtl::ImageMessage::Pointer > m_Image3dQueue;
+    IGTLBoundedQueue< igtl::TransformMessage::Pointer > m_TransformQueue;
+    IGTLBoundedQueue< igtl::TrackingDataMessage::Pointer > m_TrackingDataQueue;
+    IGTLBoundedQueue< igtl::StringMessage::Pointer > m_StringQueue;
+    IGTLBoundedQueue< igtl::MessageBase::Pointer > m_MiscQueue;
 
-    std::deque< mitk::IGTLMessage::Pointer > m_SendQueue;
+    IGTLBoundedQueue< mitk::IGTLMessage::Pointer > m_SendQueue;
 
     igtl::MessageBase::Pointer m_Latest_Message;
 
     /**
     * \brief defines the kind of buffering
     */
-    BufferingType m_BufferingType;
+    std::atomic<BufferingType> m_BufferingType;
+
+    std::atomic<unsigned long> m_NumberOfDroppedMessages;
   };
 }
 
@@ -27,14 +27,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkImageIOBase.h>
 #include "mitkImageCast.h"
 #include <mitkPhotoacousticOCLBeamformer.h>
+#include "mitkPhotoacousticThreadPool.h"
 
 
-mitk::BeamformingFilter::BeamformingFilter() : m_OutputData(nullptr), m_InputData(nullptr)
+mitk::BeamformingFilter::BeamformingFilter()
 {
   this->SetNumberOfIndexedInputs(1);
   this->SetNumberOfRequiredInputs(1);
 
   m_ProgressHandle = [](int, std::string) {};
+
+  for (unsigned int& dimension : m_TableDimensions)
+    dimension = 0;
 }
 
 void mitk::BeamformingFilter::SetProgressHandle(std::function<void(int, std::string)> progressHandle)
@@ -109,111 +113,59 @@ void mitk::BeamformingFilter::GenerateData()
   unsigned int oclOutputDimLastChunk[3] = { output->GetDimension(0), output->GetDimension(1), input->GetDimension(2) % chunkSize };
   unsigned int oclInputDimLastChunk[3] = { input->GetDimension(0), input->GetDimension(1), input->GetDimension(2) % chunkSize };
 
-  const int apodArraySize = m_Conf.TransducerElements * 4; // set the resolution of the apodization array
-  float* ApodWindow;
-
-  // calculate the appropiate apodization window
-  switch (m_Conf.Apod)
-  {
-  case beamformingSettings::Apodization::Hann:
-    ApodWindow = VonHannFunction(apodArraySize);
-    break;
-  case beamformingSettings::Apodization::Hamm:
-    ApodWindow = HammFunction(apodArraySize);
-    break;
-  case beamformingSettings::Apodization::Box:
-    ApodWindow = BoxFunction(apodArraySize);
-    break;
-  default:
-    ApodWindow = BoxFunction(apodArraySize);
-    break;
-  }
+  // the apodization window and the delays are only recomputed if the configuration or the image size changed
+  this->UpdateTables(input->GetDimension(0), input->GetDimension(1), output->GetDimension(0), output->GetDimension(1));
+  const int apodArraySize = static_cast<int>(m_Apodisation.size());
+  float* ApodWindow = m_Apodisation.data();
 
   int progInterval = output->GetDimension(2) / 20 > 1 ? output->GetDimension(2) / 20 : 1;
   // the interval at which we update the gui progress bar
 
   auto begin = std::chrono::high_resolution_clock::now(); // debbuging the performance...
-  if (!m_Conf.UseGPU)
+  // there is no OpenCL kernel for sDMAS
+  if (!m_Conf.UseGPU || m_Conf.Algorithm == beamformingSettings::BeamformingAlgorithm::sDMAS)
   {
-    for (unsigned int i = 0; i < output->GetDimension(2); ++i) // seperate Slices should get Beamforming seperately applied
+    // first, we convert any data to float, which we use by default
+    if (input->GetPixelType().GetTypeAsString() != "scalar (float)" && input->GetPixelType().GetTypeAsString() != " (float)")
     {
-      mitk::ImageReadAccessor inputReadAccessor(input, input->GetSliceData(i));
+      MITK_INFO << "Pixel type is not float, abort";
+      return;
+    }
 
-      m_OutputData = new float[m_Conf.ReconstructionLines*m_Conf.SamplesPerLine];
-      m_InputDataPuffer = new float[input->GetDimension(0)*input->GetDimension(1)];
+    mitk::ImageReadAccessor inputReadAccessor(input);
+    const float* inputData = static_cast<const float*>(inputReadAccessor.GetData());
 
-      // first, we convert any data to float, which we use by default
-      if (input->GetPixelType().GetTypeAsString() == "scalar (float)" || input->GetPixelType().GetTypeAsString() == " (float)")
-      {
-        m_InputData = (float*)inputReadAccessor.GetData();
-      }
-      else
-      {
-        MITK_INFO << "Pixel type is not float, abort";
-        return;
-      }
+    const unsigned int lines = output->GetDimension(0);
+    const unsigned int inputSliceSize = input->GetDimension(0) * input->GetDimension(1);
+    const unsigned int outputSliceSize = output->GetDimension(0) * output->GetDimension(1);
 
-      // fill the image with zeros
-      for (int l = 0; l < outputDim[0]; ++l)
-      {
-        for (int s = 0; s < outputDim[1]; ++s)
-        {
-          m_OutputData[l*(short)outputDim[1] + s] = 0;
-        }
-      }
+    // the lines of progInterval slices are beamformed at once, the progress is reported in between
+    std::vector<float> outputData(outputSliceSize * progInterval);
+    PhotoacousticThreadPool* threadPool = PhotoacousticThreadPool::GetInstance();
 
-      std::thread *threads = new std::thread[(short)outputDim[0]];
+    for (unsigned int firstSlice = 0; firstSlice < output->GetDimension(2); firstSlice += progInterval) // seperate Slices should get Beamforming seperately applied
+    {
+      const unsigned int slices = std::min((unsigned int)progInterval, output->GetDimension(2) - firstSlice);
 
-      // every line will be beamformed in a seperate thread
-      if (m_Conf.Algorithm == beamformingSettings::BeamformingAlgorithm::DAS)
+      threadPool->ParallelFor(slices * lines, [&](unsigned int task)
       {
-        if (m_Conf.DelayCalculationMethod == beamformingSettings::DelayCalc::QuadApprox)
-        {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingFilter::DASQuadraticLine, this, m_InputData, m_OutputData, inputDim, outputDim, line, ApodWindow, apodArraySize);
-          }
-        }
-        else if (m_Conf.DelayCalculationMethod == beamformingSettings::DelayCalc::Spherical)
-        {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingFilter::DASSphericalLine, this, m_InputData, m_OutputData, inputDim, outputDim, line, ApodWindow, apodArraySize);
-          }
-        }
-      }
-      else if (m_Conf.Algorithm == beamformingSettings::BeamformingAlgorithm::DMAS)
+        const unsigned int slice = task / lines;
+        const unsigned int line = task % lines;
+
+        std::vector<short> delayBuffer(input->GetDimension(0));
+        std::vector<float> signalBuffer(input->GetDimension(0));
+        float inputDimLine[2] = { inputDim[0], inputDim[1] };
+        float outputDimLine[2] = { outputDim[0], outputDim[1] };
+        this->BeamformLine(inputData + (firstSlice + slice) * inputSliceSize, outputData.data() + slice * outputSliceSize,
+          inputDimLine, outputDimLine, line, delayBuffer.data(), signalBuffer.data());
+      });
+
+      for (unsigned int slice = 0; slice < slices; ++slice)
       {
-        if (m_Conf.DelayCalculationMethod == beamformingSettings::DelayCalc::QuadApprox)
-        {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingFilter::DMASQuadraticLine, this, m_InputData, m_OutputData, inputDim, outputDim, line, ApodWindow, apodArraySize);
-          }
-        }
-        else if (m_Conf.DelayCalculationMethod == beamformingSettings::DelayCalc::Spherical)
-        {
-          for (short line = 0; line < outputDim[0]; ++line)
-          {
-            threads[line] = std::thread(&BeamformingFilter::DMASSphericalLine, this, m_InputData, m_OutputData, inputDim, outputDim, line, ApodWindow, apodArraySize);
-          }
-        }
-      }
-      // wait for all lines to finish
-      for (short line = 0; line < outputDim[0]; ++line)
-      {
-        threads[line].join();
+        output->SetSlice(outputData.data() + slice * outputSliceSize, firstSlice + slice);
       }
 
-      output->SetSlice(m_OutputData, i);
-
-      if (i % progInterval == 0)
-        m_ProgressHandle((int)((i + 1) / (float)output->GetDimension(2) * 100), "performing reconstruction");
-
-      delete[] m_OutputData;
-      delete[] m_InputDataPuffer;
-      m_OutputData = nullptr;
-      m_InputData = nullptr;
+      m_ProgressHandle((int)((firstSlice + slices) / (float)output->GetDimension(2) * 100), "performing reconstruction");
     }
   }
   else
@@ -311,155 +263,130 @@ void mitk::BeamformingFilter::GenerateData()
 void mitk::BeamformingFilter::Configure(beamformingSettings settings)
 {
   m_Conf = settings;
+  this->Modified();
+
+  // the tables are recomputed with the new settings on the next update
+  m_Apodisation.clear();
+  m_DelayTable.clear();
 }
 
-float* mitk::BeamformingFilter::VonHannFunction(int samples)
+void mitk::BeamformingFilter::BeamformFrame(const float* input, const unsigned int inputDim[2], float* output)
 {
-  float* ApodWindow = new float[samples];
+  const unsigned int lines = m_Conf.ReconstructionLines;
+  this->UpdateTables(inputDim[0], inputDim[1], lines, m_Conf.SamplesPerLine);
 
-  for (int n = 0; n < samples; ++n)
+  PhotoacousticThreadPool::GetInstance()->ParallelFor(lines, [&](unsigned int line)
   {
-    ApodWindow[n] = (1 - cos(2 * M_PI * n / (samples - 1))) / 2;
-  }
-
-  return ApodWindow;
+    std::vector<short> delayBuffer(inputDim[0]);
+    std::vector<float> signalBuffer(inputDim[0]);
+    float inputDimLine[2] = { (float)inputDim[0], (float)inputDim[1] };
+    float outputDimLine[2] = { (float)lines, (float)m_Conf.SamplesPerLine };
+    this->BeamformLine(input, output, inputDimLine, outputDimLine, line, delayBuffer.data(), signalBuffer.data());
+  });
 }
 
-float* mitk::BeamformingFilter::HammFunction(int samples)
+std::vector<float> mitk::BeamformingFilter::VonHannFunction(int samples)
 {
-  float* ApodWindow = new float[samples];
+  std::vector<float> ApodWindow(samples);
 
   for (int n = 0; n < samples; ++n)
   {
-    ApodWindow[n] = 0.54 - 0.46*cos(2 * M_PI*n / (samples - 1));
+    ApodWindow[n] = (1 - cos(2 * M_PI * n / (samples - 1))) / 2;
   }
 
   return ApodWindow;
 }
 
-float* mitk::BeamformingFilter::BoxFunction(int samples)
+std::vector<float> mitk::BeamformingFilter::HammFunction(int samples)
 {
-  float* ApodWindow = new float[samples];
+  std::vector<float> ApodWindow(samples);
 
   for (int n = 0; n < samples; ++n)
   {
-    ApodWindow[n] = 1;
+    ApodWindow[n] = 0.54 - 0.46*cos(2 * M_PI*n / (samples - 1));
   }
 
   return ApodWindow;
 }
 
-void mitk::BeamformingFilter::DASQuadraticLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, float* apodisation, const short& apodArraySize)
+std::vector<float> mitk::BeamformingFilter::BoxFunction(int samples)
 {
-  float& inputS = inputDim[1];
-  float& inputL = inputDim[0];
-
-  float& outputS = outputDim[1];
-  float& outputL = outputDim[0];
-
-  short AddSample = 0;
-  short maxLine = 0;
-  short minLine = 0;
-  float delayMultiplicator = 0;
-  float l_i = 0;
-  float s_i = 0;
-
-  float part = 0.07 * inputL;
-  float tan_phi = std::tan(m_Conf.Angle / 360 * 2 * M_PI);
-  float part_multiplicator = tan_phi * m_Conf.TimeSpacing * m_Conf.SpeedOfSound / m_Conf.Pitch * m_Conf.ReconstructionLines / m_Conf.TransducerElements;
-  float apod_mult = 1;
+  return std::vector<float>(samples, 1.0f);
+}
 
-  short usedLines = (maxLine - minLine);
+void mitk::BeamformingFilter::UpdateTables(unsigned int inputL, unsigned int inputS, unsigned int outputL, unsigned int outputS)
+{
+  const unsigned int dimensions[4] = { inputL, inputS, outputL, outputS };
+  if (!m_Apodisation.empty() && std::equal(dimensions, dimensions + 4, m_TableDimensions))
+    return;
 
-  //quadratic delay
-  l_i = line / outputL * inputL;
+  const int apodArraySize = m_Conf.TransducerElements * 4; // set the resolution of the apodization array
 
-  for (short sample = 0; sample < outputS; ++sample)
+  // calculate the appropiate apodization window
+  switch (m_Conf.Apod)
   {
-    s_i = (float)sample / outputS * inputS / 2;
-
-    part = part_multiplicator*s_i;
-
-    if (part < 1)
-      part = 1;
-
-    maxLine = (short)std::min((l_i + part) + 1, inputL);
-    minLine = (short)std::max((l_i - part), 0.0f);
-    usedLines = (maxLine - minLine);
-
-    apod_mult = apodArraySize / (maxLine - minLine);
-
-    delayMultiplicator = pow((1 / (m_Conf.TimeSpacing*m_Conf.SpeedOfSound) * (m_Conf.Pitch*m_Conf.TransducerElements) / inputL), 2) / s_i / 2;
+  case beamformingSettings::Apodization::Hann:
+    m_Apodisation = VonHannFunction(apodArraySize);
+    break;
+  case beamformingSettings::Apodization::Hamm:
+    m_Apodisation = HammFunction(apodArraySize);
+    break;
+  case beamformingSettings::Apodization::Box:
+  default:
+    m_Apodisation = BoxFunction(apodArraySize);
+    break;
+  }
 
-    for (short l_s = minLine; l_s < maxLine; ++l_s)
+  // The delays only depend on the depth of the output sample and the distance between input and output line.
+  // If the output lines lie on the input lines, this distance is an integer and one table holds all delays.
+  m_DelayTable.clear();
+  if (inputL == outputL)
+  {
+    const unsigned int offsets = 2 * inputL - 1;
+    m_DelayTable.resize(offsets * outputS);
+    for (unsigned int sample = 0; sample < outputS; ++sample)
     {
-      AddSample = delayMultiplicator * pow((l_s - l_i), 2) + s_i + (1 - m_Conf.Photoacoustic)*s_i;
-      if (AddSample < inputS && AddSample >= 0) 
-        output[sample*(short)outputL + line] += input[l_s + AddSample*(short)inputL] * apodisation[(short)((l_s - minLine)*apod_mult)];
-      else
-        --usedLines;
+      // the input line inputL - 1 is at offset 0
+      const float s_i = (float)sample / outputS * inputS / 2;
+      this->ComputeDelays(inputL - 1, s_i, 0, offsets, inputL, inputS, &m_DelayTable[sample * offsets]);
     }
-    output[sample*(short)outputL + line] = output[sample*(short)outputL + line] / usedLines;
   }
+
+  std::copy(dimensions, dimensions + 4, m_TableDimensions);
 }
 
-void mitk::BeamformingFilter::DASSphericalLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, float* apodisation, const short& apodArraySize)
+void mitk::BeamformingFilter::ComputeDelays(float l_i, float s_i, short minLine, short maxLine, float inputL, float inputS, short* delays) const
 {
-  float& inputS = inputDim[1];
-  float& inputL = inputDim[0];
-
-  float& outputS = outputDim[1];
-  float& outputL = outputDim[0];
-
-  short AddSample = 0;
-  short maxLine = 0;
-  short minLine = 0;
-  float l_i = 0;
-  float s_i = 0;
-
-  float part = 0.07 * inputL;
-  float tan_phi = std::tan(m_Conf.Angle / 360 * 2 * M_PI);
-  float part_multiplicator = tan_phi * m_Conf.TimeSpacing * m_Conf.SpeedOfSound / m_Conf.Pitch * m_Conf.ReconstructionLines / m_Conf.TransducerElements;
-  float apod_mult = 1;
-
-  short usedLines = (maxLine - minLine);
-
-  //exact delay
-
-  l_i = (float)line / outputL * inputL;
+  const float photoacousticFactor = (1 - m_Conf.Photoacoustic) * s_i;
 
-  for (short sample = 0; sample < outputS; ++sample)
+  if (m_Conf.DelayCalculationMethod == beamformingSettings::DelayCalc::QuadApprox)
   {
-    s_i = (float)sample / outputS * inputS / 2;
+    //quadratic delay
+    const float delayMultiplicator = pow((1 / (m_Conf.TimeSpacing*m_Conf.SpeedOfSound) * (m_Conf.Pitch*m_Conf.TransducerElements) / inputL), 2) / s_i / 2;
 
-    part = part_multiplicator*s_i;
-
-    if (part < 1)
-      part = 1;
-
-    maxLine = (short)std::min((l_i + part) + 1, inputL);
-    minLine = (short)std::max((l_i - part), 0.0f);
-    usedLines = (maxLine - minLine);
-
-    apod_mult = apodArraySize / (maxLine - minLine);
+    for (short l_s = minLine; l_s < maxLine; ++l_s)
+    {
+      const float distance = l_s - l_i;
+      // at the surface only the signal of the line itself is used
+      const double delay = s_i > 0 ? delayMultiplicator * pow(distance, 2) + s_i + photoacousticFactor : (distance == 0 ? 0.0 : inputS);
+      delays[l_s] = delay >= 0 && delay < inputS ? (short)delay : -1;
+    }
+  }
+  else
+  {
+    //exact delay
+    const float lateralMultiplicator = 1 / (m_Conf.TimeSpacing*m_Conf.SpeedOfSound) * m_Conf.Pitch*m_Conf.TransducerElements / inputL;
 
     for (short l_s = minLine; l_s < maxLine; ++l_s)
     {
-      AddSample = (int)sqrt(
-        pow(s_i, 2)
-        +
-        pow((1 / (m_Conf.TimeSpacing*m_Conf.SpeedOfSound) * ((l_s - l_i)*m_Conf.Pitch*m_Conf.TransducerElements) / inputL), 2)
-      ) + (1 - m_Conf.Photoacoustic)*s_i;
-      if (AddSample < inputS && AddSample >= 0) 
-        output[sample*(short)outputL + line] += input[l_s + AddSample*(short)inputL] * apodisation[(short)((l_s - minLine)*apod_mult)];
-      else
-        --usedLines;
+      const float lateral = (l_s - l_i) * lateralMultiplicator;
+      const float delay = (int)sqrt(s_i * s_i + lateral * lateral) + photoacousticFactor;
+      delays[l_s] = delay >= 0 && delay < inputS ? (short)delay : -1;
     }
-    output[sample*(short)outputL + line] = output[sample*(short)outputL + line] / usedLines;
   }
 }
 
-void mitk::BeamformingFilter::DMASQuadraticLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, float* apodisation, const short& apodArraySize)
+void mitk::BeamformingFilter::BeamformLine(const float* input, float* output, float inputDim[2], float outputDim[2], unsigned int line, short* delayBuffer, float* signalBuffer) const
 {
   float& inputS = inputDim[1];
   float& inputL = inputDim[0];
@@ -467,141 +394,114 @@ void mitk::BeamformingFilter::DMASQuadraticLine(float* input, float* output, flo
   float& outputS = outputDim[1];
   float& outputL = outputDim[0];
 
-  short maxLine = 0;
-  short minLine = 0;
-  float delayMultiplicator = 0;
-  float l_i = 0;
-  float s_i = 0;
+  const short apodArraySize = (short)m_Apodisation.size();
+  const float* apodisation = m_Apodisation.data();
 
-  float part = 0.07 * inputL;
-  float tan_phi = std::tan(m_Conf.Angle / 360 * 2 * M_PI);
-  float part_multiplicator = tan_phi * m_Conf.TimeSpacing * m_Conf.SpeedOfSound / m_Conf.Pitch * m_Conf.ReconstructionLines / m_Conf.TransducerElements;
-  float apod_mult = 1;
+  const float tan_phi = std::tan(m_Conf.Angle / 360 * 2 * M_PI);
+  const float part_multiplicator = tan_phi * m_Conf.TimeSpacing * m_Conf.SpeedOfSound / m_Conf.Pitch * m_Conf.ReconstructionLines / m_Conf.TransducerElements;
 
-  float mult = 0;
-  short usedLines = (maxLine - minLine);
+  const bool useDelayTable = !m_DelayTable.empty();
+  const unsigned int delayTableOffsets = 2 * (unsigned int)inputL - 1;
 
-  //quadratic delay
-  l_i = line / outputL * inputL;
+  const float l_i = useDelayTable ? line : line / outputL * inputL;
 
-  for (short sample = 0; sample < outputS; ++sample)
+  for (unsigned int sample = 0; sample < outputS; ++sample)
   {
-    s_i = sample / outputS * inputS / 2;
-
-    part = part_multiplicator*s_i;
+    const float s_i = (float)sample / outputS * inputS / 2;
 
+    float part = part_multiplicator*s_i;
     if (part < 1)
       part = 1;
 
-    maxLine = (short)std::min((l_i + part) + 1, inputL);
-    minLine = (short)std::max((l_i - part), 0.0f);
-    usedLines = (maxLine - minLine);
+    const short maxLine = (short)std::min((l_i + part) + 1, inputL);
+    const short minLine = (short)std::max((l_i - part), 0.0f);
+    const short lineCount = maxLine - minLine;
 
-    apod_mult = apodArraySize / (maxLine - minLine);
+    const float apod_mult = apodArraySize / lineCount;
 
-    delayMultiplicator = pow((1 / (m_Conf.TimeSpacing*m_Conf.SpeedOfSound) * (m_Conf.Pitch*m_Conf.TransducerElements) / inputL), 2) / s_i / 2;
-
-    //calculate the AddSamples beforehand to save some time
-    short* AddSample = new short[maxLine - minLine];
-    for (short l_s = 0; l_s < maxLine - minLine; ++l_s)
-    {
-      AddSample[l_s] = (short)(delayMultiplicator * pow((minLine + l_s - l_i), 2) + s_i) + (1 - m_Conf.Photoacoustic)*s_i;
-    }
+    // delays[l_s] is the delay of input line l_s
+    const short* delays = delayBuffer;
+    if (useDelayTable)
+      delays = &m_DelayTable[sample * delayTableOffsets + (delayTableOffsets / 2) - line];
+    else
+      this->ComputeDelays(l_i, s_i, minLine, maxLine, inputL, inputS, delayBuffer);
 
-    for (short l_s1 = minLine; l_s1 < maxLine - 1; ++l_s1)
+    // gather the apodized signals of all lines, signals outside of the input are zero
+    short invalidLines = 0;
+    for (short l_s = minLine; l_s < maxLine; ++l_s)
     {
-      if (AddSample[l_s1 - minLine] < (short)inputS && AddSample[l_s1 - minLine] >= 0)
+      const short delay = delays[l_s];
+      if (delay >= 0)
       {
-        for (short l_s2 = l_s1 + 1; l_s2 < maxLine; ++l_s2)
-        {
-          if (AddSample[l_s2 - minLine] < inputS && AddSample[l_s2 - minLine] >= 0)
-          {
-            mult = input[l_s2 + AddSample[l_s2 - minLine] * (short)inputL] * apodisation[(short)((l_s2 - minLine)*apod_mult)] * input[l_s1 + AddSample[l_s1 - minLine] * (short)inputL] * apodisation[(short)((l_s1 - minLine)*apod_mult)];
-            output[sample*(short)outputL + line] += sqrt(abs(mult)) * ((mult > 0) - (mult < 0));
-          }
-        }
+        signalBuffer[l_s - minLine] = input[l_s + delay*(int)inputL] * apodisation[(short)((l_s - minLine)*apod_mult)];
       }
       else
-        --usedLines;
+      {
+        signalBuffer[l_s - minLine] = 0;
+        ++invalidLines;
+      }
     }
 
-    output[sample*(short)outputL + line] = 10 * output[sample*(short)outputL + line] / (pow(usedLines, 2) - (usedLines - 1));
-
-    delete[] AddSample;
-  }
-}
-
-void mitk::BeamformingFilter::DMASSphericalLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, float* apodisation, const short& apodArraySize)
-{
-  float& inputS = inputDim[1];
-  float& inputL = inputDim[0];
-
-  float& outputS = outputDim[1];
-  float& outputL = outputDim[0];
-
-  short maxLine = 0;
-  short minLine = 0;
-  float l_i = 0;
-  float s_i = 0;
-
-  float part = 0.07 * inputL;
-  float tan_phi = std::tan(m_Conf.Angle / 360 * 2 * M_PI);
-  float part_multiplicator = tan_phi * m_Conf.TimeSpacing * m_Conf.SpeedOfSound / m_Conf.Pitch * m_Conf.ReconstructionLines / m_Conf.TransducerElements;
-  float apod_mult = 1;
-
-  float mult = 0;
-
-  short usedLines = (maxLine - minLine);
-
-  //exact delay
-
-  l_i = line / outputL * inputL;
-
-  for (short sample = 0; sample < outputS; ++sample)
-  {
-    s_i = sample / outputS * inputS / 2;
+    float& result = output[sample*(unsigned int)outputL + line];
 
-    part = part_multiplicator*s_i;
-
-    if (part < 1)
-      part = 1;
-
-    maxLine = (short)std::min((l_i + part) + 1, inputL);
-    minLine = (short)std::max((l_i - part), 0.0f);
-    usedLines = (maxLine - minLine);
-
-    apod_mult = apodArraySize / (maxLine - minLine);
-
-    //calculate the AddSamples beforehand to save some time
-    short* AddSample = new short[maxLine - minLine];
-    for (short l_s = 0; l_s < maxLine - minLine; ++l_s)
+    if (m_Conf.Algorithm == beamformingSettings::BeamformingAlgorithm::DAS)
     {
-      AddSample[l_s] = (short)sqrt(
-        pow(s_i, 2)
-        +
-        pow((1 / (m_Conf.TimeSpacing*m_Conf.SpeedOfSound) * ((minLine + l_s - l_i)*m_Conf.Pitch*m_Conf.TransducerElements) / inputL), 2)
-      ) + (1 - m_Conf.Photoacoustic)*s_i;
-    }
+      float sum[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+      short k = 0;
+      for (; k + 8 <= lineCount; k += 8)
+      {
+        for (short j = 0; j < 8; ++j)
+          sum[j] += signalBuffer[k + j];
+      }
+      for (; k < lineCount; ++k)
+        sum[0] += signalBuffer[k];
 
-    for (short l_s1 = minLine; l_s1 < maxLine - 1; ++l_s1)
+      const short usedLines = lineCount - invalidLines;
+      result = usedLines > 0 ? (((sum[0] + sum[4]) + (sum[1] + sum[5])) + ((sum[2] + sum[6]) + (sum[3] + sum[7]))) / usedLines : 0;
+    }
+    else
     {
-      if (AddSample[l_s1 - minLine] < inputS && AddSample[l_s1 - minLine] >= 0)
+      // the last line only counts if another line is combined with it
+      short usedLines = lineCount - invalidLines;
+      if (lineCount > 0 && delays[maxLine - 1] < 0)
+        ++usedLines;
+
+      double sum[4] = { 0, 0, 0, 0 };
+      double squaredSum[4] = { 0, 0, 0, 0 };
+      double dasSum[4] = { 0, 0, 0, 0 };
+      short k = 0;
+      for (; k + 4 <= lineCount; k += 4)
       {
-        for (short l_s2 = l_s1 + 1; l_s2 < maxLine; ++l_s2)
+        for (short j = 0; j < 4; ++j)
         {
-          if (AddSample[l_s2 - minLine] < inputS && AddSample[l_s2 - minLine] >= 0)
-          {
-            mult = input[l_s2 + AddSample[l_s2 - minLine] * (short)inputL] * apodisation[(int)((l_s2 - minLine)*apod_mult)] * input[l_s1 + AddSample[l_s1 - minLine] * (short)inputL] * apodisation[(int)((l_s1 - minLine)*apod_mult)];
-            output[sample*(short)outputL + line] += sqrt(abs(mult)) * ((mult > 0) - (mult < 0));
-          }
+          const double signal = signalBuffer[k + j];
+          const double root = std::sqrt(std::abs(signal));
+          sum[j] += signal < 0 ? -root : root;
+          squaredSum[j] += std::abs(signal);
+          dasSum[j] += signal;
         }
       }
-      else
-        --usedLines;
-    }
+      for (; k < lineCount; ++k)
+      {
+        const double signal = signalBuffer[k];
+        const double root = std::sqrt(std::abs(signal));
+        sum[0] += signal < 0 ? -root : root;
+        squaredSum[0] += std::abs(signal);
+        dasSum[0] += signal;
+      }
+
+      const double totalSum = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+      const double totalSquaredSum = (squaredSum[0] + squaredSum[1]) + (squaredSum[2] + squaredSum[3]);
+      const double pairSum = (totalSum * totalSum - totalSquaredSum) / 2;
 
-    output[sample*(short)outputL + line] = 10 * output[sample*(short)outputL + line] / (pow(usedLines, 2) - (usedLines - 1));
+      result = (float)(10 * pairSum / (pow(usedLines, 2) - (usedLines - 1)));
 
-    delete[] AddSample;
+      if (m_Conf.Algorithm == beamformingSettings::BeamformingAlgorithm::sDMAS)
+      {
+        // signed DMAS keeps the sign of the DAS signal
+        const double dasTotal = (dasSum[0] + dasSum[1]) + (dasSum[2] + dasSum[3]);
+        result *= (dasTotal > 0) - (dasTotal < 0);
+      }
+    }
   }
 }
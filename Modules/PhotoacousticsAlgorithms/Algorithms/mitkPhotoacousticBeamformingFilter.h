@@ -20,13 +20,21 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkImageToImageFilter.h"
 #include <functional>
+#include <vector>
+
+#include "MitkPhotoacousticsAlgorithmsExports.h"
 
 namespace mitk {
 
   //##Documentation
-  //## @brief
+  //## @brief Reconstructs photoacoustic or ultrasound images by delay-and-sum (DAS), delay-multiply-and-sum (DMAS)
+  //## or signed DMAS (sDMAS) beamforming, either with OpenCL or on the CPU.
+  //##
+  //## On the CPU, the lines of all slices are distributed over the threads of the PhotoacousticThreadPool.
+  //## The apodization window and the delays are computed once per configuration and reused for every slice
+  //## and every following update with the same configuration and image size.
   //## @ingroup Process
-  class BeamformingFilter : public ImageToImageFilter
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT BeamformingFilter : public ImageToImageFilter
   {
   public:
     mitkClassMacro(BeamformingFilter, ImageToImageFilter);
@@ -54,7 +62,7 @@ namespace mitk {
       enum Apodization {Hamm, Hann, Box};
       Apodization Apod = Hann;
 
-      enum BeamformingAlgorithm {DMAS, DAS};
+      enum BeamformingAlgorithm {DMAS, DAS, sDMAS};
       BeamformingAlgorithm Algorithm = DAS;
 
       float Angle = 10;
@@ -64,10 +72,19 @@ namespace mitk {
       bool UseBP = false;
     };
 
+    //##Description
+    //## @brief Sets the settings of the reconstruction, the delays and apodization are recomputed on the next update
     void Configure(beamformingSettings settings);
 
     void SetProgressHandle(std::function<void(int, std::string)> progressHandle);
 
+    //##Description
+    //## @brief Beamforms a single float frame on the CPU, without the ITK pipeline and without allocating images
+    //##
+    //## The output holds ReconstructionLines x SamplesPerLine samples of the current configuration. The tables are
+    //## reused for all frames of the same size, so consecutive calls must not overlap.
+    void BeamformFrame(const float* input, const unsigned int inputDim[2], float* output);
+
   protected:
 
     BeamformingFilter();
@@ -86,19 +103,35 @@ namespace mitk {
 
     std::function<void(int, std::string)> m_ProgressHandle;
 
-    float* VonHannFunction(int samples);
-    float* HammFunction(int samples);
-    float* BoxFunction(int samples);
+    std::vector<float> VonHannFunction(int samples);
+    std::vector<float> HammFunction(int samples);
+    std::vector<float> BoxFunction(int samples);
+
+    //##Description
+    //## @brief Computes the apodization window and, if every output line lies on an input line, the delay table
+    void UpdateTables(unsigned int inputL, unsigned int inputS, unsigned int outputL, unsigned int outputS);
 
-    void DASQuadraticLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, float* apodisation, const short& apodArraySize);
-    void DASSphericalLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, float* apodisation, const short& apodArraySize);
+    //##Description
+    //## @brief Computes the delays of the input lines [minLine, maxLine) for the output sample at (l_i, s_i),
+    //## delays[l_s] is the input sample of line l_s or -1 if it lies outside of the input
+    void ComputeDelays(float l_i, float s_i, short minLine, short maxLine, float inputL, float inputS, short* delays) const;
 
-    void DMASQuadraticLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, float* apodisation, const short& apodArraySize);
-    void DMASSphericalLine(float* input, float* output, float inputDim[2], float outputDim[2], const short& line, float* apodisation, const short& apodArraySize);
+    //##Description
+    //## @brief Beamforms all samples of one output line of one slice
+    //##
+    //## The delayed samples of a line are gathered into a contiguous buffer first, so that the sums of the
+    //## DAS, DMAS and sDMAS kernels run over contiguous memory and can be vectorized by the compiler.
+    //## DMAS sums the products of all pairs of signals in linear time, using
+    //## sum_{i<j} b_i b_j = ((sum_i b_i)^2 - sum_i b_i^2) / 2 with b_i = sign(a_i) sqrt(|a_i|).
+    void BeamformLine(const float* input, float* output, float inputDim[2], float outputDim[2], unsigned int line, short* delayBuffer, float* signalBuffer) const;
 
-    float* m_OutputData;
-    float* m_InputData;
-    float* m_InputDataPuffer;
+    std::vector<float> m_Apodisation;
+
+    //##Description
+    //## @brief Delay table with one row per output sample, each row holds the delays of the lateral offsets
+    //## -(inputL - 1) ... (inputL - 1) between input and output line. Empty if the delays are computed per line.
+    std::vector<short> m_DelayTable;
+    unsigned int m_TableDimensions[4];
 
     beamformingSettings m_Conf;
   };
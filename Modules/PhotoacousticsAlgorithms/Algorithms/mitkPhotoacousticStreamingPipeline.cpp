@@ -0,0 +1,338 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPhotoacousticStreamingPipeline.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkExceptionMacro.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  enum FramePixelType { FloatPixel, ShortPixel, DoublePixel, UnsupportedPixel };
+
+  FramePixelType GetFramePixelType(const mitk::Image* image)
+  {
+    const std::string type = image->GetPixelType().GetTypeAsString();
+    if (type == "scalar (float)" || type == " (float)")
+      return FloatPixel;
+    if (type == "scalar (short)" || type == " (short)")
+      return ShortPixel;
+    if (type == "scalar (double)" || type == " (double)")
+      return DoublePixel;
+    return UnsupportedPixel;
+  }
+
+  // copies the samples [firstSample, firstSample + samples) of every line and interpolates linearly between the lines
+  template <typename TPixel>
+  void CopyFrame(const TPixel* input, unsigned int inputL, unsigned int firstSample, unsigned int samples, unsigned int outputL, float* output)
+  {
+    input += firstSample * inputL;
+
+    if (inputL == outputL)
+    {
+      std::transform(input, input + samples * inputL, output, [](TPixel value) { return (float)value; });
+      return;
+    }
+
+    std::vector<unsigned int> leftLine(outputL);
+    std::vector<float> weight(outputL);
+    for (unsigned int l = 0; l < outputL; ++l)
+    {
+      // the centers of the first and last lines of input and output coincide
+      const float position = std::min(std::max(((float)l + 0.5f) * inputL / outputL - 0.5f, 0.0f), (float)(inputL - 1));
+      leftLine[l] = std::min((unsigned int)position, inputL - 2);
+      weight[l] = position - leftLine[l];
+    }
+
+    for (unsigned int s = 0; s < samples; ++s)
+    {
+      const TPixel* inputRow = input + s * inputL;
+      float* outputRow = output + s * outputL;
+      for (unsigned int l = 0; l < outputL; ++l)
+      {
+        outputRow[l] = (1 - weight[l]) * (float)inputRow[leftLine[l]] + weight[l] * (float)inputRow[leftLine[l] + 1];
+      }
+    }
+  }
+}
+
+void mitk::PhotoacousticStreamingPipeline::FrameQueue::Push(Frame* frame)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Frames.push_back(frame);
+  }
+  m_FrameAvailable.notify_one();
+}
+
+mitk::PhotoacousticStreamingPipeline::Frame* mitk::PhotoacousticStreamingPipeline::FrameQueue::Pop()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_FrameAvailable.wait(lock, [this] { return m_Closed || !m_Frames.empty(); });
+
+  // a closed queue hands out the remaining frames first
+  if (m_Frames.empty())
+    return nullptr;
+
+  Frame* frame = m_Frames.front();
+  m_Frames.pop_front();
+  return frame;
+}
+
+void mitk::PhotoacousticStreamingPipeline::FrameQueue::Close()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Closed = true;
+  }
+  m_FrameAvailable.notify_all();
+}
+
+void mitk::PhotoacousticStreamingPipeline::FrameQueue::Reset()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Frames.clear();
+  m_Closed = false;
+}
+
+mitk::PhotoacousticStreamingPipeline::PhotoacousticStreamingPipeline()
+  : m_FrameHandler([](unsigned int, const float*, const unsigned int[2]) {}),
+    m_Beamformer(BeamformingFilter::New()),
+    m_NumberOfPushedFrames(0),
+    m_NumberOfProcessedFrames(0)
+{
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    m_InputDim[i] = 0;
+    m_BeamformingInputDim[i] = 0;
+    m_OutputDim[i] = 0;
+  }
+}
+
+mitk::PhotoacousticStreamingPipeline::~PhotoacousticStreamingPipeline()
+{
+  this->Stop();
+}
+
+void mitk::PhotoacousticStreamingPipeline::Configure(streamingSettings settings)
+{
+  if (this->IsRunning())
+    mitkThrow() << "The streaming pipeline can not be configured while it is running.";
+
+  m_Settings = settings;
+  this->Modified();
+}
+
+void mitk::PhotoacousticStreamingPipeline::SetFrameHandler(FrameHandler handler)
+{
+  if (this->IsRunning())
+    mitkThrow() << "The frame handler can not be changed while the streaming pipeline is running.";
+
+  m_FrameHandler = handler;
+}
+
+bool mitk::PhotoacousticStreamingPipeline::IsRunning() const
+{
+  return m_BeamformingThread.joinable();
+}
+
+void mitk::PhotoacousticStreamingPipeline::GetOutputDimensions(unsigned int outputDim[2]) const
+{
+  outputDim[0] = m_OutputDim[0];
+  outputDim[1] = m_OutputDim[1];
+}
+
+unsigned long mitk::PhotoacousticStreamingPipeline::GetNumberOfProcessedFrames() const
+{
+  return m_NumberOfProcessedFrames;
+}
+
+void mitk::PhotoacousticStreamingPipeline::Start(const unsigned int inputDim[2])
+{
+  if (this->IsRunning())
+    mitkThrow() << "The streaming pipeline is already running.";
+
+  // frames are cropped at the bottom to 4096 samples like in PhotoacousticImage::ApplyBeamforming()
+  unsigned int lowerCutoff = 0;
+  if (4096 + m_Settings.Cutoff < inputDim[1])
+    lowerCutoff = inputDim[1] - 4096;
+  if (m_Settings.Cutoff >= inputDim[1] || inputDim[0] < 2)
+    mitkThrow() << "Frames of " << inputDim[0] << " x " << inputDim[1] << " samples can not be processed with a cutoff of " << m_Settings.Cutoff << ".";
+
+  m_InputDim[0] = inputDim[0];
+  m_InputDim[1] = inputDim[1];
+  m_BeamformingInputDim[0] = m_Settings.Beamforming.ReconstructionLines;
+  m_BeamformingInputDim[1] = inputDim[1] - m_Settings.Cutoff - lowerCutoff;
+  m_OutputDim[0] = m_Settings.Beamforming.ReconstructionLines;
+  m_OutputDim[1] = m_Settings.Beamforming.SamplesPerLine;
+
+  m_BeamformingSettings = m_Settings.Beamforming;
+  m_BeamformingSettings.RecordTime = m_BeamformingSettings.RecordTime - (double)(m_Settings.Cutoff + lowerCutoff) / inputDim[1] * m_BeamformingSettings.RecordTime; // adjust the recorded time lost by cropping
+  m_Beamformer->Configure(m_BeamformingSettings);
+
+  // all buffers are allocated here, the stages only pass them on
+  m_Frames.resize(std::max(1u, m_Settings.NumberOfBuffers));
+  m_FreeFrames.Reset();
+  m_InputFrames.Reset();
+  m_BeamformedFrames.Reset();
+  for (Frame& frame : m_Frames)
+  {
+    frame.Input.resize(m_BeamformingInputDim[0] * m_BeamformingInputDim[1]);
+    frame.Output.resize(m_OutputDim[0] * m_OutputDim[1]);
+    m_FreeFrames.Push(&frame);
+  }
+
+  m_NumberOfPushedFrames = 0;
+  m_NumberOfProcessedFrames = 0;
+
+  m_BeamformingThread = std::thread(&PhotoacousticStreamingPipeline::BeamformingLoop, this);
+  m_EnvelopeThread = std::thread(&PhotoacousticStreamingPipeline::EnvelopeLoop, this);
+}
+
+void mitk::PhotoacousticStreamingPipeline::PushFrame(const mitk::Image* image, unsigned int slice)
+{
+  if (!this->IsRunning())
+    mitkThrow() << "The streaming pipeline has to be started before frames are pushed.";
+  if (image == nullptr || image->GetDimension(0) != m_InputDim[0] || image->GetDimension(1) != m_InputDim[1])
+    mitkThrow() << "The frame does not have the size the streaming pipeline was started with.";
+  if (slice >= image->GetDimension(2))
+    mitkThrow() << "The image has no slice " << slice << ".";
+  if (GetFramePixelType(image) == UnsupportedPixel)
+    mitkThrow() << "Pixel type " << image->GetPixelType().GetTypeAsString() << " is not supported.";
+
+  // waits until the envelope stage releases a buffer
+  Frame* frame = m_FreeFrames.Pop();
+  this->PrepareFrame(image, slice, frame);
+  frame->Index = m_NumberOfPushedFrames++;
+  m_InputFrames.Push(frame);
+}
+
+void mitk::PhotoacousticStreamingPipeline::Stop()
+{
+  if (!this->IsRunning())
+    return;
+
+  // the stages finish the frames in their queues and close the queue of the next stage
+  m_InputFrames.Close();
+  m_BeamformingThread.join();
+  m_EnvelopeThread.join();
+
+  m_FreeFrames.Reset();
+  m_Frames.clear();
+}
+
+void mitk::PhotoacousticStreamingPipeline::PrepareFrame(const mitk::Image* image, unsigned int slice, Frame* frame) const
+{
+  mitk::ImageReadAccessor readAccess(image, image->GetSliceData(slice));
+
+  switch (GetFramePixelType(image))
+  {
+  case FloatPixel:
+    CopyFrame(static_cast<const float*>(readAccess.GetData()), m_InputDim[0], m_Settings.Cutoff, m_BeamformingInputDim[1], m_BeamformingInputDim[0], frame->Input.data());
+    break;
+  case ShortPixel:
+    CopyFrame(static_cast<const short*>(readAccess.GetData()), m_InputDim[0], m_Settings.Cutoff, m_BeamformingInputDim[1], m_BeamformingInputDim[0], frame->Input.data());
+    break;
+  case DoublePixel:
+    CopyFrame(static_cast<const double*>(readAccess.GetData()), m_InputDim[0], m_Settings.Cutoff, m_BeamformingInputDim[1], m_BeamformingInputDim[0], frame->Input.data());
+    break;
+  default:
+    break;
+  }
+}
+
+void mitk::PhotoacousticStreamingPipeline::BeamformingLoop()
+{
+  while (Frame* frame = m_InputFrames.Pop())
+  {
+    m_Beamformer->BeamformFrame(frame->Input.data(), m_BeamformingInputDim, frame->Output.data());
+    m_BeamformedFrames.Push(frame);
+  }
+  m_BeamformedFrames.Close();
+}
+
+void mitk::PhotoacousticStreamingPipeline::EnvelopeLoop()
+{
+  while (Frame* frame = m_BeamformedFrames.Pop())
+  {
+    // envelope detection and log compression as done by the BModeAbs and BModeAbsLog kernels
+    if (m_Settings.UseBModeFilter)
+    {
+      if (m_Settings.UseLogFilter)
+        std::transform(frame->Output.begin(), frame->Output.end(), frame->Output.begin(), [](float value) { return std::log(std::abs(value)); });
+      else
+        std::transform(frame->Output.begin(), frame->Output.end(), frame->Output.begin(), [](float value) { return std::abs(value); });
+    }
+
+    m_FrameHandler(frame->Index, frame->Output.data(), m_OutputDim);
+    ++m_NumberOfProcessedFrames;
+    m_FreeFrames.Push(frame);
+  }
+}
+
+mitk::Image::Pointer mitk::PhotoacousticStreamingPipeline::Process(mitk::Image::Pointer sequence)
+{
+  const unsigned int inputDim[2] = { sequence->GetDimension(0), sequence->GetDimension(1) };
+  const unsigned int slices = sequence->GetDimension(2);
+
+  if (GetFramePixelType(sequence) == UnsupportedPixel)
+    mitkThrow() << "Pixel type " << sequence->GetPixelType().GetTypeAsString() << " is not supported.";
+
+  this->Start(inputDim);
+
+  mitk::Image::Pointer output = mitk::Image::New();
+  unsigned int dim[] = { m_OutputDim[0], m_OutputDim[1], slices };
+  output->Initialize(mitk::MakeScalarPixelType<float>(), 3, dim);
+
+  // same geometry as the output of the BeamformingFilter
+  mitk::Vector3D spacing;
+  spacing[0] = m_BeamformingSettings.Pitch * m_BeamformingSettings.TransducerElements * 1000 / m_BeamformingSettings.ReconstructionLines;
+  spacing[1] = m_BeamformingSettings.RecordTime / 2 * m_BeamformingSettings.SpeedOfSound * 1000 / m_BeamformingSettings.SamplesPerLine;
+  spacing[2] = 1;
+  output->GetGeometry()->SetSpacing(spacing);
+  output->SetPropertyList(sequence->GetPropertyList()->Clone());
+
+  // the handler can only be exchanged while the pipeline is stopped
+  // the guard stops the pipeline and restores the handler also if a frame can not be pushed,
+  // the handler of the sequence must not outlive the local output image
+  struct FrameHandlerGuard
+  {
+    PhotoacousticStreamingPipeline* Pipeline;
+    FrameHandler Handler;
+    ~FrameHandlerGuard()
+    {
+      Pipeline->Stop();
+      Pipeline->m_FrameHandler = Handler;
+    }
+  } guard{ this, m_FrameHandler };
+
+  m_FrameHandler = [&output](unsigned int frameIndex, const float* data, const unsigned int[2])
+  {
+    output->SetSlice(data, frameIndex);
+  };
+
+  for (unsigned int slice = 0; slice < slices; ++slice)
+  {
+    this->PushFrame(sequence, slice);
+  }
+
+  // all frames are written to the output before it is returned
+  this->Stop();
+
+  return output;
+}
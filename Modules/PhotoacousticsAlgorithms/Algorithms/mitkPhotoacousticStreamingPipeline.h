@@ -0,0 +1,157 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITK_PHOTOACOUSTICS_STREAMING_PIPELINE
+#define MITK_PHOTOACOUSTICS_STREAMING_PIPELINE
+
+#include "itkObject.h"
+#include "mitkCommon.h"
+#include "mitkImage.h"
+#include "mitkPhotoacousticBeamformingFilter.h"
+
+#include "MitkPhotoacousticsAlgorithmsExports.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mitk {
+
+  //##Documentation
+  //## @brief Reconstructs a sequence of photoacoustic frames in concurrent stages with a fixed set of buffers
+  //##
+  //## The frames run through three stages:
+  //## - PushFrame() crops each frame, converts it to float and resamples it to the reconstruction lines
+  //## - a beamforming thread reconstructs it with the CPU kernels of the BeamformingFilter
+  //## - an envelope thread takes the absolute value, optionally applies log compression and hands the frame to the FrameHandler
+  //##
+  //## While one frame is beamformed, the next one is already prepared and the previous one is post processed.
+  //## A frame is only taken into the pipeline if one of the NumberOfBuffers buffers is free, otherwise PushFrame()
+  //## waits. Memory therefore does not grow with the length of the sequence and a slow consumer slows down the
+  //## producer instead of queueing frames.
+  //## @ingroup Process
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT PhotoacousticStreamingPipeline : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(PhotoacousticStreamingPipeline, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    //##Description
+    //## @brief Is called on the envelope thread for every processed frame, the data is only valid during the call
+    typedef std::function<void(unsigned int frameIndex, const float* data, const unsigned int dimensions[2])> FrameHandler;
+
+    struct streamingSettings
+    {
+      BeamformingFilter::beamformingSettings Beamforming;
+      unsigned int Cutoff = 0; // samples removed at the top of every frame
+      bool UseBModeFilter = true;
+      bool UseLogFilter = false;
+      unsigned int NumberOfBuffers = 4; // frames in the pipeline at the same time
+    };
+
+    void Configure(streamingSettings settings);
+
+    void SetFrameHandler(FrameHandler handler);
+
+    //##Description
+    //## @brief Starts the stage threads for frames of the given size (lines, samples)
+    //## @throw mitk::Exception if the pipeline is already running
+    void Start(const unsigned int inputDim[2]);
+
+    //##Description
+    //## @brief Feeds one slice of an image into the pipeline, waits while all buffers are in use
+    //## @throw mitk::Exception if the pipeline is not running, the frame size differs or the pixel type is not supported
+    void PushFrame(const mitk::Image* image, unsigned int slice = 0);
+
+    //##Description
+    //## @brief Waits until all pushed frames are handed to the FrameHandler and stops the stage threads
+    void Stop();
+
+    bool IsRunning() const;
+
+    //##Description
+    //## @brief Size (lines, samples) of the frames handed to the FrameHandler
+    void GetOutputDimensions(unsigned int outputDim[2]) const;
+
+    //##Description
+    //## @brief Processes all slices of a sequence and collects the frames in a new image
+    //##
+    //## Only the input and the result hold the whole sequence, the intermediate results of a frame are
+    //## kept in the buffers of the pipeline.
+    mitk::Image::Pointer Process(mitk::Image::Pointer sequence);
+
+    unsigned long GetNumberOfProcessedFrames() const;
+
+  protected:
+    PhotoacousticStreamingPipeline();
+    virtual ~PhotoacousticStreamingPipeline();
+
+    struct Frame
+    {
+      unsigned int Index;
+      std::vector<float> Input;
+      std::vector<float> Output;
+    };
+
+    //##Description
+    //## @brief Hands frames from one stage to the next, Pop() waits for a frame until the queue is closed
+    class FrameQueue
+    {
+    public:
+      void Push(Frame* frame);
+      Frame* Pop();
+      void Close();
+      void Reset();
+
+    private:
+      std::mutex m_Mutex;
+      std::condition_variable m_FrameAvailable;
+      std::deque<Frame*> m_Frames;
+      bool m_Closed = false;
+    };
+
+    void PrepareFrame(const mitk::Image* image, unsigned int slice, Frame* frame) const;
+    void BeamformingLoop();
+    void EnvelopeLoop();
+
+    streamingSettings m_Settings;
+    FrameHandler m_FrameHandler;
+
+    BeamformingFilter::Pointer m_Beamformer;
+    BeamformingFilter::beamformingSettings m_BeamformingSettings;
+
+    unsigned int m_InputDim[2];
+    unsigned int m_BeamformingInputDim[2];
+    unsigned int m_OutputDim[2];
+
+    std::vector<Frame> m_Frames;
+    FrameQueue m_FreeFrames;
+    FrameQueue m_InputFrames;
+    FrameQueue m_BeamformedFrames;
+
+    std::thread m_BeamformingThread;
+    std::thread m_EnvelopeThread;
+
+    unsigned int m_NumberOfPushedFrames;
+    std::atomic<unsigned long> m_NumberOfProcessedFrames;
+  };
+} // namespace mitk
+
+#endif //MITK_PHOTOACOUSTICS_STREAMING_PIPELINE
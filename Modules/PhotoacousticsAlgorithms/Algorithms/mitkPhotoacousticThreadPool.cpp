@@ -0,0 +1,116 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPhotoacousticThreadPool.h"
+
+#include <algorithm>
+
+mitk::PhotoacousticThreadPool* mitk::PhotoacousticThreadPool::GetInstance()
+{
+  // the pool lives until the process exits, joining threads while a library is unloaded can dead lock
+  static PhotoacousticThreadPool* instance = new PhotoacousticThreadPool(std::max(1u, std::thread::hardware_concurrency()));
+  return instance;
+}
+
+mitk::PhotoacousticThreadPool::PhotoacousticThreadPool(unsigned int numberOfThreads)
+  : m_Generation(0),
+    m_NumberOfBusyWorkers(0),
+    m_Stop(false),
+    m_Task(nullptr),
+    m_NumberOfTasks(0),
+    m_NextTask(0)
+{
+  // the calling thread is the first one
+  for (unsigned int i = 1; i < numberOfThreads; ++i)
+  {
+    m_Workers.push_back(std::thread(&PhotoacousticThreadPool::WorkerLoop, this));
+  }
+}
+
+mitk::PhotoacousticThreadPool::~PhotoacousticThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_JobStarted.notify_all();
+  for (std::thread& worker : m_Workers)
+  {
+    worker.join();
+  }
+}
+
+unsigned int mitk::PhotoacousticThreadPool::GetNumberOfThreads() const
+{
+  return static_cast<unsigned int>(m_Workers.size()) + 1;
+}
+
+void mitk::PhotoacousticThreadPool::ParallelFor(unsigned int numberOfTasks, const std::function<void(unsigned int)>& task)
+{
+  if (numberOfTasks == 0)
+    return;
+
+  std::lock_guard<std::mutex> jobLock(m_JobMutex);
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Task = &task;
+    m_NumberOfTasks = numberOfTasks;
+    m_NextTask = 0;
+    m_NumberOfBusyWorkers = static_cast<unsigned int>(m_Workers.size());
+    ++m_Generation;
+  }
+  m_JobStarted.notify_all();
+
+  this->RunTasks();
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_JobFinished.wait(lock, [this] { return m_NumberOfBusyWorkers == 0; });
+  m_Task = nullptr;
+}
+
+void mitk::PhotoacousticThreadPool::WorkerLoop()
+{
+  unsigned long generation = 0;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_JobStarted.wait(lock, [this, generation] { return m_Stop || m_Generation != generation; });
+      if (m_Stop)
+        return;
+      generation = m_Generation;
+    }
+
+    this->RunTasks();
+
+    bool lastWorker = false;
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      lastWorker = --m_NumberOfBusyWorkers == 0;
+    }
+    if (lastWorker)
+      m_JobFinished.notify_one();
+  }
+}
+
+void mitk::PhotoacousticThreadPool::RunTasks()
+{
+  for (unsigned int i = m_NextTask++; i < m_NumberOfTasks; i = m_NextTask++)
+  {
+    (*m_Task)(i);
+  }
+}
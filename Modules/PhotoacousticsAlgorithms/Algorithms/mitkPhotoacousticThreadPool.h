@@ -0,0 +1,84 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITK_PHOTOACOUSTICS_THREAD_POOL
+#define MITK_PHOTOACOUSTICS_THREAD_POOL
+
+#include "MitkPhotoacousticsAlgorithmsExports.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mitk {
+
+  //##Documentation
+  //## @brief Persistent pool of worker threads for the CPU reconstruction of photoacoustic images
+  //##
+  //## The workers are started once and wait for the next job, so reconstructing an image does not create
+  //## threads. The tasks of a job are handed out one by one through a shared counter: a worker that finishes
+  //## its task early takes the next one, which keeps all cores busy even if the tasks take different times.
+  //## The thread calling ParallelFor() works on the tasks as well.
+  //## @ingroup Process
+  class MITKPHOTOACOUSTICSALGORITHMS_EXPORT PhotoacousticThreadPool
+  {
+  public:
+    //##Description
+    //## @brief Returns the pool shared by all filters, it uses one thread per core
+    static PhotoacousticThreadPool* GetInstance();
+
+    explicit PhotoacousticThreadPool(unsigned int numberOfThreads);
+    ~PhotoacousticThreadPool();
+
+    //##Description
+    //## @brief Number of threads working on a job, including the calling thread
+    unsigned int GetNumberOfThreads() const;
+
+    //##Description
+    //## @brief Calls task(i) for every i in [0, numberOfTasks) and returns when all tasks are done
+    //##
+    //## Jobs of different callers are executed one after the other. A task must not call ParallelFor() itself.
+    void ParallelFor(unsigned int numberOfTasks, const std::function<void(unsigned int)>& task);
+
+  private:
+    PhotoacousticThreadPool(const PhotoacousticThreadPool&);
+    PhotoacousticThreadPool& operator=(const PhotoacousticThreadPool&);
+
+    void WorkerLoop();
+    void RunTasks();
+
+    std::vector<std::thread> m_Workers;
+
+    /** serializes the jobs of different callers */
+    std::mutex m_JobMutex;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_JobStarted;
+    std::condition_variable m_JobFinished;
+    unsigned long m_Generation;
+    unsigned int m_NumberOfBusyWorkers;
+    bool m_Stop;
+
+    const std::function<void(unsigned int)>* m_Task;
+    unsigned int m_NumberOfTasks;
+    std::atomic<unsigned int> m_NextTask;
+  };
+} // namespace mitk
+
+#endif //MITK_PHOTOACOUSTICS_THREAD_POOL
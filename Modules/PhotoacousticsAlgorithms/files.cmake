@@ -2,6 +2,8 @@ set(CPP_FILES
   mitkPhotoacousticImage.cpp
   
   Algorithms/mitkPhotoacousticBeamformingFilter.cpp
+  Algorithms/mitkPhotoacousticThreadPool.cpp
+  Algorithms/mitkPhotoacousticStreamingPipeline.cpp
   
   Algorithms/OCL/mitkPhotoacousticOCLBeamformer.cpp
   
@@ -0,0 +1,4 @@
+set(MODULE_TESTS
+  mitkPhotoacousticBeamformingFilterTest.cpp
+  mitkPhotoacousticStreamingPipelineTest.cpp
+)
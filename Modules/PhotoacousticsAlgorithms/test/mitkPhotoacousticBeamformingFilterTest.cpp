@@ -0,0 +1,301 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#define _USE_MATH_DEFINES
+
+//TEST
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+//STD
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+//MITK
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include "mitkPhotoacousticBeamformingFilter.h"
+
+/**
+* Compares the CPU beamforming of the BeamformingFilter with a reference that
+* starts one thread per line and sums the products of DMAS pair by pair, as the
+* filter did before it used the PhotoacousticThreadPool, and reports the time
+* both need for the same image.
+*/
+class mitkPhotoacousticBeamformingFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPhotoacousticBeamformingFilterTestSuite);
+  MITK_TEST(DAS_ThreadPool_EqualsPerLineThreads);
+  MITK_TEST(DMAS_ThreadPool_EqualsPerLineThreads);
+  MITK_TEST(sDMAS_HasSignOfDAS);
+  MITK_TEST(Update_ChangedConfiguration_RecomputesTables);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::BeamformingFilter::beamformingSettings Settings;
+
+  static const unsigned int Lines = 128;
+  static const unsigned int Samples = 1024;
+  static const unsigned int Slices = 4;
+
+  mitk::Image::Pointer m_Image;
+  Settings m_Settings;
+
+  static float Reference(const Settings& conf, const float* input, unsigned int line, unsigned int sample, bool dmas)
+  {
+    const float inputL = Lines;
+    const float inputS = Samples;
+    const int apodArraySize = conf.TransducerElements * 4;
+
+    const float l_i = (float)line / Lines * inputL;
+    const float s_i = (float)sample / Samples * inputS / 2;
+
+    const float tan_phi = std::tan(conf.Angle / 360 * 2 * M_PI);
+    float part = tan_phi * conf.TimeSpacing * conf.SpeedOfSound / conf.Pitch * conf.ReconstructionLines / conf.TransducerElements * s_i;
+    if (part < 1)
+      part = 1;
+
+    const short maxLine = (short)std::min((l_i + part) + 1, inputL);
+    const short minLine = (short)std::max((l_i - part), 0.0f);
+    const float apod_mult = apodArraySize / (maxLine - minLine);
+    const float delayMultiplicator = pow((1 / (conf.TimeSpacing*conf.SpeedOfSound) * (conf.Pitch*conf.TransducerElements) / inputL), 2) / s_i / 2;
+
+    std::vector<short> delays(maxLine - minLine);
+    std::vector<float> signal(maxLine - minLine);
+    for (short l_s = minLine; l_s < maxLine; ++l_s)
+    {
+      const float apodisation = (1 - cos(2 * M_PI * (short)((l_s - minLine)*apod_mult) / (apodArraySize - 1))) / 2;
+      delays[l_s - minLine] = delayMultiplicator * pow((l_s - l_i), 2) + s_i + (1 - conf.Photoacoustic)*s_i;
+      if (delays[l_s - minLine] < inputS && delays[l_s - minLine] >= 0)
+        signal[l_s - minLine] = input[l_s + delays[l_s - minLine] * Lines] * apodisation;
+    }
+
+    short usedLines = maxLine - minLine;
+    float result = 0;
+    if (!dmas)
+    {
+      for (short l_s = 0; l_s < maxLine - minLine; ++l_s)
+      {
+        if (delays[l_s] < inputS && delays[l_s] >= 0)
+          result += signal[l_s];
+        else
+          --usedLines;
+      }
+      return result / usedLines;
+    }
+
+    for (short l_s1 = 0; l_s1 < maxLine - minLine - 1; ++l_s1)
+    {
+      if (delays[l_s1] < inputS && delays[l_s1] >= 0)
+      {
+        for (short l_s2 = l_s1 + 1; l_s2 < maxLine - minLine; ++l_s2)
+        {
+          if (delays[l_s2] < inputS && delays[l_s2] >= 0)
+          {
+            const float mult = signal[l_s1] * signal[l_s2];
+            result += sqrt(std::abs(mult)) * ((mult > 0) - (mult < 0));
+          }
+        }
+      }
+      else
+        --usedLines;
+    }
+    return 10 * result / (pow(usedLines, 2) - (usedLines - 1));
+  }
+
+  // one thread per line and slice after slice, like the filter before the thread pool
+  std::vector<float> BeamformPerLineThreads(bool dmas, double& milliseconds)
+  {
+    mitk::ImageReadAccessor readAccess(m_Image);
+    const float* input = static_cast<const float*>(readAccess.GetData());
+    std::vector<float> output(Lines * Samples * Slices);
+    const Settings conf = m_Settings;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int slice = 0; slice < Slices; ++slice)
+    {
+      std::vector<std::thread> threads;
+      for (unsigned int line = 0; line < Lines; ++line)
+      {
+        threads.push_back(std::thread([&, slice, line]()
+        {
+          for (unsigned int sample = 1; sample < Samples; ++sample)
+            output[(slice * Samples + sample) * Lines + line] = Reference(conf, input + slice * Lines * Samples, line, sample, dmas);
+        }));
+      }
+      for (std::thread& thread : threads)
+        thread.join();
+    }
+    milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return output;
+  }
+
+  mitk::Image::Pointer Beamform(const Settings& settings, double& milliseconds)
+  {
+    mitk::BeamformingFilter::Pointer filter = mitk::BeamformingFilter::New();
+    filter->SetInput(m_Image);
+    filter->Configure(settings);
+
+    const auto start = std::chrono::steady_clock::now();
+    filter->Update();
+    milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    mitk::Image::Pointer output = filter->GetOutput();
+    output->DisconnectPipeline();
+    return output;
+  }
+
+  void CompareWithReference(Settings::BeamformingAlgorithm algorithm)
+  {
+    m_Settings.Algorithm = algorithm;
+    const bool dmas = algorithm == Settings::BeamformingAlgorithm::DMAS;
+
+    double referenceTime = 0;
+    const std::vector<float> expected = this->BeamformPerLineThreads(dmas, referenceTime);
+    double filterTime = 0;
+    mitk::Image::Pointer output = this->Beamform(m_Settings, filterTime);
+
+    const unsigned int dimensions[3] = { Lines, Samples, Slices };
+    for (unsigned int i = 0; i < 3; ++i)
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Output dimension", dimensions[i], output->GetDimension(i));
+
+    mitk::ImageReadAccessor readAccess(output);
+    const float* actual = static_cast<const float*>(readAccess.GetData());
+
+    float maximum = 0;
+    for (float value : expected)
+      maximum = std::max(maximum, std::abs(value));
+
+    // the first sample of each line has no defined delay in the reference
+    for (unsigned int slice = 0; slice < Slices; ++slice)
+    {
+      for (unsigned int i = Lines; i < Lines * Samples; ++i)
+      {
+        const unsigned int index = slice * Lines * Samples + i;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Beamformed value", expected[index], actual[index], 1e-4 * maximum);
+      }
+    }
+
+    MITK_INFO << (dmas ? "DMAS" : "DAS") << " of " << Slices << " slices with " << Lines << " lines: "
+              << referenceTime << " ms with one thread per line, " << filterTime << " ms with the thread pool";
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Settings = Settings();
+    m_Settings.UseGPU = false;
+    m_Settings.SamplesPerLine = Samples;
+    m_Settings.ReconstructionLines = Lines;
+    m_Settings.TransducerElements = Lines;
+    m_Settings.TimeSpacing = 1.0f / 40000000; // 40 MHz
+    m_Settings.RecordTime = Samples * m_Settings.TimeSpacing;
+    m_Settings.Angle = 27;
+    m_Settings.DelayCalculationMethod = Settings::DelayCalc::QuadApprox;
+    m_Settings.Apod = Settings::Apodization::Hann;
+
+    // a wavefront of a point source below the center of the transducer and some deterministic noise
+    unsigned int dimensions[3] = { Lines, Samples, Slices };
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+    {
+      mitk::ImageWriteAccessor writeAccess(m_Image);
+      float* data = static_cast<float*>(writeAccess.GetData());
+      unsigned int seed = 42;
+      for (unsigned int slice = 0; slice < Slices; ++slice)
+      {
+        for (unsigned int sample = 0; sample < Samples; ++sample)
+        {
+          for (unsigned int line = 0; line < Lines; ++line)
+          {
+            const float distance = std::sqrt(std::pow(line - Lines / 2.0f, 2.0f) + std::pow(Samples / 3.0f + slice, 2.0f));
+            seed = seed * 1103515245 + 12345;
+            const float noise = ((seed >> 16) % 1000) / 5000.0f - 0.1f;
+            data[(slice * Samples + sample) * Lines + line] = std::cos(0.5f * (sample - distance)) * std::exp(-std::abs(sample - distance) / 8) + noise;
+          }
+        }
+      }
+    }
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+  }
+
+  void DAS_ThreadPool_EqualsPerLineThreads()
+  {
+    this->CompareWithReference(Settings::BeamformingAlgorithm::DAS);
+  }
+
+  void DMAS_ThreadPool_EqualsPerLineThreads()
+  {
+    this->CompareWithReference(Settings::BeamformingAlgorithm::DMAS);
+  }
+
+  void sDMAS_HasSignOfDAS()
+  {
+    double milliseconds = 0;
+    m_Settings.Algorithm = Settings::BeamformingAlgorithm::DAS;
+    mitk::Image::Pointer das = this->Beamform(m_Settings, milliseconds);
+    m_Settings.Algorithm = Settings::BeamformingAlgorithm::DMAS;
+    mitk::Image::Pointer dmas = this->Beamform(m_Settings, milliseconds);
+    m_Settings.Algorithm = Settings::BeamformingAlgorithm::sDMAS;
+    mitk::Image::Pointer sdmas = this->Beamform(m_Settings, milliseconds);
+
+    mitk::ImageReadAccessor dasAccess(das), dmasAccess(dmas), sdmasAccess(sdmas);
+    const float* dasData = static_cast<const float*>(dasAccess.GetData());
+    const float* dmasData = static_cast<const float*>(dmasAccess.GetData());
+    const float* sdmasData = static_cast<const float*>(sdmasAccess.GetData());
+
+    for (unsigned int i = 0; i < Lines * Samples * Slices; ++i)
+    {
+      const float sign = (float)((dasData[i] > 0) - (dasData[i] < 0));
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("sDMAS is DMAS with the sign of DAS", sign * dmasData[i], sdmasData[i], 1e-5 * (1 + std::abs(dmasData[i])));
+    }
+  }
+
+  void Update_ChangedConfiguration_RecomputesTables()
+  {
+    mitk::BeamformingFilter::Pointer filter = mitk::BeamformingFilter::New();
+    filter->SetInput(m_Image);
+    filter->Configure(m_Settings);
+    filter->Update();
+
+    // a new configuration must not reuse the delays of the previous one
+    m_Settings.Apod = Settings::Apodization::Box;
+    m_Settings.SpeedOfSound = 1480;
+    filter->Configure(m_Settings);
+    filter->Update();
+    mitk::ImageReadAccessor reusedAccess(filter->GetOutput());
+
+    double milliseconds = 0;
+    mitk::Image::Pointer expected = this->Beamform(m_Settings, milliseconds);
+    mitk::ImageReadAccessor expectedAccess(expected);
+
+    const float* reusedData = static_cast<const float*>(reusedAccess.GetData());
+    const float* expectedData = static_cast<const float*>(expectedAccess.GetData());
+    CPPUNIT_ASSERT_MESSAGE("Output of a reconfigured filter equals the output of a new filter",
+      std::equal(reusedData, reusedData + Lines * Samples * Slices, expectedData));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPhotoacousticBeamformingFilter)
@@ -0,0 +1,162 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+//TEST
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+//STD
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+//MITK
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include "mitkPhotoacousticBeamformingFilter.h"
+#include "mitkPhotoacousticStreamingPipeline.h"
+
+/**
+* Streams a sequence through the PhotoacousticStreamingPipeline and compares the
+* frames with the result of the BeamformingFilter applied to the whole sequence.
+*/
+class mitkPhotoacousticStreamingPipelineTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPhotoacousticStreamingPipelineTestSuite);
+  MITK_TEST(Process_Sequence_EqualsBatchBeamforming);
+  MITK_TEST(PushFrame_MoreFramesThanBuffers_HandsOutFramesInOrder);
+  MITK_TEST(PushFrame_NotStarted_ThrowsException);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static const unsigned int Lines = 64;
+  static const unsigned int Samples = 512;
+  static const unsigned int Frames = 24;
+
+  mitk::Image::Pointer m_Sequence;
+  mitk::PhotoacousticStreamingPipeline::streamingSettings m_Settings;
+
+public:
+
+  void setUp() override
+  {
+    m_Settings = mitk::PhotoacousticStreamingPipeline::streamingSettings();
+    m_Settings.Beamforming.UseGPU = false;
+    m_Settings.Beamforming.SamplesPerLine = Samples;
+    m_Settings.Beamforming.ReconstructionLines = Lines;
+    m_Settings.Beamforming.TransducerElements = Lines;
+    m_Settings.Beamforming.TimeSpacing = 1.0f / 40000000; // 40 MHz
+    m_Settings.Beamforming.RecordTime = Samples * m_Settings.Beamforming.TimeSpacing;
+    m_Settings.Beamforming.Angle = 27;
+    m_Settings.NumberOfBuffers = 3;
+
+    // a point source moving along the lines
+    unsigned int dimensions[3] = { Lines, Samples, Frames };
+    m_Sequence = mitk::Image::New();
+    m_Sequence->Initialize(mitk::MakeScalarPixelType<float>(), 3, dimensions);
+    mitk::ImageWriteAccessor writeAccess(m_Sequence);
+    float* data = static_cast<float*>(writeAccess.GetData());
+    for (unsigned int frame = 0; frame < Frames; ++frame)
+    {
+      for (unsigned int sample = 0; sample < Samples; ++sample)
+      {
+        for (unsigned int line = 0; line < Lines; ++line)
+        {
+          const float distance = std::sqrt(std::pow((float)line - frame * Lines / (float)Frames, 2.0f) + std::pow(Samples / 4.0f, 2.0f));
+          data[(frame * Samples + sample) * Lines + line] = std::cos(0.5f * (sample - distance)) * std::exp(-std::abs(sample - distance) / 8);
+        }
+      }
+    }
+  }
+
+  void tearDown() override
+  {
+    m_Sequence = nullptr;
+  }
+
+  void Process_Sequence_EqualsBatchBeamforming()
+  {
+    mitk::BeamformingFilter::Pointer filter = mitk::BeamformingFilter::New();
+    filter->SetInput(m_Sequence);
+    filter->Configure(m_Settings.Beamforming);
+    auto start = std::chrono::steady_clock::now();
+    filter->Update();
+    const double batchTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    mitk::PhotoacousticStreamingPipeline::Pointer pipeline = mitk::PhotoacousticStreamingPipeline::New();
+    pipeline->Configure(m_Settings);
+    start = std::chrono::steady_clock::now();
+    mitk::Image::Pointer streamed = pipeline->Process(m_Sequence);
+    const double streamingTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Every frame was processed", (unsigned long)Frames, pipeline->GetNumberOfProcessedFrames());
+    CPPUNIT_ASSERT_MESSAGE("Pipeline is stopped after processing", !pipeline->IsRunning());
+
+    mitk::ImageReadAccessor batchAccess(filter->GetOutput());
+    mitk::ImageReadAccessor streamedAccess(streamed);
+    const float* batchData = static_cast<const float*>(batchAccess.GetData());
+    const float* streamedData = static_cast<const float*>(streamedAccess.GetData());
+
+    for (unsigned int i = 0; i < Lines * Samples * Frames; ++i)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Streamed frame is the envelope of the beamformed frame", std::abs(batchData[i]), streamedData[i], 1e-6);
+    }
+
+    MITK_INFO << Frames << " frames beamformed in " << batchTime << " ms as a volume, beamformed and envelope detected in "
+              << streamingTime << " ms by the streaming pipeline";
+  }
+
+  void PushFrame_MoreFramesThanBuffers_HandsOutFramesInOrder()
+  {
+    mitk::PhotoacousticStreamingPipeline::Pointer pipeline = mitk::PhotoacousticStreamingPipeline::New();
+    m_Settings.NumberOfBuffers = 2;
+    m_Settings.UseLogFilter = true;
+    pipeline->Configure(m_Settings);
+
+    // the handler runs on the envelope thread, the results are checked after Stop()
+    std::vector<unsigned int> frameIndices;
+    std::vector<unsigned int> frameLines;
+    pipeline->SetFrameHandler([&](unsigned int frameIndex, const float*, const unsigned int dimensions[2])
+    {
+      frameIndices.push_back(frameIndex);
+      frameLines.push_back(dimensions[0]);
+    });
+
+    const unsigned int inputDim[2] = { Lines, Samples };
+    pipeline->Start(inputDim);
+    CPPUNIT_ASSERT_THROW_MESSAGE("Settings are fixed while running", pipeline->Configure(m_Settings), mitk::Exception);
+    for (unsigned int frame = 0; frame < Frames; ++frame)
+      pipeline->PushFrame(m_Sequence, frame);
+    pipeline->Stop();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Every frame was handed out", (size_t)Frames, frameIndices.size());
+    for (unsigned int frame = 0; frame < Frames; ++frame)
+    {
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Frames keep their order", frame, frameIndices[frame]);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Frames have the reconstructed size", m_Settings.Beamforming.ReconstructionLines, frameLines[frame]);
+    }
+  }
+
+  void PushFrame_NotStarted_ThrowsException()
+  {
+    mitk::PhotoacousticStreamingPipeline::Pointer pipeline = mitk::PhotoacousticStreamingPipeline::New();
+    pipeline->Configure(m_Settings);
+    CPPUNIT_ASSERT_THROW(pipeline->PushFrame(m_Sequence, 0), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPhotoacousticStreamingPipeline)
@@ -50,6 +50,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkPAProbe.h>
 #include <mitkPALightSource.h>
 #include <mitkPAMonteCarloThreadHandler.h>
+#include <mitkPAPhotonPacketSimulator.h>
 
 #ifdef __linux__
 #include <sys/types.h>
@@ -613,6 +614,7 @@ public:
 /* DECLARE FUNCTIONS */
 
 void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thread, mitk::pa::MonteCarloThreadHandler::Pointer threadHandler);
+void launchPhoton(const InputValues* inputValues, const double* randomNumbers, mitk::pa::PhotonPacketSimulator::Photon& photon);
 
 int detector_x = -1;
 int detector_z = -1;
@@ -621,6 +623,7 @@ bool simulatePVFC = false;
 int requestedNumberOfPhotons = 100000;
 float requestedSimulationTime = 0; // in minutes
 int concurentThreadsSupported = -1;
+long long randomSeed = -1;
 float yOffset = 0; // in mm
 bool saveLegacy = false;
 std::string normalizationFilename;
@@ -678,6 +681,9 @@ int main(int argc, char * argv[]) {
     "Xml definition of the probe", "Specifies the absolute path of the location of the xml definition file of the probe design.");
   parser.addArgument("normalization-file", "nf", mitkCommandLineParser::InputFile,
     "Input normalization file", "The input normalization file is used for normalization of the number of photons in the PVFC calculations.");
+  parser.addArgument(
+    "seed", "s", mitkCommandLineParser::Int,
+    "Random seed", "Specifies the seed of the random numbers (default: -1 = seed from the current time). A simulation of a fixed number of photons with a given seed is reproducible.");
   parser.endGroup();
 
   // parse arguments, this method returns a mapping of long argument names and their values
@@ -742,6 +748,14 @@ int main(int argc, char * argv[]) {
   {
     normalizationFilename = us::any_cast<std::string>(parsedArgs["normalization-file"]);
   }
+  if (parsedArgs.count("seed"))
+  {
+    randomSeed = us::any_cast<int>(parsedArgs["seed"]);
+  }
+  if (randomSeed < 0)
+  {
+    randomSeed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  }
 
   if (concurentThreadsSupported == 0 || concurentThreadsSupported == -1)
   {
@@ -801,14 +815,45 @@ int main(int argc, char * argv[]) {
 
   auto simulationStartTime = std::chrono::system_clock::now();
 
-  for (int i = 0; i < concurentThreadsSupported; i++)
+  // The PVFC simulation records the route of every photon and runs the photons one at a time,
+  // otherwise the photons are propagated in packets by the PhotonPacketSimulator.
+  mitk::pa::PhotonPacketSimulator::Pointer photonPacketSimulator = mitk::pa::PhotonPacketSimulator::New();
+
+  if (simulatePVFC)
   {
-    threads[i] = std::thread(runMonteCarlo, &allInput, &allValues[i], (i + 1), threadHandler);
-  }
+    for (int i = 0; i < concurentThreadsSupported; i++)
+    {
+      threads[i] = std::thread(runMonteCarlo, &allInput, &allValues[i], (i + 1), threadHandler);
+    }
 
-  for (int i = 0; i < concurentThreadsSupported; i++)
+    for (int i = 0; i < concurentThreadsSupported; i++)
+    {
+      threads[i].join();
+    }
+  }
+  else
   {
-    threads[i].join();
+    mitk::pa::PhotonPacketSimulator::Tissue tissue;
+    tissue.Absorption = allInput.muaVector;
+    tissue.Scattering = allInput.musVector;
+    tissue.Anisotropy = allInput.gVector;
+    tissue.Nx = allInput.Nx;
+    tissue.Ny = allInput.Ny;
+    tissue.Nz = allInput.Nz;
+    tissue.Spacing[0] = allInput.xSpacing;
+    tissue.Spacing[1] = allInput.ySpacing;
+    tissue.Spacing[2] = allInput.zSpacing;
+    tissue.BoundaryFlag = allInput.boundaryflag;
+
+    photonPacketSimulator->SetTissue(tissue);
+    photonPacketSimulator->SetLaunchFunction([&allInput](const double* randomNumbers, mitk::pa::PhotonPacketSimulator::Photon& photon)
+    {
+      launchPhoton(&allInput, randomNumbers, photon);
+    });
+    photonPacketSimulator->SetSeed(randomSeed);
+    photonPacketSimulator->SetNumberOfThreads(concurentThreadsSupported);
+    if (verbose) std::cout << "Simulating photon packets with seed " << randomSeed << std::endl;
+    photonPacketSimulator->Simulate(threadHandler);
   }
 
   auto simulationFinishTime = std::chrono::system_clock::now();
@@ -834,17 +879,11 @@ int main(int argc, char * argv[]) {
     if (verbose) std::cout << "[OK]" << std::endl;
 
     if (verbose) std::cout << "Calculating resulting fluence ... ";
-    double tdx = 0, tdy = 0, tdz = 0;
-    long long tNphotons = 0;
-    for (int t = 0; t < concurentThreadsSupported; t++)
-    {
-      tdx = allInput.xSpacing;
-      tdy = allInput.ySpacing;
-      tdz = allInput.zSpacing;
-      tNphotons += allValues[t].Nphotons;
-      for (int voxelNumber = 0; voxelNumber < allInput.totalNumberOfVoxels; voxelNumber++) {
-        finalTotalFluence[voxelNumber] += allValues[t].totalFluence[voxelNumber];
-      }
+    double tdx = allInput.xSpacing, tdy = allInput.ySpacing, tdz = allInput.zSpacing;
+    long long tNphotons = photonPacketSimulator->GetNumberOfSimulatedPhotons();
+    const std::vector<double>& absorbedWeight = photonPacketSimulator->GetAbsorbedWeight();
+    for (int voxelNumber = 0; voxelNumber < allInput.totalNumberOfVoxels; voxelNumber++) {
+      finalTotalFluence[voxelNumber] += absorbedWeight[voxelNumber];
     }
     if (verbose) std::cout << "[OK]" << std::endl;
     std::cout << "total number of photons simulated: "
@@ -1470,3 +1509,80 @@ void runMonteCarlo(InputValues* inputValues, ReturnValues* returnValue, int thre
   if (verbose) std::cout << "------------------------------------------------------" << std::endl;
   if (verbose) std::cout << "Thread " << thread << " is finished." << std::endl;
 }
+
+/* LAUNCH a photon of the PhotonPacketSimulator with the light source of runMonteCarlo */
+void launchPhoton(const InputValues* inputValues, const double* randomNumbers, mitk::pa::PhotonPacketSimulator::Photon& photon)
+{
+  double r, phi, temp;
+
+  if (m_PhotoacousticProbe.IsNotNull())
+  {
+    mitk::pa::LightSource::PhotonInformation info = m_PhotoacousticProbe->GetNextPhoton(randomNumbers[0], randomNumbers[1],
+      randomNumbers[2], randomNumbers[3], randomNumbers[4], randomNumbers[5], randomNumbers[6], randomNumbers[7]);
+    photon.x = info.xPosition;
+    photon.y = yOffset + info.yPosition;
+    photon.z = info.zPosition;
+    photon.ux = info.xAngle;
+    photon.uy = info.yAngle;
+    photon.uz = info.zAngle;
+  }
+  else if (inputValues->launchflag == 1) // manually set launch
+  {
+    photon.x = inputValues->xs;
+    photon.y = inputValues->ys;
+    photon.z = inputValues->zs;
+    photon.ux = inputValues->ux0;
+    photon.uy = inputValues->uy0;
+    photon.uz = inputValues->uz0;
+  }
+  else if (inputValues->mcflag == 0) // uniform beam
+  {
+    // set launch point and width of beam
+    r = inputValues->radius*sqrt(randomNumbers[0]); // radius of beam at launch point
+    phi = randomNumbers[1] * 2.0*PI;
+    photon.x = inputValues->xs + r*cos(phi);
+    photon.y = inputValues->ys + r*sin(phi);
+    photon.z = inputValues->zs;
+    // set trajectory toward focus, the focus is sampled per photon instead of being written to the input values
+    r = inputValues->waist*sqrt(randomNumbers[2]); // radius of beam at focus
+    phi = randomNumbers[3] * 2.0*PI;
+    double xfocus = r*cos(phi);
+    double yfocus = r*sin(phi);
+    temp = sqrt((photon.x - xfocus)*(photon.x - xfocus)
+      + (photon.y - yfocus)*(photon.y - yfocus) + inputValues->zfocus*inputValues->zfocus);
+    photon.ux = -(photon.x - xfocus) / temp;
+    photon.uy = -(photon.y - yfocus) / temp;
+    photon.uz = sqrt(1 - photon.ux*photon.ux + photon.uy*photon.uy);
+  }
+  else if (inputValues->mcflag == 5 || inputValues->mcflag == 4) // Multispectral or monospectral DKFZ prototype
+  {
+    const double distance = inputValues->mcflag == 5 ? 1.5 : 0.83;
+    const double angle = inputValues->mcflag == 5 ? 0.436 : 0.375;
+
+    //offset in x direction in cm (random)
+    photon.x = (randomNumbers[0] * 2.5) - 1.25;
+    double b = ((randomNumbers[1]) - 0.5);
+    photon.y = (b > 0 ? yOffset + distance : yOffset - distance);
+    photon.z = 0.1;
+
+    //Angle of beam in y direction
+    photon.uy = sin((randomNumbers[2] * 0.42) - 0.21 + (b < 0 ? 1.0 : -1.0) * angle);
+    // angle of beam in x direction
+    photon.ux = sin((randomNumbers[3] * 0.42) - 0.21);
+    photon.uz = sqrt(1 - photon.ux*photon.ux - photon.uy*photon.uy);
+  }
+  else // isotropic pt source
+  {
+    double costheta = 1.0 - 2.0 * randomNumbers[0];
+    double sintheta = sqrt(1.0 - costheta*costheta);
+    double psi = 2.0 * PI * randomNumbers[1];
+    double cospsi = cos(psi);
+    double sinpsi = psi < PI ? sqrt(1.0 - cospsi*cospsi) : -sqrt(1.0 - cospsi*cospsi);
+    photon.x = inputValues->xs;
+    photon.y = inputValues->ys;
+    photon.z = inputValues->zs;
+    photon.ux = sintheta*cospsi;
+    photon.uy = sintheta*sinpsi;
+    photon.uz = costheta;
+  }
+}
@@ -15,6 +15,7 @@ SET(H_FILES
   include/mitkPALightSource.h
   include/mitkPAIOUtil.h
   include/mitkPAMonteCarloThreadHandler.h
+  include/mitkPAPhotonPacketSimulator.h
   include/mitkPASimulationBatchGenerator.h
   include/mitkPAFluenceYOffsetPair.h
   include/mitkPAVolumeManipulator.h
@@ -45,6 +46,7 @@ set(CPP_FILES
   Utils/ProbeDesign/mitkPAProbe.cpp
   Utils/ProbeDesign/mitkPALightSource.cpp
   Utils/Thread/mitkPAMonteCarloThreadHandler.cpp
+  Simulation/mitkPAPhotonPacketSimulator.cpp
 )
 
 set(RESOURCE_FILES
@@ -0,0 +1,151 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKPHOTONPACKETSIMULATOR_H
+#define MITKPHOTONPACKETSIMULATOR_H
+
+#include <MitkPhotoacousticsLibExports.h>
+
+//Includes for smart pointer usage
+#include "mitkCommon.h"
+#include "itkObject.h"
+
+#include "mitkPAMonteCarloThreadHandler.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mitk {
+  namespace pa {
+    /**
+     * @brief The PhotonPacketRandomGenerator class
+     * Generates uniformly distributed random numbers for all photons of a packet. Every lane of the packet
+     * has its own xorshift128+ generator, the states are stored as arrays, so that Fill() advances all lanes
+     * in one loop without branches, which the compiler vectorizes. The states of the lanes are derived from
+     * a seed and a stream number, equal seeds and streams always give the same numbers.
+     */
+    class MITKPHOTOACOUSTICSLIB_EXPORT PhotonPacketRandomGenerator
+    {
+    public:
+      static const unsigned int NumberOfLanes = 64;
+
+      PhotonPacketRandomGenerator();
+
+      void Seed(unsigned long long seed, unsigned long long stream);
+
+      /**
+       * @brief Fill writes the next number in (0, 1] of every lane into numbers[lane]
+       */
+      void Fill(double* numbers);
+
+    private:
+      unsigned long long m_State0[NumberOfLanes];
+      unsigned long long m_State1[NumberOfLanes];
+    };
+
+    /**
+     * @brief The PhotonPacketSimulator class
+     * Propagates photons through a voxelized tissue with the hop, drop, spin and roulette steps of mcxyz
+     * and sums the weight absorbed in each voxel.
+     *
+     * Instead of tracing one photon after the other, a packet of PhotonPacketRandomGenerator::NumberOfLanes
+     * photons is advanced by one step at a time. The photon states are stored as structure of arrays, so the
+     * step sizes, voxel boundaries and scattering directions of all photons are computed in loops that the
+     * compiler vectorizes. A dead photon is replaced by a newly launched one until the work package is done.
+     *
+     * Every thread pulls work packages from the MonteCarloThreadHandler and deposits the absorbed weight of a
+     * package in its own array, which is added to the result in the order of the package indices. The random
+     * numbers of a work package only depend on the seed and the index of the package, so a simulation with a
+     * fixed seed and number of photons gives bitwise equal results for any number of threads.
+     */
+    class MITKPHOTOACOUSTICSLIB_EXPORT PhotonPacketSimulator : public itk::Object
+    {
+    public:
+
+      mitkClassMacroItkParent(PhotonPacketSimulator, itk::Object)
+        itkFactorylessNewMacro(Self)
+
+      /**
+       * @brief The optical properties of the tissue, indexed with z*Ny*Nx + x*Ny + y like the volumes of mcxyz
+       */
+      struct Tissue
+      {
+        const double* Absorption = nullptr; // mua [1/cm]
+        const double* Scattering = nullptr; // mus [1/cm]
+        const double* Anisotropy = nullptr; // g
+        int Nx = 0;
+        int Ny = 0;
+        int Nz = 0;
+        double Spacing[3] = { 1, 1, 1 }; // x, y, z [cm]
+        int BoundaryFlag = 1; // 0 = no boundaries, 1 = escape at boundaries, 2 = escape at surface only
+      };
+
+      /**
+       * @brief The position [cm] and direction cosines of a launched photon
+       */
+      struct Photon
+      {
+        double x, y, z;
+        double ux, uy, uz;
+      };
+
+      static const unsigned int NumberOfLaunchRandomNumbers = 8;
+
+      /**
+       * @brief Launches a photon, gets NumberOfLaunchRandomNumbers uniformly distributed numbers in (0, 1]
+       */
+      typedef std::function<void(const double* randomNumbers, Photon& photon)> LaunchFunction;
+
+      void SetTissue(const Tissue& tissue);
+      void SetLaunchFunction(LaunchFunction launchFunction);
+
+      itkSetMacro(Seed, unsigned long long);
+      itkGetMacro(Seed, unsigned long long);
+      itkSetMacro(NumberOfThreads, unsigned int);
+      itkGetMacro(NumberOfThreads, unsigned int);
+      itkGetMacro(NumberOfSimulatedPhotons, long long);
+
+      /**
+       * @brief Simulate runs the work packages of the thread handler on NumberOfThreads threads
+       * @throws mitk::Exception if the tissue or the launch function is not set
+       */
+      void Simulate(MonteCarloThreadHandler::Pointer threadHandler);
+
+      /**
+       * @brief GetAbsorbedWeight returns the weight absorbed per voxel by all photons of the last simulation
+       */
+      const std::vector<double>& GetAbsorbedWeight() const;
+
+    protected:
+      PhotonPacketSimulator();
+      virtual ~PhotonPacketSimulator();
+
+      struct Packet;
+
+      void SimulateWorkPackage(unsigned long long packageIndex, long numberOfPhotons, Packet& packet, double* absorbedWeight) const;
+
+      Tissue m_Tissue;
+      LaunchFunction m_LaunchFunction;
+      unsigned long long m_Seed;
+      unsigned int m_NumberOfThreads;
+      long long m_NumberOfSimulatedPhotons;
+      std::vector<double> m_AbsorbedWeight;
+    };
+  }
+}
+
+#endif // MITKPHOTONPACKETSIMULATOR_H
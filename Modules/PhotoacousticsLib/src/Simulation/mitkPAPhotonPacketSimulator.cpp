@@ -0,0 +1,449 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPAPhotonPacketSimulator.h"
+#include "mitkExceptionMacro.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+  // the constants of mcxyz
+  const double LittleStep = 1.0E-7; // moves the photon a little bit off the voxel face
+  const double Threshold = 0.01;    // used in roulette
+  const double Chance = 0.1;        // used in roulette
+  const double OneMinusCosZero = 1.0E-12;
+  const double Pi = 3.1415926;
+
+  unsigned long long SplitMix64(unsigned long long& state)
+  {
+    unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  // SameVoxel of mcxyz without branches
+  inline bool SameVoxel(double x1, double y1, double z1, double x2, double y2, double z2, double dx, double dy, double dz)
+  {
+    const double xmax = std::min(std::floor(x1 / dx), std::floor(x2 / dx)) * dx + dx;
+    const double ymax = std::min(std::floor(y1 / dy), std::floor(y2 / dy)) * dy + dy;
+    const double zmax = std::min(std::floor(z1 / dz), std::floor(z2 / dz)) * dz + dz;
+    return (x1 <= xmax) & (x2 <= xmax) & (y1 <= ymax) & (y2 <= ymax) & (z1 < zmax) & (z2 <= zmax);
+  }
+
+  // FindVoxelFace2 of mcxyz without branches
+  inline double FindVoxelFace(double x, double y, double z, double dx, double dy, double dz, double ux, double uy, double uz)
+  {
+    const double ix2 = std::floor(x / dx) + (ux >= 0 ? 1 : 0);
+    const double iy2 = std::floor(y / dy) + (uy >= 0 ? 1 : 0);
+    const double iz2 = std::floor(z / dz) + (uz >= 0 ? 1 : 0);
+
+    const double xs = std::fabs((ix2 * dx - x) / ux);
+    const double ys = std::fabs((iy2 * dy - y) / uy);
+    const double zs = std::fabs((iz2 * dz - z) / uz);
+
+    // same order of comparisons as min3 of mcxyz, so NaN is handled equally
+    const double yz = ys >= zs ? zs : ys;
+    const double xz = xs >= zs ? zs : xs;
+    return xs <= yz ? xs : (ys <= xz ? ys : zs);
+  }
+}
+
+mitk::pa::PhotonPacketRandomGenerator::PhotonPacketRandomGenerator()
+{
+  this->Seed(0, 0);
+}
+
+void mitk::pa::PhotonPacketRandomGenerator::Seed(unsigned long long seed, unsigned long long stream)
+{
+  unsigned long long state = seed;
+  state = SplitMix64(state) ^ ((stream + 1) * 0xD1B54A32D192ED03ULL);
+
+  for (unsigned int lane = 0; lane < NumberOfLanes; ++lane)
+  {
+    m_State0[lane] = SplitMix64(state);
+    m_State1[lane] = SplitMix64(state);
+
+    // xorshift128+ must not start with a state of zeros
+    if (m_State0[lane] == 0 && m_State1[lane] == 0)
+      m_State0[lane] = 1;
+  }
+}
+
+void mitk::pa::PhotonPacketRandomGenerator::Fill(double* numbers)
+{
+  for (unsigned int lane = 0; lane < NumberOfLanes; ++lane)
+  {
+    unsigned long long s1 = m_State0[lane];
+    const unsigned long long s0 = m_State1[lane];
+    m_State0[lane] = s0;
+    s1 ^= s1 << 23;
+    m_State1[lane] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+
+    // the upper 53 bits give a double in [0, 1), shifting by one ulp excludes zero
+    numbers[lane] = (double)(((m_State1[lane] + s0) >> 11) + 1) * (1.0 / 9007199254740992.0);
+  }
+}
+
+/**
+ * @brief The states of the photons of a packet, stored as structure of arrays
+ */
+struct mitk::pa::PhotonPacketSimulator::Packet
+{
+  static const unsigned int Lanes = PhotonPacketRandomGenerator::NumberOfLanes;
+
+  PhotonPacketRandomGenerator Generator;
+
+  double X[Lanes], Y[Lanes], Z[Lanes];
+  double Ux[Lanes], Uy[Lanes], Uz[Lanes];
+  double Weight[Lanes];
+  double StepLeft[Lanes];    // dimensionless step remaining of the current hop
+  double Step[Lanes];        // step size of the current substep [cm]
+  bool InSameVoxel[Lanes];   // the current substep ends in the voxel it started in
+  long Voxel[Lanes];         // voxel of the optical properties
+  bool Inside[Lanes];        // the photon is inside of the volume and deposits weight
+  bool Alive[Lanes];
+
+  double HopRandom[Lanes];
+  double ThetaRandom[Lanes];
+  double PsiRandom[Lanes];
+  double RouletteRandom[Lanes];
+  double LaunchRandom[NumberOfLaunchRandomNumbers][Lanes];
+};
+
+mitk::pa::PhotonPacketSimulator::PhotonPacketSimulator()
+  : m_Seed(0),
+    m_NumberOfThreads(1),
+    m_NumberOfSimulatedPhotons(0)
+{
+}
+
+mitk::pa::PhotonPacketSimulator::~PhotonPacketSimulator()
+{
+}
+
+void mitk::pa::PhotonPacketSimulator::SetTissue(const Tissue& tissue)
+{
+  m_Tissue = tissue;
+  this->Modified();
+}
+
+void mitk::pa::PhotonPacketSimulator::SetLaunchFunction(LaunchFunction launchFunction)
+{
+  m_LaunchFunction = launchFunction;
+  this->Modified();
+}
+
+const std::vector<double>& mitk::pa::PhotonPacketSimulator::GetAbsorbedWeight() const
+{
+  return m_AbsorbedWeight;
+}
+
+void mitk::pa::PhotonPacketSimulator::Simulate(MonteCarloThreadHandler::Pointer threadHandler)
+{
+  if (m_Tissue.Absorption == nullptr || m_Tissue.Scattering == nullptr || m_Tissue.Anisotropy == nullptr
+    || m_Tissue.Nx <= 0 || m_Tissue.Ny <= 0 || m_Tissue.Nz <= 0)
+    mitkThrow() << "The tissue of the photon packet simulation is not set.";
+  if (!m_LaunchFunction)
+    mitkThrow() << "The launch function of the photon packet simulation is not set.";
+
+  const size_t numberOfVoxels = (size_t)m_Tissue.Nx * m_Tissue.Ny * m_Tissue.Nz;
+  const unsigned int numberOfThreads = std::max(1u, m_NumberOfThreads);
+
+  // the index of a work package is taken together with its size, so the random numbers of the
+  // n-th package do not depend on the thread that simulates it
+  std::mutex workPackageMutex;
+  unsigned long long nextPackageIndex = 0;
+
+  // the packages are added to the result in the order of their indices, so the sums do not depend
+  // on the number of threads either
+  std::mutex reductionMutex;
+  std::condition_variable reductionTurn;
+  unsigned long long nextPackageToReduce = 0;
+
+  m_AbsorbedWeight.assign(numberOfVoxels, 0);
+  m_NumberOfSimulatedPhotons = 0;
+
+  auto simulateThread = [&]()
+  {
+    std::vector<double> absorbedWeight(numberOfVoxels, 0);
+    std::unique_ptr<Packet> packet(new Packet());
+
+    for (;;)
+    {
+      long numberOfPhotons = 0;
+      unsigned long long packageIndex = 0;
+      {
+        std::lock_guard<std::mutex> lock(workPackageMutex);
+        numberOfPhotons = threadHandler->GetNextWorkPackage();
+        packageIndex = nextPackageIndex++;
+      }
+      if (numberOfPhotons > 0)
+        this->SimulateWorkPackage(packageIndex, numberOfPhotons, *packet, absorbedWeight.data());
+
+      {
+        std::unique_lock<std::mutex> lock(reductionMutex);
+        reductionTurn.wait(lock, [&] { return nextPackageToReduce == packageIndex; });
+      }
+
+      // only the thread of the next package gets here, the others wait for their turn
+      if (numberOfPhotons > 0)
+      {
+        for (size_t voxel = 0; voxel < numberOfVoxels; ++voxel)
+        {
+          m_AbsorbedWeight[voxel] += absorbedWeight[voxel];
+          absorbedWeight[voxel] = 0;
+        }
+        m_NumberOfSimulatedPhotons += numberOfPhotons;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(reductionMutex);
+        ++nextPackageToReduce;
+      }
+      reductionTurn.notify_all();
+
+      if (numberOfPhotons <= 0)
+        break;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int thread = 1; thread < numberOfThreads; ++thread)
+  {
+    threads.push_back(std::thread(simulateThread));
+  }
+  simulateThread();
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+}
+
+void mitk::pa::PhotonPacketSimulator::SimulateWorkPackage(unsigned long long packageIndex, long numberOfPhotons, Packet& packet, double* absorbedWeight) const
+{
+  const unsigned int lanes = Packet::Lanes;
+  const int Nx = m_Tissue.Nx;
+  const int Ny = m_Tissue.Ny;
+  const int Nz = m_Tissue.Nz;
+  const double dx = m_Tissue.Spacing[0];
+  const double dy = m_Tissue.Spacing[1];
+  const double dz = m_Tissue.Spacing[2];
+  const double* mua = m_Tissue.Absorption;
+  const double* mus = m_Tissue.Scattering;
+  const double* g = m_Tissue.Anisotropy;
+
+  packet.Generator.Seed(m_Seed, packageIndex);
+  std::fill(packet.Alive, packet.Alive + lanes, false);
+
+  long numberOfLaunchedPhotons = 0;
+  unsigned int numberOfAlivePhotons = 0;
+
+  for (;;)
+  {
+    /**** LAUNCH photons in the lanes of dead photons ****/
+    if (numberOfLaunchedPhotons < numberOfPhotons && numberOfAlivePhotons < lanes)
+    {
+      for (unsigned int i = 0; i < NumberOfLaunchRandomNumbers; ++i)
+        packet.Generator.Fill(packet.LaunchRandom[i]);
+
+      for (unsigned int lane = 0; lane < lanes && numberOfLaunchedPhotons < numberOfPhotons; ++lane)
+      {
+        if (packet.Alive[lane])
+          continue;
+
+        double randomNumbers[NumberOfLaunchRandomNumbers];
+        for (unsigned int i = 0; i < NumberOfLaunchRandomNumbers; ++i)
+          randomNumbers[i] = packet.LaunchRandom[i][lane];
+
+        Photon photon;
+        m_LaunchFunction(randomNumbers, photon);
+        packet.X[lane] = photon.x;
+        packet.Y[lane] = photon.y;
+        packet.Z[lane] = photon.z;
+        packet.Ux[lane] = photon.ux;
+        packet.Uy[lane] = photon.uy;
+        packet.Uz[lane] = photon.uz;
+        packet.Weight[lane] = 1.0;
+        packet.StepLeft[lane] = 0;
+
+        // outside of the volume, the properties of the outermost voxels are used
+        const int ix = std::min(std::max((int)(Nx / 2 + photon.x / dx), 0), Nx - 1);
+        const int iy = std::min(std::max((int)(Ny / 2 + photon.y / dy), 0), Ny - 1);
+        const int iz = std::min(std::max((int)(photon.z / dz), 0), Nz - 1);
+        packet.Voxel[lane] = (long)iz * Ny * Nx + (long)ix * Ny + iy;
+        packet.Inside[lane] = true;
+        packet.Alive[lane] = true;
+
+        ++numberOfLaunchedPhotons;
+        ++numberOfAlivePhotons;
+      }
+    }
+
+    if (numberOfAlivePhotons == 0)
+      break;
+
+    packet.Generator.Fill(packet.HopRandom);
+    packet.Generator.Fill(packet.ThetaRandom);
+    packet.Generator.Fill(packet.PsiRandom);
+    packet.Generator.Fill(packet.RouletteRandom);
+
+    /**** HOP
+     Start a new hop with a dimensionless step if the last one is done and find out whether the
+     step ends in the current voxel or at its face. Dead lanes are computed as well and ignored later.
+     *****/
+    for (unsigned int lane = 0; lane < lanes; ++lane)
+    {
+      const double stepLeft = packet.StepLeft[lane] == 0 ? -std::log(packet.HopRandom[lane]) : packet.StepLeft[lane];
+      packet.StepLeft[lane] = stepLeft;
+
+      const double s = stepLeft / mus[packet.Voxel[lane]];
+      const double x = packet.X[lane];
+      const double y = packet.Y[lane];
+      const double z = packet.Z[lane];
+      const double ux = packet.Ux[lane];
+      const double uy = packet.Uy[lane];
+      const double uz = packet.Uz[lane];
+
+      const bool sameVoxel = SameVoxel(x, y, z, x + s * ux, y + s * uy, z + s * uz, dx, dy, dz);
+      packet.InSameVoxel[lane] = sameVoxel;
+      packet.Step[lane] = sameVoxel ? s : LittleStep + FindVoxelFace(x, y, z, dx, dy, dz, ux, uy, uz);
+    }
+
+    /**** DROP
+     Drop the absorbed weight into the voxel and move the photon, at a voxel face check the boundaries.
+     *****/
+    for (unsigned int lane = 0; lane < lanes; ++lane)
+    {
+      if (!packet.Alive[lane])
+        continue;
+
+      const long voxel = packet.Voxel[lane];
+      const double s = packet.Step[lane];
+      const double absorb = packet.Weight[lane] * (1 - std::exp(-mua[voxel] * s));
+      packet.Weight[lane] -= absorb;
+      if (packet.Inside[lane])
+        absorbedWeight[voxel] += absorb;
+
+      packet.X[lane] += s * packet.Ux[lane];
+      packet.Y[lane] += s * packet.Uy[lane];
+      packet.Z[lane] += s * packet.Uz[lane];
+
+      if (packet.InSameVoxel[lane])
+      {
+        packet.StepLeft[lane] = 0;
+        continue;
+      }
+
+      double stepLeft = packet.StepLeft[lane] - s * mus[voxel];
+      if (stepLeft <= LittleStep)
+        stepLeft = 0;
+
+      int ix = (int)(Nx / 2 + packet.X[lane] / dx);
+      int iy = (int)(Ny / 2 + packet.Y[lane] / dy);
+      int iz = (int)(packet.Z[lane] / dz);
+      const bool outsideZ = iz >= Nz || iz < 0;
+      const bool outsideXY = ix >= Nx || ix < 0 || iy >= Ny || iy < 0;
+      ix = std::min(std::max(ix, 0), Nx - 1);
+      iy = std::min(std::max(iy, 0), Ny - 1);
+
+      bool inside = true;
+      bool escaped = false;
+      if (m_Tissue.BoundaryFlag == 0) // infinite medium, the photon wanders on without depositing weight
+      {
+        inside = !outsideZ && !outsideXY;
+      }
+      else if (m_Tissue.BoundaryFlag == 1) // escape at boundaries
+      {
+        escaped = outsideZ || outsideXY;
+      }
+      else if (m_Tissue.BoundaryFlag == 2) // escape at top surface, no x,y bottom z boundaries
+      {
+        escaped = iz < 0;
+        inside = !(iz >= Nz) && !outsideXY;
+      }
+      iz = std::min(std::max(iz, 0), Nz - 1);
+
+      packet.Inside[lane] = inside;
+      packet.Voxel[lane] = (long)iz * Ny * Nx + (long)ix * Ny + iy;
+
+      if (escaped)
+      {
+        packet.Alive[lane] = false;
+        --numberOfAlivePhotons;
+        stepLeft = 0;
+      }
+      packet.StepLeft[lane] = stepLeft;
+    }
+
+    /**** SPIN
+     Scatter the photons whose hop is done into a new trajectory, theta is sampled from the
+     Henyey-Greenstein function.
+     *****/
+    for (unsigned int lane = 0; lane < lanes; ++lane)
+    {
+      const bool spin = packet.Alive[lane] && packet.StepLeft[lane] == 0;
+
+      const double gi = g[packet.Voxel[lane]];
+      const double rnd = packet.ThetaRandom[lane];
+      const double temp = (1.0 - gi * gi) / (1.0 - gi + 2 * gi * rnd);
+      const double costheta = gi == 0.0 ? 2.0 * rnd - 1.0 : (1.0 + gi * gi - temp * temp) / (2.0 * gi);
+      const double sintheta = std::sqrt(1.0 - costheta * costheta);
+
+      const double psi = 2.0 * Pi * packet.PsiRandom[lane];
+      const double cospsi = std::cos(psi);
+      const double sinpsi = (psi < Pi ? 1.0 : -1.0) * std::sqrt(1.0 - cospsi * cospsi);
+
+      const double ux = packet.Ux[lane];
+      const double uy = packet.Uy[lane];
+      const double uz = packet.Uz[lane];
+      const bool perpendicular = 1 - std::fabs(uz) <= OneMinusCosZero;
+      const double root = perpendicular ? 1.0 : std::sqrt(1.0 - uz * uz);
+
+      const double uxx = perpendicular ? sintheta * cospsi : sintheta * (ux * uz * cospsi - uy * sinpsi) / root + ux * costheta;
+      const double uyy = perpendicular ? sintheta * sinpsi : sintheta * (uy * uz * cospsi + ux * sinpsi) / root + uy * costheta;
+      const double uzz = perpendicular ? costheta * (uz >= 0 ? 1 : -1) : -sintheta * cospsi * root + uz * costheta;
+
+      packet.Ux[lane] = spin ? uxx : ux;
+      packet.Uy[lane] = spin ? uyy : uy;
+      packet.Uz[lane] = spin ? uzz : uz;
+    }
+
+    /**** CHECK ROULETTE
+     A photon with a weight below the threshold survives with CHANCE and its weight increased by 1/CHANCE.
+     *****/
+    for (unsigned int lane = 0; lane < lanes; ++lane)
+    {
+      if (!packet.Alive[lane] || packet.StepLeft[lane] != 0 || packet.Weight[lane] >= Threshold)
+        continue;
+
+      if (packet.RouletteRandom[lane] <= Chance)
+      {
+        packet.Weight[lane] /= Chance;
+      }
+      else
+      {
+        packet.Alive[lane] = false;
+        --numberOfAlivePhotons;
+      }
+    }
+  }
+}
@@ -27,6 +27,7 @@ set(MODULE_TESTS
   mitkPhotoacousticNoiseGeneratorTest.cpp
   mitkPhotoacousticIOTest.cpp
   mitkMCThreadHandlerTest.cpp
+  mitkPhotonPacketSimulatorTest.cpp
   mitkSimulationBatchGeneratorTest.cpp
   mitkPropertyCalculatorTest.cpp
 )
@@ -0,0 +1,190 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkException.h>
+#include <mitkPAPhotonPacketSimulator.h>
+
+#include <cmath>
+#include <vector>
+
+class mitkPhotonPacketSimulatorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkPhotonPacketSimulatorTestSuite);
+  MITK_TEST(testRandomGeneratorIsReproducible);
+  MITK_TEST(testSameSeedGivesSameAbsorbedWeight);
+  MITK_TEST(testNumberOfThreadsDoesNotChangeResult);
+  MITK_TEST(testAbsorptionOfNonScatteringBeam);
+  MITK_TEST(testMissingTissueThrowsException);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  static const int m_Size = 20;
+  std::vector<double> m_Absorption;
+  std::vector<double> m_Scattering;
+  std::vector<double> m_Anisotropy;
+  mitk::pa::PhotonPacketSimulator::Tissue m_Tissue;
+
+  mitk::pa::PhotonPacketSimulator::Pointer CreateSimulator(unsigned long long seed, unsigned int numberOfThreads)
+  {
+    auto simulator = mitk::pa::PhotonPacketSimulator::New();
+    simulator->SetTissue(m_Tissue);
+    simulator->SetLaunchFunction([](const double*, mitk::pa::PhotonPacketSimulator::Photon& photon)
+    {
+      // pencil beam into the center of the top surface
+      photon.x = 0;
+      photon.y = 0;
+      photon.z = 0;
+      photon.ux = 0;
+      photon.uy = 0;
+      photon.uz = 1;
+    });
+    simulator->SetSeed(seed);
+    simulator->SetNumberOfThreads(numberOfThreads);
+    return simulator;
+  }
+
+  mitk::pa::MonteCarloThreadHandler::Pointer CreateThreadHandler(long numberOfPhotons)
+  {
+    auto threadHandler = mitk::pa::MonteCarloThreadHandler::New(numberOfPhotons, false, false);
+    threadHandler->SetPackageSize(1000);
+    return threadHandler;
+  }
+
+public:
+
+  void setUp() override
+  {
+    const int numberOfVoxels = m_Size * m_Size * m_Size;
+    m_Absorption.assign(numberOfVoxels, 1);
+    m_Scattering.assign(numberOfVoxels, 50);
+    m_Anisotropy.assign(numberOfVoxels, 0.9);
+
+    m_Tissue = mitk::pa::PhotonPacketSimulator::Tissue();
+    m_Tissue.Absorption = m_Absorption.data();
+    m_Tissue.Scattering = m_Scattering.data();
+    m_Tissue.Anisotropy = m_Anisotropy.data();
+    m_Tissue.Nx = m_Size;
+    m_Tissue.Ny = m_Size;
+    m_Tissue.Nz = m_Size;
+    m_Tissue.Spacing[0] = 0.02;
+    m_Tissue.Spacing[1] = 0.02;
+    m_Tissue.Spacing[2] = 0.02;
+  }
+
+  void testRandomGeneratorIsReproducible()
+  {
+    const unsigned int lanes = mitk::pa::PhotonPacketRandomGenerator::NumberOfLanes;
+    mitk::pa::PhotonPacketRandomGenerator generator1, generator2, generator3;
+    generator1.Seed(42, 7);
+    generator2.Seed(42, 7);
+    generator3.Seed(42, 8);
+
+    double numbers1[lanes], numbers2[lanes], numbers3[lanes];
+    double sum = 0;
+    bool otherStreamDiffers = false;
+    for (int i = 0; i < 1000; ++i)
+    {
+      generator1.Fill(numbers1);
+      generator2.Fill(numbers2);
+      generator3.Fill(numbers3);
+      for (unsigned int lane = 0; lane < lanes; ++lane)
+      {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Equal seeds give equal numbers", numbers1[lane], numbers2[lane]);
+        CPPUNIT_ASSERT_MESSAGE("Numbers are in (0, 1]", numbers1[lane] > 0 && numbers1[lane] <= 1);
+        otherStreamDiffers |= numbers1[lane] != numbers3[lane];
+        sum += numbers1[lane];
+      }
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Another stream gives other numbers", otherStreamDiffers);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Numbers are uniformly distributed", 0.5, sum / (1000 * lanes), 0.01);
+  }
+
+  void testSameSeedGivesSameAbsorbedWeight()
+  {
+    auto simulator1 = CreateSimulator(1234, 1);
+    simulator1->Simulate(CreateThreadHandler(5000));
+    auto simulator2 = CreateSimulator(1234, 1);
+    simulator2->Simulate(CreateThreadHandler(5000));
+    auto simulator3 = CreateSimulator(4321, 1);
+    simulator3->Simulate(CreateThreadHandler(5000));
+
+    CPPUNIT_ASSERT_EQUAL(5000LL, simulator1->GetNumberOfSimulatedPhotons());
+    CPPUNIT_ASSERT_MESSAGE("Equal seeds give equal results", simulator1->GetAbsorbedWeight() == simulator2->GetAbsorbedWeight());
+    CPPUNIT_ASSERT_MESSAGE("Other seeds give other results", simulator1->GetAbsorbedWeight() != simulator3->GetAbsorbedWeight());
+  }
+
+  void testNumberOfThreadsDoesNotChangeResult()
+  {
+    auto simulator1 = CreateSimulator(99, 1);
+    simulator1->Simulate(CreateThreadHandler(5500));
+    auto simulator4 = CreateSimulator(99, 4);
+    simulator4->Simulate(CreateThreadHandler(5500));
+
+    CPPUNIT_ASSERT_EQUAL(simulator1->GetNumberOfSimulatedPhotons(), simulator4->GetNumberOfSimulatedPhotons());
+
+    const std::vector<double>& absorbedWeight1 = simulator1->GetAbsorbedWeight();
+    const std::vector<double>& absorbedWeight4 = simulator4->GetAbsorbedWeight();
+    CPPUNIT_ASSERT_EQUAL(absorbedWeight1.size(), absorbedWeight4.size());
+    for (size_t voxel = 0; voxel < absorbedWeight1.size(); ++voxel)
+    {
+      // the work packages are summed in the same order
+      CPPUNIT_ASSERT_EQUAL(absorbedWeight1[voxel], absorbedWeight4[voxel]);
+    }
+  }
+
+  void testAbsorptionOfNonScatteringBeam()
+  {
+    // without scattering the beam runs straight through the center column and
+    // is attenuated following Beer-Lambert
+    m_Scattering.assign(m_Scattering.size(), 1e-6);
+    auto simulator = CreateSimulator(5, 2);
+    simulator->Simulate(CreateThreadHandler(1000));
+
+    const std::vector<double>& absorbedWeight = simulator->GetAbsorbedWeight();
+    const double mua = m_Absorption[0];
+    const double dz = m_Tissue.Spacing[2];
+    for (int iz = 0; iz < m_Size; ++iz)
+    {
+      const long voxel = (long)iz * m_Size * m_Size + (m_Size / 2) * m_Size + m_Size / 2;
+      const double expected = std::exp(-mua * iz * dz) - std::exp(-mua * (iz + 1) * dz);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, absorbedWeight[voxel] / 1000, 1e-5);
+    }
+
+    double totalAbsorbedWeight = 0;
+    for (double weight : absorbedWeight)
+      totalAbsorbedWeight += weight;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1 - std::exp(-mua * m_Size * dz), totalAbsorbedWeight / 1000, 1e-5);
+  }
+
+  void testMissingTissueThrowsException()
+  {
+    auto simulator = mitk::pa::PhotonPacketSimulator::New();
+    CPPUNIT_ASSERT_THROW(simulator->Simulate(CreateThreadHandler(10)), mitk::Exception);
+  }
+
+  void tearDown() override
+  {
+    m_Absorption.clear();
+    m_Scattering.clear();
+    m_Anisotropy.clear();
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkPhotonPacketSimulator)
@@ -0,0 +1,284 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkCompressedSliceContainer.h"
+
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+  typedef std::uint32_t RunLengthType;
+
+  // Appends the runs of equal pixels of [pixels, pixels + numberOfPixels * pixelSize)
+  void AppendRuns(const unsigned char *pixels,
+                  std::size_t numberOfPixels,
+                  unsigned int pixelSize,
+                  std::vector<unsigned char> &runs)
+  {
+    std::size_t i = 0;
+    while (i < numberOfPixels)
+    {
+      const unsigned char *value = pixels + i * pixelSize;
+      RunLengthType length = 1;
+      while (i + length < numberOfPixels && length < std::numeric_limits<RunLengthType>::max() &&
+             std::memcmp(value, pixels + (i + length) * pixelSize, pixelSize) == 0)
+      {
+        ++length;
+      }
+
+      const std::size_t offset = runs.size();
+      runs.resize(offset + sizeof(RunLengthType) + pixelSize);
+      std::memcpy(&runs[offset], &length, sizeof(RunLengthType));
+      std::memcpy(&runs[offset + sizeof(RunLengthType)], value, pixelSize);
+      i += length;
+    }
+  }
+}
+
+mitk::CompressedSliceContainer::CompressedSliceContainer()
+  : m_CopiedSize(0),
+    m_PixelType(nullptr),
+    m_Dimension(0),
+    m_Width(0),
+    m_Height(0),
+    m_PixelSize(0),
+    m_StoresChangedRegionOnly(false),
+    m_IsRunLengthEncoded(false)
+{
+  m_RegionBegin[0] = m_RegionBegin[1] = 0;
+  m_RegionEnd[0] = m_RegionEnd[1] = 0;
+}
+
+mitk::CompressedSliceContainer::~CompressedSliceContainer()
+{
+  this->WaitForEncoding();
+  delete m_PixelType;
+}
+
+void mitk::CompressedSliceContainer::WaitForEncoding()
+{
+  if (m_Encoding.valid())
+    m_Encoding.get();
+}
+
+void mitk::CompressedSliceContainer::SetSlice(const Image *slice, const Image *referenceSlice)
+{
+  this->WaitForEncoding();
+  m_Data.clear();
+  m_CopiedSize = 0;
+  delete m_PixelType;
+  m_PixelType = nullptr;
+
+  if (!slice)
+    return;
+
+  m_PixelType = new PixelType(slice->GetPixelType());
+  m_PixelSize = m_PixelType->GetSize();
+  m_Dimension = slice->GetDimension();
+  m_Dimensions.assign(slice->GetDimensions(), slice->GetDimensions() + m_Dimension);
+  m_Geometry = slice->GetGeometry()->Clone();
+
+  m_Width = m_Dimensions[0];
+  m_Height = 1;
+  for (unsigned int i = 1; i < m_Dimension; ++i)
+    m_Height *= m_Dimensions[i];
+
+  const std::size_t numberOfBytes = static_cast<std::size_t>(m_Width) * m_Height * m_PixelSize;
+  ImageReadAccessor sliceAccessor(slice);
+  m_Data.assign(static_cast<const unsigned char *>(sliceAccessor.GetData()),
+                static_cast<const unsigned char *>(sliceAccessor.GetData()) + numberOfBytes);
+  m_CopiedSize = m_Data.capacity();
+
+  std::vector<unsigned char> referencePixels;
+  m_StoresChangedRegionOnly = referenceSlice && referenceSlice->GetPixelType() == slice->GetPixelType() &&
+                              referenceSlice->GetDimension() == m_Dimension &&
+                              std::equal(m_Dimensions.begin(), m_Dimensions.end(), referenceSlice->GetDimensions());
+  if (m_StoresChangedRegionOnly)
+  {
+    ImageReadAccessor referenceAccessor(referenceSlice);
+    referencePixels.assign(static_cast<const unsigned char *>(referenceAccessor.GetData()),
+                           static_cast<const unsigned char *>(referenceAccessor.GetData()) + numberOfBytes);
+  }
+
+  m_Encoding = std::async(std::launch::async, [this, referencePixels = std::move(referencePixels)]() {
+    this->Encode(referencePixels);
+  });
+}
+
+void mitk::CompressedSliceContainer::Encode(const std::vector<unsigned char> &referencePixels)
+{
+  m_RegionBegin[0] = m_RegionBegin[1] = 0;
+  m_RegionEnd[0] = m_Width;
+  m_RegionEnd[1] = m_Height;
+
+  if (m_StoresChangedRegionOnly)
+  {
+    m_RegionBegin[0] = m_Width;
+    m_RegionBegin[1] = m_Height;
+    m_RegionEnd[0] = m_RegionEnd[1] = 0;
+
+    for (unsigned int y = 0; y < m_Height; ++y)
+    {
+      const std::size_t rowOffset = static_cast<std::size_t>(y) * m_Width * m_PixelSize;
+      if (std::memcmp(&m_Data[rowOffset], &referencePixels[rowOffset], m_Width * m_PixelSize) == 0)
+        continue;
+
+      for (unsigned int x = 0; x < m_Width; ++x)
+      {
+        const std::size_t offset = rowOffset + x * m_PixelSize;
+        if (std::memcmp(&m_Data[offset], &referencePixels[offset], m_PixelSize) != 0)
+        {
+          m_RegionBegin[0] = std::min(m_RegionBegin[0], x);
+          m_RegionEnd[0] = std::max(m_RegionEnd[0], x + 1);
+        }
+      }
+      m_RegionBegin[1] = std::min(m_RegionBegin[1], y);
+      m_RegionEnd[1] = y + 1;
+    }
+
+    // nothing changed
+    if (m_RegionEnd[1] == 0)
+    {
+      m_RegionBegin[0] = m_RegionBegin[1] = 0;
+    }
+  }
+
+  std::vector<unsigned char> runs;
+  const unsigned int regionWidth = m_RegionEnd[0] - m_RegionBegin[0];
+  const std::size_t regionSize =
+    static_cast<std::size_t>(regionWidth) * (m_RegionEnd[1] - m_RegionBegin[1]) * m_PixelSize;
+  if (regionWidth == m_Width)
+  {
+    // whole rows are contiguous, runs may continue in the next row
+    const std::size_t offset = static_cast<std::size_t>(m_RegionBegin[1]) * m_Width * m_PixelSize;
+    AppendRuns(m_Data.data() + offset,
+               static_cast<std::size_t>(m_RegionEnd[1] - m_RegionBegin[1]) * m_Width,
+               m_PixelSize,
+               runs);
+  }
+  else
+  {
+    for (unsigned int y = m_RegionBegin[1]; y < m_RegionEnd[1]; ++y)
+    {
+      const std::size_t offset = (static_cast<std::size_t>(y) * m_Width + m_RegionBegin[0]) * m_PixelSize;
+      AppendRuns(m_Data.data() + offset, regionWidth, m_PixelSize, runs);
+    }
+  }
+
+  // e.g. noise in an image that is not a segmentation, the region is stored as it is
+  m_IsRunLengthEncoded = runs.size() < regionSize;
+  if (!m_IsRunLengthEncoded)
+  {
+    runs.resize(regionSize);
+    for (unsigned int y = m_RegionBegin[1]; y < m_RegionEnd[1]; ++y)
+    {
+      std::memcpy(&runs[static_cast<std::size_t>(y - m_RegionBegin[1]) * regionWidth * m_PixelSize],
+                  &m_Data[(static_cast<std::size_t>(y) * m_Width + m_RegionBegin[0]) * m_PixelSize],
+                  static_cast<std::size_t>(regionWidth) * m_PixelSize);
+    }
+  }
+
+  runs.shrink_to_fit();
+  m_Data.swap(runs);
+}
+
+bool mitk::CompressedSliceContainer::StoresChangedRegionOnly() const
+{
+  return m_StoresChangedRegionOnly;
+}
+
+mitk::Image::Pointer mitk::CompressedSliceContainer::GetSlice(const Image *currentSlice)
+{
+  this->WaitForEncoding();
+  if (!m_PixelType)
+    return nullptr;
+
+  Image::Pointer slice = Image::New();
+  slice->Initialize(*m_PixelType, m_Dimension, m_Dimensions.data());
+
+  ImageWriteAccessor sliceAccessor(slice);
+  auto *pixels = static_cast<unsigned char *>(sliceAccessor.GetData());
+  const std::size_t numberOfBytes = static_cast<std::size_t>(m_Width) * m_Height * m_PixelSize;
+
+  if (m_StoresChangedRegionOnly)
+  {
+    if (!currentSlice || currentSlice->GetPixelType() != *m_PixelType || currentSlice->GetDimension() != m_Dimension ||
+        !std::equal(m_Dimensions.begin(), m_Dimensions.end(), currentSlice->GetDimensions()))
+    {
+      MITK_ERROR << "The current slice does not match the stored slice.";
+      return nullptr;
+    }
+
+    ImageReadAccessor currentAccessor(currentSlice);
+    std::memcpy(pixels, currentAccessor.GetData(), numberOfBytes);
+  }
+
+  const unsigned int regionWidth = m_RegionEnd[0] - m_RegionBegin[0];
+  if (!m_IsRunLengthEncoded)
+  {
+    for (unsigned int y = m_RegionBegin[1]; y < m_RegionEnd[1]; ++y)
+    {
+      std::memcpy(pixels + (static_cast<std::size_t>(y) * m_Width + m_RegionBegin[0]) * m_PixelSize,
+                  &m_Data[static_cast<std::size_t>(y - m_RegionBegin[1]) * regionWidth * m_PixelSize],
+                  static_cast<std::size_t>(regionWidth) * m_PixelSize);
+    }
+    slice->SetGeometry(m_Geometry);
+    return slice;
+  }
+
+  // write the runs row by row into the region
+  unsigned int x = m_RegionBegin[0];
+  unsigned int y = m_RegionBegin[1];
+  for (std::size_t run = 0; run < m_Data.size(); run += sizeof(RunLengthType) + m_PixelSize)
+  {
+    RunLengthType length;
+    std::memcpy(&length, &m_Data[run], sizeof(RunLengthType));
+    const unsigned char *value = &m_Data[run + sizeof(RunLengthType)];
+
+    for (RunLengthType i = 0; i < length; ++i)
+    {
+      std::memcpy(pixels + (static_cast<std::size_t>(y) * m_Width + x) * m_PixelSize, value, m_PixelSize);
+      if (++x == m_RegionEnd[0])
+      {
+        x = m_RegionBegin[0];
+        ++y;
+      }
+    }
+  }
+
+  slice->SetGeometry(m_Geometry);
+  return slice;
+}
+
+bool mitk::CompressedSliceContainer::IsEncoded() const
+{
+  return !m_Encoding.valid() || m_Encoding.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+std::size_t mitk::CompressedSliceContainer::GetMemorySize() const
+{
+  // called from the undo stack after every edit, waiting here would block the interaction until the slice is encoded
+  if (!this->IsEncoded())
+    return sizeof(*this) + m_CopiedSize;
+  return sizeof(*this) + m_Data.capacity();
+}
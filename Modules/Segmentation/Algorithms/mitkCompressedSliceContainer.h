@@ -0,0 +1,104 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkCompressedSliceContainer_h_Included
+#define mitkCompressedSliceContainer_h_Included
+
+#include "mitkCommon.h"
+#include "mitkImage.h"
+#include <MitkSegmentationExports.h>
+
+#include <itkObject.h>
+
+#include <future>
+#include <vector>
+
+namespace mitk
+{
+  /** \brief Holds one run-length encoded slice of a segmentation.
+
+    Segmentation slices consist of a few labels, so runs of equal pixels are stored instead of the pixels. The runs
+    are built pixel by pixel, i.e. for every pixel type and number of components.
+
+    If a reference slice is given, e.g. the slice before an edit, only the bounding box of the pixels that differ from
+    it is stored. Such a slice is restored on top of a slice that equals the reference slice outside of the box, see
+    GetSlice().
+
+    SetSlice() only copies the pixels, the bounding box and the runs are computed on a separate thread. GetSlice() waits
+    for it to finish, GetMemorySize() does not.
+  */
+  class MITKSEGMENTATION_EXPORT CompressedSliceContainer : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(CompressedSliceContainer, itk::Object);
+    itkFactorylessNewMacro(Self)
+
+    /** \brief Starts to encode the slice, or the region in which it differs from referenceSlice.
+      A reference slice with another size or pixel type is ignored. No pointers to the images are held.
+    */
+    void SetSlice(const Image *slice, const Image *referenceSlice = nullptr);
+
+    /** \brief True, if only the region that differs from the reference slice is stored. */
+    bool StoresChangedRegionOnly() const;
+
+    /** \brief Decodes the slice.
+      \param currentSlice provides the pixels outside of the changed region, only needed if StoresChangedRegionOnly()
+      \return the slice or nullptr, if no slice was set or currentSlice is missing or does not match
+    */
+    Image::Pointer GetSlice(const Image *currentSlice = nullptr);
+
+    /** \brief True, if the slice is encoded, i.e. GetMemorySize() does not change anymore. Does not wait. */
+    bool IsEncoded() const;
+
+    /** \brief Returns the number of bytes that are held, the copied pixels until the encoding is finished. Does not
+      wait for it.
+    */
+    std::size_t GetMemorySize() const;
+
+  protected:
+    CompressedSliceContainer();
+    ~CompressedSliceContainer() override;
+
+    void WaitForEncoding();
+
+    void Encode(const std::vector<unsigned char> &referencePixels);
+
+    std::future<void> m_Encoding;
+    // capacity of the copied pixels, m_Data is written by the encoding thread
+    std::size_t m_CopiedSize;
+
+    PixelType *m_PixelType;
+    unsigned int m_Dimension;
+    std::vector<unsigned int> m_Dimensions;
+    BaseGeometry::Pointer m_Geometry;
+
+    // width of a row in pixels and number of rows
+    unsigned int m_Width;
+    unsigned int m_Height;
+    unsigned int m_PixelSize;
+
+    bool m_StoresChangedRegionOnly;
+    bool m_IsRunLengthEncoded;
+    // changed region [begin, end) in pixels
+    unsigned int m_RegionBegin[2];
+    unsigned int m_RegionEnd[2];
+
+    // the raw pixels until they are encoded, afterwards the runs as pairs of a 32 bit length and a pixel or, if
+    // these need more memory, the pixels of the region
+    std::vector<unsigned char> m_Data;
+  };
+}
+#endif
@@ -16,14 +16,16 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDiffSliceOperation.h"
 
+#include <mitkExtractSliceFilter.h>
 #include <mitkImage.h>
+#include <mitkVtkImageOverwrite.h>
 
 #include <itkCommand.h>
 
 mitk::DiffSliceOperation::DiffSliceOperation() : Operation(1)
 {
   m_TimeStep = 0;
-  m_zlibSliceContainer = nullptr;
+  m_SliceContainer = nullptr;
   m_Image = nullptr;
   m_WorldGeometry = nullptr;
   m_SliceGeometry = nullptr;
@@ -37,6 +39,27 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
                                              BaseGeometry *currentWorldGeometry)
   : Operation(1)
 
+{
+  this->Initialize(imageVolume, slice, nullptr, sliceGeometry, timestep, currentWorldGeometry);
+}
+
+mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
+                                             Image *slice,
+                                             Image *referenceSlice,
+                                             SlicedGeometry3D *sliceGeometry,
+                                             unsigned int timestep,
+                                             BaseGeometry *currentWorldGeometry)
+  : Operation(1)
+{
+  this->Initialize(imageVolume, slice, referenceSlice, sliceGeometry, timestep, currentWorldGeometry);
+}
+
+void mitk::DiffSliceOperation::Initialize(mitk::Image *imageVolume,
+                                          Image *slice,
+                                          Image *referenceSlice,
+                                          SlicedGeometry3D *sliceGeometry,
+                                          unsigned int timestep,
+                                          BaseGeometry *currentWorldGeometry)
 {
   m_WorldGeometry = currentWorldGeometry->Clone();
 
@@ -51,8 +74,8 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
 
   m_TimeStep = timestep;
 
-  m_zlibSliceContainer = CompressedImageContainer::New();
-  m_zlibSliceContainer->SetImage(slice);
+  m_SliceContainer = CompressedSliceContainer::New();
+  m_SliceContainer->SetSlice(slice, referenceSlice);
 
   m_Image = imageVolume;
 
@@ -74,7 +97,7 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
 mitk::DiffSliceOperation::~DiffSliceOperation()
 {
   m_WorldGeometry = nullptr;
-  m_zlibSliceContainer = nullptr;
+  m_SliceContainer = nullptr;
 
   if (m_ImageIsValid)
   {
@@ -86,13 +109,40 @@ mitk::DiffSliceOperation::~DiffSliceOperation()
 
 mitk::Image::Pointer mitk::DiffSliceOperation::GetSlice()
 {
-  Image::Pointer image = m_zlibSliceContainer->GetImage();
-  return image;
+  if (!m_SliceContainer->StoresChangedRegionOnly())
+    return m_SliceContainer->GetSlice();
+
+  // the region outside of the stored one is taken from the volume, it is extracted with the same algorithm that
+  // overwrites the slice
+  vtkSmartPointer<mitkVtkImageOverwrite> reslice = vtkSmartPointer<mitkVtkImageOverwrite>::New();
+  reslice->SetOverwriteMode(false);
+  reslice->Modified();
+
+  mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New(reslice);
+  extractor->SetInput(m_Image);
+  extractor->SetTimeStep(m_TimeStep);
+  extractor->SetWorldGeometry(dynamic_cast<PlaneGeometry *>(m_WorldGeometry.GetPointer()));
+  extractor->SetVtkOutputRequest(false);
+  extractor->SetResliceTransformByGeometry(m_Image->GetTimeGeometry()->GetGeometryForTimeStep(m_TimeStep));
+  extractor->Modified();
+  extractor->Update();
+
+  return m_SliceContainer->GetSlice(extractor->GetOutput());
+}
+
+std::size_t mitk::DiffSliceOperation::GetMemorySize()
+{
+  return m_SliceContainer.IsNotNull() ? m_SliceContainer->GetMemorySize() : 0;
+}
+
+bool mitk::DiffSliceOperation::IsMemorySizeFinal()
+{
+  return m_SliceContainer.IsNull() || m_SliceContainer->IsEncoded();
 }
 
 bool mitk::DiffSliceOperation::IsValid()
 {
-  return m_ImageIsValid && m_zlibSliceContainer.IsNotNull() && (m_WorldGeometry.IsNotNull()); // TODO improve
+  return m_ImageIsValid && m_SliceContainer.IsNotNull() && (m_WorldGeometry.IsNotNull()); // TODO improve
 }
 
 void mitk::DiffSliceOperation::OnImageDeleted()
@@ -17,7 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #ifndef mitkDiffSliceOperation_h_Included
 #define mitkDiffSliceOperation_h_Included
 
-#include "mitkCompressedImageContainer.h"
+#include "mitkCompressedSliceContainer.h"
 #include <MitkSegmentationExports.h>
 #include <mitkOperation.h>
 
@@ -38,6 +38,11 @@ namespace mitk
      currentWorldGeometry   specifies the axis where the slice has to be applied in the volume.
 
     This Operation can be used to realize undo-redo functionality for e.g. segmentation purposes.
+
+    The slice is run-length encoded on a separate thread. If a reference slice is given, e.g. the slice before an
+    edit for the redo operation and the edited slice for the undo operation, only the region in which both differ is
+    stored. GetSlice() then completes the slice with the current slice of the volume, which is correct as long as the
+    operations are applied in the order of the undo stack.
   */
   class MITKSEGMENTATION_EXPORT DiffSliceOperation : public Operation
   {
@@ -61,6 +66,14 @@ namespace mitk
                        unsigned int timestep,
                        BaseGeometry *currentWorldGeometry);
 
+    /** \brief Only stores the region in which slice differs from referenceSlice. */
+    DiffSliceOperation(mitk::Image *imageVolume,
+                       mitk::Image *slice,
+                       mitk::Image *referenceSlice,
+                       SlicedGeometry3D *sliceGeometry,
+                       unsigned int timestep,
+                       BaseGeometry *currentWorldGeometry);
+
     /** \brief Check if it is a valid operation.*/
     bool IsValid();
 
@@ -73,6 +86,12 @@ namespace mitk
     /** \brief Get the slice that is applied in the operation.*/
     Image::Pointer GetSlice();
 
+    /** \brief Returns the number of bytes of the stored slice.*/
+    std::size_t GetMemorySize() override;
+
+    /** \brief False, while the stored slice is encoded.*/
+    bool IsMemorySizeFinal() override;
+
     /** \brief Get timeStep.*/
     void SetTimeStep(unsigned int timestep) { this->m_TimeStep = timestep; }
     /** \brief Set timeStep*/
@@ -91,7 +110,14 @@ namespace mitk
     /** \brief Callback for image observer.*/
     void OnImageDeleted();
 
-    CompressedImageContainer::Pointer m_zlibSliceContainer;
+    void Initialize(mitk::Image *imageVolume,
+                    mitk::Image *slice,
+                    mitk::Image *referenceSlice,
+                    SlicedGeometry3D *sliceGeometry,
+                    unsigned int timestep,
+                    BaseGeometry *currentWorldGeometry);
+
+    CompressedSliceContainer::Pointer m_SliceContainer;
 
     mitk::Image *m_Image;
 
@@ -18,8 +18,97 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkManualSegmentationToSurfaceFilter.h"
 #include "mitkVtkRepresentationProperty.h"
 #include <mitkCoreObjectFactory.h>
+#include <mitkGeometry3D.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkProportionalTimeGeometry.h>
 
 #include <vtkPolyDataNormals.h>
+#include <vtkSmartPointer.h>
+#include <vtkWindowedSincPolyDataFilter.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <thread>
+
+namespace
+{
+  struct LabelRegion
+  {
+    mitk::Label::PixelType Value;
+    unsigned int Begin[3];
+    unsigned int End[3];
+  };
+
+  std::size_t GetNumberOfPixels(const LabelRegion &region)
+  {
+    return static_cast<std::size_t>(region.End[0] - region.Begin[0]) * (region.End[1] - region.Begin[1]) *
+           (region.End[2] - region.Begin[2]);
+  }
+
+  // Creates an image of zeros and ones of the given region of one label, for all time steps
+  mitk::Image::Pointer CreateLabelImage(const mitk::Image *image,
+                                        const mitk::Label::PixelType *pixels,
+                                        const LabelRegion &region)
+  {
+    const unsigned int *dimensions = image->GetDimensions();
+    const unsigned int numberOfTimeSteps = image->GetTimeSteps();
+
+    mitk::BaseGeometry::BoundsArrayType bounds;
+    mitk::Point3D origin;
+    unsigned int labelDimensions[4];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      labelDimensions[i] = region.End[i] - region.Begin[i];
+      bounds[2 * i] = 0;
+      bounds[2 * i + 1] = labelDimensions[i];
+      origin[i] = region.Begin[i];
+    }
+    labelDimensions[3] = numberOfTimeSteps;
+    image->GetGeometry()->IndexToWorld(origin, origin);
+
+    mitk::Geometry3D::Pointer geometry = mitk::Geometry3D::New();
+    geometry->SetIndexToWorldTransform(image->GetGeometry()->GetIndexToWorldTransform()->Clone());
+    geometry->SetBounds(bounds);
+    geometry->SetOrigin(origin);
+    geometry->ImageGeometryOn();
+
+    mitk::Image::Pointer labelImage = mitk::Image::New();
+    labelImage->Initialize(mitk::MakeScalarPixelType<unsigned char>(), image->GetDimension(), labelDimensions);
+    labelImage->SetGeometry(geometry);
+
+    // SetGeometry() leaves a single time step
+    mitk::ProportionalTimeGeometry::Pointer timeGeometry = mitk::ProportionalTimeGeometry::New();
+    timeGeometry->Initialize(labelImage->GetSlicedGeometry(), numberOfTimeSteps);
+    auto *imageTimeGeometry = dynamic_cast<const mitk::ProportionalTimeGeometry *>(image->GetTimeGeometry());
+    if (imageTimeGeometry)
+    {
+      timeGeometry->SetFirstTimePoint(imageTimeGeometry->GetFirstTimePoint());
+      timeGeometry->SetStepDuration(imageTimeGeometry->GetStepDuration());
+    }
+    labelImage->SetTimeGeometry(timeGeometry);
+
+    mitk::ImageWriteAccessor accessor(labelImage);
+    auto *labelPixels = static_cast<unsigned char *>(accessor.GetData());
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+    {
+      for (unsigned int z = region.Begin[2]; z < region.End[2]; ++z)
+      {
+        for (unsigned int y = region.Begin[1]; y < region.End[1]; ++y)
+        {
+          const mitk::Label::PixelType *row =
+            pixels + ((static_cast<std::size_t>(t) * dimensions[2] + z) * dimensions[1] + y) * dimensions[0];
+          for (unsigned int x = 0; x < labelDimensions[0]; ++x)
+            *labelPixels++ = row[region.Begin[0] + x] == region.Value ? 1 : 0;
+        }
+      }
+    }
+
+    return labelImage;
+  }
+}
 
 namespace mitk
 {
@@ -44,6 +133,8 @@ namespace mitk
     SetParameter("Decimate mesh", true);
     SetParameter("Decimation rate", 0.8f);
     SetParameter("Wireframe", false);
+    SetParameter("Per label", false);
+    SetParameter("Windowed sinc smoothing", false);
   }
 
   bool ShowSegmentationAsSurface::ReadyToRun()
@@ -66,55 +157,82 @@ namespace mitk
     Image::Pointer image;
     GetPointerParameter("Input", image);
 
-    bool smooth(true);
-    GetParameter("Smooth", smooth);
+    SurfaceParameters parameters;
+
+    parameters.Smooth = true;
+    GetParameter("Smooth", parameters.Smooth);
+
+    parameters.ApplyMedian = true;
+    GetParameter("Apply median", parameters.ApplyMedian);
 
-    bool applyMedian(true);
-    GetParameter("Apply median", applyMedian);
+    parameters.DecimateMesh = true;
+    GetParameter("Decimate mesh", parameters.DecimateMesh);
 
-    bool decimateMesh(true);
-    GetParameter("Decimate mesh", decimateMesh);
+    parameters.MedianKernelSize = 3;
+    GetParameter("Median kernel size", parameters.MedianKernelSize);
 
-    unsigned int medianKernelSize(3);
-    GetParameter("Median kernel size", medianKernelSize);
+    parameters.GaussianSD = 1.5;
+    GetParameter("Gaussian SD", parameters.GaussianSD);
+
+    parameters.ReductionRate = 0.8;
+    GetParameter("Decimation rate", parameters.ReductionRate);
+
+    parameters.WindowedSincSmoothing = false;
+    GetParameter("Windowed sinc smoothing", parameters.WindowedSincSmoothing);
+
+    bool perLabel(false);
+    GetParameter("Per label", perLabel);
+
+    MITK_INFO << "Creating polygon model with smoothing " << parameters.Smooth << " gaussianSD " << parameters.GaussianSD
+              << " median " << parameters.ApplyMedian << " median kernel " << parameters.MedianKernelSize
+              << " mesh reduction " << parameters.DecimateMesh << " reductionRate " << parameters.ReductionRate
+              << " windowed sinc " << parameters.WindowedSincSmoothing << " per label " << perLabel;
+
+    // fix to avoid vtk warnings see bug #5390
+    if (image->GetDimension() > 3)
+      parameters.DecimateMesh = false;
 
-    float gaussianSD(1.5);
-    GetParameter("Gaussian SD", gaussianSD);
+    m_LabelSurfaces.clear();
 
-    float reductionRate(0.8);
-    GetParameter("Decimation rate", reductionRate);
+    auto *labelSetImage = dynamic_cast<LabelSetImage *>(image.GetPointer());
+    if (perLabel && labelSetImage)
+    {
+      this->CreateLabelSurfaces(labelSetImage, parameters);
+    }
+    else
+    {
+      m_Surface = this->CreateSurface(image, parameters);
+    }
 
-    MITK_INFO << "Creating polygon model with smoothing " << smooth << " gaussianSD " << gaussianSD << " median "
-              << applyMedian << " median kernel " << medianKernelSize << " mesh reduction " << decimateMesh
-              << " reductionRate " << reductionRate;
+    return true;
+  }
 
+  Surface::Pointer ShowSegmentationAsSurface::CreateSurface(Image *image, const SurfaceParameters &parameters)
+  {
     ManualSegmentationToSurfaceFilter::Pointer surfaceFilter = ManualSegmentationToSurfaceFilter::New();
     surfaceFilter->SetInput(image);
     surfaceFilter->SetThreshold(0.5); // expects binary image with zeros and ones
 
-    surfaceFilter->SetUseGaussianImageSmooth(smooth); // apply gaussian to thresholded image ?
-    surfaceFilter->SetSmooth(smooth);
-    if (smooth)
+    surfaceFilter->SetUseGaussianImageSmooth(parameters.Smooth); // apply gaussian to thresholded image ?
+    surfaceFilter->SetSmooth(parameters.Smooth);
+    if (parameters.Smooth)
     {
       surfaceFilter->InterpolationOn();
-      surfaceFilter->SetGaussianStandardDeviation(gaussianSD);
+      surfaceFilter->SetGaussianStandardDeviation(parameters.GaussianSD);
     }
 
-    surfaceFilter->SetMedianFilter3D(applyMedian); // apply median to segmentation before marching cubes ?
-    if (applyMedian)
+    surfaceFilter->SetMedianFilter3D(parameters.ApplyMedian); // apply median to segmentation before marching cubes ?
+    if (parameters.ApplyMedian)
     {
+      // apply median to segmentation before marching cubes
       surfaceFilter->SetMedianKernelSize(
-        medianKernelSize, medianKernelSize, medianKernelSize); // apply median to segmentation before marching cubes
+        parameters.MedianKernelSize, parameters.MedianKernelSize, parameters.MedianKernelSize);
     }
 
-    // fix to avoid vtk warnings see bug #5390
-    if (image->GetDimension() > 3)
-      decimateMesh = false;
-
-    if (decimateMesh)
+    if (parameters.DecimateMesh)
     {
       surfaceFilter->SetDecimate(ImageToSurfaceFilter::QuadricDecimation);
-      surfaceFilter->SetTargetReduction(reductionRate);
+      surfaceFilter->SetTargetReduction(parameters.ReductionRate);
     }
     else
     {
@@ -124,9 +242,9 @@ namespace mitk
     surfaceFilter->UpdateLargestPossibleRegion();
 
     // calculate normals for nicer display
-    m_Surface = surfaceFilter->GetOutput();
+    Surface::Pointer surface = surfaceFilter->GetOutput();
 
-    vtkPolyData *polyData = m_Surface->GetVtkPolyData();
+    vtkSmartPointer<vtkPolyData> polyData = surface->GetVtkPolyData();
 
     if (!polyData)
       throw std::logic_error("Could not create polygon model");
@@ -134,7 +252,22 @@ namespace mitk
     polyData->SetVerts(nullptr);
     polyData->SetLines(nullptr);
 
-    if (smooth || applyMedian || decimateMesh)
+    if (parameters.WindowedSincSmoothing && polyData->GetNumberOfPoints() > 0)
+    {
+      vtkSmartPointer<vtkWindowedSincPolyDataFilter> smoother = vtkSmartPointer<vtkWindowedSincPolyDataFilter>::New();
+      smoother->SetInputData(polyData);
+      smoother->SetNumberOfIterations(20);
+      smoother->SetPassBand(0.01);
+      smoother->BoundarySmoothingOff();
+      smoother->FeatureEdgeSmoothingOff();
+      smoother->NonManifoldSmoothingOn();
+      smoother->NormalizeCoordinatesOn();
+      smoother->Update();
+
+      polyData = smoother->GetOutput();
+    }
+
+    if (parameters.Smooth || parameters.ApplyMedian || parameters.DecimateMesh || parameters.WindowedSincSmoothing)
     {
       vtkPolyDataNormals *normalsGen = vtkPolyDataNormals::New();
 
@@ -143,36 +276,167 @@ namespace mitk
       normalsGen->SetInputData(polyData);
       normalsGen->Update();
 
-      m_Surface->SetVtkPolyData(normalsGen->GetOutput());
+      surface->SetVtkPolyData(normalsGen->GetOutput());
 
       normalsGen->Delete();
     }
     else
     {
-      m_Surface->SetVtkPolyData(polyData);
+      surface->SetVtkPolyData(polyData);
     }
 
-    return true;
+    surface->DisconnectPipeline();
+
+    return surface;
   }
 
-  void ShowSegmentationAsSurface::ThreadedUpdateSuccessful()
+  void ShowSegmentationAsSurface::CreateLabelSurfaces(LabelSetImage *image, const SurfaceParameters &parameters)
   {
-    m_Node = DataNode::New();
+    if (image->GetPixelType() != MakeScalarPixelType<Label::PixelType>())
+      mitkThrow() << "Unexpected pixel type of the label set image.";
+
+    std::vector<LabelRegion> regions;
+    const LabelSet *labelSet = image->GetLabelSet(image->GetActiveLayer());
+    const Label::PixelType exteriorValue = image->GetExteriorLabel()->GetValue();
+    Label::PixelType maximumValue = 0;
+    for (auto iter = labelSet->IteratorConstBegin(); iter != labelSet->IteratorConstEnd(); ++iter)
+    {
+      if (iter->first != exteriorValue)
+        maximumValue = std::max(maximumValue, iter->first);
+    }
+
+    // bounding boxes of all labels in one pass over the image, for all time steps
+    const unsigned int *dimensions = image->GetDimensions();
+    const unsigned int numberOfTimeSteps = image->GetTimeSteps();
+
+    std::vector<LabelRegion> boxes(static_cast<std::size_t>(maximumValue) + 1);
+    for (auto &box : boxes)
+    {
+      std::copy(dimensions, dimensions + 3, box.Begin);
+      std::fill(box.End, box.End + 3, 0);
+    }
+
+    ImageReadAccessor accessor(image);
+    const auto *pixels = static_cast<const Label::PixelType *>(accessor.GetData());
+    const Label::PixelType *pixel = pixels;
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+    {
+      for (unsigned int z = 0; z < dimensions[2]; ++z)
+      {
+        for (unsigned int y = 0; y < dimensions[1]; ++y)
+        {
+          for (unsigned int x = 0; x < dimensions[0]; ++x, ++pixel)
+          {
+            if (*pixel > maximumValue || *pixel == exteriorValue)
+              continue;
+
+            LabelRegion &box = boxes[*pixel];
+            box.Begin[0] = std::min(box.Begin[0], x);
+            box.Begin[1] = std::min(box.Begin[1], y);
+            box.Begin[2] = std::min(box.Begin[2], z);
+            box.End[0] = std::max(box.End[0], x + 1);
+            box.End[1] = std::max(box.End[1], y + 1);
+            box.End[2] = std::max(box.End[2], z + 1);
+          }
+        }
+      }
+    }
+
+    // the median and gaussian kernels as well as the marching cubes need background around the label
+    const unsigned int margin = 2 + (parameters.ApplyMedian ? parameters.MedianKernelSize / 2 : 0) +
+                                (parameters.Smooth ? static_cast<unsigned int>(std::ceil(parameters.GaussianSD)) : 0);
+
+    for (auto iter = labelSet->IteratorConstBegin(); iter != labelSet->IteratorConstEnd(); ++iter)
+    {
+      if (iter->first == exteriorValue || boxes[iter->first].End[0] == 0)
+        continue;
+
+      LabelRegion region = boxes[iter->first];
+      region.Value = iter->first;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        region.Begin[i] = region.Begin[i] > margin ? region.Begin[i] - margin : 0;
+        region.End[i] = std::min(region.End[i] + margin, dimensions[i]);
+      }
+      regions.push_back(region);
+    }
+
+    // start with the largest labels to balance the load of the threads
+    std::sort(regions.begin(), regions.end(), [](const LabelRegion &a, const LabelRegion &b) {
+      return GetNumberOfPixels(a) > GetNumberOfPixels(b);
+    });
+
+    std::vector<Surface::Pointer> surfaces(regions.size());
+    std::atomic<std::size_t> nextRegion(0);
+    auto createSurfaces = [&]() {
+      for (std::size_t i = nextRegion++; i < regions.size(); i = nextRegion++)
+      {
+        Image::Pointer labelImage = CreateLabelImage(image, pixels, regions[i]);
+        surfaces[i] = this->CreateSurface(labelImage, parameters);
+      }
+    };
+
+    const std::size_t numberOfThreads =
+      std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), regions.size());
+    std::vector<std::future<void>> threads;
+    for (std::size_t i = 1; i < numberOfThreads; ++i)
+      threads.push_back(std::async(std::launch::async, createSurfaces));
+
+    createSurfaces();
+    for (auto &thread : threads)
+      thread.get();
+
+    for (std::size_t i = 0; i < regions.size(); ++i)
+    {
+      if (surfaces[i]->GetVtkPolyData()->GetNumberOfPoints() > 0)
+        m_LabelSurfaces.emplace_back(regions[i].Value, surfaces[i]);
+    }
+  }
+
+  DataNode::Pointer ShowSegmentationAsSurface::CreateSurfaceNode(Surface *surface)
+  {
+    DataNode::Pointer node = DataNode::New();
 
     bool wireframe(false);
     GetParameter("Wireframe", wireframe);
     if (wireframe)
     {
       auto *np =
-        dynamic_cast<VtkRepresentationProperty *>(m_Node->GetProperty("material.representation"));
+        dynamic_cast<VtkRepresentationProperty *>(node->GetProperty("material.representation"));
       if (np)
         np->SetRepresentationToWireframe();
     }
 
-    m_Node->SetProperty("opacity", FloatProperty::New(0.3));
-    m_Node->SetProperty("line width", IntProperty::New(1));
-    m_Node->SetProperty("scalar visibility", BoolProperty::New(false));
+    node->SetProperty("opacity", FloatProperty::New(0.3));
+    node->SetProperty("line width", IntProperty::New(1));
+    node->SetProperty("scalar visibility", BoolProperty::New(false));
+
+    node->SetData(surface);
+
+    bool showResult(true);
+    GetParameter("Show result", showResult);
 
+    bool syncVisibility(false);
+    GetParameter("Sync visibility", syncVisibility);
+
+    Image::Pointer image;
+    GetPointerParameter("Input", image);
+
+    BaseProperty *organTypeProp = image->GetProperty("organ type");
+    if (organTypeProp)
+      surface->SetProperty("organ type", organTypeProp);
+
+    BaseProperty *visibleProp = GetGroupNode()->GetProperty("visible");
+    if (visibleProp && syncVisibility)
+      node->ReplaceProperty("visible", visibleProp->Clone());
+    else
+      node->SetProperty("visible", BoolProperty::New(showResult));
+
+    return node;
+  }
+
+  void ShowSegmentationAsSurface::ThreadedUpdateSuccessful()
+  {
     std::string groupNodesName("surface");
 
     DataNode *groupNode = GetGroupNode();
@@ -185,39 +449,45 @@ namespace mitk
       if (smooth)
         groupNodesName.append("_smoothed");
     }
+
+    Image::Pointer image;
+    GetPointerParameter("Input", image);
+    auto *labelSetImage = dynamic_cast<LabelSetImage *>(image.GetPointer());
+
+    if (!m_LabelSurfaces.empty() && labelSetImage)
+    {
+      for (const auto &labelSurface : m_LabelSurfaces)
+      {
+        // the label may have been removed meanwhile
+        Label *label = labelSetImage->GetLabel(labelSurface.first, labelSetImage->GetActiveLayer());
+        if (!label)
+          continue;
+
+        m_Node = this->CreateSurfaceNode(labelSurface.second);
+        m_Node->SetProperty("name", StringProperty::New(groupNodesName + "_" + label->GetName()));
+        m_Node->SetProperty("color", ColorProperty::New(label->GetColor()));
+
+        InsertBelowGroupNode(m_Node);
+      }
+
+      m_LabelSurfaces.clear();
+      Superclass::ThreadedUpdateSuccessful();
+      return;
+    }
+
+    m_Node = this->CreateSurfaceNode(m_Surface);
     m_Node->SetProperty("name", StringProperty::New(groupNodesName));
 
     // synchronize this object's color with the parent's color
     // surfaceNode->SetProperty( "color", parentNode->GetProperty( "color" ) );
     // surfaceNode->SetProperty( "visible", parentNode->GetProperty( "visible" ) );
 
-    m_Node->SetData(m_Surface);
-
     BaseProperty *colorProp = groupNode->GetProperty("color");
     if (colorProp)
       m_Node->ReplaceProperty("color", colorProp->Clone());
     else
       m_Node->SetProperty("color", ColorProperty::New(1.0, 1.0, 0.0));
 
-    bool showResult(true);
-    GetParameter("Show result", showResult);
-
-    bool syncVisibility(false);
-    GetParameter("Sync visibility", syncVisibility);
-
-    Image::Pointer image;
-    GetPointerParameter("Input", image);
-
-    BaseProperty *organTypeProp = image->GetProperty("organ type");
-    if (organTypeProp)
-      m_Surface->SetProperty("organ type", organTypeProp);
-
-    BaseProperty *visibleProp = groupNode->GetProperty("visible");
-    if (visibleProp && syncVisibility)
-      m_Node->ReplaceProperty("visible", visibleProp->Clone());
-    else
-      m_Node->SetProperty("visible", BoolProperty::New(showResult));
-
     InsertBelowGroupNode(m_Node);
 
     Superclass::ThreadedUpdateSuccessful();
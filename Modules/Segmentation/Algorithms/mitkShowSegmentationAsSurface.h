@@ -17,13 +17,24 @@ See LICENSE.txt or http://www.mitk.org for details.
 #ifndef MITK_SHOW_SEGMENTATION_AS_SURFACE_H_INCLUDET_WAD
 #define MITK_SHOW_SEGMENTATION_AS_SURFACE_H_INCLUDET_WAD
 
+#include "mitkLabelSetImage.h"
 #include "mitkSegmentationSink.h"
 #include "mitkSurface.h"
 #include "mitkUIDGenerator.h"
 #include <MitkSegmentationExports.h>
 
+#include <utility>
+#include <vector>
+
 namespace mitk
 {
+  /** \brief Creates a surface from a segmentation and adds it below the segmentation node.
+
+    If the parameter "Per label" is set and the input is a LabelSetImage, one surface is created for each label of the
+    active layer. Each label is cropped to its bounding box and the labels are processed concurrently.
+
+    The parameter "Windowed sinc smoothing" additionally smooths the meshes by a vtkWindowedSincPolyDataFilter.
+  */
   class MITKSEGMENTATION_EXPORT ShowSegmentationAsSurface : public SegmentationSink
   {
   public:
@@ -41,11 +52,31 @@ namespace mitk
     virtual void ThreadedUpdateSuccessful() override; // will be called from a thread after calling StartAlgorithm
 
   private:
+    struct SurfaceParameters
+    {
+      bool Smooth;
+      bool ApplyMedian;
+      bool DecimateMesh;
+      bool WindowedSincSmoothing;
+      unsigned int MedianKernelSize;
+      float GaussianSD;
+      float ReductionRate;
+    };
+
+    /** \brief Creates a surface by ManualSegmentationToSurfaceFilter from a binary image of zeros and ones. */
+    Surface::Pointer CreateSurface(Image *image, const SurfaceParameters &parameters);
+
+    /** \brief Crops every label to its bounding box and creates the surfaces of all labels concurrently. */
+    void CreateLabelSurfaces(LabelSetImage *image, const SurfaceParameters &parameters);
+
+    DataNode::Pointer CreateSurfaceNode(Surface *surface);
+
     UIDGenerator m_UIDGeneratorSurfaces;
 
     Surface::Pointer m_Surface;
     DataNode::Pointer m_Node;
 
+    std::vector<std::pair<Label::PixelType, Surface::Pointer>> m_LabelSurfaces;
   };
 
 } // namespace
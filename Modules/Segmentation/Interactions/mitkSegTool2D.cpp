@@ -373,14 +373,8 @@ void mitk::SegTool2D::WriteSliceToVolume(mitk::SegTool2D::SliceInformation slice
   auto *image = dynamic_cast<Image *>(workingNode->GetData());
 
   /*============= BEGIN undo/redo feature block ========================*/
-  // Create undo operation by caching the not yet modified slices
+  // Cache the not yet modified slice for the undo operation
   mitk::Image::Pointer originalSlice = GetAffectedImageSliceAs2DImage(sliceInfo.plane, image, sliceInfo.timestep);
-  auto *undoOperation =
-    new DiffSliceOperation(const_cast<mitk::Image *>(image),
-                           originalSlice,
-                           dynamic_cast<SlicedGeometry3D *>(originalSlice->GetGeometry()),
-                           sliceInfo.timestep,
-                           sliceInfo.plane);
   /*============= END undo/redo feature block ========================*/
 
   // Make sure that for reslicing and overwriting the same alogrithm is used. We can specify the mode of the vtk
@@ -409,10 +403,20 @@ void mitk::SegTool2D::WriteSliceToVolume(mitk::SegTool2D::SliceInformation slice
   image->GetVtkImageData()->Modified();
 
   /*============= BEGIN undo/redo feature block ========================*/
-  // specify the undo operation with the edited slice
+  // specify the undo and redo operation, both only store the region in which the edited slice differs from the
+  // original one
+  mitk::Image::Pointer editedSlice = extractor->GetOutput();
+  auto *undoOperation =
+    new DiffSliceOperation(const_cast<mitk::Image *>(image),
+                           originalSlice,
+                           editedSlice,
+                           dynamic_cast<SlicedGeometry3D *>(originalSlice->GetGeometry()),
+                           sliceInfo.timestep,
+                           sliceInfo.plane);
   auto *doOperation =
     new DiffSliceOperation(image,
-                           extractor->GetOutput(),
+                           editedSlice,
+                           originalSlice,
                            dynamic_cast<SlicedGeometry3D *>(sliceInfo.slice->GetGeometry()),
                            sliceInfo.timestep,
                            sliceInfo.plane);
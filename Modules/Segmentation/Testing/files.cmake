@@ -1,4 +1,5 @@
 set(MODULE_TESTS
+  mitkCompressedSliceContainerTest.cpp
   mitkContourMapper2DTest.cpp
   mitkContourTest.cpp
   mitkContourModelSetToImageFilterTest.cpp
@@ -11,6 +12,7 @@ set(MODULE_TESTS
 #  mitkToolManagerTest.cpp
   mitkToolManagerProviderTest.cpp
   mitkManualSegmentationToSurfaceFilterTest.cpp #new cpp unit style
+  mitkShowSegmentationAsSurfaceTest.cpp
 )
 
 if(MITK_ENABLE_RENDERING_TESTING) #since mitkInteractionTestHelper is currently creating a vtkRenderWindow
@@ -0,0 +1,246 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// Testing
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// other
+#include <mitkCompressedSliceContainer.h>
+#include <mitkDiffSliceOperation.h>
+#include <mitkDiffSliceOperationApplier.h>
+#include <mitkExtractSliceFilter.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <itkRGBPixel.h>
+
+#include <cstring>
+#include <memory>
+#include <random>
+
+class mitkCompressedSliceContainerTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkCompressedSliceContainerTestSuite);
+  MITK_TEST(GetSlice_UnchangedSlice_StoresNoPixels);
+  MITK_TEST(GetSlice_SinglePixelChanged_NeedsCurrentSlice);
+  MITK_TEST(GetSlice_RunsAcrossRows_ReturnsSlice);
+  MITK_TEST(GetSlice_Noise_IsStoredRaw);
+  MITK_TEST(GetSlice_ShortPixels_ReturnsSlice);
+  MITK_TEST(GetSlice_RGBPixels_ReturnsSlice);
+  MITK_TEST(ExecuteOperation_UndoAndRedo_RestoresSlices);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  static const unsigned int Width = 100;
+  static const unsigned int Height = 100;
+
+  mitk::Image::Pointer CreateSlice(const mitk::PixelType &pixelType)
+  {
+    unsigned int dimensions[2] = {Width, Height};
+    mitk::Image::Pointer slice = mitk::Image::New();
+    slice->Initialize(pixelType, 2, dimensions);
+
+    mitk::ImageWriteAccessor accessor(slice);
+    std::memset(accessor.GetData(), 0, this->GetNumberOfBytes(slice));
+    return slice;
+  }
+
+  std::size_t GetNumberOfBytes(const mitk::Image *image)
+  {
+    std::size_t numberOfBytes = image->GetPixelType().GetSize();
+    for (unsigned int i = 0; i < image->GetDimension(); ++i)
+      numberOfBytes *= image->GetDimension(i);
+    return numberOfBytes;
+  }
+
+  // Sets the pixels [begin, end) in row-major order, the components of a pixel get value, value + 1, ...
+  void FillPixels(mitk::Image *image, std::size_t begin, std::size_t end, unsigned char value)
+  {
+    const std::size_t pixelSize = image->GetPixelType().GetSize();
+    mitk::ImageWriteAccessor accessor(image);
+    auto *pixels = static_cast<unsigned char *>(accessor.GetData());
+    for (std::size_t i = begin * pixelSize; i < end * pixelSize; ++i)
+      pixels[i] = static_cast<unsigned char>(value + i % pixelSize);
+  }
+
+  void AssertEqualPixels(const std::string &message, mitk::Image *expected, mitk::Image *actual)
+  {
+    CPPUNIT_ASSERT_MESSAGE(message + ": slice is restored", actual != nullptr);
+    CPPUNIT_ASSERT_MESSAGE(message + ": pixel type", expected->GetPixelType() == actual->GetPixelType());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(message + ": size", this->GetNumberOfBytes(expected), this->GetNumberOfBytes(actual));
+
+    mitk::ImageReadAccessor expectedAccessor(expected);
+    mitk::ImageReadAccessor actualAccessor(actual);
+    CPPUNIT_ASSERT_MESSAGE(
+      message + ": pixels",
+      std::memcmp(expectedAccessor.GetData(), actualAccessor.GetData(), this->GetNumberOfBytes(expected)) == 0);
+  }
+
+  // Edits a slice with a few labels and checks that it is restored from the changed region
+  void TestChangedRegion(const mitk::PixelType &pixelType)
+  {
+    mitk::Image::Pointer originalSlice = this->CreateSlice(pixelType);
+    this->FillPixels(originalSlice, 20 * Width, 40 * Width, 1);
+
+    mitk::Image::Pointer editedSlice = originalSlice->Clone();
+    for (unsigned int y = 30; y < 50; ++y)
+      this->FillPixels(editedSlice, y * Width + 10, y * Width + 60, 2);
+
+    mitk::CompressedSliceContainer::Pointer container = mitk::CompressedSliceContainer::New();
+    container->SetSlice(editedSlice, originalSlice);
+    CPPUNIT_ASSERT(container->StoresChangedRegionOnly());
+    this->AssertEqualPixels("Edited slice", editedSlice, container->GetSlice(originalSlice));
+    CPPUNIT_ASSERT_MESSAGE("GetSlice() waits for the encoding", container->IsEncoded());
+    CPPUNIT_ASSERT_MESSAGE("The changed region is smaller than the slice",
+                           container->GetMemorySize() <
+                             sizeof(mitk::CompressedSliceContainer) + this->GetNumberOfBytes(editedSlice) / 4);
+  }
+
+  mitk::Image::Pointer ExtractSlice(mitk::Image *volume, mitk::PlaneGeometry *plane)
+  {
+    mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New();
+    extractor->SetInput(volume);
+    extractor->SetWorldGeometry(plane);
+    extractor->SetResliceTransformByGeometry(volume->GetGeometry());
+    extractor->Update();
+
+    mitk::Image::Pointer slice = extractor->GetOutput();
+    slice->DisconnectPipeline();
+    return slice;
+  }
+
+public:
+  void GetSlice_UnchangedSlice_StoresNoPixels()
+  {
+    mitk::Image::Pointer slice = this->CreateSlice(mitk::MakeScalarPixelType<unsigned char>());
+    this->FillPixels(slice, 10 * Width, 20 * Width, 1);
+
+    mitk::CompressedSliceContainer::Pointer container = mitk::CompressedSliceContainer::New();
+    container->SetSlice(slice, slice->Clone());
+    CPPUNIT_ASSERT(container->StoresChangedRegionOnly());
+    this->AssertEqualPixels("Unchanged slice", slice, container->GetSlice(slice));
+    CPPUNIT_ASSERT_MESSAGE("No pixels are stored",
+                           container->GetMemorySize() < sizeof(mitk::CompressedSliceContainer) + 64);
+  }
+
+  void GetSlice_SinglePixelChanged_NeedsCurrentSlice()
+  {
+    mitk::Image::Pointer originalSlice = this->CreateSlice(mitk::MakeScalarPixelType<unsigned char>());
+    mitk::Image::Pointer editedSlice = originalSlice->Clone();
+    this->FillPixels(editedSlice, 50 * Width + 50, 50 * Width + 51, 1);
+
+    mitk::CompressedSliceContainer::Pointer container = mitk::CompressedSliceContainer::New();
+    container->SetSlice(editedSlice, originalSlice);
+    CPPUNIT_ASSERT(container->StoresChangedRegionOnly());
+    CPPUNIT_ASSERT_MESSAGE("A changed region can't be restored without the current slice",
+                           container->GetSlice().IsNull());
+    this->AssertEqualPixels("Single changed pixel", editedSlice, container->GetSlice(originalSlice));
+    CPPUNIT_ASSERT_MESSAGE("Only the changed pixel is stored",
+                           container->GetMemorySize() < sizeof(mitk::CompressedSliceContainer) + 64);
+  }
+
+  void GetSlice_RunsAcrossRows_ReturnsSlice()
+  {
+    // the changed region spans whole rows, its runs continue in the next row
+    mitk::Image::Pointer originalSlice = this->CreateSlice(mitk::MakeScalarPixelType<unsigned char>());
+    mitk::Image::Pointer editedSlice = originalSlice->Clone();
+    this->FillPixels(editedSlice, 10 * Width + 50, 12 * Width + 50, 1);
+
+    mitk::CompressedSliceContainer::Pointer container = mitk::CompressedSliceContainer::New();
+    container->SetSlice(editedSlice, originalSlice);
+    this->AssertEqualPixels("Runs across rows", editedSlice, container->GetSlice(originalSlice));
+
+    // without a reference slice the whole slice is stored
+    container->SetSlice(editedSlice);
+    CPPUNIT_ASSERT(!container->StoresChangedRegionOnly());
+    this->AssertEqualPixels("Runs across rows of the whole slice", editedSlice, container->GetSlice());
+    CPPUNIT_ASSERT_MESSAGE("The runs are smaller than the slice",
+                           container->GetMemorySize() < sizeof(mitk::CompressedSliceContainer) + 64);
+  }
+
+  void GetSlice_Noise_IsStoredRaw()
+  {
+    mitk::Image::Pointer slice = this->CreateSlice(mitk::MakeScalarPixelType<unsigned char>());
+    {
+      std::mt19937 generator(42);
+      std::uniform_int_distribution<int> distribution(0, 255);
+      mitk::ImageWriteAccessor accessor(slice);
+      auto *pixels = static_cast<unsigned char *>(accessor.GetData());
+      for (std::size_t i = 0; i < this->GetNumberOfBytes(slice); ++i)
+        pixels[i] = static_cast<unsigned char>(distribution(generator));
+    }
+
+    mitk::CompressedSliceContainer::Pointer container = mitk::CompressedSliceContainer::New();
+    container->SetSlice(slice);
+    this->AssertEqualPixels("Noise", slice, container->GetSlice());
+
+    // runs of single pixels would need five times the memory
+    CPPUNIT_ASSERT_MESSAGE("Noise is not run-length encoded",
+                           container->GetMemorySize() <
+                             sizeof(mitk::CompressedSliceContainer) + 2 * this->GetNumberOfBytes(slice));
+  }
+
+  void GetSlice_ShortPixels_ReturnsSlice() { this->TestChangedRegion(mitk::MakeScalarPixelType<short>()); }
+
+  void GetSlice_RGBPixels_ReturnsSlice()
+  {
+    this->TestChangedRegion(mitk::MakePixelType<unsigned char, itk::RGBPixel<unsigned char>, 3>());
+  }
+
+  void ExecuteOperation_UndoAndRedo_RestoresSlices()
+  {
+    unsigned int dimensions[3] = {20, 20, 20};
+    mitk::Image::Pointer volume = mitk::Image::New();
+    volume->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 3, dimensions);
+    {
+      mitk::ImageWriteAccessor accessor(volume);
+      auto *pixels = static_cast<unsigned char *>(accessor.GetData());
+      std::memset(pixels, 0, 20 * 20 * 20);
+      for (unsigned int z = 5; z < 15; ++z)
+        for (unsigned int y = 5; y < 15; ++y)
+          std::memset(pixels + (z * 20 + y) * 20 + 5, 1, 10);
+    }
+
+    mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+    plane->InitializeStandardPlane(volume->GetGeometry(), mitk::PlaneGeometry::Axial, 10, true, false);
+    mitk::Vector3D normal = plane->GetNormal();
+    normal.Normalize();
+    // pixel spacing is 1, move the plane into the center of the pixels
+    plane->SetOrigin(plane->GetOrigin() + normal * 0.5);
+
+    mitk::Image::Pointer originalSlice = this->ExtractSlice(volume, plane);
+    mitk::Image::Pointer editedSlice = originalSlice->Clone();
+    for (unsigned int y = 8; y < 12; ++y)
+      this->FillPixels(editedSlice, y * 20 + 8, y * 20 + 18, 2);
+
+    // like SegTool2D, both operations only store the changed region
+    std::unique_ptr<mitk::Operation> redoOperation(new mitk::DiffSliceOperation(
+      volume, editedSlice, originalSlice, originalSlice->GetSlicedGeometry(), 0, plane));
+    std::unique_ptr<mitk::Operation> undoOperation(new mitk::DiffSliceOperation(
+      volume, originalSlice, editedSlice, originalSlice->GetSlicedGeometry(), 0, plane));
+
+    mitk::DiffSliceOperationApplier *applier = mitk::DiffSliceOperationApplier::GetInstance();
+    applier->ExecuteOperation(redoOperation.get());
+    this->AssertEqualPixels("Edit", editedSlice, this->ExtractSlice(volume, plane));
+    applier->ExecuteOperation(undoOperation.get());
+    this->AssertEqualPixels("Undo", originalSlice, this->ExtractSlice(volume, plane));
+    applier->ExecuteOperation(redoOperation.get());
+    this->AssertEqualPixels("Redo", editedSlice, this->ExtractSlice(volume, plane));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkCompressedSliceContainer)
@@ -0,0 +1,162 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+// Testing
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// other
+#include <mitkCallbackFromGUIThread.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkLabelSetImage.h>
+#include <mitkShowSegmentationAsSurface.h>
+#include <mitkStandaloneDataStorage.h>
+#include <mitkSurface.h>
+
+#include <vtkPolyData.h>
+
+#include <map>
+
+namespace
+{
+  // Executes the commands right away, so that the nodes are inserted when StartBlockingAlgorithm() returns
+  class DirectCallbackFromGUIThread : public mitk::CallbackFromGUIThreadImplementation
+  {
+  public:
+    void CallThisFromGUIThread(itk::Command *command, itk::EventObject *event) override
+    {
+      if (event)
+      {
+        command->Execute(static_cast<const itk::Object *>(nullptr), *event);
+      }
+      else
+      {
+        const itk::NoEvent dummyEvent;
+        command->Execute(static_cast<const itk::Object *>(nullptr), dummyEvent);
+      }
+    }
+  };
+}
+
+class mitkShowSegmentationAsSurfaceTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkShowSegmentationAsSurfaceTestSuite);
+  MITK_TEST(StartBlockingAlgorithm_PerLabel_CreatesSurfaceOfEachLabel);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  struct LabelBox
+  {
+    unsigned int Begin[3];
+    unsigned int End[3];
+  };
+
+  DirectCallbackFromGUIThread m_Callback;
+  mitk::Vector3D m_Spacing;
+  mitk::Point3D m_Origin;
+
+  void FillLabel(mitk::LabelSetImage *image, mitk::Label::PixelType value, const LabelBox &box)
+  {
+    const unsigned int *dimensions = image->GetDimensions();
+    mitk::ImageWriteAccessor accessor(image);
+    auto *pixels = static_cast<mitk::Label::PixelType *>(accessor.GetData());
+    for (unsigned int z = box.Begin[2]; z < box.End[2]; ++z)
+      for (unsigned int y = box.Begin[1]; y < box.End[1]; ++y)
+        for (unsigned int x = box.Begin[0]; x < box.End[0]; ++x)
+          pixels[(z * dimensions[1] + y) * dimensions[0] + x] = value;
+  }
+
+public:
+  void setUp() override
+  {
+    mitk::CallbackFromGUIThread::RegisterImplementation(&m_Callback);
+
+    m_Spacing[0] = 1.0;
+    m_Spacing[1] = 1.5;
+    m_Spacing[2] = 2.0;
+    m_Origin[0] = 10.0;
+    m_Origin[1] = -5.0;
+    m_Origin[2] = 3.0;
+  }
+
+  void tearDown() override { mitk::CallbackFromGUIThread::RegisterImplementation(nullptr); }
+
+  void StartBlockingAlgorithm_PerLabel_CreatesSurfaceOfEachLabel()
+  {
+    unsigned int dimensions[3] = {20, 16, 14};
+    mitk::Image::Pointer referenceImage = mitk::Image::New();
+    referenceImage->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 3, dimensions);
+    referenceImage->SetSpacing(m_Spacing);
+    referenceImage->SetOrigin(m_Origin);
+
+    mitk::LabelSetImage::Pointer segmentation = mitk::LabelSetImage::New();
+    segmentation->Initialize(referenceImage);
+
+    mitk::Color color;
+    color.Fill(1.0);
+    std::map<std::string, LabelBox> boxes;
+    boxes["small"] = {{2, 2, 2}, {6, 6, 6}};
+    boxes["large"] = {{10, 8, 3}, {16, 13, 10}};
+    for (const auto &box : boxes)
+    {
+      segmentation->GetActiveLabelSet()->AddLabel(box.first, color);
+      this->FillLabel(segmentation, segmentation->GetActiveLabelSet()->GetActiveLabel()->GetValue(), box.second);
+    }
+
+    mitk::StandaloneDataStorage::Pointer dataStorage = mitk::StandaloneDataStorage::New();
+    mitk::DataNode::Pointer groupNode = mitk::DataNode::New();
+    groupNode->SetName("segmentation");
+    groupNode->SetData(segmentation);
+    dataStorage->Add(groupNode);
+
+    // without smoothing, the marching cubes cut the edges between the label and the background
+    mitk::ShowSegmentationAsSurface::Pointer surfaceFilter = mitk::ShowSegmentationAsSurface::New();
+    surfaceFilter->SetPointerParameter("Input", segmentation);
+    surfaceFilter->SetPointerParameter("Group node", groupNode);
+    surfaceFilter->SetParameter("Per label", true);
+    surfaceFilter->SetParameter("Smooth", false);
+    surfaceFilter->SetParameter("Apply median", false);
+    surfaceFilter->SetParameter("Decimate mesh", false);
+    surfaceFilter->SetDataStorage(*dataStorage);
+    surfaceFilter->StartBlockingAlgorithm();
+
+    mitk::DataStorage::SetOfObjects::ConstPointer surfaceNodes = dataStorage->GetDerivations(groupNode);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("One surface per label", boxes.size(), static_cast<std::size_t>(surfaceNodes->Size()));
+
+    for (auto iter = surfaceNodes->Begin(); iter != surfaceNodes->End(); ++iter)
+    {
+      mitk::DataNode *surfaceNode = iter->Value();
+      auto box = boxes.find(surfaceNode->GetName().substr(std::string("segmentation_").size()));
+      CPPUNIT_ASSERT_MESSAGE("Surface is named after its label", box != boxes.end());
+
+      auto *surface = dynamic_cast<mitk::Surface *>(surfaceNode->GetData());
+      CPPUNIT_ASSERT_MESSAGE("Node holds a surface", surface != nullptr);
+      double bounds[6];
+      surface->GetVtkPolyData()->GetBounds(bounds);
+
+      // the surface lies between the centers of the outermost label pixels and the background pixels
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        const double begin = m_Origin[i] + (box->second.Begin[i] - 0.5) * m_Spacing[i];
+        const double end = m_Origin[i] + (box->second.End[i] - 0.5) * m_Spacing[i];
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(box->first + ": lower bound", begin, bounds[2 * i], 0.5 * m_Spacing[i]);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(box->first + ": upper bound", end, bounds[2 * i + 1], 0.5 * m_Spacing[i]);
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkShowSegmentationAsSurface)
@@ -1,5 +1,6 @@
 set(CPP_FILES
   Algorithms/mitkCalculateSegmentationVolume.cpp
+  Algorithms/mitkCompressedSliceContainer.cpp
   Algorithms/mitkContourModelSetToImageFilter.cpp
   Algorithms/mitkContourSetToPointSetFilter.cpp
   Algorithms/mitkContourUtils.cpp
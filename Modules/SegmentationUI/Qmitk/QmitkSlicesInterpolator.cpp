@@ -81,6 +81,7 @@ QmitkSlicesInterpolator::QmitkSlicesInterpolator(QWidget *parent, const char * /
     m_LastSliceIndex(0),
     m_2DInterpolationEnabled(false),
     m_3DInterpolationEnabled(false),
+    m_Restart3DInterpolation(false),
     m_FirstRun(true)
 {
   m_GroupBoxEnableExclusiveInterpolationMode = new QGroupBox("Interpolation", this);
@@ -593,6 +594,13 @@ void QmitkSlicesInterpolator::Interpolate(mitk::PlaneGeometry *plane,
 
 void QmitkSlicesInterpolator::OnSurfaceInterpolationFinished()
 {
+  if (m_Restart3DInterpolation)
+  {
+    m_Restart3DInterpolation = false;
+    this->Start3DInterpolation();
+    return;
+  }
+
   mitk::Surface::Pointer interpolatedSurface = m_SurfaceInterpolator->GetInterpolationResult();
   mitk::DataNode *workingNode = m_ToolManager->GetWorkingData(0);
 
@@ -1143,13 +1151,9 @@ void QmitkSlicesInterpolator::On3DInterpolationActivated(bool on)
             ret = msgBox.exec();
           }
 
-          if (m_Watcher.isRunning())
-            m_Watcher.waitForFinished();
-
           if (ret == QMessageBox::Yes)
           {
-            m_Future = QtConcurrent::run(this, &QmitkSlicesInterpolator::Run3DInterpolation);
-            m_Watcher.setFuture(m_Future);
+            this->Start3DInterpolation();
           }
           else
           {
@@ -1212,10 +1216,7 @@ void QmitkSlicesInterpolator::OnSurfaceInterpolationInfoChanged(const itk::Event
 {
   if (m_3DInterpolationEnabled)
   {
-    if (m_Watcher.isRunning())
-      m_Watcher.waitForFinished();
-    m_Future = QtConcurrent::run(this, &QmitkSlicesInterpolator::Run3DInterpolation);
-    m_Watcher.setFuture(m_Future);
+    this->Start3DInterpolation();
   }
 }
 
@@ -1272,10 +1273,7 @@ void QmitkSlicesInterpolator::SetCurrentContourListID()
 
         if (m_3DInterpolationEnabled)
         {
-          if (m_Watcher.isRunning())
-            m_Watcher.waitForFinished();
-          m_Future = QtConcurrent::run(this, &QmitkSlicesInterpolator::Run3DInterpolation);
-          m_Watcher.setFuture(m_Future);
+          this->Start3DInterpolation();
         }
       }
     }
@@ -1328,10 +1326,26 @@ void QmitkSlicesInterpolator::OnSliceNavigationControllerDeleted(const itk::Obje
   }
 }
 
+void QmitkSlicesInterpolator::Start3DInterpolation()
+{
+  // The running interpolation is outdated, it aborts itself after the contours were changed. It is not waited for,
+  // so that drawing the next contour is not blocked.
+  if (m_Watcher.isRunning())
+  {
+    m_SurfaceInterpolator->AbortInterpolation();
+    m_Restart3DInterpolation = true;
+    return;
+  }
+
+  m_Future = QtConcurrent::run(this, &QmitkSlicesInterpolator::Run3DInterpolation);
+  m_Watcher.setFuture(m_Future);
+}
+
 void QmitkSlicesInterpolator::WaitForFutures()
 {
   if (m_Watcher.isRunning())
   {
+    m_SurfaceInterpolator->AbortInterpolation();
     m_Watcher.waitForFinished();
   }
 
@@ -239,6 +239,7 @@ private:
   void Show2DInterpolationControls(bool show);
   void Show3DInterpolationControls(bool show);
   void CheckSupportedImageDimension();
+  void Start3DInterpolation();
   void WaitForFutures();
   void NodeRemoved(const mitk::DataNode* node);
 
@@ -288,6 +289,8 @@ private:
 
   QFuture<void> m_Future;
   QFutureWatcher<void> m_Watcher;
+  // Set if the running 3D interpolation is outdated, it is restarted when it has finished
+  bool m_Restart3DInterpolation;
   QTimer *m_Timer;
 
   QFuture<void> m_PlaneFuture;
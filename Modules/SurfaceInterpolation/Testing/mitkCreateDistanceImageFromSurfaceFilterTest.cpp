@@ -18,10 +18,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkCreateDistanceImageFromSurfaceFilter.h>
 #include <mitkIOUtil.h>
 #include <mitkImageAccessByItk.h>
+#include <mitkImageReadAccessor.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
+#include <itkCommand.h>
+
 #include <vtkDebugLeaks.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+#include <cmath>
 
 class mitkCreateDistanceImageFromSurfaceFilterTestSuite : public mitk::TestFixture
 {
@@ -29,13 +36,94 @@ class mitkCreateDistanceImageFromSurfaceFilterTestSuite : public mitk::TestFixtu
   vtkDebugLeaks::SetExitError(0);
   MITK_TEST(TestCreateDistanceImageForLiver);
   MITK_TEST(TestCreateDistanceImageForTube);
+  MITK_TEST(TestCreateDistanceImageForLiverWithWendlandFunction);
+  MITK_TEST(TestIncrementalUpdateAfterMovingAContour);
+  MITK_TEST(TestIncrementalUpdateAfterAbortedUpdate);
   CPPUNIT_TEST_SUITE_END();
 
 private:
   std::vector<mitk::Surface::Pointer> contourList;
+  itk::ImageBase<3>::Pointer m_LiverImage;
+  mitk::ComputeContourSetNormalsFilter::Pointer m_NormalsFilter;
+  unsigned int m_NumberOfProgressEventsWhileFilling;
+
+  // Aborts the filter after a few layers of the narrow band have been evaluated
+  void AbortWhileFillingDistanceImage(itk::Object *caller, const itk::EventObject &)
+  {
+    auto *filter = static_cast<itk::ProcessObject *>(caller);
+    if (filter->GetProgress() > 0.5 && ++m_NumberOfProgressEventsWhileFilling >= 5)
+      filter->AbortGenerateDataOn();
+  }
+
+  // Loads the liver contours into contourList and sets them as inputs of m_NormalsFilter, m_LiverImage gets the
+  // geometry of the liver segmentation
+  void LoadLiverContours()
+  {
+    // That's the number of available liver contours in MITK-Data
+    unsigned int NUMBER_OF_LIVER_CONTOURS = 18;
+
+    for (unsigned int i = 0; i <= NUMBER_OF_LIVER_CONTOURS; ++i)
+    {
+      std::stringstream s;
+      s << "SurfaceInterpolation/InterpolateLiver/LiverContourWithNormals_";
+      s << i;
+      s << ".vtk";
+      mitk::Surface::Pointer contour = dynamic_cast<mitk::Surface*>(mitk::IOUtil::Load(GetTestDataFilePath(s.str()))[0].GetPointer());
+      contourList.push_back(contour);
+    }
+
+    mitk::Image::Pointer segmentationImage =
+      dynamic_cast<mitk::Image*>(mitk::IOUtil::Load(GetTestDataFilePath("SurfaceInterpolation/Reference/LiverSegmentation.nrrd"))[0].GetPointer());
+
+    m_LiverImage = itk::ImageBase<3>::New();
+    AccessFixedDimensionByItk_1(segmentationImage, GetImageBase, 3, m_LiverImage);
+
+    m_NormalsFilter = mitk::ComputeContourSetNormalsFilter::New();
+    for (unsigned int j = 0; j < contourList.size(); j++)
+    {
+      m_NormalsFilter->SetInput(j, contourList.at(j));
+    }
+  }
+
+  mitk::CreateDistanceImageFromSurfaceFilter::Pointer CreateWendlandFilter()
+  {
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer filter = mitk::CreateDistanceImageFromSurfaceFilter::New();
+    filter->SetReferenceImage(m_LiverImage.GetPointer());
+    filter->SetRadialBasisFunction(mitk::CreateDistanceImageFromSurfaceFilter::WendlandRadialBasisFunction);
+    return filter;
+  }
+
+  unsigned int GetNumberOfPixels(const mitk::Image *image)
+  {
+    unsigned int numberOfPixels = 1;
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      numberOfPixels *= image->GetDimension(dim);
+    return numberOfPixels;
+  }
+
+  // Counts the pixels of two distance images of the same geometry that differ by at most 1% of the spacing
+  unsigned int CountEqualPixels(mitk::Image *image, mitk::Image *referenceImage)
+  {
+    CPPUNIT_ASSERT(mitk::Equal(*(referenceImage->GetGeometry()), *(image->GetGeometry()), 0.0001, true));
+
+    mitk::ImageReadAccessor accessor(image);
+    mitk::ImageReadAccessor referenceAccessor(referenceImage);
+    const double *values = static_cast<const double *>(accessor.GetData());
+    const double *referenceValues = static_cast<const double *>(referenceAccessor.GetData());
+
+    const unsigned int numberOfPixels = this->GetNumberOfPixels(referenceImage);
+    const double tolerance = 0.01 * referenceImage->GetGeometry()->GetSpacing()[0];
+    unsigned int numberOfEqualPixels = 0;
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+    {
+      if (std::fabs(values[i] - referenceValues[i]) <= tolerance)
+        ++numberOfEqualPixels;
+    }
+    return numberOfEqualPixels;
+  }
 
 public:
-  void setUp() override {}
+  void setUp() override { m_NumberOfProgressEventsWhileFilling = 0; }
   template <typename TPixel, unsigned int VImageDimension>
   void GetImageBase(itk::Image<TPixel, VImageDimension> *input, itk::ImageBase<3>::Pointer &result)
   {
@@ -131,6 +219,162 @@ public:
     CPPUNIT_ASSERT_MESSAGE("HolesDistanceImages are not equal!",
                            mitk::Equal(*(holesDistanceImageReference), *(holeDistanceImage), 0.0001, true));
   }
+
+  // Interpolate the shape of the liver with the compactly supported function and compare it with the reference
+  void TestCreateDistanceImageForLiverWithWendlandFunction()
+  {
+    this->LoadLiverContours();
+
+    std::vector<mitk::Image::Pointer> distanceImages;
+    for (unsigned int numberOfThreads : {1u, 4u})
+    {
+      mitk::CreateDistanceImageFromSurfaceFilter::Pointer m_InterpolateSurfaceFilter = this->CreateWendlandFilter();
+      m_InterpolateSurfaceFilter->SetNumberOfThreads(numberOfThreads);
+
+      for (unsigned int j = 0; j < contourList.size(); j++)
+      {
+        m_InterpolateSurfaceFilter->SetInput(j, m_NormalsFilter->GetOutput(j));
+      }
+
+      m_InterpolateSurfaceFilter->Update();
+      distanceImages.push_back(m_InterpolateSurfaceFilter->GetOutput());
+      CPPUNIT_ASSERT(distanceImages.back().IsNotNull());
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Distance images of one and four threads are not equal!",
+                           mitk::Equal(*(distanceImages[0]), *(distanceImages[1]), 0, true));
+
+    // The values differ from the linear interpolation, but the inside and the outside of the liver must match
+    mitk::Image::Pointer liverDistanceImageReference =
+      dynamic_cast<mitk::Image*>(mitk::IOUtil::Load(GetTestDataFilePath("SurfaceInterpolation/Reference/LiverDistanceImage.nrrd"))[0].GetPointer());
+    CPPUNIT_ASSERT(mitk::Equal(*(liverDistanceImageReference->GetGeometry()), *(distanceImages[0]->GetGeometry()), 0.0001, true));
+
+    mitk::ImageReadAccessor referenceAccessor(liverDistanceImageReference);
+    mitk::ImageReadAccessor distanceAccessor(distanceImages[0]);
+    const double *referenceValues = static_cast<const double *>(referenceAccessor.GetData());
+    const double *distanceValues = static_cast<const double *>(distanceAccessor.GetData());
+
+    const unsigned int numberOfPixels = this->GetNumberOfPixels(distanceImages[0]);
+
+    // Only the narrow band around the surface is compared. The other pixels are filled with +/- ten times the
+    // spacing from the inside and outside and would agree in most cases, however the band is interpolated.
+    const double spacing = distanceImages[0]->GetGeometry()->GetSpacing()[0];
+    unsigned int numberOfBandPixels = 0;
+    unsigned int numberOfEqualSigns = 0;
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+    {
+      if (std::fabs(referenceValues[i]) >= 5 * spacing)
+        continue;
+
+      ++numberOfBandPixels;
+      if ((referenceValues[i] < 0) == (distanceValues[i] < 0))
+        ++numberOfEqualSigns;
+    }
+    CPPUNIT_ASSERT_MESSAGE("The reference has a narrow band", numberOfBandPixels > 0);
+    CPPUNIT_ASSERT_MESSAGE("Inside and outside of the liver differ from the reference!",
+                           numberOfEqualSigns > 0.97 * numberOfBandPixels);
+  }
+
+  // Move a liver contour by half a pixel after an update, the incremental update must only evaluate the region
+  // around the moved contour and agree with a full update
+  void TestIncrementalUpdateAfterMovingAContour()
+  {
+    this->LoadLiverContours();
+    m_NormalsFilter->Update();
+
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer incrementalFilter = this->CreateWendlandFilter();
+    incrementalFilter->IncrementalUpdateOn();
+    for (unsigned int j = 0; j < contourList.size(); j++)
+    {
+      incrementalFilter->SetInput(j, m_NormalsFilter->GetOutput(j));
+    }
+    incrementalFilter->Update();
+
+    // An inner contour is moved, so that the bounds of the distance image and the support radius stay the same
+    const unsigned int movedContourIndex = contourList.size() / 2;
+    mitk::Surface::Pointer movedContour = m_NormalsFilter->GetOutput(movedContourIndex)->Clone();
+    vtkPoints *points = movedContour->GetVtkPolyData()->GetPoints();
+    const double shift = 0.5 * incrementalFilter->GetDistanceImageSpacing();
+    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+      double point[3];
+      points->GetPoint(i, point);
+      point[0] += shift;
+      points->SetPoint(i, point);
+    }
+    points->Modified();
+
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer fullFilter = this->CreateWendlandFilter();
+
+    incrementalFilter->Reset();
+    for (unsigned int j = 0; j < contourList.size(); j++)
+    {
+      const mitk::Surface *contour = j == movedContourIndex ? movedContour.GetPointer() : m_NormalsFilter->GetOutput(j);
+      incrementalFilter->SetInput(j, contour);
+      fullFilter->SetInput(j, contour);
+    }
+    incrementalFilter->Update();
+    fullFilter->Update();
+
+    CPPUNIT_ASSERT_MESSAGE("The full update evaluates distance values", fullFilter->GetNumberOfEvaluatedPixels() > 0);
+    CPPUNIT_ASSERT_MESSAGE("The incremental update evaluates as many distance values as a full update!",
+                           incrementalFilter->GetNumberOfEvaluatedPixels() < fullFilter->GetNumberOfEvaluatedPixels());
+
+    // Pixels at the border of the narrow band may be set in one of the images only
+    mitk::Image::Pointer fullImage = fullFilter->GetOutput();
+    CPPUNIT_ASSERT_MESSAGE("Incremental update differs from the full update!",
+                           this->CountEqualPixels(incrementalFilter->GetOutput(), fullImage) >
+                             0.999 * this->GetNumberOfPixels(fullImage));
+  }
+
+  // Abort an incremental update after a contour was removed, restore the contour and compare the next
+  // incremental update with a full one
+  void TestIncrementalUpdateAfterAbortedUpdate()
+  {
+    this->LoadLiverContours();
+
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer incrementalFilter = this->CreateWendlandFilter();
+    incrementalFilter->IncrementalUpdateOn();
+    for (unsigned int j = 0; j < contourList.size(); j++)
+    {
+      incrementalFilter->SetInput(j, m_NormalsFilter->GetOutput(j));
+    }
+    incrementalFilter->Update();
+
+    // The update without one contour is aborted after some distance values of its weights were evaluated
+    const unsigned int removedContour = contourList.size() / 2;
+    incrementalFilter->Reset();
+    for (unsigned int j = 0, input = 0; j < contourList.size(); j++)
+    {
+      if (j == removedContour)
+        continue;
+      incrementalFilter->SetInput(input++, m_NormalsFilter->GetOutput(j));
+    }
+
+    auto abortCommand = itk::MemberCommand<mitkCreateDistanceImageFromSurfaceFilterTestSuite>::New();
+    abortCommand->SetCallbackFunction(this, &mitkCreateDistanceImageFromSurfaceFilterTestSuite::AbortWhileFillingDistanceImage);
+    const unsigned long observerTag = incrementalFilter->AddObserver(itk::ProgressEvent(), abortCommand);
+    CPPUNIT_ASSERT_THROW(incrementalFilter->Update(), itk::ProcessAborted);
+    incrementalFilter->RemoveObserver(observerTag);
+
+    // With all contours again, the centers equal those of the last completed update
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer fullFilter = this->CreateWendlandFilter();
+
+    incrementalFilter->Reset();
+    for (unsigned int j = 0; j < contourList.size(); j++)
+    {
+      incrementalFilter->SetInput(j, m_NormalsFilter->GetOutput(j));
+      fullFilter->SetInput(j, m_NormalsFilter->GetOutput(j));
+    }
+    incrementalFilter->Update();
+    fullFilter->Update();
+
+    // No value of the aborted update is kept
+    mitk::Image::Pointer fullImage = fullFilter->GetOutput();
+    CPPUNIT_ASSERT_MESSAGE("Incremental update after an aborted update differs from the full update!",
+                           this->CountEqualPixels(incrementalFilter->GetOutput(), fullImage) ==
+                             this->GetNumberOfPixels(fullImage));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkCreateDistanceImageFromSurfaceFilter)
@@ -28,6 +28,7 @@ class mitkSurfaceInterpolationControllerTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkSurfaceInterpolationControllerTestSuite);
   MITK_TEST(TestSingleton);
+  MITK_TEST(TestSetRadialBasisFunction);
   MITK_TEST(TestSetCurrentInterpolationSession);
   MITK_TEST(TestReplaceInterpolationSession);
   MITK_TEST(TestRemoveAllInterpolationSessions);
@@ -87,6 +88,21 @@ public:
                            m_Controller.GetPointer() == controller2.GetPointer());
   }
 
+  void TestSetRadialBasisFunction()
+  {
+    CPPUNIT_ASSERT_MESSAGE("The linear radial basis function is not the default!",
+                           m_Controller->GetRadialBasisFunction() ==
+                             mitk::CreateDistanceImageFromSurfaceFilter::LinearRadialBasisFunction);
+
+    m_Controller->SetRadialBasisFunction(mitk::CreateDistanceImageFromSurfaceFilter::WendlandRadialBasisFunction);
+    CPPUNIT_ASSERT_MESSAGE("The Wendland radial basis function is not set!",
+                           m_Controller->GetRadialBasisFunction() ==
+                             mitk::CreateDistanceImageFromSurfaceFilter::WendlandRadialBasisFunction);
+
+    // the controller is a singleton, the other tests use the default
+    m_Controller->SetRadialBasisFunction(mitk::CreateDistanceImageFromSurfaceFilter::LinearRadialBasisFunction);
+  }
+
   void TestSetCurrentInterpolationSession()
   {
     // Create image for testing
@@ -24,9 +24,180 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkSmartPointer.h"
 
 #include "itkImageRegionIteratorWithIndex.h"
-#include "itkNeighborhoodIterator.h"
 
-#include <queue>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <set>
+#include <thread>
+
+namespace
+{
+  // Phi(r) of the Wendland function with support radius R
+  inline double WendlandFunction(double r, double supportRadius)
+  {
+    if (r >= supportRadius)
+      return 0;
+
+    const double q = r / supportRadius;
+    double t = 1 - q;
+    t *= t;
+    t *= t;
+    return t * (4 * q + 1);
+  }
+
+  // Orders points lexicographically to find equal points
+  struct PointLess
+  {
+    bool operator()(const mitk::CreateDistanceImageFromSurfaceFilter::PointType &p1,
+                    const mitk::CreateDistanceImageFromSurfaceFilter::PointType &p2) const
+    {
+      return std::lexicographical_compare(p1.begin(), p1.end(), p2.begin(), p2.end());
+    }
+  };
+
+  // Calls function(i) for all i in [0, n), the range is split into one block per thread
+  template <class Function>
+  void ParallelFor(std::size_t n, unsigned int numberOfThreads, const Function &function)
+  {
+    // starting threads does not pay off for a few values
+    const std::size_t minimumBlockSize = 64;
+    numberOfThreads = std::max(1u, std::min<unsigned int>(numberOfThreads, n / minimumBlockSize));
+
+    auto processBlock = [&](unsigned int block) {
+      const std::size_t end = n * (block + 1) / numberOfThreads;
+      for (std::size_t i = n * block / numberOfThreads; i < end; ++i)
+        function(i);
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int block = 1; block < numberOfThreads; ++block)
+      threads.emplace_back(processBlock, block);
+    processBlock(0);
+    for (auto &thread : threads)
+      thread.join();
+  }
+}
+
+struct mitk::CreateDistanceImageFromSurfaceFilter::CenterGrid
+{
+  PointType Origin;
+  double CellSize;
+  long Size[3];
+  // The centers of cell c are CenterIds[CellStarts[c]] ... CenterIds[CellStarts[c + 1] - 1]
+  std::vector<unsigned int> CellStarts;
+  std::vector<unsigned int> CenterIds;
+
+  // Sorts the first numberOfCenters centers into cells of at least the given size
+  void Build(const CenterList &centers, std::size_t numberOfCenters, double cellSize)
+  {
+    PointType minPoint = centers.at(0);
+    PointType maxPoint = centers.at(0);
+    for (std::size_t i = 1; i < numberOfCenters; ++i)
+    {
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        minPoint[dim] = std::min(minPoint[dim], centers[i][dim]);
+        maxPoint[dim] = std::max(maxPoint[dim], centers[i][dim]);
+      }
+    }
+
+    // Avoid a grid with many more cells than centers if the cells are small compared to the extent
+    Origin = minPoint;
+    CellSize = cellSize;
+    std::size_t numberOfCells;
+    do
+    {
+      numberOfCells = 1;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        Size[dim] = static_cast<long>((maxPoint[dim] - minPoint[dim]) / CellSize) + 1;
+        numberOfCells *= Size[dim];
+      }
+      if (numberOfCells > 8 * numberOfCenters + 64)
+        CellSize *= 2;
+      else
+        break;
+    } while (true);
+
+    std::vector<unsigned int> cellOfCenter(numberOfCenters);
+    CellStarts.assign(numberOfCells + 1, 0);
+    for (std::size_t i = 0; i < numberOfCenters; ++i)
+    {
+      long cell = 0;
+      for (int dim = 2; dim >= 0; --dim)
+      {
+        const long index = std::min(static_cast<long>((centers[i][dim] - Origin[dim]) / CellSize), Size[dim] - 1);
+        cell = cell * Size[dim] + index;
+      }
+      cellOfCenter[i] = cell;
+      ++CellStarts[cell + 1];
+    }
+    for (std::size_t cell = 0; cell < numberOfCells; ++cell)
+      CellStarts[cell + 1] += CellStarts[cell];
+
+    CenterIds.resize(numberOfCenters);
+    std::vector<unsigned int> nextPosition(CellStarts.begin(), CellStarts.end() - 1);
+    for (std::size_t i = 0; i < numberOfCenters; ++i)
+      CenterIds[nextPosition[cellOfCenter[i]]++] = i;
+  }
+
+  // Calls function(centerId) for all centers in the cell of the point and the adjacent cells, which contain all
+  // centers closer to the point than the cell size
+  template <class Function>
+  void ForEachCenterAround(const PointType &point, const Function &function) const
+  {
+    long first[3], last[3];
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      const double cell = std::floor((point[dim] - Origin[dim]) / CellSize);
+      if (cell < -1 || cell > Size[dim])
+        return;
+      first[dim] = std::max(static_cast<long>(cell) - 1, 0L);
+      last[dim] = std::min(static_cast<long>(cell) + 1, Size[dim] - 1);
+    }
+
+    for (long z = first[2]; z <= last[2]; ++z)
+    {
+      for (long y = first[1]; y <= last[1]; ++y)
+      {
+        const long cellOffset = (z * Size[1] + y) * Size[0];
+        const unsigned int end = CellStarts[cellOffset + last[0] + 1];
+        for (unsigned int k = CellStarts[cellOffset + first[0]]; k < end; ++k)
+          function(CenterIds[k]);
+      }
+    }
+  }
+
+  // Returns the largest number of centers that ForEachCenterAround() calls the function for
+  unsigned int GetMaximumNumberOfCentersAround() const
+  {
+    unsigned int maximumNumberOfCenters = 0;
+    for (long z = 0; z < Size[2]; ++z)
+    {
+      for (long y = 0; y < Size[1]; ++y)
+      {
+        for (long x = 0; x < Size[0]; ++x)
+        {
+          const long firstX = std::max(x - 1, 0L);
+          const long lastX = std::min(x + 1, Size[0] - 1);
+          unsigned int numberOfCenters = 0;
+          for (long cellZ = std::max(z - 1, 0L); cellZ <= std::min(z + 1, Size[2] - 1); ++cellZ)
+          {
+            for (long cellY = std::max(y - 1, 0L); cellY <= std::min(y + 1, Size[1] - 1); ++cellY)
+            {
+              const long cellOffset = (cellZ * Size[1] + cellY) * Size[0];
+              numberOfCenters += CellStarts[cellOffset + lastX + 1] - CellStarts[cellOffset + firstX];
+            }
+          }
+          maximumNumberOfCenters = std::max(maximumNumberOfCenters, numberOfCenters);
+        }
+      }
+    }
+    return maximumNumberOfCenters;
+  }
+};
 
 void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 {
@@ -111,6 +282,16 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 mitk::CreateDistanceImageFromSurfaceFilter::CreateDistanceImageFromSurfaceFilter()
 {
   m_DistanceImageVolume = 50000;
+  m_RadialBasisFunction = LinearRadialBasisFunction;
+  m_SupportRadius = 0;
+  m_UsedSupportRadius = 0;
+  m_NumberOfThreads = 0;
+  m_IncrementalUpdate = false;
+  m_HasPreviousUpdate = false;
+  m_UpdateAffectedRegion = false;
+  m_PreviousSupportRadius = 0;
+  m_PreviousSpacing = 0;
+  m_NumberOfEvaluatedPixels = 0;
   this->m_UseProgressBar = false;
   this->m_ProgressStepSize = 5;
 
@@ -124,16 +305,29 @@ mitk::CreateDistanceImageFromSurfaceFilter::~CreateDistanceImageFromSurfaceFilte
 
 void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
 {
+  // An aborted update keeps the state of the previous update, the next update is compared with that one.
+  // An aborted update leaves its centers behind
+  m_Centers.clear();
+  m_Normals.clear();
+  m_ContourIndices.clear();
+
   this->PreprocessContourPoints();
   this->CreateEmptyDistanceImage();
 
+  m_UpdateAffectedRegion = m_HasPreviousUpdate && m_IncrementalUpdate &&
+                           m_RadialBasisFunction == WendlandRadialBasisFunction &&
+                           m_DistanceImageSpacing == m_PreviousSpacing &&
+                           m_DistanceImageITK->GetOrigin() == m_PreviousOrigin &&
+                           m_DistanceImageITK->GetLargestPossibleRegion().GetSize() == m_PreviousSize;
+
   // First of all we have to build the equation-system from the existing contour-edge-points
   this->CreateSolutionMatrixAndFunctionValues();
 
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(1);
 
-  m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+  this->SolveEquationSystem();
+  this->InvalidateDistanceValues();
 
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(2);
@@ -144,8 +338,27 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(2);
 
+  if (m_IncrementalUpdate && m_RadialBasisFunction == WendlandRadialBasisFunction)
+  {
+    m_PreviousCenters = m_Centers;
+    m_PreviousWeights = m_Weights;
+    m_PreviousSupportRadius = m_UsedSupportRadius;
+    m_PreviousSpacing = m_DistanceImageSpacing;
+    m_PreviousOrigin = m_DistanceImageITK->GetOrigin();
+    m_PreviousSize = m_DistanceImageITK->GetLargestPossibleRegion().GetSize();
+    m_HasPreviousUpdate = true;
+  }
+  else
+  {
+    m_HasPreviousUpdate = false;
+    m_PreviousCenters.clear();
+    m_DistanceValues.clear();
+  }
+
   m_Centers.clear();
   m_Normals.clear();
+  m_ContourIndices.clear();
+  m_CenterGrid.reset();
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
@@ -171,6 +384,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
   double p[3];
   PointType currentPoint;
   PointType normal;
+  std::set<PointType, PointLess> existingCenters;
 
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
@@ -203,9 +417,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
         currentPoint.copy_in(p);
 
-        int count = std::count(m_Centers.begin(), m_Centers.end(), currentPoint);
-
-        if (count == 0)
+        if (existingCenters.insert(currentPoint).second)
         {
           double currentNormal[3];
           currentCellNormals->GetTuple(cell[j], currentNormal);
@@ -215,6 +427,8 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
           m_Normals.push_back(normal);
 
           m_Centers.push_back(currentPoint);
+
+          m_ContourIndices.push_back(i);
         }
 
       } // end for all points
@@ -266,12 +480,48 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   }
 
   // Now we have created all centers and all function values. Next step is to create the solution matrix
+  unsigned int numberOfContourPoints = numberOfCenters;
   numberOfCenters = m_Centers.size();
 
-  m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
-
   m_Weights.resize(numberOfCenters);
 
+  if (m_RadialBasisFunction == WendlandRadialBasisFunction)
+  {
+    m_SolutionMatrix.resize(0, 0);
+
+    m_UsedSupportRadius = m_SupportRadius > 0 ? m_SupportRadius : this->EstimateSupportRadius(numberOfContourPoints);
+
+    // Keep the previous radius as long as it still bridges the gaps with some margin and does not make the support
+    // much larger than necessary, so that a slightly changed contour does not enforce a full update
+    if (m_UpdateAffectedRegion && m_SupportRadius <= 0 && 0.8 * m_UsedSupportRadius <= m_PreviousSupportRadius &&
+        2 * m_UsedSupportRadius >= m_PreviousSupportRadius)
+    {
+      m_UsedSupportRadius = m_PreviousSupportRadius;
+    }
+    m_UpdateAffectedRegion = m_UpdateAffectedRegion && m_UsedSupportRadius == m_PreviousSupportRadius;
+    m_CenterGrid.reset(new CenterGrid);
+    m_CenterGrid->Build(m_Centers, numberOfCenters, m_UsedSupportRadius);
+
+    // Only the centers in the support of each other give non-zero entries
+    std::vector<Eigen::Triplet<double>> entries;
+    for (unsigned int i = 0; i < numberOfCenters; i++)
+    {
+      const PointType &p1 = m_Centers[i];
+      m_CenterGrid->ForEachCenterAround(p1, [&](unsigned int j) {
+        const double norm = (p1 - m_Centers[j]).two_norm();
+        if (norm < m_UsedSupportRadius)
+          entries.emplace_back(i, j, WendlandFunction(norm, m_UsedSupportRadius));
+      });
+    }
+
+    m_SparseSolutionMatrix.resize(numberOfCenters, numberOfCenters);
+    m_SparseSolutionMatrix.setFromTriplets(entries.begin(), entries.end());
+    return;
+  }
+
+  m_SparseSolutionMatrix.resize(0, 0);
+  m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
+
   PointType p1;
   PointType p2;
   double norm;
@@ -290,6 +540,179 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   }
 }
 
+void mitk::CreateDistanceImageFromSurfaceFilter::SolveEquationSystem()
+{
+  this->UpdateProgressAndCheckAbort(0);
+
+  if (m_RadialBasisFunction == LinearRadialBasisFunction)
+  {
+    m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+    return;
+  }
+
+  // The matrix of the Wendland function is positive definite, conjugate gradients converge within a few hundred
+  // iterations, the direct solver is only used if they fail. The iterations are run in blocks to be able to abort.
+  const unsigned int iterationsPerBlock = 100;
+  const Eigen::Index maximumIterations = 2 * m_SparseSolutionMatrix.cols();
+  Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower | Eigen::Upper> iterativeSolver;
+  iterativeSolver.setTolerance(1e-10);
+  iterativeSolver.setMaxIterations(iterationsPerBlock);
+  iterativeSolver.compute(m_SparseSolutionMatrix);
+
+  m_Weights = Eigen::VectorXd::Zero(m_SparseSolutionMatrix.cols());
+  for (Eigen::Index iterations = 0; iterations < maximumIterations; iterations += iterationsPerBlock)
+  {
+    this->UpdateProgressAndCheckAbort(0.5f * iterations / maximumIterations);
+
+    m_Weights = iterativeSolver.solveWithGuess(m_FunctionValues, Eigen::VectorXd(m_Weights));
+    if (iterativeSolver.info() == Eigen::Success)
+      return;
+  }
+
+  MITK_WARN << "mitk::CreateDistanceImageFromSurfaceFilter: Conjugate gradients did not converge after "
+            << maximumIterations << " iterations, solving with a LDLT decomposition.";
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> directSolver(m_SparseSolutionMatrix);
+  m_Weights = directSolver.solve(m_FunctionValues);
+  if (directSolver.info() != Eigen::Success)
+  {
+    itkExceptionMacro("mitk::CreateDistanceImageFromSurfaceFilter: The equation system could not be solved!");
+  }
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::InvalidateDistanceValues()
+{
+  const std::size_t numberOfPixels = m_DistanceImageITK->GetLargestPossibleRegion().GetNumberOfPixels();
+  if (!m_UpdateAffectedRegion || m_DistanceValues.size() != numberOfPixels)
+  {
+    m_DistanceValues.assign(numberOfPixels, std::numeric_limits<double>::quiet_NaN());
+    return;
+  }
+
+  // The distance value of a pixel differs by less than 1% of the spacing if the weights of all centers in its support
+  // differ by less than this tolerance, since Phi(r) <= 1. The support of a pixel, which may lie between the
+  // contours, contains at most the centers that the grid visits around it.
+  const unsigned int maximumNumberOfCentersInSupport =
+    std::max(1u, m_CenterGrid->GetMaximumNumberOfCentersAround());
+  const double tolerance = 0.01 * m_DistanceImageSpacing / maximumNumberOfCentersInSupport;
+
+  std::map<PointType, unsigned int, PointLess> previousCenterIds;
+  for (unsigned int i = 0; i < m_PreviousCenters.size(); ++i)
+    previousCenterIds.emplace(m_PreviousCenters[i], i);
+
+  // Centers that were added or removed or whose weight changed
+  CenterList changedCenters;
+  for (unsigned int i = 0; i < m_Centers.size(); ++i)
+  {
+    auto previousCenter = previousCenterIds.find(m_Centers[i]);
+    if (previousCenter == previousCenterIds.end())
+    {
+      changedCenters.push_back(m_Centers[i]);
+      continue;
+    }
+
+    const double previousWeight = m_PreviousWeights[previousCenter->second];
+    if (std::fabs(m_Weights[i] - previousWeight) <= tolerance)
+      m_Weights[i] = previousWeight;
+    else
+      changedCenters.push_back(m_Centers[i]);
+    previousCenterIds.erase(previousCenter);
+  }
+  for (const auto &removedCenter : previousCenterIds)
+    changedCenters.push_back(removedCenter.first);
+
+  const DistanceImageType::SizeType size = m_DistanceImageITK->GetLargestPossibleRegion().GetSize();
+  const long radius = static_cast<long>(std::ceil(m_UsedSupportRadius / m_DistanceImageSpacing));
+  for (const auto &center : changedCenters)
+  {
+    DistanceImageType::PointType centerAsPoint;
+    centerAsPoint[0] = center[0];
+    centerAsPoint[1] = center[1];
+    centerAsPoint[2] = center[2];
+    itk::ContinuousIndex<double, 3> centerIndex;
+    m_DistanceImageITK->TransformPhysicalPointToContinuousIndex(centerAsPoint, centerIndex);
+
+    long first[3], last[3];
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      first[dim] = std::max(static_cast<long>(std::floor(centerIndex[dim])) - radius, 0L);
+      last[dim] = std::min(static_cast<long>(std::ceil(centerIndex[dim])) + radius, static_cast<long>(size[dim]) - 1);
+    }
+
+    for (long z = first[2]; z <= last[2]; ++z)
+    {
+      for (long y = first[1]; y <= last[1]; ++y)
+      {
+        const std::size_t offset = (z * size[1] + y) * size[0];
+        for (long x = first[0]; x <= last[0]; ++x)
+          m_DistanceValues[offset + x] = std::numeric_limits<double>::quiet_NaN();
+      }
+    }
+  }
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::UpdateProgressAndCheckAbort(float progress)
+{
+  this->UpdateProgress(progress);
+  if (this->GetAbortGenerateData())
+  {
+    itk::ProcessAborted exception(__FILE__, __LINE__);
+    exception.SetDescription("mitk::CreateDistanceImageFromSurfaceFilter: The interpolation was aborted.");
+    exception.SetLocation(ITK_LOCATION);
+    throw exception;
+  }
+}
+
+double mitk::CreateDistanceImageFromSurfaceFilter::EstimateSupportRadius(unsigned int numberOfContourPoints) const
+{
+  const double minimumRadius = 4 * m_DistanceImageSpacing;
+
+  // The radius must not exceed the extent of the contour points, a larger radius does not change the matrix
+  PointType minPoint = m_Centers.at(0);
+  PointType maxPoint = m_Centers.at(0);
+  for (unsigned int i = 1; i < numberOfContourPoints; ++i)
+  {
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      minPoint[dim] = std::min(minPoint[dim], m_Centers[i][dim]);
+      maxPoint[dim] = std::max(maxPoint[dim], m_Centers[i][dim]);
+    }
+  }
+  const double maximumRadius = std::max((maxPoint - minPoint).two_norm() + 2 * m_DistanceImageSpacing, minimumRadius);
+
+  // Search the closest point of another contour for each contour point within a growing radius
+  CenterGrid grid;
+  for (double searchRadius = minimumRadius; searchRadius < maximumRadius; searchRadius *= 2)
+  {
+    grid.Build(m_Centers, numberOfContourPoints, searchRadius);
+
+    double largestGap = 0;
+    bool allPointsHaveNeighbors = true;
+    for (unsigned int i = 0; i < numberOfContourPoints && allPointsHaveNeighbors; ++i)
+    {
+      double gap = std::numeric_limits<double>::max();
+      grid.ForEachCenterAround(m_Centers[i], [&](unsigned int j) {
+        if (m_ContourIndices[j] != m_ContourIndices[i])
+          gap = std::min(gap, (m_Centers[i] - m_Centers[j]).two_norm());
+      });
+      allPointsHaveNeighbors = gap < searchRadius;
+      largestGap = std::max(largestGap, gap);
+    }
+
+    if (allPointsHaveNeighbors)
+      return std::max(2 * largestGap, minimumRadius);
+  }
+
+  // e.g. there is only one contour
+  return maximumRadius;
+}
+
+unsigned int mitk::CreateDistanceImageFromSurfaceFilter::GetNumberOfUsedThreads() const
+{
+  if (m_NumberOfThreads > 0)
+    return m_NumberOfThreads;
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
 void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
 {
   /*
@@ -301,14 +724,15 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   * 3. Next iteration take the next index from the list and originAsIndex with 1. again
   *
   * This is done until the narrowband_point_list is empty.
+  *
+  * The narrow band grows by one layer of neighbors per iteration. The distance values of a layer are
+  * calculated on several threads, which gives the same image as growing the band pixel by pixel.
+  * Distance values that are still valid from the previous update are not calculated again.
   */
 
   typedef itk::ImageRegionIteratorWithIndex<DistanceImageType> ImageIterator;
-  typedef itk::NeighborhoodIterator<DistanceImageType> NeighborhoodImageIterator;
 
-  std::queue<DistanceImageType::IndexType> narrowbandPoints;
   PointType currentPoint = m_Centers.at(0);
-  double distance = this->CalculateDistanceValue(currentPoint);
 
   // create itk::Point from vnl_vector
   DistanceImageType::PointType currentPointAsPoint;
@@ -323,46 +747,96 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   assert(
     m_DistanceImageITK->GetLargestPossibleRegion().IsInside(currentIndex)); // we are quite certain this should hold
 
-  narrowbandPoints.push(currentIndex);
-  m_DistanceImageITK->SetPixel(currentIndex, distance);
-
-  NeighborhoodImageIterator::RadiusType radius;
-  radius.Fill(1);
-  NeighborhoodImageIterator nIt(radius, m_DistanceImageITK, m_DistanceImageITK->GetLargestPossibleRegion());
-  unsigned int relativeNbIdx[] = {4, 10, 12, 14, 16, 22};
+  const DistanceImageType::RegionType region = m_DistanceImageITK->GetLargestPossibleRegion();
+  const DistanceImageType::SizeType size = region.GetSize();
+  const DistanceImageType::OffsetValueType strides[3] = {
+    1, static_cast<DistanceImageType::OffsetValueType>(size[0]), static_cast<DistanceImageType::OffsetValueType>(size[0] * size[1])};
+  double *buffer = m_DistanceImageITK->GetBufferPointer();
+
+  // Every pixel is calculated once, pixels outside the narrow band keep the default value.
+  // 1 marks a visited pixel, 2 a pixel whose distance value was evaluated by this update.
+  std::vector<char> isCalculated(region.GetNumberOfPixels(), 0);
+
+  std::vector<DistanceImageType::OffsetValueType> narrowbandPoints(1, m_DistanceImageITK->ComputeOffset(currentIndex));
+  std::vector<DistanceImageType::OffsetValueType> neighbors;
+  isCalculated[narrowbandPoints[0]] = 1;
+  m_NumberOfEvaluatedPixels = 0;
+  if (std::isnan(m_DistanceValues[narrowbandPoints[0]]))
+  {
+    m_DistanceValues[narrowbandPoints[0]] = this->CalculateDistanceValue(currentPoint);
+    isCalculated[narrowbandPoints[0]] = 2;
+    ++m_NumberOfEvaluatedPixels;
+  }
+  buffer[narrowbandPoints[0]] = m_DistanceValues[narrowbandPoints[0]];
 
-  bool isInBounds = false;
+  const unsigned int numberOfThreads = this->GetNumberOfUsedThreads();
+  std::size_t numberOfCalculatedPixels = 1;
   while (!narrowbandPoints.empty())
   {
-    nIt.SetLocation(narrowbandPoints.front());
-    narrowbandPoints.pop();
-
-    unsigned int *relativeNb = &relativeNbIdx[0];
-    for (int i = 0; i < 6; i++)
+    try
+    {
+      this->UpdateProgressAndCheckAbort(0.5f + 0.5f * numberOfCalculatedPixels / isCalculated.size());
+    }
+    catch (const itk::ProcessAborted &)
     {
-      nIt.GetPixel(*relativeNb, isInBounds);
-      if (isInBounds && nIt.GetPixel(*relativeNb) == m_DistanceImageDefaultBufferValue)
+      // The values evaluated so far belong to the weights of this update, but the next update is compared with
+      // the previous one
+      for (std::size_t offset = 0; offset < isCalculated.size(); ++offset)
       {
-        currentIndex = nIt.GetIndex(*relativeNb);
-
-        // Transform the currently checked point from index-coordinates to
-        // world-coordinates
-        m_DistanceImageITK->TransformIndexToPhysicalPoint(currentIndex, currentPointAsPoint);
-
-        // create a vnl_vector
-        currentPoint[0] = currentPointAsPoint[0];
-        currentPoint[1] = currentPointAsPoint[1];
-        currentPoint[2] = currentPointAsPoint[2];
+        if (isCalculated[offset] == 2)
+          m_DistanceValues[offset] = std::numeric_limits<double>::quiet_NaN();
+      }
+      throw;
+    }
 
-        // and check the distance
-        distance = this->CalculateDistanceValue(currentPoint);
-        if (std::fabs(distance) <= m_DistanceImageSpacing * 2)
+    // Collect the 6er neighbors of the current layer that have not been calculated yet
+    neighbors.clear();
+    for (auto offset : narrowbandPoints)
+    {
+      currentIndex = m_DistanceImageITK->ComputeIndex(offset);
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        if (currentIndex[dim] > 0 && !isCalculated[offset - strides[dim]])
+        {
+          isCalculated[offset - strides[dim]] = 1;
+          neighbors.push_back(offset - strides[dim]);
+        }
+        if (currentIndex[dim] + 1 < static_cast<DistanceImageType::IndexValueType>(size[dim]) &&
+            !isCalculated[offset + strides[dim]])
         {
-          nIt.SetPixel(*relativeNb, distance);
-          narrowbandPoints.push(currentIndex);
+          isCalculated[offset + strides[dim]] = 1;
+          neighbors.push_back(offset + strides[dim]);
         }
       }
-      relativeNb++;
+    }
+
+    numberOfCalculatedPixels += neighbors.size();
+    ParallelFor(neighbors.size(), numberOfThreads, [&](std::size_t i) {
+      if (!std::isnan(m_DistanceValues[neighbors[i]]))
+        return;
+
+      // Transform the currently checked point from index-coordinates to world-coordinates
+      DistanceImageType::PointType neighborAsPoint;
+      m_DistanceImageITK->TransformIndexToPhysicalPoint(m_DistanceImageITK->ComputeIndex(neighbors[i]), neighborAsPoint);
+      PointType neighborPoint;
+      neighborPoint[0] = neighborAsPoint[0];
+      neighborPoint[1] = neighborAsPoint[1];
+      neighborPoint[2] = neighborAsPoint[2];
+      m_DistanceValues[neighbors[i]] = this->CalculateDistanceValue(neighborPoint);
+      isCalculated[neighbors[i]] = 2;
+    });
+
+    // If the distance is below the threshold the neighbor belongs to the next layer
+    narrowbandPoints.clear();
+    for (std::size_t i = 0; i < neighbors.size(); ++i)
+    {
+      if (isCalculated[neighbors[i]] == 2)
+        ++m_NumberOfEvaluatedPixels;
+      if (std::fabs(m_DistanceValues[neighbors[i]]) <= m_DistanceImageSpacing * 2)
+      {
+        buffer[neighbors[i]] = m_DistanceValues[neighbors[i]];
+        narrowbandPoints.push_back(neighbors[i]);
+      }
     }
   }
 
@@ -423,23 +897,30 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   CastToMitkImage(m_DistanceImageITK, resultImage);
 }
 
-double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointType p)
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(const PointType &p) const
 {
   double distanceValue(0);
-  PointType p1;
-  PointType p2;
-  double norm;
 
-  CenterList::iterator centerIter;
+  if (m_RadialBasisFunction == WendlandRadialBasisFunction)
+  {
+    bool hasSupport = false;
+    m_CenterGrid->ForEachCenterAround(p, [&](unsigned int centerId) {
+      const double norm = (p - m_Centers[centerId]).two_norm();
+      if (norm < m_UsedSupportRadius)
+      {
+        distanceValue += WendlandFunction(norm, m_UsedSupportRadius) * m_Weights[centerId];
+        hasSupport = true;
+      }
+    });
+
+    // Far from all centers the interpolated value is zero, which must not be mistaken for the surface
+    return hasSupport ? distanceValue : m_DistanceImageDefaultBufferValue;
+  }
 
-  unsigned int count(0);
-  for (centerIter = m_Centers.begin(); centerIter != m_Centers.end(); centerIter++)
+  const std::size_t numberOfCenters = m_Centers.size();
+  for (std::size_t i = 0; i < numberOfCenters; ++i)
   {
-    p1 = *centerIter;
-    p2 = p - p1;
-    norm = p2.two_norm();
-    distanceValue = distanceValue + (norm * m_Weights[count]);
-    ++count;
+    distanceValue += (p - m_Centers[i]).two_norm() * m_Weights[i];
   }
   return distanceValue;
 }
@@ -451,6 +932,19 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateOutputInformation()
 void mitk::CreateDistanceImageFromSurfaceFilter::PrintEquationSystem()
 {
   std::stringstream out;
+  if (m_RadialBasisFunction == WendlandRadialBasisFunction)
+  {
+    out << "Support radius: " << m_UsedSupportRadius << " ****** Number of non-zeros: "
+        << m_SparseSolutionMatrix.nonZeros() << endl;
+    out << m_SparseSolutionMatrix << endl;
+    for (unsigned int i = 0; i < m_Centers.size(); i++)
+    {
+      out << m_Centers.at(i) << ";" << endl;
+    }
+    std::cout << "Equation system: \n\n\n" << out.str();
+    return;
+  }
+
   out << "Nummber of rows: " << m_SolutionMatrix.rows() << " ****** Number of columns: " << m_SolutionMatrix.cols()
       << endl;
   out << "[ ";
@@ -528,6 +1022,14 @@ void mitk::CreateDistanceImageFromSurfaceFilter::Reset()
   this->SetNthOutput(0, output.GetPointer());
 }
 
+void mitk::CreateDistanceImageFromSurfaceFilter::ResetIncrementalUpdate()
+{
+  m_HasPreviousUpdate = false;
+  m_PreviousCenters.clear();
+  m_PreviousWeights.resize(0);
+  m_DistanceValues.clear();
+}
+
 void mitk::CreateDistanceImageFromSurfaceFilter::SetUseProgressBar(bool status)
 {
   this->m_UseProgressBar = status;
@@ -28,6 +28,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkImageBase.h"
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <memory>
 
 namespace mitk
 {
@@ -56,6 +59,26 @@ namespace mitk
          with the marching cubes algorithm. (Within the  distance image the surface goes exactly where the pixelvalues
   are zero)
 
+         By default the distance function is interpolated with Phi(r) = r, so that every center influences the whole
+  image and the dense equation system has to be solved with O(n^3) operations for n centers. With
+  SetRadialBasisFunction(WendlandRadialBasisFunction) the compactly supported Wendland function is used instead.
+  Only centers closer than the support radius influence each other, the sparse equation system is solved
+  iteratively and a distance value is evaluated from the centers of the neighboring cells of a grid only.
+  The distance values of the narrow band are evaluated on several threads in both cases.
+
+  If SetIncrementalUpdate(true) is set, the Wendland interpolation keeps the centers, weights and distance values of
+  the last update. If the image geometry and the support radius did not change, only the distance values within the
+  support of centers, which were added, removed or whose weight changed, are evaluated again. Weights that changed
+  by less than 1% of the image spacing divided by the largest number of centers around a grid cell are kept, so the
+  distance values differ by less than 1% of the spacing from a full update, up to the accuracy of the iterative
+  solver. Changing a contour slightly keeps the support radius, while removing or adding a contour usually changes
+  it and enforces a full update. Reset() keeps this state, since the centers of the next update are compared with
+  the previous ones anyway. GetNumberOfEvaluatedPixels() tells how many distance values an update evaluated.
+
+  The filter can be aborted with AbortGenerateDataOn() from a ProgressEvent observer, it then throws an
+  itk::ProcessAborted exception. An aborted update keeps the state of the last completed one for the next
+  incremental update.
+
          Note that the obtained distance image has always an isotropig spacing. The size (in this case volume) of the
   image can be
          adjusted by calling SetDistanceImageVolume(unsigned int volume) which specifies the number ob pixels enclosed
@@ -78,6 +101,17 @@ namespace mitk
 
     typedef std::vector<Surface::Pointer> SurfaceList;
 
+    /**
+    \brief The radial basis function used for the interpolation
+    - LinearRadialBasisFunction: Phi(r) = r
+    - WendlandRadialBasisFunction: Phi(r) = (1 - r/R)^4 * (4r/R + 1) for r < R and 0 otherwise, R is the support radius
+    */
+    enum RadialBasisFunctionType
+    {
+      LinearRadialBasisFunction,
+      WendlandRadialBasisFunction
+    };
+
     mitkClassMacro(CreateDistanceImageFromSurfaceFilter, ImageSource);
     itkFactorylessNewMacro(Self) itkCloneMacro(Self)
 
@@ -103,11 +137,45 @@ namespace mitk
     */
     itkSetMacro(DistanceImageVolume, unsigned int);
 
+    itkSetMacro(RadialBasisFunction, RadialBasisFunctionType);
+    itkGetMacro(RadialBasisFunction, RadialBasisFunctionType);
+
+    /**
+    \brief Set the support radius of the Wendland function in mm.
+           If it is 0 (default), the radius is twice the largest distance between a contour point
+           and the closest point of another contour, so that the interpolation bridges the gaps between the contours.
+    */
+    itkSetMacro(SupportRadius, double);
+    itkGetMacro(SupportRadius, double);
+
+    /**
+    \brief Set the number of threads evaluating the distance values. If it is 0 (default), one thread
+           per core is used.
+    */
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetMacro(NumberOfThreads, unsigned int);
+
+    /**
+    \brief Set whether an update of the Wendland interpolation only evaluates the region affected by changed contours
+    */
+    itkSetMacro(IncrementalUpdate, bool);
+    itkGetMacro(IncrementalUpdate, bool);
+    itkBooleanMacro(IncrementalUpdate);
+
+    /**
+    \brief Returns the number of distance values evaluated by the last update. An incremental update only evaluates
+           the values within the support of changed centers.
+    */
+    itkGetMacro(NumberOfEvaluatedPixels, std::size_t);
+
     void PrintEquationSystem();
 
     // Resets the filter, i.e. removes all inputs and outputs
     void Reset();
 
+    // Discards the centers, weights and distance values kept for the incremental update
+    void ResetIncrementalUpdate();
+
     /**
       \brief Set whether the mitkProgressBar should be used
 
@@ -131,8 +199,36 @@ namespace mitk
     virtual void GenerateOutputInformation() override;
 
   private:
+    // Grid of the centers with a cell size of at least the support radius
+    struct CenterGrid;
+
     void CreateSolutionMatrixAndFunctionValues();
-    double CalculateDistanceValue(PointType p);
+    void SolveEquationSystem();
+
+    /**
+    \brief Keeps the previous weights that changed only slightly and forgets the distance values within the support
+           of the changed centers. Without a usable previous update all distance values are forgotten.
+    */
+    void InvalidateDistanceValues();
+
+    /**
+    \brief Invokes a ProgressEvent and throws an itk::ProcessAborted exception if the filter was aborted
+    */
+    void UpdateProgressAndCheckAbort(float progress);
+
+    /**
+    \brief Returns the interpolated distance value at the given point. With the Wendland function, a point without
+           any center in its support gets m_DistanceImageDefaultBufferValue.
+    */
+    double CalculateDistanceValue(const PointType &p) const;
+
+    /**
+    \brief Determines the support radius of the Wendland function if none is set. The centers must start
+           with the given number of contour points.
+    */
+    double EstimateSupportRadius(unsigned int numberOfContourPoints) const;
+
+    unsigned int GetNumberOfUsedThreads() const;
 
     void FillDistanceImage();
 
@@ -162,7 +258,32 @@ namespace mitk
     CenterList m_Centers;
     NormalList m_Normals;
 
+    // The index of the input contour of each contour point
+    std::vector<unsigned int> m_ContourIndices;
+
+    RadialBasisFunctionType m_RadialBasisFunction;
+    double m_SupportRadius;
+    double m_UsedSupportRadius;
+    unsigned int m_NumberOfThreads;
+    std::unique_ptr<CenterGrid> m_CenterGrid;
+
+    // The state of the last update for incremental updates
+    bool m_IncrementalUpdate;
+    bool m_HasPreviousUpdate;
+    bool m_UpdateAffectedRegion;
+    CenterList m_PreviousCenters;
+    Eigen::VectorXd m_PreviousWeights;
+    double m_PreviousSupportRadius;
+    double m_PreviousSpacing;
+    DistanceImageType::PointType m_PreviousOrigin;
+    DistanceImageType::SizeType m_PreviousSize;
+    std::size_t m_NumberOfEvaluatedPixels;
+
+    // The calculated distance values of all pixels, NaN if not calculated
+    std::vector<double> m_DistanceValues;
+
     Eigen::MatrixXd m_SolutionMatrix;
+    Eigen::SparseMatrix<double> m_SparseSolutionMatrix;
     Eigen::VectorXd m_FunctionValues;
     Eigen::VectorXd m_Weights;
 
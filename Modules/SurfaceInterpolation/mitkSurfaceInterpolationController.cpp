@@ -20,6 +20,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkMemoryUtilities.h"
 
 #include "mitkImageToSurfaceFilter.h"
+#include <itkCommand.h>
+#include <itkProcessObject.h>
 //#include "vtkXMLPolyDataWriter.h"
 #include "vtkPolyDataWriter.h"
 
@@ -78,7 +80,11 @@ mitk::SurfaceInterpolationController::ContourPositionInformation CreateContourPo
 }
 
 mitk::SurfaceInterpolationController::SurfaceInterpolationController()
-  : m_SelectedSegmentation(nullptr), m_CurrentTimeStep(0)
+  : m_SelectedSegmentation(nullptr),
+    m_CurrentTimeStep(0),
+    m_Generation(0),
+    m_InterpolatedGeneration(0),
+    m_PipelineNeedsReinitialization(false)
 {
   m_DistanceImageSpacing = 0.0;
   m_ReduceFilter = ReduceContourSetFilter::New();
@@ -92,6 +98,13 @@ mitk::SurfaceInterpolationController::SurfaceInterpolationController()
   m_NormalsFilter->SetProgressStepSize(1);
   m_InterpolateSurfaceFilter->SetUseProgressBar(true);
   m_InterpolateSurfaceFilter->SetProgressStepSize(7);
+  // only used with the Wendland function, see SetRadialBasisFunction()
+  m_InterpolateSurfaceFilter->IncrementalUpdateOn();
+
+  itk::MemberCommand<SurfaceInterpolationController>::Pointer progressCommand =
+    itk::MemberCommand<SurfaceInterpolationController>::New();
+  progressCommand->SetCallbackFunction(this, &SurfaceInterpolationController::OnInterpolationProgress);
+  m_InterpolateSurfaceFilter->AddObserver(itk::ProgressEvent(), progressCommand);
 
   m_Contours = Surface::New();
 
@@ -125,25 +138,47 @@ mitk::SurfaceInterpolationController *mitk::SurfaceInterpolationController::GetI
   return m_Instance;
 }
 
+void mitk::SurfaceInterpolationController::SetCurrentTimeStep(unsigned int ts)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_ContoursMutex);
+    if (m_CurrentTimeStep == ts)
+      return;
+
+    m_CurrentTimeStep = ts;
+
+    if (!m_SelectedSegmentation)
+      return;
+
+    this->ContoursChanged(true);
+  }
+  this->Modified();
+}
+
 void mitk::SurfaceInterpolationController::AddNewContour(mitk::Surface::Pointer newContour)
 {
   if (newContour->GetVtkPolyData()->GetNumberOfPoints() > 0)
   {
-    ContourPositionInformation contourInfo = CreateContourPositionInformation(newContour);
-    this->AddToInterpolationPipeline(contourInfo);
-
+    {
+      std::lock_guard<std::mutex> lock(m_ContoursMutex);
+      ContourPositionInformation contourInfo = CreateContourPositionInformation(newContour);
+      this->AddToInterpolationPipeline(contourInfo);
+    }
     this->Modified();
   }
 }
 
 void mitk::SurfaceInterpolationController::AddNewContours(std::vector<mitk::Surface::Pointer> newContours)
 {
-  for (unsigned int i = 0; i < newContours.size(); ++i)
   {
-    if (newContours.at(i)->GetVtkPolyData()->GetNumberOfPoints() > 0)
+    std::lock_guard<std::mutex> lock(m_ContoursMutex);
+    for (unsigned int i = 0; i < newContours.size(); ++i)
     {
-      ContourPositionInformation contourInfo = CreateContourPositionInformation(newContours.at(i));
-      this->AddToInterpolationPipeline(contourInfo);
+      if (newContours.at(i)->GetVtkPolyData()->GetNumberOfPoints() > 0)
+      {
+        ContourPositionInformation contourInfo = CreateContourPositionInformation(newContours.at(i));
+        this->AddToInterpolationPipeline(contourInfo);
+      }
     }
   }
   this->Modified();
@@ -181,22 +216,33 @@ void mitk::SurfaceInterpolationController::AddToInterpolationPipeline(ContourPos
   // Don't save a new empty contour
   if (pos == -1 && newContour->GetVtkPolyData()->GetNumberOfPoints() > 0)
   {
-    m_ReduceFilter->SetInput(m_ListOfInterpolationSessions[m_SelectedSegmentation][m_CurrentTimeStep].size(),
-                             newContour);
     m_ListOfInterpolationSessions[m_SelectedSegmentation][m_CurrentTimeStep].push_back(contourInfo);
+    this->ContoursChanged();
   }
   else if (pos != -1 && newContour->GetVtkPolyData()->GetNumberOfPoints() > 0)
   {
     m_ListOfInterpolationSessions[m_SelectedSegmentation][m_CurrentTimeStep].at(pos) = contourInfo;
-    m_ReduceFilter->SetInput(pos, newContour);
+    this->ContoursChanged();
   }
   else if (newContour->GetVtkPolyData()->GetNumberOfPoints() == 0)
   {
-    this->RemoveContour(contourInfo);
+    this->RemoveContourFromPipeline(contourInfo);
   }
 }
 
 bool mitk::SurfaceInterpolationController::RemoveContour(ContourPositionInformation contourInfo)
+{
+  bool removed = false;
+  {
+    std::lock_guard<std::mutex> lock(m_ContoursMutex);
+    removed = this->RemoveContourFromPipeline(contourInfo);
+  }
+  if (removed)
+    this->Modified();
+  return removed;
+}
+
+bool mitk::SurfaceInterpolationController::RemoveContourFromPipeline(ContourPositionInformation contourInfo)
 {
   if (!m_SelectedSegmentation)
   {
@@ -216,7 +262,7 @@ bool mitk::SurfaceInterpolationController::RemoveContour(ContourPositionInformat
     if (ContoursCoplanar(currentContour, contourInfo))
     {
       m_ListOfInterpolationSessions[m_SelectedSegmentation][m_CurrentTimeStep].erase(it);
-      this->ReinitializeInterpolation();
+      this->ContoursChanged(true);
       return true;
     }
     ++it;
@@ -226,6 +272,7 @@ bool mitk::SurfaceInterpolationController::RemoveContour(ContourPositionInformat
 
 const mitk::Surface *mitk::SurfaceInterpolationController::GetContour(ContourPositionInformation contourInfo)
 {
+  std::lock_guard<std::mutex> lock(m_ContoursMutex);
   if (!m_SelectedSegmentation)
   {
     return nullptr;
@@ -249,6 +296,7 @@ const mitk::Surface *mitk::SurfaceInterpolationController::GetContour(ContourPos
 
 unsigned int mitk::SurfaceInterpolationController::GetNumberOfContours()
 {
+  std::lock_guard<std::mutex> lock(m_ContoursMutex);
   if (!m_SelectedSegmentation)
   {
     return -1;
@@ -265,75 +313,161 @@ unsigned int mitk::SurfaceInterpolationController::GetNumberOfContours()
 
 void mitk::SurfaceInterpolationController::Interpolate()
 {
-  m_ReduceFilter->Update();
+  std::lock_guard<std::mutex> interpolationLock(m_InterpolationMutex);
 
-  m_CurrentNumberOfReducedContours = m_ReduceFilter->GetNumberOfOutputs();
-  if (m_CurrentNumberOfReducedContours == 1)
+  // The contours are copied, so that they can be changed while the pipeline runs
+  mitk::Image::Pointer segmentation;
+  unsigned int timeStep = 0;
+  ContourPositionInformationList contours;
+  bool reinitializePipeline = false;
   {
-    vtkPolyData *tmp = m_ReduceFilter->GetOutput(0)->GetVtkPolyData();
-    if (tmp == nullptr)
-    {
-      m_CurrentNumberOfReducedContours = 0;
-    }
+    std::lock_guard<std::mutex> contoursLock(m_ContoursMutex);
+    m_InterpolatedGeneration = m_Generation.load();
+    segmentation = m_SelectedSegmentation;
+    timeStep = m_CurrentTimeStep;
+    if (segmentation && timeStep < m_ListOfInterpolationSessions[segmentation].size())
+      contours = m_ListOfInterpolationSessions[segmentation][timeStep];
+    reinitializePipeline = m_PipelineNeedsReinitialization;
+    m_PipelineNeedsReinitialization = false;
   }
 
-  mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
-  timeSelector->SetInput(m_SelectedSegmentation);
-  timeSelector->SetTimeNr(m_CurrentTimeStep);
-  timeSelector->SetChannelNr(0);
-  timeSelector->Update();
-  mitk::Image::Pointer refSegImage = timeSelector->GetOutput();
+  if (segmentation.IsNull())
+    return;
 
-  m_NormalsFilter->SetSegmentationBinaryImage(refSegImage);
-  for (unsigned int i = 0; i < m_CurrentNumberOfReducedContours; i++)
+  try
   {
-    mitk::Surface::Pointer reducedContour = m_ReduceFilter->GetOutput(i);
-    reducedContour->DisconnectPipeline();
-    m_NormalsFilter->SetInput(i, reducedContour);
-    m_InterpolateSurfaceFilter->SetInput(i, m_NormalsFilter->GetOutput(i));
-  }
+    if (reinitializePipeline)
+      this->ReinitializeInterpolation(segmentation, timeStep);
 
-  if (m_CurrentNumberOfReducedContours < 2)
-  {
-    // If no interpolation is possible reset the interpolation result
-    m_InterpolationResult = nullptr;
-    return;
-  }
+    // Only the new or changed contours modify the reduction
+    for (unsigned int i = 0; i < contours.size(); ++i)
+      m_ReduceFilter->SetInput(i, contours[i].contour);
 
-  // Setting up progress bar
-  mitk::ProgressBar::GetInstance()->AddStepsToDo(10);
+    m_ReduceFilter->Update();
+
+    m_CurrentNumberOfReducedContours = m_ReduceFilter->GetNumberOfOutputs();
+    if (m_CurrentNumberOfReducedContours == 1)
+    {
+      vtkPolyData *tmp = m_ReduceFilter->GetOutput(0)->GetVtkPolyData();
+      if (tmp == nullptr)
+      {
+        m_CurrentNumberOfReducedContours = 0;
+      }
+    }
+
+    mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
+    timeSelector->SetInput(segmentation);
+    timeSelector->SetTimeNr(timeStep);
+    timeSelector->SetChannelNr(0);
+    timeSelector->Update();
+    mitk::Image::Pointer refSegImage = timeSelector->GetOutput();
+
+    m_NormalsFilter->SetSegmentationBinaryImage(refSegImage);
+    for (unsigned int i = 0; i < m_CurrentNumberOfReducedContours; i++)
+    {
+      mitk::Surface::Pointer reducedContour = m_ReduceFilter->GetOutput(i);
+      reducedContour->DisconnectPipeline();
+      m_NormalsFilter->SetInput(i, reducedContour);
+      m_InterpolateSurfaceFilter->SetInput(i, m_NormalsFilter->GetOutput(i));
+    }
+
+    if (m_CurrentNumberOfReducedContours < 2)
+    {
+      // If no interpolation is possible reset the interpolation result
+      std::lock_guard<std::mutex> contoursLock(m_ContoursMutex);
+      if (m_Generation == m_InterpolatedGeneration)
+        m_InterpolationResult = nullptr;
+      return;
+    }
+
+    // Setting up progress bar
+    mitk::ProgressBar::GetInstance()->AddStepsToDo(10);
+
+    // Only the distance image checks for an abort while it is updated, the other filters are checked in between
+    this->AbortIfOutdated();
+    m_NormalsFilter->Update();
+    this->AbortIfOutdated();
+    m_InterpolateSurfaceFilter->Update();
+    this->AbortIfOutdated();
+
+    // create a surface from the distance-image
+    mitk::ImageToSurfaceFilter::Pointer imageToSurfaceFilter = mitk::ImageToSurfaceFilter::New();
+    imageToSurfaceFilter->SetInput(m_InterpolateSurfaceFilter->GetOutput());
+    imageToSurfaceFilter->SetThreshold(0);
+    imageToSurfaceFilter->SetSmooth(true);
+    imageToSurfaceFilter->SetSmoothIteration(20);
+    imageToSurfaceFilter->Update();
+    this->AbortIfOutdated();
+
+    mitk::Surface::Pointer interpolationResult = mitk::Surface::New();
+    interpolationResult->SetVtkPolyData(imageToSurfaceFilter->GetOutput()->GetVtkPolyData(), timeStep);
+    interpolationResult->DisconnectPipeline();
+    {
+      // The result of outdated contours is dropped, e.g. after another session was selected
+      std::lock_guard<std::mutex> contoursLock(m_ContoursMutex);
+      this->AbortIfOutdated();
+      m_InterpolationResult = interpolationResult;
+    }
+
+    m_DistanceImageSpacing = m_InterpolateSurfaceFilter->GetDistanceImageSpacing();
+
+    vtkSmartPointer<vtkAppendPolyData> polyDataAppender = vtkSmartPointer<vtkAppendPolyData>::New();
+    for (unsigned int i = 0; i < contours.size(); i++)
+    {
+      polyDataAppender->AddInputData(contours.at(i).contour->GetVtkPolyData());
+    }
+    polyDataAppender->Update();
+    m_Contours->SetVtkPolyData(polyDataAppender->GetOutput());
 
-  // create a surface from the distance-image
-  mitk::ImageToSurfaceFilter::Pointer imageToSurfaceFilter = mitk::ImageToSurfaceFilter::New();
-  imageToSurfaceFilter->SetInput(m_InterpolateSurfaceFilter->GetOutput());
-  imageToSurfaceFilter->SetThreshold(0);
-  imageToSurfaceFilter->SetSmooth(true);
-  imageToSurfaceFilter->SetSmoothIteration(20);
-  imageToSurfaceFilter->Update();
+    // Last progress step
+    mitk::ProgressBar::GetInstance()->Progress(20);
+  }
+  catch (const itk::ProcessAborted &)
+  {
+    // The contours are changed or the interpolation was aborted, the previous result is kept
+    mitk::ProgressBar::GetInstance()->Progress(20);
+  }
+}
 
-  mitk::Surface::Pointer interpolationResult = mitk::Surface::New();
-  interpolationResult->SetVtkPolyData(imageToSurfaceFilter->GetOutput()->GetVtkPolyData(), m_CurrentTimeStep);
-  m_InterpolationResult = interpolationResult;
+void mitk::SurfaceInterpolationController::AbortInterpolation()
+{
+  ++m_Generation;
+}
 
-  m_DistanceImageSpacing = m_InterpolateSurfaceFilter->GetDistanceImageSpacing();
+void mitk::SurfaceInterpolationController::ContoursChanged(bool reinitializePipeline)
+{
+  if (reinitializePipeline)
+    m_PipelineNeedsReinitialization = true;
+  ++m_Generation;
+}
 
-  vtkSmartPointer<vtkAppendPolyData> polyDataAppender = vtkSmartPointer<vtkAppendPolyData>::New();
-  for (unsigned int i = 0; i < m_ListOfInterpolationSessions[m_SelectedSegmentation][m_CurrentTimeStep].size(); i++)
+void mitk::SurfaceInterpolationController::AbortIfOutdated()
+{
+  if (m_Generation != m_InterpolatedGeneration)
   {
-    polyDataAppender->AddInputData(
-      m_ListOfInterpolationSessions[m_SelectedSegmentation][m_CurrentTimeStep].at(i).contour->GetVtkPolyData());
+    itk::ProcessAborted exception(__FILE__, __LINE__);
+    exception.SetDescription("mitk::SurfaceInterpolationController: The interpolation is outdated.");
+    exception.SetLocation(ITK_LOCATION);
+    throw exception;
   }
-  polyDataAppender->Update();
-  m_Contours->SetVtkPolyData(polyDataAppender->GetOutput());
+}
 
-  // Last progress step
-  mitk::ProgressBar::GetInstance()->Progress(20);
+void mitk::SurfaceInterpolationController::OnInterpolationProgress(itk::Object *caller,
+                                                                   const itk::EventObject & /*event*/)
+{
+  if (m_Generation != m_InterpolatedGeneration)
+    static_cast<itk::ProcessObject *>(caller)->AbortGenerateDataOn();
+}
 
-  m_InterpolationResult->DisconnectPipeline();
+std::unique_lock<std::mutex> mitk::SurfaceInterpolationController::LockInterpolation()
+{
+  this->AbortInterpolation();
+  return std::unique_lock<std::mutex>(m_InterpolationMutex);
 }
 
 mitk::Surface::Pointer mitk::SurfaceInterpolationController::GetInterpolationResult()
 {
+  std::lock_guard<std::mutex> lock(m_ContoursMutex);
   return m_InterpolationResult;
 }
 
@@ -349,20 +483,43 @@ void mitk::SurfaceInterpolationController::SetDataStorage(DataStorage::Pointer d
 
 void mitk::SurfaceInterpolationController::SetMinSpacing(double minSpacing)
 {
+  auto lock = this->LockInterpolation();
   m_ReduceFilter->SetMinSpacing(minSpacing);
 }
 
 void mitk::SurfaceInterpolationController::SetMaxSpacing(double maxSpacing)
 {
+  auto lock = this->LockInterpolation();
   m_ReduceFilter->SetMaxSpacing(maxSpacing);
   m_NormalsFilter->SetMaxSpacing(maxSpacing);
 }
 
 void mitk::SurfaceInterpolationController::SetDistanceImageVolume(unsigned int distImgVolume)
 {
+  auto lock = this->LockInterpolation();
   m_InterpolateSurfaceFilter->SetDistanceImageVolume(distImgVolume);
 }
 
+void mitk::SurfaceInterpolationController::SetRadialBasisFunction(
+  CreateDistanceImageFromSurfaceFilter::RadialBasisFunctionType radialBasisFunction)
+{
+  {
+    auto lock = this->LockInterpolation();
+    if (m_InterpolateSurfaceFilter->GetRadialBasisFunction() == radialBasisFunction)
+      return;
+
+    m_InterpolateSurfaceFilter->SetRadialBasisFunction(radialBasisFunction);
+    m_InterpolateSurfaceFilter->ResetIncrementalUpdate();
+  }
+  this->Modified();
+}
+
+mitk::CreateDistanceImageFromSurfaceFilter::RadialBasisFunctionType
+  mitk::SurfaceInterpolationController::GetRadialBasisFunction()
+{
+  return m_InterpolateSurfaceFilter->GetRadialBasisFunction();
+}
+
 mitk::Image::Pointer mitk::SurfaceInterpolationController::GetCurrentSegmentation()
 {
   return m_SelectedSegmentation;
@@ -401,12 +558,14 @@ void mitk::SurfaceInterpolationController::SetCurrentSegmentationInterpolationLi
 
 void mitk::SurfaceInterpolationController::SetCurrentInterpolationSession(mitk::Image::Pointer currentSegmentationImage)
 {
+  std::unique_lock<std::mutex> lock(m_ContoursMutex);
   if (currentSegmentationImage.GetPointer() == m_SelectedSegmentation)
     return;
 
   if (currentSegmentationImage.IsNull())
   {
     m_SelectedSegmentation = nullptr;
+    this->ContoursChanged(true);
     return;
   }
 
@@ -421,7 +580,6 @@ void mitk::SurfaceInterpolationController::SetCurrentInterpolationSession(mitk::
     m_ListOfInterpolationSessions.insert(
       std::pair<mitk::Image *, ContourPositionInformationVec2D>(m_SelectedSegmentation, newList));
     m_InterpolationResult = nullptr;
-    m_CurrentNumberOfReducedContours = 0;
 
     itk::MemberCommand<SurfaceInterpolationController>::Pointer command =
       itk::MemberCommand<SurfaceInterpolationController>::New();
@@ -430,7 +588,13 @@ void mitk::SurfaceInterpolationController::SetCurrentInterpolationSession(mitk::
       m_SelectedSegmentation, m_SelectedSegmentation->AddObserver(itk::DeleteEvent(), command)));
   }
 
-  this->ReinitializeInterpolation();
+  const unsigned int numTimeSteps = m_SelectedSegmentation->GetTimeSteps();
+  if (m_ListOfInterpolationSessions[m_SelectedSegmentation].size() != numTimeSteps)
+    m_ListOfInterpolationSessions[m_SelectedSegmentation].resize(numTimeSteps);
+
+  this->ContoursChanged(true);
+  lock.unlock();
+  this->Modified();
 }
 
 bool mitk::SurfaceInterpolationController::ReplaceInterpolationSession(mitk::Image::Pointer oldSession,
@@ -445,6 +609,7 @@ bool mitk::SurfaceInterpolationController::ReplaceInterpolationSession(mitk::Ima
   if (!mitk::Equal(*(oldSession->GetGeometry()), *(newSession->GetGeometry()), mitk::eps, false))
     return false;
 
+  std::unique_lock<std::mutex> lock(m_ContoursMutex);
   auto it = m_ListOfInterpolationSessions.find(oldSession.GetPointer());
 
   if (it == m_ListOfInterpolationSessions.end())
@@ -460,15 +625,11 @@ bool mitk::SurfaceInterpolationController::ReplaceInterpolationSession(mitk::Ima
     std::pair<mitk::Image *, unsigned long>(newSession, newSession->AddObserver(itk::DeleteEvent(), command)));
 
   if (m_SelectedSegmentation == oldSession)
+  {
     m_SelectedSegmentation = newSession;
-
-  mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
-  timeSelector->SetInput(m_SelectedSegmentation);
-  timeSelector->SetTimeNr(m_CurrentTimeStep);
-  timeSelector->SetChannelNr(0);
-  timeSelector->Update();
-  mitk::Image::Pointer refSegImage = timeSelector->GetOutput();
-  m_NormalsFilter->SetSegmentationBinaryImage(refSegImage);
+    this->ContoursChanged(true);
+  }
+  lock.unlock();
 
   this->RemoveInterpolationSession(oldSession);
   return true;
@@ -483,10 +644,11 @@ void mitk::SurfaceInterpolationController::RemoveInterpolationSession(mitk::Imag
 {
   if (segmentationImage)
   {
+    std::lock_guard<std::mutex> lock(m_ContoursMutex);
     if (m_SelectedSegmentation == segmentationImage)
     {
-      m_NormalsFilter->SetSegmentationBinaryImage(nullptr);
       m_SelectedSegmentation = nullptr;
+      this->ContoursChanged(true);
     }
     m_ListOfInterpolationSessions.erase(segmentationImage);
     // Remove observer
@@ -501,6 +663,8 @@ void mitk::SurfaceInterpolationController::RemoveInterpolationSession(mitk::Imag
 
 void mitk::SurfaceInterpolationController::RemoveAllInterpolationSessions()
 {
+  std::lock_guard<std::mutex> lock(m_ContoursMutex);
+
   // Removing all observers
   auto dataIter = m_SegmentationObserverTags.begin();
   while (dataIter != m_SegmentationObserverTags.end())
@@ -513,6 +677,7 @@ void mitk::SurfaceInterpolationController::RemoveAllInterpolationSessions()
   m_SegmentationObserverTags.clear();
   m_SelectedSegmentation = nullptr;
   m_ListOfInterpolationSessions.clear();
+  this->ContoursChanged(true);
 }
 
 void mitk::SurfaceInterpolationController::ReinitializeInterpolation(mitk::Surface::Pointer contours)
@@ -629,71 +794,32 @@ void mitk::SurfaceInterpolationController::OnSegmentationDeleted(const itk::Obje
   auto *tempImage = dynamic_cast<mitk::Image *>(const_cast<itk::Object *>(caller));
   if (tempImage)
   {
+    std::lock_guard<std::mutex> lock(m_ContoursMutex);
     if (m_SelectedSegmentation == tempImage)
     {
-      m_NormalsFilter->SetSegmentationBinaryImage(nullptr);
       m_SelectedSegmentation = nullptr;
+      this->ContoursChanged(true);
     }
     m_SegmentationObserverTags.erase(tempImage);
     m_ListOfInterpolationSessions.erase(tempImage);
   }
 }
 
-void mitk::SurfaceInterpolationController::ReinitializeInterpolation()
+void mitk::SurfaceInterpolationController::ReinitializeInterpolation(mitk::Image *segmentation, unsigned int timeStep)
 {
-  // If session has changed reset the pipeline
+  // If session has changed reset the pipeline, Interpolate() passes the contours again
   m_ReduceFilter->Reset();
   m_NormalsFilter->Reset();
   m_InterpolateSurfaceFilter->Reset();
 
   itk::ImageBase<3>::Pointer itkImage = itk::ImageBase<3>::New();
 
-  if (m_SelectedSegmentation)
-  {
-    mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
-    timeSelector->SetInput(m_SelectedSegmentation);
-    timeSelector->SetTimeNr(m_CurrentTimeStep);
-    timeSelector->SetChannelNr(0);
-    timeSelector->Update();
-    mitk::Image::Pointer refSegImage = timeSelector->GetOutput();
-    AccessFixedDimensionByItk_1(refSegImage, GetImageBase, 3, itkImage);
-    m_InterpolateSurfaceFilter->SetReferenceImage(itkImage.GetPointer());
-
-    unsigned int numTimeSteps = m_SelectedSegmentation->GetTimeSteps();
-    unsigned int size = m_ListOfInterpolationSessions[m_SelectedSegmentation].size();
-    if (size != numTimeSteps)
-    {
-      m_ListOfInterpolationSessions[m_SelectedSegmentation].resize(numTimeSteps);
-    }
-
-    if (m_CurrentTimeStep < numTimeSteps)
-    {
-      unsigned int numContours = m_ListOfInterpolationSessions[m_SelectedSegmentation][m_CurrentTimeStep].size();
-      for (unsigned int c = 0; c < numContours; ++c)
-      {
-        m_ReduceFilter->SetInput(c,
-                                 m_ListOfInterpolationSessions[m_SelectedSegmentation][m_CurrentTimeStep][c].contour);
-      }
-
-      m_ReduceFilter->Update();
-
-      m_CurrentNumberOfReducedContours = m_ReduceFilter->GetNumberOfOutputs();
-      if (m_CurrentNumberOfReducedContours == 1)
-      {
-        vtkPolyData *tmp = m_ReduceFilter->GetOutput(0)->GetVtkPolyData();
-        if (tmp == nullptr)
-        {
-          m_CurrentNumberOfReducedContours = 0;
-        }
-      }
-
-      for (unsigned int i = 0; i < m_CurrentNumberOfReducedContours; i++)
-      {
-        m_NormalsFilter->SetInput(i, m_ReduceFilter->GetOutput(i));
-        m_InterpolateSurfaceFilter->SetInput(i, m_NormalsFilter->GetOutput(i));
-      }
-    }
-
-    Modified();
-  }
+  mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
+  timeSelector->SetInput(segmentation);
+  timeSelector->SetTimeNr(timeStep);
+  timeSelector->SetChannelNr(0);
+  timeSelector->Update();
+  mitk::Image::Pointer refSegImage = timeSelector->GetOutput();
+  AccessFixedDimensionByItk_1(refSegImage, GetImageBase, 3, itkImage);
+  m_InterpolateSurfaceFilter->SetReferenceImage(itkImage.GetPointer());
 }
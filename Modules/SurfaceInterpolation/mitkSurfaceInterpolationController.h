@@ -48,6 +48,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkProgressBar.h"
 
+#include <atomic>
+#include <mutex>
+
 namespace mitk
 {
   class MITKSURFACEINTERPOLATION_EXPORT SurfaceInterpolationController : public itk::Object
@@ -72,18 +75,7 @@ namespace mitk
 
     static SurfaceInterpolationController *GetInstance();
 
-    void SetCurrentTimeStep(unsigned int ts)
-    {
-      if (m_CurrentTimeStep != ts)
-      {
-        m_CurrentTimeStep = ts;
-
-        if (m_SelectedSegmentation)
-        {
-          this->ReinitializeInterpolation();
-        }
-      }
-    };
+    void SetCurrentTimeStep(unsigned int ts);
 
     unsigned int GetCurrentTimeStep() { return m_CurrentTimeStep; };
     /**
@@ -122,9 +114,21 @@ namespace mitk
 
     /**
      * Interpolates the 3D surface from the given extracted contours
+     *
+     * With the WendlandRadialBasisFunction (see SetRadialBasisFunction()) the distance image is updated
+     * incrementally, i.e. after a single contour was changed only the region around that contour is evaluated
+     * again. Only one interpolation runs at a time. It works on a copy of the contours, so the contours and sessions
+     * can be changed from another thread without waiting for it. A running interpolation is aborted as soon as its
+     * contours are outdated or AbortInterpolation() is called, the previous interpolation result is kept in that
+     * case. An interpolation that starts afterwards uses the current contours.
      */
     void Interpolate();
 
+    /**
+     * @brief Aborts a running interpolation, e.g. because it will be restarted with other settings
+     */
+    void AbortInterpolation();
+
     mitk::Surface::Pointer GetInterpolationResult();
 
     /**
@@ -145,6 +149,17 @@ namespace mitk
      */
     void SetDistanceImageVolume(unsigned int distImageVolume);
 
+    /**
+     * @brief Sets the radial basis function of the interpolation, see CreateDistanceImageFromSurfaceFilter
+     *
+     * The default LinearRadialBasisFunction gives the established interpolation results, every contour influences
+     * the whole surface. The WendlandRadialBasisFunction only bridges the gaps between neighboring contours, so the
+     * interpolated surface differs slightly, but it is much faster for many contours and is updated incrementally
+     * after a contour was changed.
+     */
+    void SetRadialBasisFunction(CreateDistanceImageFromSurfaceFilter::RadialBasisFunctionType radialBasisFunction);
+    CreateDistanceImageFromSurfaceFilter::RadialBasisFunctionType GetRadialBasisFunction();
+
     /**
      * @brief Get the current selected segmentation for which the interpolation is performed
      * @return the current segmentation image
@@ -221,12 +236,26 @@ namespace mitk
     void GetImageBase(itk::Image<TPixel, VImageDimension> *input, itk::ImageBase<3>::Pointer &result);
 
   private:
-    void ReinitializeInterpolation();
+    // Resets the pipeline for another segmentation, time step or removed contours, only called by Interpolate()
+    void ReinitializeInterpolation(mitk::Image *segmentation, unsigned int timeStep);
+
+    bool RemoveContourFromPipeline(ContourPositionInformation contourInfo);
 
     void OnSegmentationDeleted(const itk::Object *caller, const itk::EventObject &event);
 
     void AddToInterpolationPipeline(ContourPositionInformation contourInfo);
 
+    void OnInterpolationProgress(itk::Object *caller, const itk::EventObject &event);
+
+    // Aborts the running interpolation and locks the pipeline, for changes of the filters
+    std::unique_lock<std::mutex> LockInterpolation();
+
+    // Marks the running interpolation as outdated, the caller has to hold m_ContoursMutex
+    void ContoursChanged(bool reinitializePipeline = false);
+
+    // Throws itk::ProcessAborted between the filters of the pipeline, if the interpolation is outdated
+    void AbortIfOutdated();
+
     ReduceContourSetFilter::Pointer m_ReduceFilter;
     ComputeContourSetNormalsFilter::Pointer m_NormalsFilter;
     CreateDistanceImageFromSurfaceFilter::Pointer m_InterpolateSurfaceFilter;
@@ -250,6 +279,17 @@ namespace mitk
     std::map<mitk::Image *, unsigned long> m_SegmentationObserverTags;
 
     unsigned int m_CurrentTimeStep;
+
+    // Held by Interpolate() for the whole pipeline, guards the filters
+    std::mutex m_InterpolationMutex;
+    // Held shortly, guards the sessions and their contours
+    std::mutex m_ContoursMutex;
+    // Incremented by every change of the contours and by AbortInterpolation()
+    std::atomic<unsigned int> m_Generation;
+    // m_Generation when the running interpolation copied the contours
+    std::atomic<unsigned int> m_InterpolatedGeneration;
+    // Set if the pipeline has to be set up again, e.g. after a contour was removed
+    bool m_PipelineNeedsReinitialization;
   };
 }
 #endif
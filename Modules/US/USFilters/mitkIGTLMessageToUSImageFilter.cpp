@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkIGTLMessageToUSImageFilter.h>
 #include <igtlImageMessage.h>
 #include <itkByteSwapper.h>
+#include <mitkImageWriteAccessor.h>
 
 void mitk::IGTLMessageToUSImageFilter::GetNextRawImage(
   mitk::Image::Pointer& img)
@@ -78,22 +79,14 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
   igtl::ImageMessage* msg,
   bool big_endian)
 {
-  typedef itk::Image<TPixel, 3> ImageType;
-
-  typename ImageType::Pointer output = ImageType::New();
-  typename ImageType::RegionType region;
-  typename ImageType::RegionType::SizeType size;
-  typename ImageType::RegionType::IndexType index;
-  typename ImageType::SpacingType spacing;
-  typename ImageType::PointType origin;
-
   // Copy dimensions
   int dims[3];
   msg->GetDimensions(dims);
+  unsigned int dimensions[3];
   size_t num_pixel = 1;
   for (size_t i = 0; i < 3; i++)
   {
-    size[i] = dims[i];
+    dimensions[i] = dims[i];
     num_pixel *= dims[i];
   }
 
@@ -110,58 +103,55 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
     }
   }
 
-  index.Fill(0);
-
-  float matF[4][4];
-  msg->GetMatrix(matF);
-  vtkMatrix4x4* vtkMatrix = vtkMatrix4x4::New();
-
-  for (size_t i = 0; i < 4; ++i)
-    for (size_t j = 0; j < 4; ++j)
-      vtkMatrix->SetElement(i, j, matF[i][j]);
-
   float spacingMsg[3];
 
   msg->GetSpacing(spacingMsg);
 
+  mitk::Vector3D spacing;
   for (int i = 0; i < 3; ++i)
     spacing[i] = spacingMsg[i];
 
-  region.SetSize(size);
-  region.SetIndex(index);
-  output->SetRegions(region);
-  output->SetSpacing(spacing);
-  output->Allocate();
+  // The previous image is overwritten if nobody else refers to it any more,
+  // otherwise a new image is allocated
+  mitk::PixelType pixelType = mitk::MakeScalarPixelType<TPixel>();
+  bool reusePreviousImage = m_previousImage.IsNotNull() && m_previousImage->GetReferenceCount() == 1 && m_previousImage->GetPixelType() == pixelType &&
+    m_previousImage->GetDimension() == 3;
+  for (size_t i = 0; reusePreviousImage && i < 3; i++)
+  {
+    reusePreviousImage = m_previousImage->GetDimension(i) == dimensions[i];
+  }
 
-  TPixel* in = (TPixel*)msg->GetScalarPointer();
-  TPixel* out = (TPixel*)output->GetBufferPointer();
-  memcpy(out, in, num_pixel * sizeof(TPixel));
-  if (big_endian)
+  if (reusePreviousImage)
   {
-    // Even though this method is called "FromSystemToBigEndian", it also swaps
-    // "FromBigEndianToSystem".
-    // This makes sense, but might be confusing at first glance.
-    itk::ByteSwapper<TPixel>::SwapRangeFromSystemToBigEndian(out, num_pixel);
+    img = m_previousImage;
   }
   else
   {
-    itk::ByteSwapper<TPixel>::SwapRangeFromSystemToLittleEndian(out, num_pixel);
+    img = mitk::Image::New();
+    img->Initialize(pixelType, 3, dimensions);
   }
+  img->SetSpacing(spacing);
 
-  img = mitk::Image::New();
-  img->InitializeByItk(output.GetPointer());
-  img->SetVolume(output->GetBufferPointer());
-  //img->GetGeometry()->SetIndexToWorldTransformByVtkMatrix(vtkMatrix);
-  m_previousImage = img;
-  vtkMatrix->Delete();
-
-  float iorigin[3];
-  msg->GetOrigin(iorigin);
-  for (size_t i = 0; i < 3; i++)
+  // The payload of the message is copied directly into the image buffer
   {
-    origin[i] = iorigin[i];
+    mitk::ImageWriteAccessor accessor(img);
+    TPixel* out = static_cast<TPixel*>(accessor.GetData());
+    memcpy(out, msg->GetScalarPointer(), num_pixel * sizeof(TPixel));
+    if (big_endian)
+    {
+      // Even though this method is called "FromSystemToBigEndian", it also swaps
+      // "FromBigEndianToSystem".
+      // This makes sense, but might be confusing at first glance.
+      itk::ByteSwapper<TPixel>::SwapRangeFromSystemToBigEndian(out, num_pixel);
+    }
+    else
+    {
+      itk::ByteSwapper<TPixel>::SwapRangeFromSystemToLittleEndian(out, num_pixel);
+    }
   }
-  output->SetOrigin(origin);
+  img->Modified();
+
+  m_previousImage = img;
 }
 
 mitk::IGTLMessageToUSImageFilter::IGTLMessageToUSImageFilter()
@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "QmitkCreatePolygonModelAction.h"
 
 // MITK
+#include <mitkLabelSetImage.h>
 #include <mitkShowSegmentationAsSmoothedSurface.h>
 #include <mitkShowSegmentationAsSurface.h>
 #include <mitkProgressBar.h>
@@ -75,6 +76,8 @@ void QmitkCreatePolygonModelAction::Run(const QList<DataNode::Pointer> &selected
       surfaceFilter->SetParameter("Gaussian SD", 1.5f);
       surfaceFilter->SetParameter("Decimate mesh", m_IsDecimated);
       surfaceFilter->SetParameter("Decimation rate", 0.8f);
+      // one surface for each label, the labels are processed in parallel
+      surfaceFilter->SetParameter("Per label", dynamic_cast<LabelSetImage *>(image.GetPointer()) != nullptr);
 
       StatusBar::GetInstance()->DisplayText("Surface creation started in background...");
 
@@ -363,6 +363,8 @@ void PAImageProcessing::HandleBeamformingResults(mitk::Image::Pointer image)
     newNodeName << "DAS bf, ";
   else if (BFconfig.Algorithm == mitk::BeamformingFilter::beamformingSettings::BeamformingAlgorithm::DMAS)
     newNodeName << "DMAS bf, ";
+  else if (BFconfig.Algorithm == mitk::BeamformingFilter::beamformingSettings::BeamformingAlgorithm::sDMAS)
+    newNodeName << "sDMAS bf, ";
 
   if (BFconfig.DelayCalculationMethod == mitk::BeamformingFilter::beamformingSettings::DelayCalc::QuadApprox)
     newNodeName << "q. delay";
@@ -846,6 +848,8 @@ void PAImageProcessing::UpdateBFSettings(mitk::Image::Pointer image)
     BFconfig.Algorithm = mitk::BeamformingFilter::beamformingSettings::BeamformingAlgorithm::DAS;
   else if ("DMAS" == m_Controls.BFAlgorithm->currentText())
     BFconfig.Algorithm = mitk::BeamformingFilter::beamformingSettings::BeamformingAlgorithm::DMAS;
+  else if ("sDMAS" == m_Controls.BFAlgorithm->currentText())
+    BFconfig.Algorithm = mitk::BeamformingFilter::beamformingSettings::BeamformingAlgorithm::sDMAS;
 
   if ("Quad. Approx." == m_Controls.DelayCalculation->currentText())
   {